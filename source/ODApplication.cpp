@@ -21,8 +21,10 @@
 
 #include "ODApplication.h"
 
+#include "gamemap/LevelInfoIndex.h"
 #include "network/ODServer.h"
 #include "network/ODClient.h"
+#include "network/ODRelay.h"
 #include "network/ServerMode.h"
 #include "sound/MusicPlayer.h"
 #include "sound/SoundEffectsManager.h"
@@ -30,6 +32,7 @@
 #include "render/ODFrameListener.h"
 #include "render/TextRenderer.h"
 #include "utils/ConfigManager.h"
+#include "utils/Helper.h"
 #include "utils/LogManager.h"
 #include "utils/LogSinkConsole.h"
 #include "utils/LogSinkFile.h"
@@ -54,6 +57,8 @@
 #endif /* OGRE_PLATFORM == OGRE_PLATFORM_WIN32 */
 #endif /* OD_USE_SFML_WINDOW */
 
+#include <SFML/System/Sleep.hpp>
+
 #include <boost/program_options.hpp>
 
 #include <string>
@@ -72,6 +77,8 @@ void ODApplication::startGame(boost::program_options::variables_map& options)
 
     if(resMgr.isServerMode())
         startServer();
+    else if(resMgr.isRelayMode())
+        startRelay();
     else
         startClient();
 }
@@ -105,6 +112,47 @@ void ODApplication::startServer()
     server.stopServer();
 }
 
+void ODApplication::startRelay()
+{
+    ResourceManager& resMgr = ResourceManager::getSingleton();
+
+    OD_LOG_INF("Initializing");
+
+    ConfigManager configManager(resMgr.getConfigPath(), "", resMgr.getSoundPath());
+
+    // The relay listens to spectators on the usual port. The server port is the same if not given
+    int32_t listeningPort = resMgr.getForcedNetworkPort();
+    if(listeningPort == -1)
+        listeningPort = static_cast<int32_t>(configManager.getNetworkPort());
+
+    std::string host = resMgr.getRelayServer();
+    int32_t serverPort = listeningPort;
+    std::size_t index = host.rfind(':');
+    if(index != std::string::npos)
+    {
+        serverPort = Helper::toInt(host.substr(index + 1));
+        host = host.substr(0, index);
+    }
+
+    // There is no observer seat on the server nor game state snapshot. See the relay option help
+    OD_LOG_INF("Launching relay. The spectators will see the vision of the seat given to the relay and "
+        "late spectators will replay the game from its start");
+    ODRelay relay("Relay", std::string("OpenDungeons V ") + ODApplication::VERSION,
+        resMgr.getRelayDelaySeconds() * 1000);
+    std::string replayFilename = resMgr.getReplayDataPath() + resMgr.buildReplayFilename();
+    if(!relay.startRelay(host, serverPort, listeningPort, replayFilename))
+    {
+        OD_LOG_ERR("Could not start relay !!!");
+        return;
+    }
+
+    while(relay.isRelaying())
+        sf::sleep(sf::milliseconds(1000));
+
+    OD_LOG_INF("Stopping relay...");
+    relay.stopRelay();
+}
+
 void ODApplication::startClient()
 {
     ResourceManager& resMgr = ResourceManager::getSingleton();
@@ -214,6 +262,16 @@ void ODApplication::startClient()
 
     Ogre::ResourceGroupManager::getSingletonPtr()->initialiseAllResourceGroups();
 
+    // The level lists are refreshed while the main menu loads so that the menus do not have
+    // to parse the levels that changed since the last launch
+    LevelInfoIndex levelInfoIndex(resMgr.getUserDataPath() + "levelinfo.index");
+    levelInfoIndex.startBackgroundRefresh({
+        resMgr.getGameLevelPathSkirmish(),
+        resMgr.getUserLevelPathSkirmish(),
+        resMgr.getGameLevelPathMultiplayer(),
+        resMgr.getUserLevelPathMultiplayer()
+    });
+
     MusicPlayer musicPlayer(resMgr.getMusicPath(), resMgr.listAllMusicFiles());
     SoundEffectsManager soundEffectsManager;
 
@@ -64,6 +64,8 @@ private:
     void startClient();
     //! \brief Server mode. Creates only the needed to launch a level. Note that this is to be used without gui
     void startServer();
+    //! \brief Relay mode. Connects to a server and relays the game to spectators. Used without gui
+    void startRelay();
 };
 
 #endif // ODAPPLICATION_H
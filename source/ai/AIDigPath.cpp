@@ -0,0 +1,155 @@
+/*!
+ *  Copyright (C) 2011-2016  OpenDungeons Team
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "ai/AIDigPath.h"
+
+#include "ai/AITileSnapshot.h"
+
+#include <algorithm>
+#include <functional>
+
+AIDigPath::AIDigPath() :
+    mCostFullTile(0.0),
+    mPenaltyGold(0.0),
+    mPenaltyClaimedWall(0.0),
+    mNodeBudget(0),
+    mIsNodeBudgetReached(false)
+{
+}
+
+void AIDigPath::setCosts(double costFullTile, double penaltyGold, double penaltyClaimedWall, uint32_t nodeBudget)
+{
+    mCostFullTile = costFullTile;
+    mPenaltyGold = penaltyGold;
+    mPenaltyClaimedWall = penaltyClaimedWall;
+    mNodeBudget = nodeBudget;
+}
+
+double AIDigPath::computeTileCost(uint16_t flags) const
+{
+    if((flags & AITileSnapshot::WALKABLE) != 0)
+        return 1.0;
+
+    if((flags & AITileSnapshot::DIGGABLE) == 0)
+        return -1.0;
+
+    // The snapshot does not know the fullness of the tiles. We consider them full
+    double cost = 1.0;
+    if((flags & AITileSnapshot::FULL) != 0)
+        cost += mCostFullTile;
+    if((flags & AITileSnapshot::GOLD) != 0)
+        cost += mPenaltyGold;
+    if((flags & AITileSnapshot::CLAIMED) != 0)
+        cost += mPenaltyClaimedWall;
+
+    return cost;
+}
+
+bool AIDigPath::search(const AITileSnapshot& snapshot, const std::vector<uint8_t>& reachable,
+    int32_t targetX, int32_t targetY, std::vector<std::pair<int32_t, int32_t>>& tilesToDig)
+{
+    mIsNodeBudgetReached = false;
+    if(!snapshot.isInside(targetX, targetY))
+        return false;
+
+    int32_t sizeY = snapshot.getSizeY();
+    std::size_t nbTiles = static_cast<std::size_t>(snapshot.getSizeX() * sizeY);
+    if(mCosts.size() != nbTiles)
+    {
+        mCosts.assign(nbTiles, -1.0);
+        mParents.assign(nbTiles, -1);
+    }
+
+    // Dijkstra from the target. As there may be many reachable tiles, there is no good heuristic
+    // to use A*. The node budget keeps the search bounded
+    typedef std::pair<double, uint32_t> OpenTile;
+    std::greater<OpenTile> isGreater;
+    uint32_t targetIndex = snapshot.getIndex(targetX, targetY);
+    mCosts[targetIndex] = 0.0;
+    mTouchedTiles.push_back(targetIndex);
+    mOpenTiles.push_back(OpenTile(0.0, targetIndex));
+    uint32_t nbProcessedNodes = 0;
+    int32_t reachedIndex = -1;
+    while(!mOpenTiles.empty())
+    {
+        std::pop_heap(mOpenTiles.begin(), mOpenTiles.end(), isGreater);
+        OpenTile openTile = mOpenTiles.back();
+        mOpenTiles.pop_back();
+        uint32_t index = openTile.second;
+        if(openTile.first > mCosts[index])
+            continue;
+
+        if(reachable[index] != 0)
+        {
+            reachedIndex = static_cast<int32_t>(index);
+            break;
+        }
+
+        if((mNodeBudget > 0) && (nbProcessedNodes >= mNodeBudget))
+        {
+            mIsNodeBudgetReached = true;
+            break;
+        }
+        ++nbProcessedNodes;
+
+        int32_t x = static_cast<int32_t>(index) / sizeY;
+        int32_t y = static_cast<int32_t>(index) % sizeY;
+        static const int32_t neighbors[4][2] = { {-1, 0}, {1, 0}, {0, -1}, {0, 1} };
+        for(const int32_t* neighbor : neighbors)
+        {
+            int32_t xx = x + neighbor[0];
+            int32_t yy = y + neighbor[1];
+            double tileCost = computeTileCost(snapshot.getFlags(xx, yy));
+            if(tileCost < 0.0)
+                continue;
+
+            uint32_t neighIndex = snapshot.getIndex(xx, yy);
+            double cost = mCosts[index] + tileCost;
+            if(mCosts[neighIndex] < 0.0)
+                mTouchedTiles.push_back(neighIndex);
+            else if(cost >= mCosts[neighIndex])
+                continue;
+
+            mCosts[neighIndex] = cost;
+            mParents[neighIndex] = static_cast<int32_t>(index);
+            mOpenTiles.push_back(OpenTile(cost, neighIndex));
+            std::push_heap(mOpenTiles.begin(), mOpenTiles.end(), isGreater);
+        }
+    }
+
+    // The reached tile can be walked on. We dig the tiles between it and the target
+    if(reachedIndex != -1)
+    {
+        for(int32_t index = mParents[reachedIndex]; index != -1; index = mParents[index])
+        {
+            int32_t x = index / sizeY;
+            int32_t y = index % sizeY;
+            if((snapshot.getFlags(x, y) & AITileSnapshot::DIGGABLE) != 0)
+                tilesToDig.push_back(std::make_pair(x, y));
+        }
+    }
+
+    for(uint32_t index : mTouchedTiles)
+    {
+        mCosts[index] = -1.0;
+        mParents[index] = -1;
+    }
+    mTouchedTiles.clear();
+    mOpenTiles.clear();
+
+    return reachedIndex != -1;
+}
@@ -0,0 +1,72 @@
+/*!
+ *  Copyright (C) 2011-2016  OpenDungeons Team
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef AIDIGPATH_H
+#define AIDIGPATH_H
+
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+class AITileSnapshot;
+
+//! \brief Searches the cheapest way to dig from a target tile to the tiles a worker can already reach. The
+//! costs are the ones GameMap::path uses through diggable tiles (see ConfigManager::getDigPathCostFullTile):
+//! walking through a tile costs 1 and digging it costs more, even more for gold and claimed walls. The
+//! search is bounded by a node budget. It only reads the given snapshot so it can run on a worker thread.
+class AIDigPath
+{
+public:
+    AIDigPath();
+
+    //! \brief Sets the costs and the maximum number of tiles processed by a search (0 for no limit)
+    void setCosts(double costFullTile, double penaltyGold, double penaltyClaimedWall, uint32_t nodeBudget);
+
+    //! \brief Returns the cost of going through a tile with the given flags or a negative value
+    //! if the worker can neither walk through it nor dig it
+    double computeTileCost(uint16_t flags) const;
+
+    //! \brief Searches from (targetX, targetY) to a tile for which reachable (indexed like the snapshot)
+    //! is not 0. If found, returns true and fills tilesToDig with the diggable tiles on the way from the
+    //! reached tile to the target (included)
+    bool search(const AITileSnapshot& snapshot, const std::vector<uint8_t>& reachable,
+        int32_t targetX, int32_t targetY, std::vector<std::pair<int32_t, int32_t>>& tilesToDig);
+
+    //! \brief Returns true if the last search stopped because it processed too many tiles
+    inline bool isNodeBudgetReached() const
+    { return mIsNodeBudgetReached; }
+
+private:
+    double mCostFullTile;
+    double mPenaltyGold;
+    double mPenaltyClaimedWall;
+    uint32_t mNodeBudget;
+    bool mIsNodeBudgetReached;
+
+    //! \brief Cost from the target and parent of each tile of the snapshot. Only the tiles in
+    //! mTouchedTiles are set. They are reset after each search so that we do not have to clear
+    //! the whole map each time
+    std::vector<double> mCosts;
+    std::vector<int32_t> mParents;
+    std::vector<uint32_t> mTouchedTiles;
+
+    //! \brief Heap of the tiles to process (cost and index). A tile may be pushed several times.
+    //! Only the entry with its current cost is processed
+    std::vector<std::pair<double, uint32_t>> mOpenTiles;
+};
+
+#endif // AIDIGPATH_H
@@ -19,14 +19,22 @@
 
 #include "ai/AIFactory.h"
 #include "ai/BaseAI.h"
+#include "utils/ConfigManager.h"
+#include "utils/Helper.h"
+#include "utils/LogManager.h"
+#include "utils/WorkerPool.h"
+
+#include <OgreTimer.h>
 
 AIManager::AIManager(GameMap& gameMap)
-    : mGameMap(gameMap)
+    : mGameMap(gameMap),
+      mNextAiIndex(0)
 {
 }
 
 AIManager::~AIManager()
 {
+    // The AIs should be deleted before the pool as their planners may be in use
     clearAIList();
 }
 
@@ -36,24 +44,69 @@ bool AIManager::assignAI(Player& player, KeeperAIType type)
     if(ai == nullptr)
         return false;
 
+    if(mWorkerPool == nullptr)
+        mWorkerPool.reset(new WorkerPool(1));
+
     mAiList.push_back(ai);
     return true;
 }
 
 bool AIManager::doTurn(double timeSinceLastTurn)
 {
+    uint32_t nbAis = mAiList.size();
+    if(nbAis == 0)
+        return true;
+
+    // The searches that are over are applied now. The ones still running will be applied during a
+    // next turn: the server thread never waits for the worker. The AIs check the plans they apply
+    // as the tiles may have changed since the search started
     for(BaseAI* ai : mAiList)
     {
+        AIPlanner& planner = ai->getPlanner();
+        if(planner.isPlanDone())
+            ai->applyPlan(planner.retrievePlan());
+    }
+
+    uint64_t turnBudgetMicroseconds = ConfigManager::getSingleton().getAITurnBudgetMicroseconds();
+    Ogre::Timer stopwatch;
+    bool isPlanningAllowed = true;
+    uint32_t nbAisRun = 0;
+    while(nbAisRun < nbAis)
+    {
+        if((nbAisRun > 0) && (stopwatch.getMicroseconds() >= turnBudgetMicroseconds))
+            break;
+
+        BaseAI* ai = mAiList[mNextAiIndex];
+        mNextAiIndex = (mNextAiIndex + 1) % nbAis;
+        ++nbAisRun;
+
+        ai->setPlanningAllowed(isPlanningAllowed);
         ai->doTurn(timeSinceLastTurn);
+
+        AIPlanner& planner = ai->getPlanner();
+        if(planner.hasRequest())
+        {
+            planner.startPlanning(*mWorkerPool);
+            isPlanningAllowed = false;
+        }
+    }
+
+    if(nbAisRun < nbAis)
+    {
+        OD_LOG_DBG("AI turn budget exceeded, nbAisRun=" + Helper::toString(nbAisRun)
+            + "/" + Helper::toString(nbAis) + ", time=" + Helper::toString(stopwatch.getMicroseconds()));
     }
+
     return true;
 }
 
 void AIManager::clearAIList()
 {
+    // Deleting an AI waits for its search in progress, if any
     for(BaseAI* ai : mAiList)
     {
         delete ai;
     }
     mAiList.clear();
+    mNextAiIndex = 0;
 }
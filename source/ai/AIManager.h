@@ -18,11 +18,14 @@
 #ifndef AIMANAGER_H
 #define AIMANAGER_H
 
+#include <cstdint>
+#include <memory>
 #include <vector>
 
 class BaseAI;
 class GameMap;
 class Player;
+class WorkerPool;
 
 enum class KeeperAIType;
 
@@ -36,12 +39,26 @@ public:
     virtual ~AIManager();
 
     bool assignAI(Player& player, KeeperAIType type);
+
+    //! \brief Applies the plans of the searches that are over then runs the AIs that fit in the time
+    //! budget of this turn (see ConfigManager::getAITurnBudgetMicroseconds). AIs are run in a round robin
+    //! way starting from the first one that could not run during the previous turn. The first AI is
+    //! always run so that every AI gets its turn eventually. Because the expensive searches (room
+    //! places, gold and the ways to dig to them) are done by the AIPlanner on a worker thread, what an
+    //! AI does on the server thread is bounded: a single AI cannot use much more than the budget.
+    //! At most one search is started per turn so that the worker does not fall behind.
     bool doTurn(double timeSinceLastTurn);
     void clearAIList();
 
 private:
     GameMap& mGameMap;
     AIList mAiList;
+
+    //! \brief Index in mAiList of the first AI to run next turn
+    uint32_t mNextAiIndex;
+
+    //! \brief Runs the AIPlanner searches. Created with the first AI
+    std::unique_ptr<WorkerPool> mWorkerPool;
 };
 
 #endif // AIMANAGER_H
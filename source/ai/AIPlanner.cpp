@@ -0,0 +1,664 @@
+/*!
+ *  Copyright (C) 2011-2016  OpenDungeons Team
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "ai/AIPlanner.h"
+
+#include "entities/Creature.h"
+#include "entities/Tile.h"
+#include "game/Seat.h"
+#include "gamemap/GameMap.h"
+#include "utils/ConfigManager.h"
+#include "utils/Helper.h"
+#include "utils/LogManager.h"
+#include "utils/WorkerPool.h"
+
+#include <algorithm>
+#include <cstdlib>
+
+static const int32_t pointsPerWallSpot = 50;
+static const int32_t handicapPerTileOffset = 20;
+
+AIPlan::AIPlan()
+{
+    clear(Type::none);
+}
+
+void AIPlan::clear(Type type)
+{
+    mType = type;
+    mIsFound = false;
+    mNoMoreGold = false;
+    mRoomPosX = -1;
+    mRoomPosY = -1;
+    mRoomSize = -1;
+    mTilesToDig.clear();
+}
+
+AIPlanner::AIPlanner(GameMap& gameMap, Seat* seat) :
+    mGameMap(gameMap),
+    mSeat(seat),
+    mRequestType(AIPlan::Type::none),
+    mCentralX(0),
+    mCentralY(0),
+    mWantedSize(0),
+    mHasRequest(false),
+    mIsPlanning(false),
+    mGroundSummedAreaCaptureId(0),
+    mIsGroundSummedAreaComputed(false),
+    mReachableCaptureId(0),
+    mReachableCentralX(0),
+    mReachableCentralY(0),
+    mIsReachableComputed(false),
+    mGoldTilesFirstIndex(0),
+    mGoldTilesCaptureId(0),
+    mGoldTilesCentralX(0),
+    mGoldTilesCentralY(0),
+    mIsGoldTilesComputed(false),
+    mIsPlanDone(false)
+{
+}
+
+AIPlanner::~AIPlanner()
+{
+    // The worker uses our members. We cannot be destroyed before it is done
+    if(mIsPlanning)
+        waitPlan();
+}
+
+void AIPlanner::requestRoomPlace(Tile* central, const Creature& worker, int32_t wantedSize)
+{
+    prepareRequest(AIPlan::Type::roomPlace, central, worker);
+    mWantedSize = wantedSize;
+}
+
+void AIPlanner::requestGold(Tile* central, const Creature& worker)
+{
+    prepareRequest(AIPlan::Type::gold, central, worker);
+}
+
+void AIPlanner::prepareRequest(AIPlan::Type type, Tile* central, const Creature& worker)
+{
+    if(mIsPlanning)
+    {
+        OD_LOG_ERR("A search is already running for seatId=" + Helper::toString(mSeat->getId()));
+        return;
+    }
+
+    // The snapshot and the dig path costs are only used by the worker while planning so we can update them now
+    mSnapshot.update(mGameMap, mSeat, worker);
+    const ConfigManager& config = ConfigManager::getSingleton();
+    mDigPath.setCosts(config.getDigPathCostFullTile(), config.getDigPathPenaltyGold(),
+        config.getDigPathPenaltyClaimedWall(), config.getDigPathNodeBudget());
+
+    mRequestType = type;
+    mCentralX = central->getX();
+    mCentralY = central->getY();
+    mRandom.seed(Random::getStream(Random::Stream::ai).next());
+    mHasRequest = true;
+}
+
+void AIPlanner::startPlanning(WorkerPool& workerPool)
+{
+    if(!mHasRequest)
+        return;
+
+    mHasRequest = false;
+    mIsPlanning = true;
+    mIsPlanDone = false;
+    workerPool.post([this]()
+    {
+        computePlan();
+        std::lock_guard<std::mutex> lock(mMutex);
+        mIsPlanDone = true;
+        mPlanDoneCondition.notify_all();
+    });
+}
+
+bool AIPlanner::isPlanDone()
+{
+    if(!mIsPlanning)
+        return false;
+
+    std::lock_guard<std::mutex> lock(mMutex);
+    return mIsPlanDone;
+}
+
+const AIPlan& AIPlanner::retrievePlan()
+{
+    if(!mIsPlanning)
+    {
+        OD_LOG_ERR("No search started for seatId=" + Helper::toString(mSeat->getId()));
+        return mPlan;
+    }
+    if(!isPlanDone())
+    {
+        OD_LOG_ERR("Retrieving a plan not done for seatId=" + Helper::toString(mSeat->getId()));
+        waitPlan();
+    }
+    mIsPlanning = false;
+    return mPlan;
+}
+
+void AIPlanner::waitPlan()
+{
+    std::unique_lock<std::mutex> lock(mMutex);
+    mPlanDoneCondition.wait(lock, [this]() { return mIsPlanDone; });
+}
+
+void AIPlanner::computePlan()
+{
+    mPlan.clear(mRequestType);
+    switch(mRequestType)
+    {
+        case AIPlan::Type::roomPlace:
+            planRoomPlace();
+            break;
+        case AIPlan::Type::gold:
+            planGold();
+            break;
+        default:
+            break;
+    }
+}
+
+void AIPlanner::planRoomPlace()
+{
+    int32_t bestX = 0;
+    int32_t bestY = 0;
+    if(!findBestPlaceForRoom(bestX, bestY))
+        return;
+
+    mPlan.mIsFound = true;
+    mPlan.mRoomPosX = bestX;
+    mPlan.mRoomPosY = bestY;
+    mPlan.mRoomSize = mWantedSize;
+
+    // If we cannot dig up to the room, we keep the place. It will be built if it gets reachable
+    if(!computeDigPath(bestX, bestY))
+        return;
+
+    for(int32_t xx = 0; xx < mWantedSize; ++xx)
+    {
+        for(int32_t yy = 0; yy < mWantedSize; ++yy)
+        {
+            if((mSnapshot.getFlags(bestX + xx, bestY + yy) & AITileSnapshot::DIGGABLE) != 0)
+                addTileToDig(bestX + xx, bestY + yy);
+        }
+    }
+}
+
+void AIPlanner::planGold()
+{
+    if(!mIsGoldTilesComputed || (mGoldTilesCentralX != mCentralX) || (mGoldTilesCentralY != mCentralY))
+        computeGoldTilesByDistance();
+
+    if(!hasGoldTileToDig() && (mGoldTilesCaptureId != mSnapshot.getCaptureId()))
+        computeGoldTilesByDistance();
+
+    if(!hasGoldTileToDig())
+    {
+        mPlan.mNoMoreGold = true;
+        return;
+    }
+
+    // We search for the closest gold tile. Gold tiles are sorted by distance so we only have to
+    // look at the first ones. If we cannot dig a way to a tile, we try the next ones. The tile is
+    // kept so that it will be tried again next time. To avoid computing too many paths during the
+    // same search, we only try a few tiles each time
+    const uint32_t maxTriesPerSearch = 3;
+    uint32_t nbTries = 0;
+    int32_t goldX = -1;
+    int32_t goldY = -1;
+    int32_t sizeY = mSnapshot.getSizeY();
+    for(uint32_t index = mGoldTilesFirstIndex; (index < mGoldTiles.size()) && (nbTries < maxTriesPerSearch); ++index)
+    {
+        int32_t x = static_cast<int32_t>(mGoldTiles[index].first) / sizeY;
+        int32_t y = static_cast<int32_t>(mGoldTiles[index].first) % sizeY;
+        if(!isGoldTileToDig(x, y))
+            continue;
+
+        ++nbTries;
+        if(computeDigPath(x, y))
+        {
+            goldX = x;
+            goldY = y;
+            break;
+        }
+    }
+
+    if(goldX == -1)
+        return;
+
+    mPlan.mIsFound = true;
+
+    // If the neighbors are gold, we dig them
+    const uint32_t levelTilesDig = 2;
+    std::vector<std::pair<int32_t, int32_t>> goldTiles;
+    goldTiles.push_back(std::make_pair(goldX, goldY));
+    uint32_t levelFirstIndex = 0;
+    for(uint32_t level = 0; level < levelTilesDig; ++level)
+    {
+        uint32_t levelEndIndex = goldTiles.size();
+        for(uint32_t index = levelFirstIndex; index < levelEndIndex; ++index)
+        {
+            static const int32_t neighbors[4][2] = { {-1, 0}, {1, 0}, {0, -1}, {0, 1} };
+            for(const int32_t* neighbor : neighbors)
+            {
+                std::pair<int32_t, int32_t> neigh(goldTiles[index].first + neighbor[0],
+                    goldTiles[index].second + neighbor[1]);
+                if(!isGoldTileToDig(neigh.first, neigh.second))
+                    continue;
+                if(std::find(goldTiles.begin(), goldTiles.end(), neigh) != goldTiles.end())
+                    continue;
+
+                goldTiles.push_back(neigh);
+            }
+        }
+        levelFirstIndex = levelEndIndex;
+    }
+
+    for(const std::pair<int32_t, int32_t>& gold : goldTiles)
+        addTileToDig(gold.first, gold.second);
+}
+
+bool AIPlanner::isGroundTileConsidered(int32_t x, int32_t y) const
+{
+    uint16_t flags = mSnapshot.getFlags(x, y);
+    // Dirt and gold can always be built (even if digging may be needed depending on fullness)
+    if((flags & (AITileSnapshot::DIRT | AITileSnapshot::GOLD)) == 0)
+        return false;
+
+    if((flags & AITileSnapshot::CLAIMED) == 0)
+        return true;
+
+    // We check if we can build on that tile and if there is no building currently
+    if((flags & AITileSnapshot::CLAIMED_FOR_SEAT) == 0)
+        return false;
+    if((flags & AITileSnapshot::BUILDING) != 0)
+        return false;
+
+    // We don't want to break a wall where there are activespots from another one
+    const uint16_t roomForSeat = AITileSnapshot::CLAIMED_FOR_SEAT | AITileSnapshot::ROOM;
+    if(((mSnapshot.getFlags(x - 1, y) & roomForSeat) == roomForSeat) ||
+       ((mSnapshot.getFlags(x + 1, y) & roomForSeat) == roomForSeat) ||
+       ((mSnapshot.getFlags(x, y - 1) & roomForSeat) == roomForSeat) ||
+       ((mSnapshot.getFlags(x, y + 1) & roomForSeat) == roomForSeat))
+    {
+        return false;
+    }
+
+    return true;
+}
+
+bool AIPlanner::isWallTileConsidered(int32_t x, int32_t y) const
+{
+    // We only consider wall claimed for the correct seat or dirt (that can be claimed)
+    uint16_t flags = mSnapshot.getFlags(x, y);
+    if((flags & AITileSnapshot::FULL) == 0)
+        return false;
+
+    return (flags & (AITileSnapshot::DIRT | AITileSnapshot::WALL_CLAIMED_FOR_SEAT)) != 0;
+}
+
+void AIPlanner::computeGroundSummedArea()
+{
+    if(mIsGroundSummedAreaComputed && (mGroundSummedAreaCaptureId == mSnapshot.getCaptureId()))
+        return;
+
+    // mGroundSummedArea[(x + 1) * (sizeY + 1) + (y + 1)] is the number of tiles that can be considered
+    // for building a room in the rectangle from (0, 0) to (x, y). First row and column are 0
+    int32_t sizeX = mSnapshot.getSizeX();
+    int32_t sizeY = mSnapshot.getSizeY();
+    mGroundSummedArea.assign((sizeX + 1) * (sizeY + 1), 0);
+    for(int32_t xx = 0; xx < sizeX; ++xx)
+    {
+        for(int32_t yy = 0; yy < sizeY; ++yy)
+        {
+            uint32_t value = isGroundTileConsidered(xx, yy) ? 1 : 0;
+            mGroundSummedArea[(xx + 1) * (sizeY + 1) + (yy + 1)] = value
+                + mGroundSummedArea[xx * (sizeY + 1) + (yy + 1)]
+                + mGroundSummedArea[(xx + 1) * (sizeY + 1) + yy]
+                - mGroundSummedArea[xx * (sizeY + 1) + yy];
+        }
+    }
+    mGroundSummedAreaCaptureId = mSnapshot.getCaptureId();
+    mIsGroundSummedAreaComputed = true;
+}
+
+bool AIPlanner::isGroundSquareConsidered(int32_t x1, int32_t y1, int32_t wantedSize) const
+{
+    int32_t sizeY = mSnapshot.getSizeY();
+    int32_t x2 = x1 + wantedSize;
+    int32_t y2 = y1 + wantedSize;
+    if((x1 < 0) || (y1 < 0) || (x2 > mSnapshot.getSizeX()) || (y2 > sizeY))
+        return false;
+
+    uint32_t nbTiles = mGroundSummedArea[x2 * (sizeY + 1) + y2]
+        - mGroundSummedArea[x1 * (sizeY + 1) + y2]
+        - mGroundSummedArea[x2 * (sizeY + 1) + y1]
+        + mGroundSummedArea[x1 * (sizeY + 1) + y1];
+
+    return nbTiles == static_cast<uint32_t>(wantedSize * wantedSize);
+}
+
+int32_t AIPlanner::countWallActiveSpots(int32_t x, int32_t y, int32_t dirX, int32_t dirY, int32_t wantedSize) const
+{
+    // That's not exactly how the activespots will be computed but it will be enough (especially
+    // when the room size is even)
+    int32_t nbConsecutiveTiles = 0;
+    int32_t nbActiveWallSpots = 0;
+    for(int32_t kk = 0; kk < wantedSize; ++kk)
+    {
+        int32_t xx = x + kk * dirX;
+        int32_t yy = y + kk * dirY;
+        if(!mSnapshot.isInside(xx, yy))
+            continue;
+
+        if(isWallTileConsidered(xx, yy))
+            ++nbConsecutiveTiles;
+        else
+            nbConsecutiveTiles = 0;
+
+        if(nbActiveWallSpots == 0)
+        {
+            if(nbConsecutiveTiles >= 3)
+            {
+                nbConsecutiveTiles = 0;
+                ++nbActiveWallSpots;
+            }
+        }
+        else if(nbConsecutiveTiles >= 2)
+        {
+            nbConsecutiveTiles = 0;
+            ++nbActiveWallSpots;
+        }
+    }
+    return nbActiveWallSpots;
+}
+
+bool AIPlanner::computePointsForRoom(int32_t tileX, int32_t tileY, int32_t wantedSize,
+    bool bottomLeft2TopRight, int32_t& points) const
+{
+    points = 0;
+    if(bottomLeft2TopRight)
+    {
+        if(!isGroundSquareConsidered(tileX, tileY, wantedSize))
+            return false;
+
+        points += countWallActiveSpots(tileX - 1, tileY, 0, 1, wantedSize) * pointsPerWallSpot;
+        points += countWallActiveSpots(tileX + wantedSize, tileY, 0, 1, wantedSize) * pointsPerWallSpot;
+        points += countWallActiveSpots(tileX, tileY - 1, 1, 0, wantedSize) * pointsPerWallSpot;
+        points += countWallActiveSpots(tileX, tileY + wantedSize, 1, 0, wantedSize) * pointsPerWallSpot;
+    }
+    else
+    {
+        if(!isGroundSquareConsidered(tileX - wantedSize + 1, tileY - wantedSize + 1, wantedSize))
+            return false;
+
+        points += countWallActiveSpots(tileX + 1, tileY, 0, -1, wantedSize) * pointsPerWallSpot;
+        points += countWallActiveSpots(tileX - wantedSize, tileY, 0, -1, wantedSize) * pointsPerWallSpot;
+        points += countWallActiveSpots(tileX, tileY + 1, -1, 0, wantedSize) * pointsPerWallSpot;
+        points += countWallActiveSpots(tileX, tileY - wantedSize, -1, 0, wantedSize) * pointsPerWallSpot;
+    }
+
+    return true;
+}
+
+//! To find the position, we try every square of the wantedSize width around the central tile for each possible distance
+bool AIPlanner::findBestPlaceForRoom(int32_t& bestX, int32_t& bestY)
+{
+    // We use a point system to find the best position. Once we find a valid position, we will set a handicap
+    // that will increase as we go away from the given tile. Once the handicap is > to the max points we can get minus
+    // the points the room we found got, we can stop searching.
+    // With this logic, we can tune easily what the AI should prefer between distance and active spots.
+    int32_t wantedSize = mWantedSize;
+
+    // We search for the maximum points a room can get
+    int32_t maxPointsPossible = 0;
+    if(wantedSize >= 3)
+    {
+        // Maximum central active spots
+        int32_t nbCentralActiveSpots = ((wantedSize - 3) / 2) + 1;
+        // Wall active spots
+        maxPointsPossible += nbCentralActiveSpots * 4 * pointsPerWallSpot;
+    }
+
+    // Many candidate squares overlap. Instead of checking each tile of each of them, we use
+    // the summed area table of the tiles where we could build
+    computeGroundSummedArea();
+
+    bool isFound = false;
+    int32_t handicap = 0;
+    int32_t bestPoints = 0;
+    int32_t bestDistance = 0;
+    int32_t maxOffset = std::max(mSnapshot.getSizeX(), mSnapshot.getSizeY());
+
+    // For each side, the first tile of the candidate square and if the square is built
+    // from it towards the top right (North and East) or towards the bottom left (South and West)
+    auto tryPlace = [&](int32_t x, int32_t y, bool bottomLeft2TopRight)
+    {
+        int32_t points = 0;
+        if(!mSnapshot.isInside(x, y) ||
+           !computePointsForRoom(x, y, wantedSize, bottomLeft2TopRight, points))
+        {
+            return;
+        }
+
+        points -= handicap;
+        int32_t halfSize = bottomLeft2TopRight ? (wantedSize / 2) : -(wantedSize / 2);
+        int32_t centerX = x + halfSize;
+        int32_t centerY = y + halfSize;
+        int32_t distance = (mCentralX - centerX) * (mCentralX - centerX);
+        distance += (mCentralY - centerY) * (mCentralY - centerY);
+        if((points > bestPoints) ||
+           (points == bestPoints && distance < bestDistance))
+        {
+            bestDistance = distance;
+            bestX = bottomLeft2TopRight ? x : (x - wantedSize + 1);
+            bestY = bottomLeft2TopRight ? y : (y - wantedSize + 1);
+            bestPoints = points;
+            isFound = true;
+        }
+    };
+
+    for(int32_t offset = 1; offset < maxOffset; ++offset)
+    {
+        int32_t nbTiles = offset * 2 + wantedSize - 1;
+        for(int32_t k = 0; k < nbTiles; ++k)
+        {
+            // North
+            tryPlace(mCentralX - offset - wantedSize + 2 + k, mCentralY + offset, true);
+            // East
+            tryPlace(mCentralX + offset, mCentralY - k + offset, true);
+            // South
+            tryPlace(mCentralX + offset + wantedSize - 2 - k, mCentralY - offset, false);
+            // West
+            tryPlace(mCentralX - offset, mCentralY - offset + k, false);
+        }
+
+        if(isFound)
+        {
+            handicap += handicapPerTileOffset;
+            // If we already found the best place, stop searching
+            if(handicap > (maxPointsPossible - bestPoints))
+                break;
+        }
+    }
+
+    return isFound;
+}
+
+void AIPlanner::computeReachableFromCentral()
+{
+    if(mIsReachableComputed &&
+       (mReachableCaptureId == mSnapshot.getCaptureId()) &&
+       (mReachableCentralX == mCentralX) &&
+       (mReachableCentralY == mCentralY))
+    {
+        return;
+    }
+
+    int32_t sizeX = mSnapshot.getSizeX();
+    int32_t sizeY = mSnapshot.getSizeY();
+    mReachableFromCentral.assign(sizeX * sizeY, 0);
+    std::vector<uint32_t> tilesToProcess;
+    if((mSnapshot.getFlags(mCentralX, mCentralY) & AITileSnapshot::WALKABLE) != 0)
+    {
+        mReachableFromCentral[mSnapshot.getIndex(mCentralX, mCentralY)] = 1;
+        tilesToProcess.push_back(mSnapshot.getIndex(mCentralX, mCentralY));
+    }
+    while(!tilesToProcess.empty())
+    {
+        int32_t x = static_cast<int32_t>(tilesToProcess.back()) / sizeY;
+        int32_t y = static_cast<int32_t>(tilesToProcess.back()) % sizeY;
+        tilesToProcess.pop_back();
+        static const int32_t neighbors[4][2] = { {-1, 0}, {1, 0}, {0, -1}, {0, 1} };
+        for(const int32_t* neighbor : neighbors)
+        {
+            int32_t xx = x + neighbor[0];
+            int32_t yy = y + neighbor[1];
+            if((mSnapshot.getFlags(xx, yy) & AITileSnapshot::WALKABLE) == 0)
+                continue;
+
+            uint8_t& isReached = mReachableFromCentral[mSnapshot.getIndex(xx, yy)];
+            if(isReached != 0)
+                continue;
+
+            isReached = 1;
+            tilesToProcess.push_back(mSnapshot.getIndex(xx, yy));
+        }
+    }
+
+    mReachableCaptureId = mSnapshot.getCaptureId();
+    mReachableCentralX = mCentralX;
+    mReachableCentralY = mCentralY;
+    mIsReachableComputed = true;
+}
+
+bool AIPlanner::computeDigPath(int32_t targetX, int32_t targetY)
+{
+    if(!mSnapshot.isInside(targetX, targetY))
+    {
+        OD_LOG_ERR("targetX=" + Helper::toString(targetX) + ", targetY=" + Helper::toString(targetY));
+        return false;
+    }
+
+    computeReachableFromCentral();
+
+    mDigPathTiles.clear();
+    if(!mDigPath.search(mSnapshot, mReachableFromCentral, targetX, targetY, mDigPathTiles))
+        return false;
+
+    for(const std::pair<int32_t, int32_t>& tile : mDigPathTiles)
+        addTileToDig(tile.first, tile.second);
+
+    return true;
+}
+
+void AIPlanner::computeGoldTilesByDistance()
+{
+    mGoldTilesCentralX = mCentralX;
+    mGoldTilesCentralY = mCentralY;
+    mGoldTilesFirstIndex = 0;
+    mGoldTilesCaptureId = mSnapshot.getCaptureId();
+    mIsGoldTilesComputed = true;
+    mGoldTiles.clear();
+
+    // We flood fill from the central tile through the tiles the worker can walk on or dig. Gold
+    // that is not reached (behind rocks or enemy walls) cannot be dug so there is no need to try
+    int32_t sizeY = mSnapshot.getSizeY();
+    std::vector<uint8_t> reached(mSnapshot.getSizeX() * sizeY, 0);
+    std::vector<uint32_t> tilesToProcess;
+    if(mSnapshot.isInside(mCentralX, mCentralY))
+    {
+        reached[mSnapshot.getIndex(mCentralX, mCentralY)] = 1;
+        tilesToProcess.push_back(mSnapshot.getIndex(mCentralX, mCentralY));
+    }
+    while(!tilesToProcess.empty())
+    {
+        uint32_t index = tilesToProcess.back();
+        tilesToProcess.pop_back();
+        int32_t x = static_cast<int32_t>(index) / sizeY;
+        int32_t y = static_cast<int32_t>(index) % sizeY;
+        if(isGoldTileToDig(x, y))
+        {
+            int32_t distance = std::max(std::abs(x - mCentralX), std::abs(y - mCentralY));
+            mGoldTiles.push_back(std::pair<uint32_t, int32_t>(index, distance));
+        }
+
+        static const int32_t neighbors[4][2] = { {-1, 0}, {1, 0}, {0, -1}, {0, 1} };
+        for(const int32_t* neighbor : neighbors)
+        {
+            int32_t xx = x + neighbor[0];
+            int32_t yy = y + neighbor[1];
+            if((mSnapshot.getFlags(xx, yy) & (AITileSnapshot::WALKABLE | AITileSnapshot::DIGGABLE)) == 0)
+                continue;
+
+            uint8_t& isReached = reached[mSnapshot.getIndex(xx, yy)];
+            if(isReached != 0)
+                continue;
+
+            isReached = 1;
+            tilesToProcess.push_back(mSnapshot.getIndex(xx, yy));
+        }
+    }
+
+    // If there are more than one tile at the same distance, we want to choose randomly to try
+    // to not be too predictable. We shuffle the tiles before sorting them
+    for(uint32_t index = mGoldTiles.size(); index > 1; --index)
+    {
+        uint32_t swapIndex = mRandom.Uint(0, index - 1);
+        std::swap(mGoldTiles[index - 1], mGoldTiles[swapIndex]);
+    }
+
+    std::stable_sort(mGoldTiles.begin(), mGoldTiles.end(),
+        [](const std::pair<uint32_t, int32_t>& p1, const std::pair<uint32_t, int32_t>& p2)
+        {
+            return p1.second < p2.second;
+        });
+}
+
+bool AIPlanner::hasGoldTileToDig()
+{
+    // We skip the closest tiles that have been dug since last time
+    int32_t sizeY = mSnapshot.getSizeY();
+    while(mGoldTilesFirstIndex < mGoldTiles.size())
+    {
+        int32_t index = static_cast<int32_t>(mGoldTiles[mGoldTilesFirstIndex].first);
+        if(isGoldTileToDig(index / sizeY, index % sizeY))
+            break;
+
+        ++mGoldTilesFirstIndex;
+    }
+
+    return mGoldTilesFirstIndex < mGoldTiles.size();
+}
+
+bool AIPlanner::isGoldTileToDig(int32_t x, int32_t y) const
+{
+    const uint16_t fullGold = AITileSnapshot::FULL | AITileSnapshot::GOLD;
+    return (mSnapshot.getFlags(x, y) & fullGold) == fullGold;
+}
+
+void AIPlanner::addTileToDig(int32_t x, int32_t y)
+{
+    std::pair<int32_t, int32_t> tile(x, y);
+    if(std::find(mPlan.mTilesToDig.begin(), mPlan.mTilesToDig.end(), tile) != mPlan.mTilesToDig.end())
+        return;
+
+    mPlan.mTilesToDig.push_back(tile);
+}
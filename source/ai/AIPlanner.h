@@ -0,0 +1,206 @@
+/*!
+ *  Copyright (C) 2011-2016  OpenDungeons Team
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef AIPLANNER_H
+#define AIPLANNER_H
+
+#include "ai/AIDigPath.h"
+#include "ai/AITileSnapshot.h"
+#include "utils/Random.h"
+
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+class Creature;
+class GameMap;
+class Seat;
+class Tile;
+class WorkerPool;
+
+//! \brief Result of a search done by AIPlanner. It is applied by the AI on the server thread.
+struct AIPlan
+{
+    enum class Type
+    {
+        none,
+        roomPlace,
+        gold
+    };
+
+    AIPlan();
+
+    void clear(Type type);
+
+    Type mType;
+    //! \brief True if a room place or a gold tile could be found
+    bool mIsFound;
+    //! \brief Set for gold searches when there is no reachable gold left
+    bool mNoMoreGold;
+    int32_t mRoomPosX;
+    int32_t mRoomPosY;
+    int32_t mRoomSize;
+    //! \brief Coordinates of the tiles the AI should mark for digging
+    std::vector<std::pair<int32_t, int32_t>> mTilesToDig;
+};
+
+//! \brief Runs the expensive searches of an AI (where to build a room, which gold to dig and the way to it)
+//! on a worker thread. The AI requests a search on the server thread, the AIManager starts it once the
+//! AI turn is over and the result is applied at the beginning of the first AI turn after the search is over.
+//! The server thread never waits for the worker. While the search runs, the worker only reads the snapshot
+//! and the planner caches and the server thread does not touch them.
+class AIPlanner
+{
+public:
+    AIPlanner(GameMap& gameMap, Seat* seat);
+    //! \brief Waits for the search in progress, if any
+    ~AIPlanner();
+
+    AIPlanner(const AIPlanner&) = delete;
+    AIPlanner& operator=(const AIPlanner&) = delete;
+
+    //! \brief Requests a search for the best place for a square room of the given size around central.
+    //! The tiles to dig to reach it will be in the plan.
+    void requestRoomPlace(Tile* central, const Creature& worker, int32_t wantedSize);
+
+    //! \brief Requests a search for the closest gold tile reachable from central. The tiles to dig to
+    //! reach it will be in the plan.
+    void requestGold(Tile* central, const Creature& worker);
+
+    //! \brief Returns true if a search has been requested and not started yet
+    inline bool hasRequest() const
+    { return mHasRequest; }
+
+    //! \brief Returns true if a search has been started and its plan not retrieved yet
+    inline bool isPlanning() const
+    { return mIsPlanning; }
+
+    //! \brief Returns true if no search is requested or running
+    inline bool isIdle() const
+    { return !mHasRequest && !mIsPlanning; }
+
+    //! \brief Starts the requested search on the given pool
+    void startPlanning(WorkerPool& workerPool);
+
+    //! \brief Returns true if the search started with startPlanning is over. Does not wait for it
+    bool isPlanDone();
+
+    //! \brief Returns the plan of the search started with startPlanning. Must only be called once isPlanDone
+    //! returned true. The plan stays valid until the next request
+    const AIPlan& retrievePlan();
+
+private:
+    //! \brief Waits for the search started with startPlanning
+    void waitPlan();
+
+    void prepareRequest(AIPlan::Type type, Tile* central, const Creature& worker);
+
+    //! \brief Called on the worker thread
+    void computePlan();
+
+    void planRoomPlace();
+    void planGold();
+
+    //! \brief Same rules as the server uses to know where a room could be built (dirt or gold not
+    //! claimed or claimed by the seat without building and not next to one of its rooms)
+    bool isGroundTileConsidered(int32_t x, int32_t y) const;
+    //! \brief Dirt walls or walls claimed by the seat could be used for the room active spots
+    bool isWallTileConsidered(int32_t x, int32_t y) const;
+
+    //! \brief Builds the summed area table of the tiles returned by isGroundTileConsidered if the
+    //! snapshot changed since it was last computed
+    void computeGroundSummedArea();
+    //! \brief Returns true if every tile of the square of wantedSize side starting at (x1, y1) could be used
+    bool isGroundSquareConsidered(int32_t x1, int32_t y1, int32_t wantedSize) const;
+
+    bool computePointsForRoom(int32_t tileX, int32_t tileY, int32_t wantedSize, bool bottomLeft2TopRight,
+        int32_t& points) const;
+    //! \brief Returns the number of active spots that could be placed on the wantedSize wall tiles starting
+    //! at (x, y) in the given direction
+    int32_t countWallActiveSpots(int32_t x, int32_t y, int32_t dirX, int32_t dirY, int32_t wantedSize) const;
+
+    bool findBestPlaceForRoom(int32_t& bestX, int32_t& bestY);
+
+    //! \brief Fills mReachableFromCentral with the tiles the worker can walk to from the central tile
+    void computeReachableFromCentral();
+
+    //! \brief Searches the cheapest way to dig from the target to a tile the worker can reach (see AIDigPath).
+    //! If found, the tiles to dig are added to the plan and true is returned
+    bool computeDigPath(int32_t targetX, int32_t targetY);
+
+    //! \brief Fills mGoldTiles with the gold tiles the worker could reach from central by walking or digging,
+    //! sorted by distance (randomly between tiles at the same distance)
+    void computeGoldTilesByDistance();
+
+    //! \brief Skips the first tiles of mGoldTiles that have been dug. Returns true if there is
+    //! still gold to dig in mGoldTiles
+    bool hasGoldTileToDig();
+
+    bool isGoldTileToDig(int32_t x, int32_t y) const;
+
+    void addTileToDig(int32_t x, int32_t y);
+
+    GameMap& mGameMap;
+    Seat* mSeat;
+
+    //! \brief Request. Set on the server thread before the search is started
+    AIPlan::Type mRequestType;
+    int32_t mCentralX;
+    int32_t mCentralY;
+    int32_t mWantedSize;
+    //! \brief Seeded from the AI random stream when the search is requested so that games stay reproducible
+    RandomGenerator mRandom;
+
+    //! \brief Only used by the server thread
+    bool mHasRequest;
+    bool mIsPlanning;
+
+    AITileSnapshot mSnapshot;
+    AIPlan mPlan;
+
+    //! \brief Caches only used by the worker thread
+    std::vector<uint32_t> mGroundSummedArea;
+    uint32_t mGroundSummedAreaCaptureId;
+    bool mIsGroundSummedAreaComputed;
+
+    std::vector<uint8_t> mReachableFromCentral;
+    uint32_t mReachableCaptureId;
+    int32_t mReachableCentralX;
+    int32_t mReachableCentralY;
+    bool mIsReachableComputed;
+
+    AIDigPath mDigPath;
+    std::vector<std::pair<int32_t, int32_t>> mDigPathTiles;
+
+    //! \brief Reachable gold tiles (index in the snapshot and distance to central). Gold tiles can only
+    //! disappear so the ones already dug are skipped from mGoldTilesFirstIndex instead of searching
+    //! the whole map for each search
+    std::vector<std::pair<uint32_t, int32_t>> mGoldTiles;
+    uint32_t mGoldTilesFirstIndex;
+    uint32_t mGoldTilesCaptureId;
+    int32_t mGoldTilesCentralX;
+    int32_t mGoldTilesCentralY;
+    bool mIsGoldTilesComputed;
+
+    std::mutex mMutex;
+    std::condition_variable mPlanDoneCondition;
+    bool mIsPlanDone;
+};
+
+#endif // AIPLANNER_H
@@ -0,0 +1,83 @@
+/*!
+ *  Copyright (C) 2011-2016  OpenDungeons Team
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "ai/AITileSnapshot.h"
+
+#include "entities/Creature.h"
+#include "entities/Tile.h"
+#include "gamemap/GameMap.h"
+
+void AITileSnapshot::update(const GameMap& gameMap, Seat* seat, const Creature& worker)
+{
+    uint64_t tilesLayoutVersion = gameMap.getTilesLayoutVersion();
+    bool isCaptureNeeded = (mCaptureId == 0) ||
+        (mWorkerDefinition != worker.getDefinition()) ||
+        (mSizeX != gameMap.getMapSizeX()) ||
+        (mSizeY != gameMap.getMapSizeY()) ||
+        !gameMap.getTilesLayoutChangedSince(mTilesLayoutVersion, mChangedTiles);
+
+    if(isCaptureNeeded)
+    {
+        reset(gameMap.getMapSizeX(), gameMap.getMapSizeY());
+        for(int32_t xx = 0; xx < mSizeX; ++xx)
+        {
+            for(int32_t yy = 0; yy < mSizeY; ++yy)
+                mFlags[getIndex(xx, yy)] = computeFlags(gameMap.getTile(xx, yy), seat, worker);
+        }
+    }
+    else
+    {
+        // Only the tiles changed since the last update are copied. The caches of the planner are
+        // kept if none of them changed for this seat
+        for(uint32_t index : mChangedTiles)
+        {
+            int32_t x = static_cast<int32_t>(index) / mSizeY;
+            int32_t y = static_cast<int32_t>(index) % mSizeY;
+            setFlags(x, y, computeFlags(gameMap.getTile(x, y), seat, worker));
+        }
+    }
+
+    mTilesLayoutVersion = tilesLayoutVersion;
+    mWorkerDefinition = worker.getDefinition();
+}
+
+uint16_t AITileSnapshot::computeFlags(Tile* tile, Seat* seat, const Creature& worker)
+{
+    uint16_t flags = 0;
+    if(tile->getFullness() > 0.0)
+        flags |= FULL;
+    if(tile->getType() == TileType::dirt)
+        flags |= DIRT;
+    else if(tile->getType() == TileType::gold)
+        flags |= GOLD;
+    if(tile->isClaimed())
+        flags |= CLAIMED;
+    if(tile->isClaimedForSeat(seat))
+        flags |= CLAIMED_FOR_SEAT;
+    if(tile->isWallClaimedForSeat(seat))
+        flags |= WALL_CLAIMED_FOR_SEAT;
+    if(tile->getCoveringBuilding() != nullptr)
+        flags |= BUILDING;
+    if(tile->getCoveringRoom() != nullptr)
+        flags |= ROOM;
+    if(tile->isDiggable(seat))
+        flags |= DIGGABLE;
+    if(worker.canGoThroughTile(tile))
+        flags |= WALKABLE;
+
+    return flags;
+}
@@ -0,0 +1,114 @@
+/*!
+ *  Copyright (C) 2011-2016  OpenDungeons Team
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef AITILESNAPSHOT_H
+#define AITILESNAPSHOT_H
+
+#include <cstdint>
+#include <vector>
+
+class Creature;
+class CreatureDefinition;
+class GameMap;
+class Seat;
+class Tile;
+
+//! \brief Copy of what the AI planning needs to know about the tiles. It is captured by the server
+//! thread so that the searches can run on a worker thread without touching the game map.
+class AITileSnapshot
+{
+public:
+    static const uint16_t FULL                  = 0x0001;
+    static const uint16_t DIRT                  = 0x0002;
+    static const uint16_t GOLD                  = 0x0004;
+    static const uint16_t CLAIMED               = 0x0008;
+    static const uint16_t CLAIMED_FOR_SEAT      = 0x0010;
+    static const uint16_t WALL_CLAIMED_FOR_SEAT = 0x0020;
+    static const uint16_t BUILDING              = 0x0040;
+    static const uint16_t ROOM                  = 0x0080;
+    static const uint16_t DIGGABLE              = 0x0100;
+    static const uint16_t WALKABLE              = 0x0200;
+
+    AITileSnapshot() :
+        mSizeX(0),
+        mSizeY(0),
+        mCaptureId(0),
+        mTilesLayoutVersion(0),
+        mWorkerDefinition(nullptr)
+    {}
+
+    //! \brief Copies the state of the tiles as seen by the given seat and worker. Only the tiles changed
+    //! since the last update are copied (see TileContainer::getTilesLayoutChangedSince) unless the map
+    //! or the worker changed. Must be called from the server thread
+    void update(const GameMap& gameMap, Seat* seat, const Creature& worker);
+
+    inline int32_t getSizeX() const
+    { return mSizeX; }
+
+    inline int32_t getSizeY() const
+    { return mSizeY; }
+
+    inline bool isInside(int32_t x, int32_t y) const
+    { return (x >= 0) && (y >= 0) && (x < mSizeX) && (y < mSizeY); }
+
+    inline uint32_t getIndex(int32_t x, int32_t y) const
+    { return static_cast<uint32_t>(x * mSizeY + y); }
+
+    //! \brief Returns the flags of the given tile or 0 if it is outside the map
+    inline uint16_t getFlags(int32_t x, int32_t y) const
+    { return isInside(x, y) ? mFlags[getIndex(x, y)] : 0; }
+
+    //! \brief Resizes the snapshot and sets the flags of every tile to 0
+    inline void reset(int32_t sizeX, int32_t sizeY)
+    {
+        mSizeX = sizeX;
+        mSizeY = sizeY;
+        mFlags.assign(mSizeX * mSizeY, 0);
+        ++mCaptureId;
+    }
+
+    //! \brief Sets the flags of the given tile, which must be inside the map
+    inline void setFlags(int32_t x, int32_t y, uint16_t flags)
+    {
+        uint16_t& tileFlags = mFlags[getIndex(x, y)];
+        if(tileFlags == flags)
+            return;
+
+        tileFlags = flags;
+        ++mCaptureId;
+    }
+
+    //! \brief Incremented each time the flags of a tile change. Allows the planner to know if its
+    //! caches are still valid
+    inline uint32_t getCaptureId() const
+    { return mCaptureId; }
+
+private:
+    static uint16_t computeFlags(Tile* tile, Seat* seat, const Creature& worker);
+
+    std::vector<uint16_t> mFlags;
+    int32_t mSizeX;
+    int32_t mSizeY;
+    uint32_t mCaptureId;
+    //! \brief Tiles layout version (see TileContainer::getTilesLayoutVersion) and worker the snapshot was captured for
+    uint64_t mTilesLayoutVersion;
+    const CreatureDefinition* mWorkerDefinition;
+    //! \brief Kept to avoid allocating it at each update
+    std::vector<uint32_t> mChangedTiles;
+};
+
+#endif // AITILESNAPSHOT_H
@@ -18,6 +18,8 @@
 #ifndef BASEAI_H
 #define BASEAI_H
 
+#include "ai/AIPlanner.h"
+
 #include <string>
 #include <vector>
 #include <cstdint>
@@ -44,28 +46,39 @@ public:
      */
     virtual bool doTurn(double timeSinceLastTurn) = 0;
 
+    //! \brief Called on the server thread with the result of the search requested to mPlanner
+    virtual void applyPlan(const AIPlan&)
+    {}
+
+    inline AIPlanner& getPlanner()
+    { return mPlanner; }
+
+    //! \brief Set by the AIManager. Searches are run one at a time so that they do not pile up
+    //! on the worker
+    inline void setPlanningAllowed(bool allowed)
+    { mIsPlanningAllowed = allowed; }
+
 protected:
     BaseAI(GameMap& gameMap, Player& player);
 
     Room* getDungeonTemple();
 
-    //! \brief Searches for the best place where to place a room around the given tile. It will take
-    //! into account any constructible tile (even if not digged yet). On success, it returns true and bestX
-    //! and bestY will be set accordingly. It will return false if no constructible square of wantedSize
-    //! is found
-    bool findBestPlaceForRoom(Tile* tile, Seat* playerSeat, int32_t wantedSize, bool useWalls,
-        int32_t& bestX, int32_t& bestY);
+    //! \brief Returns true if a search can be requested to mPlanner during this turn
+    inline bool canStartPlanning() const
+    { return mIsPlanningAllowed && mPlanner.isIdle(); }
 
-    bool digWayToTile(Tile* tileStart, Tile* tileEnd);
-    bool computePointsForRoom(Tile* tile, Seat* playerSeat, int32_t wantedSize,
-        bool bottomLeft2TopRight, bool useWalls, int32_t& points);
+    //! \brief Returns true if a room could be built on the square of wantedSize side starting at tile
+    //! (tiles may still need to be dug)
+    bool isRoomPlaceValid(Tile* tile, Seat* playerSeat, int32_t wantedSize);
 
     GameMap& mGameMap;
     Player& mPlayer;
+    AIPlanner mPlanner;
 
 private:
     bool shouldGroundTileBeConsideredForBestPlaceForRoom(Tile* tile, Seat* playerSeat);
-    bool shouldWallTileBeConsideredForBestPlaceForRoom(Tile* tile, Seat* playerSeat);
+
+    bool mIsPlanningAllowed;
 };
 
 #endif // BASEAI_H
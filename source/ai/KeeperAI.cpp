@@ -33,6 +33,7 @@
 #include "utils/LogManager.h"
 #include "utils/Random.h"
 
+#include <cstdlib>
 #include <vector>
 
 // Contains the rooms the AI will try to build. It will try to build them in the given order
@@ -52,21 +53,21 @@ KeeperAI::KeeperAI(GameMap& gameMap, Player& player, int cooldownDefenseMin, int
              int cooldownSaveWoundedCreaturesMin, int cooldownSaveWoundedCreaturesMax,
              int cooldownLookingForRoomsMin, int cooldownLookingForRoomsMax):
     BaseAI(gameMap, player),
-    mCooldownCheckTreasury(0),
-    mCooldownLookingForRooms(0),
+    mNextTurnCheckTreasury(0),
+    mNextTurnLookingForRooms(0),
     mCooldownLookingForRoomsMin(cooldownLookingForRoomsMin),
     mCooldownLookingForRoomsMax(cooldownLookingForRoomsMax),
     mRoomPosX(-1),
     mRoomPosY(-1),
     mRoomSize(-1),
     mNoMoreReachableGold(false),
-    mCooldownLookingForGold(0),
-    mCooldownDefense(0),
+    mNextTurnLookingForGold(0),
+    mNextTurnDefense(0),
     mCooldownDefenseMin(cooldownDefenseMin),
     mCooldownDefenseMax(cooldownDefenseMax),
-    mCooldownWorkers(0),
-    mCooldownRepairRooms(0),
-    mCooldownSaveWoundedCreatures(0),
+    mNextTurnWorkers(0),
+    mNextTurnRepairRooms(0),
+    mNextTurnSaveWoundedCreatures(0),
     mCooldownSaveWoundedCreaturesMin(cooldownSaveWoundedCreaturesMin),
     mCooldownSaveWoundedCreaturesMax(cooldownSaveWoundedCreaturesMax),
     mIsFirstUpkeepDone(false)
@@ -117,23 +118,11 @@ bool KeeperAI::checkTreasury()
 {
     // If the treasury gets destroyed, we don't want the AI to build each turn the
     // free treasury
-    if(mCooldownCheckTreasury > 0)
-    {
-        --mCooldownCheckTreasury;
+    if(!isCooldownOver(mNextTurnCheckTreasury, 10, 30))
         return false;
-    }
-    mCooldownCheckTreasury = Random::Int(10,30);
-
-    int totalGold = 0;
-    int totalStorage = 0;
-    for(Room* room : mGameMap.getRooms())
-    {
-        if(room->getSeat() != mPlayer.getSeat())
-            continue;
 
-        totalGold += room->getTotalGoldStored();
-        totalStorage += room->getTotalGoldStorage();
-    }
+    int totalGold = mPlayer.getSeat()->getGold();
+    int totalStorage = mPlayer.getSeat()->getGoldMax();
 
     // We want at least to be allowed to store 3000 gold
     if(totalStorage >= 3000)
@@ -152,8 +141,7 @@ bool KeeperAI::checkTreasury()
         return false;
 
     // We try in priority to gold next to an existing treasury
-    std::vector<Room*> treasuriesOwned = mGameMap.getRoomsByTypeAndSeat(RoomType::treasury, mPlayer.getSeat());
-    for(Room* treasury : treasuriesOwned)
+    for(Room* treasury : mGameMap.getRoomsByTypeAndSeat(RoomType::treasury, mPlayer.getSeat()))
     {
         for(Tile* tile : treasury->getCoveredTiles())
         {
@@ -283,13 +271,13 @@ bool KeeperAI::checkTreasury()
 
 bool KeeperAI::handleRooms()
 {
-    if(mCooldownLookingForRooms > 0)
-    {
-        --mCooldownLookingForRooms;
+    // Searching a new room place is done on a worker thread. If it cannot be started now, we will
+    // try again next turn without waiting for the cooldown
+    if((mRoomSize == -1) && !canStartPlanning())
         return false;
-    }
 
-    mCooldownLookingForRooms = Random::Int(mCooldownLookingForRoomsMin, mCooldownLookingForRoomsMax);
+    if(!isCooldownOver(mNextTurnLookingForRooms, mCooldownLookingForRoomsMin, mCooldownLookingForRoomsMax))
+        return false;
 
     // We check if the last built room is done
     if(mRoomSize != -1)
@@ -301,8 +289,7 @@ bool KeeperAI::handleRooms()
             mRoomSize = -1;
             return false;
         }
-        int32_t points;
-        if(!computePointsForRoom(tile, mPlayer.getSeat(), mRoomSize, true, false, points))
+        if(!isRoomPlaceValid(tile, mPlayer.getSeat(), mRoomSize))
         {
             // The room is not valid anymore (may be claimed or built by somebody else). We redo
             mRoomSize = -1;
@@ -318,40 +305,13 @@ bool KeeperAI::handleRooms()
         return false;
     }
 
-    Tile* central = getDungeonTemple()->getCentralTile();
-    int32_t bestX = 0;
-    int32_t bestY = 0;
-    if(!findBestPlaceForRoom(central, mPlayer.getSeat(), 5, true, bestX, bestY))
-        return false;
-
-    mRoomSize = 5;
-    mRoomPosX = bestX;
-    mRoomPosY = bestY;
-
-    Tile* tileDest = mGameMap.getTile(mRoomPosX, mRoomPosY);
-    if(tileDest == nullptr)
-    {
-        OD_LOG_ERR("tileDest=" + Tile::displayAsString(tileDest) + ", mRoomPosX=" + Helper::toString(mRoomPosX) + ", mRoomPosY=" + Helper::toString(mRoomPosY));
-        return false;
-    }
-    if(!digWayToTile(central, tileDest))
+    // If we have no worker, we cannot know where it could go
+    Creature* worker = mGameMap.getWorkerForPathFinding(mPlayer.getSeat());
+    if(worker == nullptr)
         return false;
 
-    for(int xx = 0; xx < mRoomSize; ++xx)
-    {
-        for(int yy = 0; yy < mRoomSize; ++yy)
-        {
-            Tile* tile = mGameMap.getTile(mRoomPosX + xx, mRoomPosY + yy);
-            if(tile == nullptr)
-            {
-                OD_LOG_ERR("xx=" + Helper::toString(mRoomPosX + xx) + ", yy=" + Helper::toString(mRoomPosY + yy));
-                continue;
-            }
-
-            tile->setMarkedForDigging(true, &mPlayer);
-        }
-    }
-
+    Tile* central = getDungeonTemple()->getCentralTile();
+    mPlanner.requestRoomPlace(central, *worker, 5);
     return true;
 }
 
@@ -360,155 +320,76 @@ bool KeeperAI::lookForGold()
     if (mNoMoreReachableGold)
         return false;
 
-    if(mCooldownLookingForGold > 0)
-    {
-        --mCooldownLookingForGold;
+    if(!canStartPlanning())
         return false;
-    }
 
-    mCooldownLookingForGold = Random::Int(70,120);
+    if(!isCooldownOver(mNextTurnLookingForGold, 70, 120))
+        return false;
 
     // Do we need gold ?
-    int emptyStorage = 0;
-    for(Room* room : mGameMap.getRooms())
-    {
-        if(room->getSeat() != mPlayer.getSeat())
-            continue;
-
-        emptyStorage += (room->getTotalGoldStorage() - room->getTotalGoldStored());
-    }
+    int emptyStorage = mGameMap.getRoomsFreeCapacity(RoomType::treasury, mPlayer.getSeat());
 
     // No need to search for gold
     if(emptyStorage < 100)
         return false;
 
+    // If we have no worker, we cannot know if the gold is reachable
+    Creature* worker = mGameMap.getWorkerForPathFinding(mPlayer.getSeat());
+    if(worker == nullptr)
+        return false;
+
     Tile* central = getDungeonTemple()->getCentralTile();
-    int widerSide = mGameMap.getMapSizeX() > mGameMap.getMapSizeY() ?
-        mGameMap.getMapSizeX() : mGameMap.getMapSizeY();
+    mPlanner.requestGold(central, *worker);
+    return true;
+}
 
-    // We search for the closest gold tile
-    Tile* firstGoldTile = nullptr;
-    for(int32_t distance = 1; distance < widerSide; ++distance)
+void KeeperAI::applyPlan(const AIPlan& plan)
+{
+    switch(plan.mType)
     {
-        for(int k = 0; k <= distance; ++k)
+        case AIPlan::Type::roomPlace:
         {
-            Tile* t;
-            // North-East
-            t = mGameMap.getTile(central->getX() + k, central->getY() + distance);
-            if(t != nullptr && t->getType() == TileType::gold && t->getFullness() > 0.0)
-            {
-                // If we already have a tile at same distance, we randomly change to
-                // try to not be too predictable
-                if((firstGoldTile == nullptr) || (Random::Uint(1,2) == 1))
-                    firstGoldTile = t;
-            }
-            // North-West
-            if(k > 0)
-            {
-                t = mGameMap.getTile(central->getX() - k, central->getY() + distance);
-                if(t != nullptr && t->getType() == TileType::gold && t->getFullness() > 0.0)
-                {
-                    if((firstGoldTile == nullptr) || (Random::Uint(1,2) == 1))
-                        firstGoldTile = t;
-                }
-            }
-            // South-East
-            t = mGameMap.getTile(central->getX() + k, central->getY() - distance);
-            if(t != nullptr && t->getType() == TileType::gold && t->getFullness() > 0.0)
-            {
-                if((firstGoldTile == nullptr) || (Random::Uint(1,2) == 1))
-                    firstGoldTile = t;
-            }
-            // South-West
-            if(k > 0)
-            {
-                t = mGameMap.getTile(central->getX() - k, central->getY() - distance);
-                if(t != nullptr && t->getType() == TileType::gold && t->getFullness() > 0.0)
-                {
-                    if((firstGoldTile == nullptr) || (Random::Uint(1,2) == 1))
-                        firstGoldTile = t;
-                }
-            }
-            // East-North
-            t = mGameMap.getTile(central->getX() + distance, central->getY() + k);
-            if(t != nullptr && t->getType() == TileType::gold && t->getFullness() > 0.0)
-            {
-                if((firstGoldTile == nullptr) || (Random::Uint(1,2) == 1))
-                    firstGoldTile = t;
-            }
-            // East-South
-            if(k > 0)
-            {
-                t = mGameMap.getTile(central->getX() + distance, central->getY() - k);
-                if(t != nullptr && t->getType() == TileType::gold && t->getFullness() > 0.0)
-                {
-                    if((firstGoldTile == nullptr) || (Random::Uint(1,2) == 1))
-                        firstGoldTile = t;
-                }
-            }
-            // West-North
-            t = mGameMap.getTile(central->getX() - distance, central->getY() + k);
-            if(t != nullptr && t->getType() == TileType::gold && t->getFullness() > 0.0)
-            {
-                if((firstGoldTile == nullptr) || (Random::Uint(1,2) == 1))
-                    firstGoldTile = t;
-            }
-            // West-South
-            if(k > 0)
-            {
-                t = mGameMap.getTile(central->getX() - distance, central->getY() - k);
-                if(t != nullptr && t->getType() == TileType::gold && t->getFullness() > 0.0)
-                {
-                    if((firstGoldTile == nullptr) || (Random::Uint(1,2) == 1))
-                        firstGoldTile = t;
-                }
-            }
+            if(!plan.mIsFound)
+                return;
 
-            if(firstGoldTile != nullptr)
-                break;
+            mRoomSize = plan.mRoomSize;
+            mRoomPosX = plan.mRoomPosX;
+            mRoomPosY = plan.mRoomPosY;
+            break;
         }
-
-        // If we found a tile, no need to continue
-        if(firstGoldTile != nullptr)
+        case AIPlan::Type::gold:
+        {
+            if(plan.mNoMoreGold)
+                mNoMoreReachableGold = true;
             break;
+        }
+        default:
+            return;
     }
 
-    // No more gold
-    if (firstGoldTile == nullptr)
-    {
-        mNoMoreReachableGold = true;
-        return false;
-    }
-
-    if(!digWayToTile(central, firstGoldTile))
-    {
-        mNoMoreReachableGold = true;
-        return false;
-    }
-
-    // If the neighbors are gold, we dig them
-    const int levelTilesDig = 2;
-    std::set<Tile*> tilesDig;
-    // Because we can't insert Tiles in tilesDig while iterating, we use a copy: tilesDigTmp
-    std::set<Tile*> tilesDigTmp;
-    tilesDig.insert(firstGoldTile);
-
-    for(int i = 0; i < levelTilesDig; ++i)
+    // The tiles may have changed since the search started. setMarkedForDigging ignores the
+    // ones that cannot be dug anymore
+    for(const std::pair<int32_t, int32_t>& coords : plan.mTilesToDig)
     {
-        tilesDigTmp = tilesDig;
-        for(Tile* tile : tilesDigTmp)
+        Tile* tile = mGameMap.getTile(coords.first, coords.second);
+        if(tile == nullptr)
         {
-            for(Tile* neigh : tile->getAllNeighbors())
-            {
-                if(neigh->getType() == TileType::gold && neigh->getFullness() > 0.0)
-                    tilesDig.insert(neigh);
-            }
+            OD_LOG_ERR("x=" + Helper::toString(coords.first) + ", y=" + Helper::toString(coords.second));
+            continue;
         }
-    }
 
-    for(Tile* tile : tilesDig)
         tile->setMarkedForDigging(true, &mPlayer);
+    }
+}
+
+bool KeeperAI::isCooldownOver(int64_t& nextTurn, int cooldownMin, int cooldownMax)
+{
+    int64_t turn = mGameMap.getTurnNumber();
+    if(turn < nextTurn)
+        return false;
 
+    // The cooldown is the number of turns to skip
+    nextTurn = turn + 1 + Random::Int(Random::Stream::ai, cooldownMin, cooldownMax);
     return true;
 }
 
@@ -602,12 +483,8 @@ bool KeeperAI::checkNeedRoom(RoomType roomType)
 
 void KeeperAI::saveWoundedCreatures()
 {
-    if(mCooldownSaveWoundedCreatures > 0)
-    {
-        --mCooldownSaveWoundedCreatures;
+    if(!isCooldownOver(mNextTurnSaveWoundedCreatures, mCooldownSaveWoundedCreaturesMin, mCooldownSaveWoundedCreaturesMax))
         return;
-    }
-    mCooldownSaveWoundedCreatures = Random::Int(mCooldownSaveWoundedCreaturesMin, mCooldownSaveWoundedCreaturesMax);
 
     Tile* dungeonTempleTile = getDungeonTemple()->getCentralTile();
     if(dungeonTempleTile == nullptr)
@@ -617,7 +494,7 @@ void KeeperAI::saveWoundedCreatures()
     }
 
     Seat* seat = mPlayer.getSeat();
-    std::vector<Creature*> creatures = mGameMap.getCreaturesBySeat(seat);
+    TurnSpan<Creature*> creatures = mGameMap.getCreaturesBySeat(seat);
     for(Creature* creature : creatures)
     {
         // We take away fleeing creatures not too near our dungeon heart
@@ -645,12 +522,8 @@ void KeeperAI::saveWoundedCreatures()
 
 void KeeperAI::handleDefense()
 {
-    if(mCooldownDefense > 0)
-    {
-        --mCooldownDefense;
+    if(!isCooldownOver(mNextTurnDefense, mCooldownDefenseMin, mCooldownDefenseMax))
         return;
-    }
-    mCooldownDefense = Random::Int(mCooldownDefenseMin, mCooldownDefenseMax);
 
     Seat* seat = mPlayer.getSeat();
     // We drop creatures nearby owned or allied attacked creatures
@@ -700,13 +573,8 @@ void KeeperAI::handleDefense()
 
 bool KeeperAI::handleWorkers()
 {
-    if(mCooldownWorkers > 0)
-    {
-        --mCooldownWorkers;
+    if(!isCooldownOver(mNextTurnWorkers, 3, 10))
         return false;
-    }
-
-    mCooldownWorkers = Random::Int(3,10);
 
     // We want to use the first covered tile because the central might be destroyed and enemy claimed
     // and, if it is the case, we will not be able to spawn a worker.
@@ -719,7 +587,7 @@ bool KeeperAI::handleWorkers()
     // If we have less than 4 workers or we have the chance, we summon
     int nbWorkers = mPlayer.getSeat()->getNumCreaturesWorkers();
     if((nbWorkers < 4) ||
-       (Random::Int(0, nbWorkers * 3) == 0))
+       (Random::Int(Random::Stream::ai, 0, nbWorkers * 3) == 0))
     {
         Tile* tile = getDungeonTemple()->getCoveredTile(0);
         std::vector<Tile*> tiles;
@@ -735,13 +603,8 @@ bool KeeperAI::handleWorkers()
 
 bool KeeperAI::repairRooms()
 {
-    if(mCooldownRepairRooms > 0)
-    {
-        --mCooldownRepairRooms;
+    if(!isCooldownOver(mNextTurnRepairRooms, 20, 60))
         return false;
-    }
-
-    mCooldownRepairRooms = Random::Int(20,60);
 
     Seat* seat = mPlayer.getSeat();
     for(Room* room : mGameMap.getRooms())
@@ -772,7 +635,7 @@ bool KeeperAI::handleTiredCreatures()
     if(mPlayer.getSeat()->getNbRooms(RoomType::dormitory) <= 0)
         return false;
 
-    std::vector<Creature*> creatures = mGameMap.getCreaturesBySeat(mPlayer.getSeat());
+    TurnSpan<Creature*> creatures = mGameMap.getCreaturesBySeat(mPlayer.getSeat());
     for(Creature* creature : creatures)
     {
         // We do not take creatures fighting
@@ -842,7 +705,7 @@ bool KeeperAI::handleHungryCreatures()
     if(mPlayer.getSeat()->getNbRooms(RoomType::hatchery) <= 0)
         return false;
 
-    std::vector<Creature*> creatures = mGameMap.getCreaturesBySeat(mPlayer.getSeat());
+    TurnSpan<Creature*> creatures = mGameMap.getCreaturesBySeat(mPlayer.getSeat());
     for(Creature* creature : creatures)
     {
         // We do not take creatures fighting
@@ -20,6 +20,8 @@
 
 #include "ai/BaseAI.h"
 
+#include <cstdint>
+
 enum class RoomType;
 
 class KeeperAI : public BaseAI
@@ -30,6 +32,7 @@ public:
              int cooldownSaveWoundedCreaturesMin, int cooldownSaveWoundedCreaturesMax,
              int cooldownLookingForRoomsMin, int cooldownLookingForRoomsMax);
     virtual bool doTurn(double timeSinceLastTurn);
+    virtual void applyPlan(const AIPlan& plan);
 
 protected:
     //! \brief Checks if the AI has a treasury. If not, we search for the first available tile
@@ -38,11 +41,12 @@ protected:
     bool checkTreasury();
 
     //! \brief Checks if a room is needed. If yes, it will check if place is available
-    //! and start digging for it.
+    //! and start digging for it. The place is searched on a worker thread and applied next turn.
     //! Returns true if the action has been done and false if nothing has been done
     bool handleRooms();
 
-    //! \brief Look for gold and make way up to it.
+    //! \brief Look for gold and make way up to it. The gold is searched on a worker thread
+    //! and the way is marked for digging next turn.
     //! \brief Returns whether the action could succeed.
     //! It will also return false once it's done.
     bool lookForGold();
@@ -84,21 +88,26 @@ private:
     //! \brief Returns true if the given room is needed and false otherwise
     bool checkNeedRoom(RoomType roomType);
 
-    int mCooldownCheckTreasury;
-    int mCooldownLookingForRooms;
+    //! \brief Returns false if nextTurn is not reached yet. Otherwise, sets nextTurn after a random
+    //! cooldown (in turns) and returns true. Cooldowns are counted in turns and not in calls so that
+    //! an AI skipped by the AIManager because of its time budget keeps the same pace
+    bool isCooldownOver(int64_t& nextTurn, int cooldownMin, int cooldownMax);
+
+    int64_t mNextTurnCheckTreasury;
+    int64_t mNextTurnLookingForRooms;
     int mCooldownLookingForRoomsMin;
     int mCooldownLookingForRoomsMax;
     int mRoomPosX;
     int mRoomPosY;
     int mRoomSize;
     bool mNoMoreReachableGold;
-    int mCooldownLookingForGold;
-    int mCooldownDefense;
+    int64_t mNextTurnLookingForGold;
+    int64_t mNextTurnDefense;
     int mCooldownDefenseMin;
     int mCooldownDefenseMax;
-    int mCooldownWorkers;
-    int mCooldownRepairRooms;
-    int mCooldownSaveWoundedCreatures;
+    int64_t mNextTurnWorkers;
+    int64_t mNextTurnRepairRooms;
+    int64_t mNextTurnSaveWoundedCreatures;
     int mCooldownSaveWoundedCreaturesMin;
     int mCooldownSaveWoundedCreaturesMax;
     bool mIsFirstUpkeepDone;
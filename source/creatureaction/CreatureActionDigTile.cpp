@@ -145,27 +145,28 @@ bool CreatureActionDigTile::handleDigTile(Creature& creature, Tile& tileDig, Til
         obj->createMesh();
         obj->setPosition(pos);
 
+        // If every treasury is full, we do not need to check them
         bool isTreasuryAvailable = false;
-        for(Room* room : creature.getGameMap()->getRooms())
+        if(creature.getGameMap()->getRoomsFreeCapacity(RoomType::treasury, creature.getSeat()) > 0)
         {
-            if(room->getSeat() != creature.getSeat())
-                continue;
-
-            if(room->getTotalGoldStorage() <= 0)
-                continue;
+            for(Room* room : creature.getGameMap()->getRoomsByTypeAndSeat(RoomType::treasury, creature.getSeat()))
+            {
+                if(room->getTotalGoldStorage() <= 0)
+                    continue;
 
-            if(room->getTotalGoldStored() >= room->getTotalGoldStorage())
-                continue;
+                if(room->getTotalGoldStored() >= room->getTotalGoldStorage())
+                    continue;
 
-            if(room->numCoveredTiles() <= 0)
-                continue;
+                if(room->numCoveredTiles() <= 0)
+                    continue;
 
-            Tile* tile = room->getCoveredTile(0);
-            if(!creature.getGameMap()->pathExists(&creature, myTile, tile))
-                continue;
+                Tile* tile = room->getCoveredTile(0);
+                if(!creature.getGameMap()->pathExists(&creature, myTile, tile))
+                    continue;
 
-            isTreasuryAvailable = true;
-            break;
+                isTreasuryAvailable = true;
+                break;
+            }
         }
 
         if(isTreasuryAvailable)
@@ -109,7 +109,7 @@ bool CreatureActionEatChicken::handleEatChicken(Creature& creature, ChickenEntit
     // We can eat the chicken
     chicken->eatChicken(&creature);
     creature.foodEaten(ConfigManager::getSingleton().getRoomConfigDouble("HatcheryHungerPerChicken"));
-    creature.setJobCooldown(Random::Int(ConfigManager::getSingleton().getRoomConfigUInt32("HatcheryCooldownChickenMin"),
+    creature.setJobCooldown(Random::Int(Random::Stream::creatures, ConfigManager::getSingleton().getRoomConfigUInt32("HatcheryCooldownChickenMin"),
         ConfigManager::getSingleton().getRoomConfigUInt32("HatcheryCooldownChickenMax")));
     creature.setHP(creature.getHP() + ConfigManager::getSingleton().getRoomConfigDouble("HatcheryHpRecoveredPerChicken"));
     creature.computeCreatureOverlayHealthValue();
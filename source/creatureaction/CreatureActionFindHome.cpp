@@ -99,26 +99,32 @@ bool CreatureActionFindHome::handleFindHome(Creature& creature, bool forced)
     }
 
     // Check to see if we can walk to a dormitory that does have an open tile.
-    std::vector<Room*> tempRooms = creature.getGameMap()->getRoomsByTypeAndSeat(RoomType::dormitory, creature.getSeat());
+    // If there is no free tile in our dormitories, we do not need to check them
     std::vector<Tile*> availableDormitories;
-    for (Room* room : tempRooms)
+    if(creature.getGameMap()->getRoomsFreeCapacity(RoomType::dormitory, creature.getSeat()) > 0)
     {
-        if(room->getType() != RoomType::dormitory)
+        for (Room* room : creature.getGameMap()->getRoomsByTypeAndSeat(RoomType::dormitory, creature.getSeat()))
         {
-            OD_LOG_ERR("room=" + room->getName());
-            continue;
-        }
+            if(room->getType() != RoomType::dormitory)
+            {
+                OD_LOG_ERR("room=" + room->getName());
+                continue;
+            }
 
-        RoomDormitory* dormitory = static_cast<RoomDormitory*>(room);
-        Tile* tile = dormitory->getLocationForBed(&creature);
-        if(tile == nullptr)
-            continue;
+            if(room->getFreeCapacityIndexed() <= 0)
+                continue;
 
-        // Check if the room is accessible
-        if(!creature.getGameMap()->pathExists(&creature, myTile, tile))
-            continue;
+            RoomDormitory* dormitory = static_cast<RoomDormitory*>(room);
+            Tile* tile = dormitory->getLocationForBed(&creature);
+            if(tile == nullptr)
+                continue;
 
-        availableDormitories.push_back(tile);
+            // Check if the room is accessible
+            if(!creature.getGameMap()->pathExists(&creature, myTile, tile))
+                continue;
+
+            availableDormitories.push_back(tile);
+        }
     }
 
     // If we found a valid path to an open room in a dormitory, then start walking along it.
@@ -76,11 +76,8 @@ bool CreatureActionGetFee::handleGetFee(Creature& creature)
 
     // We try to go to some treasury were there is still some gold
     std::vector<Tile*> availableTreasuries;
-    for(Room* room : creature.getGameMap()->getRooms())
+    for(Room* room : creature.getGameMap()->getRoomsByTypeAndSeat(RoomType::treasury, creature.getSeat()))
     {
-        if(room->getSeat() != creature.getSeat())
-            continue;
-
         if(room->getTotalGoldStored() <= 0)
             continue;
 
@@ -69,8 +69,8 @@ bool CreatureActionLeaveDungeon::handleLeaveDungeon(Creature& creature)
     }
 
     // We try to go to the portal
-    std::vector<Room*> tempRooms = creature.getGameMap()->getRoomsByTypeAndSeat(RoomType::portal, creature.getSeat());
-    tempRooms = creature.getGameMap()->getReachableRooms(tempRooms, myTile, &creature);
+    std::vector<Room*> tempRooms = creature.getGameMap()->getReachableRooms(
+        creature.getGameMap()->getRoomsByTypeAndSeat(RoomType::portal, creature.getSeat()), myTile, &creature);
     if(tempRooms.empty())
     {
         creature.popAction();
@@ -79,7 +79,7 @@ bool CreatureActionLeaveDungeon::handleLeaveDungeon(Creature& creature)
 
     creature.fireChatMsgLeavingDungeon();
 
-    int index = Random::Int(0, tempRooms.size() - 1);
+    int index = Random::Int(Random::Stream::creatures, 0, tempRooms.size() - 1);
     Room* room = tempRooms[index];
     Tile* tile = room->getCentralTile();
     if(!creature.setDestination(tile))
@@ -58,7 +58,7 @@ bool CreatureActionSearchEntityToCarry::handleSearchEntityToCarry(Creature& crea
     }
 
     std::vector<Building*> buildings = creature.getGameMap()->getReachableBuildingsPerSeat(creature.getSeat(), myTile, &creature);
-    std::vector<GameEntity*> carryableEntities = creature.getGameMap()->getCarryableEntities(&creature, creature.getTilesWithinSightRadius());
+    TurnSpan<GameEntity*> carryableEntities = creature.getGameMap()->getCarryableEntities(&creature, creature.getTilesWithinSightRadius());
     std::vector<Tile*> carryableEntityInMyTileClients;
     std::vector<GameEntity*> availableEntities;
     EntityCarryType highestPriority = EntityCarryType::notCarryable;
@@ -149,7 +149,7 @@ bool CreatureActionSearchEntityToCarry::handleSearchEntityToCarry(Creature& crea
     }
 
     // We randomly choose one of the visible carryable entities
-    uint32_t index = Random::Uint(0,availableEntities.size()-1);
+    uint32_t index = Random::Uint(Random::Stream::creatures, 0,availableEntities.size()-1);
     GameEntity* entity = availableEntities[index];
     creature.pushAction(Utils::make_unique<CreatureActionGrabEntity>(creature, *entity));
     return true;
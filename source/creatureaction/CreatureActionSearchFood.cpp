@@ -95,7 +95,7 @@ bool CreatureActionSearchFood::handleSearchFood(Creature& creature, bool forced)
 
     // We couldn't find a wandering chicken. We look for a room where we can eat
     // Get the list of hatchery controlled by our seat and make sure there is at least one.
-    std::vector<Room*> hatcheries = creature.getGameMap()->getRoomsByTypeAndSeat(RoomType::hatchery, creature.getSeat());
+    RoomsView hatcheries = creature.getGameMap()->getRoomsByTypeAndSeat(RoomType::hatchery, creature.getSeat());
     if (hatcheries.empty())
     {
         if((creature.getSeat()->getPlayer() != nullptr) &&
@@ -108,27 +108,31 @@ bool CreatureActionSearchFood::handleSearchFood(Creature& creature, bool forced)
         return true;
     }
 
-    // Pick a hatchery where we can eat and try to walk to it.
+    // Pick a hatchery where we can eat and try to walk to it. If every hatchery is
+    // full, we do not need to check them
     std::vector<Tile*> hatcheriesTiles;
-    for(Room* hatcheryRoom : hatcheries)
+    if(creature.getGameMap()->getRoomsFreeCapacity(RoomType::hatchery, creature.getSeat()) > 0)
     {
-        if(hatcheryRoom->numCoveredTiles() <= 0)
-            continue;
+        for(Room* hatcheryRoom : hatcheries)
+        {
+            if(hatcheryRoom->numCoveredTiles() <= 0)
+                continue;
 
-        if(!hatcheryRoom->hasOpenCreatureSpot(&creature))
-            continue;
+            if(!hatcheryRoom->hasOpenCreatureSpot(&creature))
+                continue;
 
-        Tile* tile = hatcheryRoom->getCoveredTile(0);
-        if(tile == nullptr)
-        {
-            OD_LOG_ERR("creature=" + creature.getName() + ", hatchery=" + hatcheryRoom->getName());
-            continue;
-        }
+            Tile* tile = hatcheryRoom->getCoveredTile(0);
+            if(tile == nullptr)
+            {
+                OD_LOG_ERR("creature=" + creature.getName() + ", hatchery=" + hatcheryRoom->getName());
+                continue;
+            }
 
-        if(!creature.getGameMap()->pathExists(&creature, myTile, tile))
-            continue;
+            if(!creature.getGameMap()->pathExists(&creature, myTile, tile))
+                continue;
 
-        hatcheriesTiles.push_back(tile);
+            hatcheriesTiles.push_back(tile);
+        }
     }
 
     if(hatcheriesTiles.empty())
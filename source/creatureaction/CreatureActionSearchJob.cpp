@@ -57,7 +57,7 @@ bool CreatureActionSearchJob::handleSearchJob(Creature& creature, bool forced)
         case CreatureMoodLevel::Upset:
         {
             // 20% chances of not working
-            if(Random::Int(0, 100) < 20)
+            if(Random::Int(Random::Stream::creatures, 0, 100) < 20)
             {
                 creature.popAction();
                 return true;
@@ -151,7 +151,7 @@ bool CreatureActionSearchJob::handleSearchJob(Creature& creature, bool forced)
             if((affinity.getEfficiency() <= 0) ||
                (room->getType() == RoomType::hatchery))
             {
-                int index = Random::Int(0, room->numCoveredTiles() - 1);
+                int index = Random::Int(Random::Stream::creatures, 0, room->numCoveredTiles() - 1);
                 Tile* tileDest = room->getCoveredTile(index);
                 creature.setDestination(tileDest);
                 return false;
@@ -168,17 +168,11 @@ bool CreatureActionSearchJob::handleSearchJob(Creature& creature, bool forced)
         // We are not in a room of the good type or we couldn't use it. We check if there is a reachable room
         // of the good type
         std::vector<Tile*> rooms;
-        for(Room* room : creature.getGameMap()->getRooms())
+        for(Room* room : creature.getGameMap()->getRoomsByTypeAndSeat(affinity.getRoomType(), creature.getSeat()))
         {
-            if(room->getSeat() != creature.getSeat())
-                continue;
-
             if(room->numCoveredTiles() <= 0)
                 continue;
 
-            if(room->getType() != affinity.getRoomType())
-                continue;
-
             // If efficiency is 0, we just want to wander so no need to check if the room is available
             if((affinity.getEfficiency() > 0) && !room->hasOpenCreatureSpot(&creature))
                 continue;
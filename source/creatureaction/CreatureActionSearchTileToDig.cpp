@@ -84,8 +84,7 @@ bool CreatureActionSearchTileToDig::handleSearchTileToDig(Creature& creature, in
             continue;
 
         // Check if there is still empty space for digging the tile
-        std::vector<Tile*> tiles;
-        tempTile->canWorkerDig(creature, tiles);
+        TurnSpan<Tile*> tiles = tempTile->canWorkerDig(creature);
         if(tiles.empty())
             continue;
 
@@ -119,8 +118,7 @@ bool CreatureActionSearchTileToDig::handleSearchTileToDig(Creature& creature, in
             continue;
 
         // and there is still room to work on it
-        std::vector<Tile*> tiles;
-        tile->canWorkerDig(creature, tiles);
+        TurnSpan<Tile*> tiles = tile->canWorkerDig(creature);
         if(tiles.empty())
             continue;
 
@@ -159,27 +157,28 @@ bool CreatureActionSearchTileToDig::handleSearchTileToDig(Creature& creature, in
         obj->createMesh();
         obj->setPosition(pos);
 
+        // If every treasury is full, we do not need to check them
         bool isTreasuryAvailable = false;
-        for(Room* room : creature.getGameMap()->getRooms())
+        if(creature.getGameMap()->getRoomsFreeCapacity(RoomType::treasury, creature.getSeat()) > 0)
         {
-            if(room->getSeat() != creature.getSeat())
-                continue;
+            for(Room* room : creature.getGameMap()->getRoomsByTypeAndSeat(RoomType::treasury, creature.getSeat()))
+            {
+                if(room->getTotalGoldStorage() <= 0)
+                    continue;
 
-            if(room->getTotalGoldStorage() <= 0)
-                continue;
+                if(room->getTotalGoldStored() >= room->getTotalGoldStorage())
+                    continue;
 
-            if(room->getTotalGoldStored() >= room->getTotalGoldStorage())
-                continue;
+                if(room->numCoveredTiles() <= 0)
+                    continue;
 
-            if(room->numCoveredTiles() <= 0)
-                continue;
+                Tile* tile = room->getCoveredTile(0);
+                if(!creature.getGameMap()->pathExists(&creature, myTile, tile))
+                    continue;
 
-            Tile* tile = room->getCoveredTile(0);
-            if(!creature.getGameMap()->pathExists(&creature, myTile, tile))
-                continue;
-
-            isTreasuryAvailable = true;
-            break;
+                isTreasuryAvailable = true;
+                break;
+            }
         }
         if(isTreasuryAvailable)
         {
@@ -92,7 +92,7 @@ bool CreatureActionUseRoom::handleJob(Creature& creature, Room* room, bool force
             case CreatureMoodLevel::Upset:
             {
                 // 20% chances of not working
-                if(Random::Int(0, 100) < 20)
+                if(Random::Int(Random::Stream::creatures, 0, 100) < 20)
                 {
                     creature.popAction();
                     return true;
@@ -87,7 +87,7 @@ bool CreatureBehaviourFleeWhenWeak::processBehaviour(Creature& creature) const
     }
 
     // We randomly choose to flee
-    if(Random::Uint(0, 100) < 20)
+    if(Random::Uint(Random::Stream::creatures, 0, 100) < 20)
     {
         if(creature.isActionInList(CreatureActionType::flee))
             return true;
@@ -116,7 +116,7 @@ void ChickenEntity::doUpkeep()
         return;
 
     // We might not move
-    if(Random::Int(1,2) == 1)
+    if(Random::Int(Random::Stream::creatures, 1,2) == 1)
     {
         setAnimationState("Pick");
         return;
@@ -136,7 +136,7 @@ void ChickenEntity::doUpkeep()
     if(possibleTileMove.empty())
         return;
 
-    uint32_t indexTile = Random::Uint(0, possibleTileMove.size() - 1);
+    uint32_t indexTile = Random::Uint(Random::Stream::creatures, 0, possibleTileMove.size() - 1);
     Tile* tileDest = possibleTileMove[indexTile];
     Ogre::Vector3 v (static_cast<Ogre::Real>(tileDest->getX()), static_cast<Ogre::Real>(tileDest->getY()), 0.0);
     std::vector<Ogre::Vector3> path;
@@ -242,13 +242,13 @@ void ChickenEntity::correctEntityMovePosition(Ogre::Vector3& position)
 {
     static const double offset = 0.3;
     if(position.x > 0)
-        position.x += Random::Double(-offset, offset);
+        position.x += Random::Double(Random::Stream::creatures, -offset, offset);
 
     if(position.y > 0)
-        position.y += Random::Double(-offset, offset);
+        position.y += Random::Double(Random::Stream::creatures, -offset, offset);
 
     if(position.z > 0)
-        position.z += Random::Double(-offset, offset);
+        position.z += Random::Double(Random::Stream::creatures, -offset, offset);
 }
 
 bool ChickenEntity::eatChicken(Creature* creature)
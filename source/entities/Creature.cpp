@@ -57,6 +57,7 @@
 #include "game/Seat.h"
 #include "gamemap/GameMap.h"
 #include "gamemap/Pathfinding.h"
+#include "gamemap/SaveGameSnapshot.h"
 #include "giftboxes/GiftBoxSkill.h"
 #include "network/ODClient.h"
 #include "network/ODServer.h"
@@ -73,6 +74,7 @@
 #include "utils/Helper.h"
 #include "utils/LogManager.h"
 #include "utils/MakeUnique.h"
+#include "utils/MemoryReport.h"
 #include "utils/Random.h"
 
 #include <CEGUI/Event.h>
@@ -90,6 +92,7 @@
 
 #include <cmath>
 #include <algorithm>
+#include <sstream>
 
 #if OGRE_PLATFORM == OGRE_PLATFORM_WIN32
 #define snprintf_is_banned_in_OD_code _snprintf
@@ -171,7 +174,10 @@ Creature::Creature(GameMap* gameMap, const CreatureDefinition* definition, Seat*
     mSeatPrison              (nullptr),
     mNbTurnsTorture          (0),
     mNbTurnsPrison           (0),
-    mActiveSlapsCount        (0)
+    mActiveSlapsCount        (0),
+    mIsCountedInGameMap      (false),
+    mSeatCreaturesCounted    (nullptr),
+    mIsCountedAsWorker       (false)
 
 {
     //TODO: This should be set in initialiser list in parent classes
@@ -249,7 +255,10 @@ Creature::Creature(GameMap* gameMap) :
     mSeatPrison              (nullptr),
     mNbTurnsTorture          (0),
     mNbTurnsPrison           (0),
-    mActiveSlapsCount        (0)
+    mActiveSlapsCount        (0),
+    mIsCountedInGameMap      (false),
+    mSeatCreaturesCounted    (nullptr),
+    mIsCountedAsWorker       (false)
 {
 }
 
@@ -321,6 +330,9 @@ void Creature::addToGameMap()
         return;
 
     getGameMap()->addActiveObject(this);
+
+    mIsCountedInGameMap = true;
+    updateSeatCreaturesCount();
 }
 
 void Creature::removeFromGameMap()
@@ -343,6 +355,9 @@ void Creature::removeFromGameMap()
 
     fireRemoveEntityToSeatsWithVision();
     getGameMap()->removeActiveObject(this);
+
+    mIsCountedInGameMap = false;
+    updateSeatCreaturesCount();
 }
 
 std::string Creature::getCreatureStreamFormat()
@@ -360,32 +375,32 @@ std::string Creature::getCreatureStreamFormat()
 
 void Creature::exportToStream(std::ostream& os) const
 {
-    MovableGameEntity::exportToStream(os);
-    os << mDefinition->getClassName() << "\t";
-    os << getLevel() << "\t" << mExp << "\t";
-    if(getHP() < mMaxHP)
-        os << getHP();
-    else
-        os << "max";
-    os << "\t" << mWakefulness << "\t" << mHunger << "\t" << mGoldCarried;
-
-    // Check creature weapons
-    if(mWeaponL != nullptr)
-        os << "\t" << mWeaponL->getName();
-    else
-        os << "\tnone";
-
-    if(mWeaponR != nullptr)
-        os << "\t" << mWeaponR->getName();
-    else
-        os << "\tnone";
+    CreatureSaveState state;
+    exportToSaveState(state);
+    exportSaveStateToStream(state, os);
+}
 
-    os << "\t" << Skills::toString(mSkillTypeDropDeath);
+void Creature::exportToSaveState(CreatureSaveState& state) const
+{
+    // MovableGameEntity does not add anything to the GameEntity fields
+    GameEntity::exportToSaveState(state);
+    state.mClassName = mDefinition->getClassName();
+    state.mLevel = getLevel();
+    state.mExp = mExp;
+    state.mIsHpMax = (getHP() >= mMaxHP);
+    state.mHp = getHP();
+    state.mWakefulness = mWakefulness;
+    state.mHunger = mHunger;
+    state.mGoldCarried = mGoldCarried;
 
-    os << "\t" << mWeaponDropDeath;
+    // Check creature weapons
+    state.mWeaponL = (mWeaponL != nullptr) ? mWeaponL->getName() : "none";
+    state.mWeaponR = (mWeaponR != nullptr) ? mWeaponR->getName() : "none";
+    state.mSkillTypeDropDeath = mSkillTypeDropDeath;
+    state.mWeaponDropDeath = mWeaponDropDeath;
 
-    uint32_t nbEffects = mEntityParticleEffects.size();
-    os << "\t" << nbEffects;
+    state.mNbEffects = mEntityParticleEffects.size();
+    state.mEffects.clear();
     for(EntityParticleEffect* effect : mEntityParticleEffects)
     {
         // We only save creature particle effects. The other are expected to be re-created
@@ -394,11 +409,32 @@ void Creature::exportToStream(std::ostream& os) const
             continue;
 
         CreatureParticleEffect* creatureParticleEffect = static_cast<CreatureParticleEffect*>(effect);
-        os << "\t";
-        CreatureEffectManager::write(*creatureParticleEffect->mEffect, os);
+        std::ostringstream ss;
+        CreatureEffectManager::write(*creatureParticleEffect->mEffect, ss);
+        state.mEffects.push_back(ss.str());
     }
 }
 
+void Creature::exportSaveStateToStream(const CreatureSaveState& state, std::ostream& os)
+{
+    GameEntity::exportSaveStateToStream(state, os);
+    os << state.mClassName << "\t";
+    os << state.mLevel << "\t" << state.mExp << "\t";
+    if(!state.mIsHpMax)
+        os << state.mHp;
+    else
+        os << "max";
+    os << "\t" << state.mWakefulness << "\t" << state.mHunger << "\t" << state.mGoldCarried;
+    os << "\t" << state.mWeaponL;
+    os << "\t" << state.mWeaponR;
+    os << "\t" << Skills::toString(state.mSkillTypeDropDeath);
+    os << "\t" << state.mWeaponDropDeath;
+
+    os << "\t" << state.mNbEffects;
+    for(const std::string& effect : state.mEffects)
+        os << "\t" << effect;
+}
+
 bool Creature::importFromStream(std::istream& is)
 {
     // Beware: A generic class name might be used here so we shouldn't use mDefinition
@@ -629,6 +665,12 @@ void Creature::setPosition(const Ogre::Vector3& v)
         mCarriedEntity->notifyCarryMove(v);
 }
 
+void Creature::onWalkStep(const Ogre::Vector3& position)
+{
+    if(mCarriedEntity != nullptr)
+        mCarriedEntity->notifyCarryMove(position);
+}
+
 void Creature::setHP(double nHP)
 {
     if (nHP > mMaxHP)
@@ -676,24 +718,37 @@ void Creature::update(Ogre::Real timeSinceLastFrame)
 }
 
 void Creature::computeVisibleTiles()
+{
+    if (!givesVision())
+        return;
+
+    // Look at the surrounding area
+    updateTilesInSight();
+    notifyVisibleTiles();
+}
+
+bool Creature::givesVision() const
 {
     // dead Creatures do not give vision
     if (getHP() <= 0.0)
-        return;
+        return false;
 
     // KO Creatures do not give vision
     if (isKo())
-        return;
+        return false;
 
     // creatures in jail do not give vision
     if (mSeatPrison != nullptr)
-        return;
+        return false;
 
     if (!getIsOnMap())
-        return;
+        return false;
 
-    // Look at the surrounding area
-    updateTilesInSight();
+    return true;
+}
+
+void Creature::notifyVisibleTiles()
+{
     for(Tile* tile : mVisibleTiles)
         tile->notifyVision(getSeat());
 }
@@ -771,6 +826,8 @@ void Creature::doUpkeep()
             // it is not standing on a jail. It is free
             mSeatPrison = nullptr;
             mNeedFireRefresh = true;
+            // It can be attacked again. We notify the tile listeners (traps in range for example)
+            myTile->fireTileStateChanged();
         }
     }
 
@@ -896,8 +953,12 @@ void Creature::doUpkeep()
         increaseHunger(mDefinition->getHungerGrowthPerTurn());
     }
 
-    mVisibleEnemyObjects         = getVisibleEnemyObjects();
-    mVisibleAlliedObjects        = getVisibleAlliedObjects();
+    // The lists are kept until next turn so they are copied from the turn arena. Once the vectors
+    // are big enough, this does not allocate memory
+    TurnSpan<GameEntity*> visibleEnemyObjects = getVisibleEnemyObjects();
+    mVisibleEnemyObjects.assign(visibleEnemyObjects.begin(), visibleEnemyObjects.end());
+    TurnSpan<GameEntity*> visibleAlliedObjects = getVisibleAlliedObjects();
+    mVisibleAlliedObjects.assign(visibleAlliedObjects.begin(), visibleAlliedObjects.end());
     mReachableAlliedObjects      = getReachableAttackableObjects(mVisibleAlliedObjects);
 
     // Check if we should compute mood
@@ -910,7 +971,7 @@ void Creature::doUpkeep()
     {
         computeMood();
         computeCreatureOverlayMoodValue();
-        mMoodCooldownTurns = Random::Int(0, 5);
+        mMoodCooldownTurns = Random::Int(Random::Stream::creatures, 0, 5);
     }
 
     if(mMoodValue < CreatureMoodLevel::Furious)
@@ -1089,7 +1150,7 @@ bool Creature::handleIdleAction()
         if(!reachableCallToWars.empty())
         {
             // We go there
-            uint32_t index = Random::Uint(0,reachableCallToWars.size()-1);
+            uint32_t index = Random::Uint(Random::Stream::creatures, 0,reachableCallToWars.size()-1);
             Spell* callToWar = reachableCallToWars[index];
             Tile* callToWarTile = callToWar->getPositionTile();
             std::list<Tile*> tempPath = getGameMap()->path(this, callToWarTile);
@@ -1110,7 +1171,7 @@ bool Creature::handleIdleAction()
     if (!mDefinition->isWorker() &&
         !hasActionBeenTried(CreatureActionType::findHome) &&
         (mHomeTile == nullptr) &&
-        (Random::Double(0.0, 1.0) < 0.5))
+        (Random::Double(Random::Stream::creatures, 0.0, 1.0) < 0.5))
     {
         pushAction(Utils::make_unique<CreatureActionFindHome>(*this, false));
         return true;
@@ -1120,7 +1181,7 @@ bool Creature::handleIdleAction()
     if (!mDefinition->isWorker() &&
         !hasActionBeenTried(CreatureActionType::sleep) &&
         (mHomeTile != nullptr) &&
-        (Random::Double(20.0, 30.0) > mWakefulness))
+        (Random::Double(Random::Stream::creatures, 20.0, 30.0) > mWakefulness))
     {
         pushAction(Utils::make_unique<CreatureActionSleep>(*this));
         return true;
@@ -1129,7 +1190,7 @@ bool Creature::handleIdleAction()
     // If we are hungry, we go to eat
     if (!mDefinition->isWorker() &&
         !hasActionBeenTried(CreatureActionType::searchFood) &&
-        (Random::Double(70.0, 80.0) < mHunger))
+        (Random::Double(Random::Stream::creatures, 70.0, 80.0) < mHunger))
     {
         pushAction(Utils::make_unique<CreatureActionSearchFood>(*this, false));
         return true;
@@ -1140,7 +1201,7 @@ bool Creature::handleIdleAction()
     // creatures more likely to steal gold than others
     if (!mDefinition->isWorker() &&
         !hasActionBeenTried(CreatureActionType::stealFreeGold) &&
-        (Random::Uint(0, 10) > 8))
+        (Random::Uint(Random::Stream::creatures, 0, 10) > 8))
     {
         pushAction(Utils::make_unique<CreatureActionStealFreeGold>(*this));
         return true;
@@ -1149,7 +1210,7 @@ bool Creature::handleIdleAction()
     // Otherwise, we try to work
     if (!mDefinition->isWorker() &&
         !hasActionBeenTried(CreatureActionType::searchJob) &&
-        (Random::Double(0.0, 1.0) < 0.4))
+        (Random::Double(Random::Stream::creatures, 0.0, 1.0) < 0.4))
     {
         pushAction(Utils::make_unique<CreatureActionSearchJob>(*this, false));
         return true;
@@ -1172,7 +1233,7 @@ bool Creature::handleIdleAction()
         // Non-workers only.
 
         // Check to see if we want to try to follow a worker around or if we want to try to explore.
-        double r = Random::Double(0.0, 1.0);
+        double r = Random::Double(Random::Stream::creatures, 0.0, 1.0);
         if (r < 0.7)
         {
             bool workerFound = false;
@@ -1189,18 +1250,18 @@ bool Creature::handleIdleAction()
                     {
                         // Worker is digging, get near it since it could expose enemies.
                         int x = static_cast<int>(static_cast<double>(tempTile->getX()) + 3.0
-                                * Random::gaussianRandomDouble());
+                                * Random::gaussianRandomDouble(Random::Stream::creatures));
                         int y = static_cast<int>(static_cast<double>(tempTile->getY()) + 3.0
-                                * Random::gaussianRandomDouble());
+                                * Random::gaussianRandomDouble(Random::Stream::creatures));
                         tileDest = getGameMap()->getTile(x, y);
                     }
                     else
                     {
                         // Worker is not digging, wander a bit farther around the worker.
                         int x = static_cast<int>(static_cast<double>(tempTile->getX()) + 8.0
-                                * Random::gaussianRandomDouble());
+                                * Random::gaussianRandomDouble(Random::Stream::creatures));
                         int y = static_cast<int>(static_cast<double>(tempTile->getY()) + 8.0
-                                * Random::gaussianRandomDouble());
+                                * Random::gaussianRandomDouble(Random::Stream::creatures));
                         tileDest = getGameMap()->getTile(x, y);
                     }
                     workerFound = true;
@@ -1211,7 +1272,7 @@ bool Creature::handleIdleAction()
                 {
                     if (!reachableTiles.empty())
                     {
-                        tileDest = reachableTiles[static_cast<unsigned int>(Random::Double(0.6, 0.8)
+                        tileDest = reachableTiles[static_cast<unsigned int>(Random::Double(Random::Stream::creatures, 0.6, 0.8)
                                                                            * (reachableTiles.size() - 1))];
                     }
                 }
@@ -1223,7 +1284,7 @@ bool Creature::handleIdleAction()
             if (!reachableTiles.empty())
             {
                 unsigned int tileIndex = static_cast<unsigned int>(reachableTiles.size()
-                                                                   * Random::Double(0.1, 0.3));
+                                                                   * Random::Double(Random::Stream::creatures, 0.1, 0.3));
                 tileDest = reachableTiles[tileIndex];
             }
         }
@@ -1235,7 +1296,7 @@ bool Creature::handleIdleAction()
         // Choose a tile far away from our current position to wander to.
         if (!reachableTiles.empty())
         {
-            tileDest = reachableTiles[Random::Uint(reachableTiles.size() / 2,
+            tileDest = reachableTiles[Random::Uint(Random::Stream::creatures, reachableTiles.size() / 2,
                                                    reachableTiles.size() - 1)];
         }
     }
@@ -1341,7 +1402,7 @@ bool Creature::searchBestTargetInList(const std::vector<GameEntity*>& listObject
         int bestScoreAttack = -1;
         std::vector<Tile*> tiles;
         if(tilesFilter.empty())
-            tiles = getGameMap()->visibleTiles(tileAttackCheck->getX(), tileAttackCheck->getY(), skillRangeMaxInt);
+            getGameMap()->visibleTiles(tileAttackCheck->getX(), tileAttackCheck->getY(), skillRangeMaxInt, tiles);
         else
         {
             float radiusSquared = skillRangeMaxInt * skillRangeMaxInt;
@@ -1397,7 +1458,7 @@ bool Creature::searchBestTargetInList(const std::vector<GameEntity*>& listObject
         Tile* fleeTile = nullptr;
         std::vector<Tile*> tiles;
         if(tilesFilter.empty())
-            tiles = getGameMap()->visibleTiles(tileEntityFlee->getX(), tileEntityFlee->getY(), fightIdleDist);
+            getGameMap()->visibleTiles(tileEntityFlee->getX(), tileEntityFlee->getY(), fightIdleDist, tiles);
         else
         {
             float radiusSquared = fightIdleDist * fightIdleDist;
@@ -1638,19 +1699,40 @@ void Creature::updateFromPacket(ODPacket& is)
 }
 
 void Creature::updateTilesInSight()
+{
+    getGameMap()->prepareTileDistance(mDefinition->getSightRadius());
+    updateTilesInSight(getGameMap()->getVisibilityWork());
+}
+
+void Creature::updateTilesInSight(TileVisibilityWork& work)
 {
     Tile* posTile = getPositionTile();
     if (posTile == nullptr)
         return;
 
     // The tiles with sight radius without constraints
-    mTilesWithinSightRadius = getGameMap()->circularRegion(posTile->getX(), posTile->getY(), mDefinition->getSightRadius());
+    // We reuse the vectors from one turn to another to avoid allocating memory each time
+    getGameMap()->circularRegion(posTile->getX(), posTile->getY(), mDefinition->getSightRadius(), mTilesWithinSightRadius);
 
     // Only the tiles the creature can "see".
-    mVisibleTiles = getGameMap()->visibleTiles(posTile->getX(), posTile->getY(), mDefinition->getSightRadius());
+    getGameMap()->visibleTiles(posTile->getX(), posTile->getY(), mDefinition->getSightRadius(), mVisibleTiles, work);
 }
 
-std::vector<GameEntity*> Creature::getVisibleEnemyObjects()
+void Creature::fillMemoryReport(MemoryReport& report) const
+{
+    // Actions are polymorphic. We count them as base actions
+    report.add("creatureActions", MemoryReport::vectorBytes(mActions)
+        + mActions.size() * sizeof(CreatureAction)
+        + MemoryReport::vectorBytes(mActionTry));
+
+    report.add("creatureVision", MemoryReport::vectorBytes(mTilesWithinSightRadius)
+        + MemoryReport::vectorBytes(mVisibleTiles)
+        + MemoryReport::vectorBytes(mVisibleEnemyObjects)
+        + MemoryReport::vectorBytes(mVisibleAlliedObjects)
+        + MemoryReport::vectorBytes(mReachableAlliedObjects));
+}
+
+TurnSpan<GameEntity*> Creature::getVisibleEnemyObjects()
 {
     return getVisibleForce(getSeat(), true);
 }
@@ -1699,12 +1781,12 @@ std::vector<GameEntity*> Creature::getCreaturesFromList(const std::vector<GameEn
     return tempVector;
 }
 
-std::vector<GameEntity*> Creature::getVisibleAlliedObjects()
+TurnSpan<GameEntity*> Creature::getVisibleAlliedObjects()
 {
     return getVisibleForce(getSeat(), false);
 }
 
-std::vector<GameEntity*> Creature::getVisibleForce(Seat* seat, bool invert)
+TurnSpan<GameEntity*> Creature::getVisibleForce(Seat* seat, bool invert)
 {
     return getGameMap()->getVisibleForce(mVisibleTiles, seat, invert);
 }
@@ -2217,8 +2299,7 @@ void Creature::drop(const Ogre::Vector3& v)
                 )
             {
                 // Check if there is room for digging
-                std::vector<Tile*> tiles;
-                tile->canWorkerDig(*this, tiles);
+                TurnSpan<Tile*> tiles = tile->canWorkerDig(*this);
                 // We search for the closest neighbor tile (may be not the position
                 // tile if the player drops several workers at the same tile)
                 float distBest = -1;
@@ -2367,7 +2448,7 @@ bool Creature::wanderRandomly(const std::string& animationState)
     if (reachableTiles.empty())
         return false;
 
-    Tile* tileDestination = reachableTiles[Random::Uint(0, reachableTiles.size() - 1)];
+    Tile* tileDestination = reachableTiles[Random::Uint(Random::Stream::creatures, 0, reachableTiles.size() - 1)];
     setDestination(tileDestination);
     return false;
 }
@@ -2766,6 +2847,8 @@ void Creature::setupDefinition(GameMap& gameMap, const CreatureDefinition& defau
 
         computeCreatureOverlayHealthValue();
     }
+
+    updateSeatCreaturesCount();
 }
 
 void Creature::fireCreatureSound(CreatureSound sound)
@@ -2894,6 +2977,35 @@ void Creature::computeCreatureOverlayHealthValue()
         mOverlayHealthValue = value;
         mNeedFireRefresh = true;
     }
+
+    // Every hp change ends here so we can check if the creature died
+    updateSeatCreaturesCount();
+}
+
+void Creature::updateSeatCreaturesCount()
+{
+    if(!getIsOnServerMap())
+        return;
+
+    Seat* seat = nullptr;
+    bool isWorker = false;
+    if(mIsCountedInGameMap && (mDefinition != nullptr) && isAlive())
+    {
+        seat = getSeat();
+        isWorker = mDefinition->isWorker();
+    }
+
+    if((seat == mSeatCreaturesCounted) && (isWorker == mIsCountedAsWorker))
+        return;
+
+    if(mSeatCreaturesCounted != nullptr)
+        mSeatCreaturesCounted->notifyCreaturesCountChanged(mIsCountedAsWorker, -1);
+
+    if(seat != nullptr)
+        seat->notifyCreaturesCountChanged(isWorker, 1);
+
+    mSeatCreaturesCounted = seat;
+    mIsCountedAsWorker = isWorker;
 }
 
 void Creature::computeCreatureOverlayMoodValue()
@@ -3002,13 +3114,13 @@ void Creature::correctEntityMovePosition(Ogre::Vector3& position)
 {
     static const double offset = 0.3;
     if(position.x > 0)
-        position.x += Random::Double(-offset, offset);
+        position.x += Random::Double(Random::Stream::creatures, -offset, offset);
 
     if(position.y > 0)
-        position.y += Random::Double(-offset, offset);
+        position.y += Random::Double(Random::Stream::creatures, -offset, offset);
 
     if(position.z > 0)
-        position.z += Random::Double(-offset, offset);
+        position.z += Random::Double(Random::Stream::creatures, -offset, offset);
 }
 
 void Creature::checkWalkPathValid()
@@ -3220,6 +3332,7 @@ void Creature::changeSeat(Seat* newSeat)
     OD_LOG_INF("creature=" + getName() + " changes side from seatId=" + Helper::toString(getSeat()->getId()) + " to seatId=" + Helper::toString(newSeat->getId()));
     OD_ASSERT_TRUE_MSG(getSeat() != newSeat, "creature=" + getName() + ", seatId=" + Helper::toString(newSeat->getId()));
     setSeat(newSeat);
+    updateSeatCreaturesCount();
     mMoodValue = CreatureMoodLevel::Neutral;
     mMoodPoints = 0;
     mWakefulness = 100;
@@ -22,6 +22,7 @@
 #define CREATURE_H
 
 #include "entities/MovableGameEntity.h"
+#include "utils/TurnArena.h"
 
 #include <OgreVector2.h>
 #include <OgreVector3.h>
@@ -38,10 +39,14 @@ class CreatureDefinition;
 class CreatureOverlayStatus;
 class CreatureSkill;
 class GameMap;
+class MemoryReport;
 class ODPacket;
 class Room;
+class TileVisibilityWork;
 class Weapon;
 
+struct CreatureSaveState;
+
 enum class CreatureActionType;
 enum class CreatureMoodLevel;
 enum class SkillType;
@@ -252,6 +257,17 @@ public:
     //! \brief Computes the visible tiles and tags them to know which are visible
     void computeVisibleTiles();
 
+    //! \brief Returns true if the creature gives vision this turn (it is alive, on map, not KO nor in jail)
+    bool givesVision() const;
+
+    //! \brief Same as updateTilesInSight but uses the given work vectors. Only the creature sight vectors
+    //! are modified so that it can be called for different creatures from several threads at the same time.
+    //! The tile distances must be prepared for the creature sight radius
+    void updateTilesInSight(TileVisibilityWork& work);
+
+    //! \brief Tags the tiles computed by updateTilesInSight as visible for the creature seat
+    void notifyVisibleTiles();
+
     virtual bool isAttackable(Tile* tile, Seat* seat) const override;
 
     double getPhysicalDefense() const;
@@ -266,7 +282,8 @@ public:
     void updateTilesInSight();
 
     //! \brief Loops over the visibleTiles and adds all enemy creatures in each tile to a list which it returns.
-    std::vector<GameEntity*> getVisibleEnemyObjects();
+    //! The list is allocated in the turn arena
+    TurnSpan<GameEntity*> getVisibleEnemyObjects();
 
     //! \brief Loops over objectsToCheck and returns a vector containing all the ones which can be reached via a valid path.
     std::vector<GameEntity*> getReachableAttackableObjects(const std::vector<GameEntity*> &objectsToCheck);
@@ -275,11 +292,12 @@ public:
     std::vector<GameEntity*> getCreaturesFromList(const std::vector<GameEntity*> &objectsToCheck, bool workersOnly);
 
     //! \brief Loops over the visibleTiles and adds all allied creatures in each tile to a list which it returns.
-    std::vector<GameEntity*> getVisibleAlliedObjects();
+    //! The list is allocated in the turn arena
+    TurnSpan<GameEntity*> getVisibleAlliedObjects();
 
     //! \brief Loops over the visibleTiles and returns any creatures in those tiles
     //! allied with the given seat (or if invert is true, does not allied)
-    std::vector<GameEntity*> getVisibleForce(Seat* seat, bool invert);
+    TurnSpan<GameEntity*> getVisibleForce(Seat* seat, bool invert);
 
     //! \brief Conform: GameEntity functions handling covered tiles
     std::vector<Tile*> getCoveredTiles() override;
@@ -330,6 +348,11 @@ public:
     //! \returns A string describing the IO format the creatures need to have in file.
     static std::string getCreatureStreamFormat();
 
+    //! \brief Copies the fields written by Creature::exportToStream (see SaveGameSnapshot)
+    void exportToSaveState(CreatureSaveState& state) const;
+    //! \brief Writes the given state with the format of Creature::exportToStream
+    static void exportSaveStateToStream(const CreatureSaveState& state, std::ostream& os);
+
     //! \brief Get a creature from a stream
     static Creature* getCreatureFromStream(GameMap* gameMap, std::istream& is);
     //! \brief Get a creature from a packet
@@ -398,6 +421,9 @@ public:
     inline const std::vector<Tile*>& getVisibleTiles() const
     { return mVisibleTiles; }
 
+    //! \brief Adds the memory used by the creature action stack and vision vectors to the given report
+    void fillMemoryReport(MemoryReport& report) const;
+
     inline const std::vector<Tile*>& getTilesWithinSightRadius() const
     { return mTilesWithinSightRadius; }
 
@@ -598,6 +624,7 @@ protected:
     virtual void destroyMeshLocal() override;
     virtual void fireAddEntity(Seat* seat, bool async) override;
     virtual void fireRemoveEntity(Seat* seat) override;
+    virtual void onWalkStep(const Ogre::Vector3& position) override;
 private:
     enum ForceAction
     {
@@ -761,6 +788,14 @@ private:
     //! \brief Skills the creature can use
     std::vector<CreatureSkillData> mSkillData;
 
+    //! \brief True between addToGameMap and removeFromGameMap. Used on server side only
+    bool                            mIsCountedInGameMap;
+
+    //! \brief The seat whose creature counters this creature is counted in (nullptr if none) and
+    //! whether it is counted as a worker. Used on server side only
+    Seat*                           mSeatCreaturesCounted;
+    bool                            mIsCountedAsWorker;
+
     //! \brief A sub-function called by doTurn()
     //! This one checks if there is something prioritary to do (like fighting). If it is the case,
     //! it should empty the action list before adding what to do.
@@ -779,6 +814,10 @@ private:
     void computeMood();
 
     void computeCreatureOverlayMoodValue();
+
+    //! \brief Updates the seats creature counters if this creature state changed (alive, seat, ...).
+    //! Should be called each time the creature seat or hp is changed
+    void updateSeatCreaturesCount();
 };
 
 #endif // CREATURE_H
@@ -28,6 +28,7 @@
 #include "rooms/RoomType.h"
 #include "utils/Helper.h"
 #include "utils/LogManager.h"
+#include "utils/TextTokenizer.h"
 
 static CreatureRoomAffinity EMPTY_AFFINITY(RoomType::nullRoomType, 0, 0);
 
@@ -349,7 +350,7 @@ ODPacket& operator>>(ODPacket& is, CreatureDefinition* c)
     return is;
 }
 
-CreatureDefinition* CreatureDefinition::load(std::stringstream& defFile, const std::map<std::string, CreatureDefinition*>& defMap)
+CreatureDefinition* CreatureDefinition::load(TextTokenizer& defFile, const std::map<std::string, CreatureDefinition*>& defMap)
 {
     if (!defFile.good())
         return nullptr;
@@ -365,7 +366,7 @@ CreatureDefinition* CreatureDefinition::load(std::stringstream& defFile, const s
 
 }
 
-bool CreatureDefinition::update(CreatureDefinition* creatureDef, std::stringstream& defFile, const std::map<std::string, CreatureDefinition*>& defMap)
+bool CreatureDefinition::update(CreatureDefinition* creatureDef, TextTokenizer& defFile, const std::map<std::string, CreatureDefinition*>& defMap)
 {
     std::string nextParam;
     bool exit = false;
@@ -1002,7 +1003,7 @@ void CreatureDefinition::writeCreatureDefinitionDiff(
     file << "[/Creature]" << std::endl;
 }
 
-void CreatureDefinition::loadXPTable(std::stringstream& defFile, CreatureDefinition* creatureDef)
+void CreatureDefinition::loadXPTable(TextTokenizer& defFile, CreatureDefinition* creatureDef)
 {
     if (creatureDef == nullptr)
     {
@@ -1042,7 +1043,7 @@ void CreatureDefinition::loadXPTable(std::stringstream& defFile, CreatureDefinit
     }
 }
 
-void CreatureDefinition::loadCreatureSkills(std::stringstream& defFile, CreatureDefinition* creatureDef)
+void CreatureDefinition::loadCreatureSkills(TextTokenizer& defFile, CreatureDefinition* creatureDef)
 {
     if (creatureDef == nullptr)
     {
@@ -1056,13 +1057,12 @@ void CreatureDefinition::loadCreatureSkills(std::stringstream& defFile, Creature
         return;
     }
 
-    std::string nextParam;
+    TextView line;
     // We want to start on the next line
-    std::getline(defFile, nextParam);
-    while (defFile.good())
+    defFile.restOfLine(line);
+    while (defFile.nextLine(line))
     {
-        if(!Helper::readNextLineNotEmpty(defFile, nextParam))
-            break;
+        std::string nextParam = line.toString();
 
         if (nextParam == "[/CreatureSkills]"||
             nextParam == "[/Creature]" || nextParam == "[/Creatures]")
@@ -1082,7 +1082,7 @@ void CreatureDefinition::loadCreatureSkills(std::stringstream& defFile, Creature
     }
 }
 
-void CreatureDefinition::loadCreatureBehaviours(std::stringstream& defFile, CreatureDefinition* creatureDef)
+void CreatureDefinition::loadCreatureBehaviours(TextTokenizer& defFile, CreatureDefinition* creatureDef)
 {
     if (creatureDef == nullptr)
     {
@@ -1096,13 +1096,12 @@ void CreatureDefinition::loadCreatureBehaviours(std::stringstream& defFile, Crea
         return;
     }
 
-    std::string nextParam;
+    TextView line;
     // We want to start on the next line
-    std::getline(defFile, nextParam);
-    while (defFile.good())
+    defFile.restOfLine(line);
+    while (defFile.nextLine(line))
     {
-        if(!Helper::readNextLineNotEmpty(defFile, nextParam))
-            break;
+        std::string nextParam = line.toString();
 
         if (nextParam == "[/CreatureBehaviours]" ||
             nextParam == "[/Creature]" || nextParam == "[/Creatures]")
@@ -1122,7 +1121,7 @@ void CreatureDefinition::loadCreatureBehaviours(std::stringstream& defFile, Crea
     }
 }
 
-void CreatureDefinition::loadCreatureMoods(std::stringstream& defFile, CreatureDefinition* creatureDef)
+void CreatureDefinition::loadCreatureMoods(TextTokenizer& defFile, CreatureDefinition* creatureDef)
 {
     if (creatureDef == nullptr)
     {
@@ -1136,13 +1135,12 @@ void CreatureDefinition::loadCreatureMoods(std::stringstream& defFile, CreatureD
         return;
     }
 
-    std::string nextParam;
+    TextView line;
     // We want to start on the next line
-    std::getline(defFile, nextParam);
-    while (defFile.good())
+    defFile.restOfLine(line);
+    while (defFile.nextLine(line))
     {
-        if(!Helper::readNextLineNotEmpty(defFile, nextParam))
-            break;
+        std::string nextParam = line.toString();
 
         if (nextParam == "[/MoodModifiers]" ||
             nextParam == "[/Creature]" || nextParam == "[/Creatures]")
@@ -1162,7 +1160,7 @@ void CreatureDefinition::loadCreatureMoods(std::stringstream& defFile, CreatureD
     }
 }
 
-void CreatureDefinition::loadRoomAffinity(std::stringstream& defFile, CreatureDefinition* creatureDef)
+void CreatureDefinition::loadRoomAffinity(TextTokenizer& defFile, CreatureDefinition* creatureDef)
 {
     OD_ASSERT_TRUE(creatureDef != nullptr);
     if (creatureDef == nullptr)
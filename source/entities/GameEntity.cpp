@@ -27,6 +27,7 @@
 #include "game/Player.h"
 #include "game/Seat.h"
 #include "gamemap/GameMap.h"
+#include "gamemap/SaveGameSnapshot.h"
 #include "network/ODPacket.h"
 #include "network/ODServer.h"
 #include "network/ServerNotification.h"
@@ -414,19 +415,33 @@ void GameEntity::importFromPacket(ODPacket& is)
 
 void GameEntity::exportToStream(std::ostream& os) const
 {
-    int seatId = -1;
-    if(mSeat != nullptr)
-        seatId = mSeat->getId();
-
-    os << seatId << "\t";
-    os << mName << "\t";
-    os << mMeshName << "\t";
-    os << mPosition.x << "\t" << mPosition.y << "\t" << mPosition.z << "\t";
+    GameEntitySaveState state;
+    exportToSaveState(state);
+    exportSaveStateToStream(state, os);
 
     // We do not export to stream the particle effects. It is the entity work to know if
     // they should be exported or not
 }
 
+void GameEntity::exportToSaveState(GameEntitySaveState& state) const
+{
+    state.mSeatId = -1;
+    if(mSeat != nullptr)
+        state.mSeatId = mSeat->getId();
+
+    state.mName = mName;
+    state.mMeshName = mMeshName;
+    state.mPosition = mPosition;
+}
+
+void GameEntity::exportSaveStateToStream(const GameEntitySaveState& state, std::ostream& os)
+{
+    os << state.mSeatId << "\t";
+    os << state.mName << "\t";
+    os << state.mMeshName << "\t";
+    os << state.mPosition.x << "\t" << state.mPosition.y << "\t" << state.mPosition.z << "\t";
+}
+
 bool GameEntity::importFromStream(std::istream& is)
 {
     int seatId;
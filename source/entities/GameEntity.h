@@ -42,6 +42,8 @@ class Player;
 class Seat;
 class Tile;
 
+struct GameEntitySaveState;
+
 enum class GameEntityType;
 
 namespace EntityParentNodeAttach
@@ -393,6 +395,12 @@ class GameEntity
 
     static void exportToStream(GameEntity* entity, std::ostream& os);
 
+    //! \brief Copies the fields written by GameEntity::exportToStream. Used to save the
+    //! game without formatting the level file on the server thread (see SaveGameSnapshot)
+    void exportToSaveState(GameEntitySaveState& state) const;
+    //! \brief Writes the given state with the format of GameEntity::exportToStream
+    static void exportSaveStateToStream(const GameEntitySaveState& state, std::ostream& os);
+
   protected:
     /*! \brief Exports the headers needed to recreate the entity. For example, for missile objects
      * type cannon, it exports GameEntityType::missileObject and MissileType::oneHit. The content of the
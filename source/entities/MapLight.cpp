@@ -141,11 +141,11 @@ void MapLight::update(Ogre::Real timeSinceLastFrame)
     mThetaY += static_cast<Ogre::Real>(mFactorY * 3.0 * timeSinceLastFrame);
     mThetaZ += static_cast<Ogre::Real>(mFactorZ * 3.0 * timeSinceLastFrame);
 
-    if (Random::Double(0.0, 1.0) < 0.1)
+    if (Random::Double(Random::Stream::client, 0.0, 1.0) < 0.1)
         mFactorX *= -1.0;
-    if (Random::Double(0.0, 1.0) < 0.1)
+    if (Random::Double(Random::Stream::client, 0.0, 1.0) < 0.1)
         mFactorY *= -1.0;
-    if (Random::Double(0.0, 1.0) < 0.1)
+    if (Random::Double(Random::Stream::client, 0.0, 1.0) < 0.1)
         mFactorZ *= -1.0;
 
     Ogre::Vector3 flickerPosition = Ogre::Vector3(sin(mThetaX), sin(mThetaY), sin(mThetaZ));
@@ -48,7 +48,7 @@ bool MissileBoulder::hitCreature(Tile* tile, GameEntity* entity)
         entity->notifyFightPlayer(tile);
 
     ++mNbHits;
-    if(Random::Uint(0, 10 - mNbHits) <= 0)
+    if(Random::Uint(Random::Stream::traps, 0, 10 - mNbHits) <= 0)
         return false;
 
     return true;
@@ -57,10 +57,10 @@ bool MissileBoulder::hitCreature(Tile* tile, GameEntity* entity)
 bool MissileBoulder::wallHitNextDirection(const Ogre::Vector3& actDirection, Tile* tile, Ogre::Vector3& nextDirection)
 {
     // When we hit a wall, we might break
-    if(Random::Uint(1, 2) == 1)
+    if(Random::Uint(Random::Stream::traps, 1, 2) == 1)
         return false;
 
-    if(Random::Uint(1, 2) == 1)
+    if(Random::Uint(Random::Stream::traps, 1, 2) == 1)
     {
         nextDirection.x = actDirection.y;
         nextDirection.y = actDirection.x;
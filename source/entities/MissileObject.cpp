@@ -24,6 +24,7 @@
 #include "entities/Tile.h"
 #include "game/Seat.h"
 #include "gamemap/GameMap.h"
+#include "gamemap/Pathfinding.h"
 #include "network/ODPacket.h"
 #include "utils/Helper.h"
 #include "utils/LogManager.h"
@@ -92,28 +93,42 @@ void MissileObject::doUpkeep()
         return;
     }
 
-    // We check if a creature is in our way. We start by taking the tile we will be on
+    // We walk through the tiles crossed by the missile during this turn, starting by the one it is on
     Ogre::Vector3 position = getPosition();
     double moveDist = getMoveSpeed();
-    Ogre::Vector3 destination;
-    std::list<Tile*> tiles;
-    mIsMissileAlive = computeDestination(position, moveDist, mDirection, destination, tiles);
+    Ogre::Vector3 destination = position + (moveDist * mDirection);
+    Pathfinding::GridTraversal traversal(position.x, position.y, mDirection.x, mDirection.y, moveDist);
 
-    std::vector<Ogre::Vector3> path;
+    mWalkPathWork.clear();
     Tile* lastTile = nullptr;
-    while(!tiles.empty() && mIsMissileAlive)
+    while(true)
     {
-        Tile* tmpTile = tiles.front();
-        tiles.pop_front();
-
+        Tile* tmpTile = getGameMap()->getTile(traversal.getX(), traversal.getY());
         if(tmpTile == nullptr)
         {
-            OD_LOG_ERR("Unexpected null tile when reading missile path name=" + getName() + ", lastTile=" + (lastTile == nullptr ? std::string("nullptr") : Tile::displayAsString(lastTile)));
-            continue;
+            // We got out of the map. We take the last tile as the destination and we can die
+            if(lastTile != nullptr)
+            {
+                destination.x = static_cast<Ogre::Real>(lastTile->getX());
+                destination.y = static_cast<Ogre::Real>(lastTile->getY());
+            }
+            else
+                destination = position;
+
+            mIsMissileAlive = false;
+            break;
         }
 
         if(tmpTile->getFullness() > 0.0)
         {
+            if(lastTile == nullptr)
+            {
+                OD_LOG_ERR("missile name=" + getName() + " is in a wall on tile=" + Tile::displayAsString(tmpTile));
+                destination = position;
+                mIsMissileAlive = false;
+                break;
+            }
+
             Ogre::Vector3 nextDirection;
             OD_LOG_INF("missile name=" + getName() + ", hit wall on tile=" + Tile::displayAsString(tmpTile));
             mIsMissileAlive = wallHitNextDirection(mDirection, lastTile, nextDirection);
@@ -123,30 +138,19 @@ void MissileObject::doUpkeep()
                 destination.y = static_cast<Ogre::Real>(lastTile->getY());
                 break;
             }
-            else
-            {
-                position.x = static_cast<Ogre::Real>(lastTile->getX());
-                position.y = static_cast<Ogre::Real>(lastTile->getY());
-                path.push_back(position);
-                // We compute next position
-                mDirection = nextDirection;
-                mIsMissileAlive = computeDestination(position, moveDist, mDirection, destination, tiles);
-                continue;
-            }
-        }
 
-        if(lastTile != nullptr)
-        {
-            Ogre::Vector3 lastPos;
-            lastPos.x = static_cast<Ogre::Real>(lastTile->getX());
-            lastPos.y = static_cast<Ogre::Real>(lastTile->getY());
-            lastPos.z = position.z;
-            Ogre::Vector3 curPos;
-            curPos.x = static_cast<Ogre::Real>(tmpTile->getX());
-            curPos.y = static_cast<Ogre::Real>(tmpTile->getY());
-            curPos.z = position.z;
-            moveDist -= lastPos.distance(curPos);
+            // The missile goes on from the last tile with the remaining distance
+            moveDist -= traversal.getDistance();
+            position.x = static_cast<Ogre::Real>(lastTile->getX());
+            position.y = static_cast<Ogre::Real>(lastTile->getY());
+            mWalkPathWork.push_back(position);
+            mDirection = nextDirection;
+            destination = position + (moveDist * mDirection);
+            traversal = Pathfinding::GridTraversal(position.x, position.y, mDirection.x, mDirection.y, moveDist);
+            lastTile = nullptr;
+            continue;
         }
+
         lastTile = tmpTile;
 
         // If we are aiming a specific entity, we check if we hit
@@ -165,67 +169,37 @@ void MissileObject::doUpkeep()
             }
         }
 
-        std::vector<Tile*> tileVector;
-        tileVector.push_back(tmpTile);
-        std::vector<GameEntity*> enemyCreatures = getGameMap()->getVisibleCreatures(tileVector, getSeat(), true);
-        for(std::vector<GameEntity*>::iterator it = enemyCreatures.begin(); it != enemyCreatures.end(); ++it)
-        {
-            GameEntity* creature = *it;
-            OD_LOG_INF("missile=" + getName() + " hit creature=" + creature->getName() + ", on tile=" + Tile::displayAsString(tmpTile));
-            if(!hitCreature(tmpTile, creature))
-            {
-                destination -= moveDist * mDirection;
-                mIsMissileAlive = false;
-                break;
-            }
-        }
+        if(!hitCreaturesOnTile(tmpTile, true, destination))
+            mIsMissileAlive = false;
 
-        if(!mDamageAllies || !mIsMissileAlive)
-            continue;
+        if(mDamageAllies && mIsMissileAlive && !hitCreaturesOnTile(tmpTile, false, destination))
+            mIsMissileAlive = false;
 
-        std::vector<GameEntity*> alliedCreatures = getGameMap()->getVisibleCreatures(tileVector, getSeat(), false);
-        for(std::vector<GameEntity*>::iterator it = alliedCreatures.begin(); it != alliedCreatures.end(); ++it)
-        {
-            GameEntity* creature = *it;
-            OD_LOG_INF("missile=" + getName() + " hit creature=" + creature->getName() + ", on tile=" + Tile::displayAsString(tmpTile));
-            if(!hitCreature(tmpTile, creature))
-            {
-                destination -= moveDist * mDirection;
-                mIsMissileAlive = false;
-                break;
-            }
-        }
+        if(!mIsMissileAlive)
+            break;
+
+        if(!traversal.next())
+            break;
     }
 
-    path.push_back(destination);
-    setWalkPath(EntityAnimation::idle_anim, EntityAnimation::idle_anim, true, true, path);
+    mWalkPathWork.push_back(destination);
+    setWalkPath(EntityAnimation::idle_anim, EntityAnimation::idle_anim, true, true, mWalkPathWork);
 }
 
-bool MissileObject::computeDestination(const Ogre::Vector3& position, double moveDist, const Ogre::Vector3& direction,
-        Ogre::Vector3& destination, std::list<Tile*>& tiles)
+bool MissileObject::hitCreaturesOnTile(Tile* tile, bool enemyCreatures, Ogre::Vector3& destination)
 {
-    destination = position + (moveDist * direction);
-    tiles = getGameMap()->tilesBetween(Helper::round(position.x),
-        Helper::round(position.y), Helper::round(destination.x), Helper::round(destination.y));
-    if(tiles.empty())
+    mHitCreaturesWork.clear();
+    tile->fillWithEntities(mHitCreaturesWork, enemyCreatures ? SelectionEntityWanted::creatureAliveEnemyAttackable : SelectionEntityWanted::creatureAliveAllied,
+        getSeat()->getPlayer());
+    for(GameEntity* creature : mHitCreaturesWork)
     {
-        OD_LOG_ERR("missile=" + getName() + " has unexpected empty tiles destination");
-        return false;
-    }
-
-    // If we get out of the map, we take the last tile as the destination
-    if((direction.x > 0.0 && destination.x > static_cast<Ogre::Real>(getGameMap()->getMapSizeX() - 1)) ||
-       (direction.x < 0.0 && destination.x < 0.0) ||
-       (direction.y > 0 && destination.y > static_cast<Ogre::Real>(getGameMap()->getMapSizeY() - 1)) ||
-       (direction.y < 0 && destination.y < 0))
-    {
-        Tile* lastTile = tiles.back();
-        destination.x = static_cast<Ogre::Real>(lastTile->getX());
-        destination.y = static_cast<Ogre::Real>(lastTile->getY());
-
-        // We are in the last position, we can die
-        if(tiles.size() <= 1)
+        OD_LOG_INF("missile=" + getName() + " hit creature=" + creature->getName() + ", on tile=" + Tile::displayAsString(tile));
+        if(!hitCreature(tile, creature))
+        {
+            destination.x = static_cast<Ogre::Real>(tile->getX());
+            destination.y = static_cast<Ogre::Real>(tile->getY());
             return false;
+        }
     }
 
     return true;
@@ -21,6 +21,7 @@
 #include "entities/RenderedMovableEntity.h"
 
 #include <string>
+#include <vector>
 #include <iosfwd>
 
 class Building;
@@ -103,14 +104,20 @@ protected:
     void importFromPacket(ODPacket& is) override;
 
 private:
-    bool computeDestination(const Ogre::Vector3& position, double moveDist, const Ogre::Vector3& direction,
-        Ogre::Vector3& destination, std::list<Tile*>& tiles);
+    //! \brief Calls hitCreature for the enemy (or allied) creatures on the given tile. If one stops the missile,
+    //! destination is set to the tile and false is returned
+    bool hitCreaturesOnTile(Tile* tile, bool enemyCreatures, Ogre::Vector3& destination);
+
     Ogre::Vector3 mDirection;
     bool mIsMissileAlive;
     GameEntity* mEntityTarget;
     bool mDamageAllies;
     bool mKoEnemyCreature;
     double mSpeed;
+
+    //! \brief Work vectors kept from one upkeep to another to avoid allocating memory each turn
+    std::vector<Ogre::Vector3> mWalkPathWork;
+    std::vector<GameEntity*> mHitCreaturesWork;
 };
 
 #endif // MISSILEOBJECT_H
@@ -206,13 +206,35 @@ void MovableGameEntity::setAnimationState(const std::string& state, bool loop, c
     RenderManager::getSingleton().rrSetObjectAnimationState(this, state, loop);
 }
 
-void MovableGameEntity::update(Ogre::Real timeSinceLastFrame)
+double MovableGameEntity::advanceAnimationTime(Ogre::Real timeSinceLastFrame)
 {
-    // Advance the animation
     double addedTime = static_cast<Ogre::Real>(ODApplication::turnsPerSecond
          * static_cast<double>(timeSinceLastFrame)
          * getAnimationSpeedFactor());
     mAnimationTime += addedTime;
+    return addedTime;
+}
+
+bool MovableGameEntity::getNextWalkDestination(Ogre::Vector3& destination) const
+{
+    if(mWalkQueue.empty())
+        return false;
+
+    destination = mWalkQueue.front();
+    return true;
+}
+
+void MovableGameEntity::applyWalkStep(const Ogre::Vector3& position, const Ogre::Vector3& direction)
+{
+    mWalkDirection = direction;
+    GameEntity::setPosition(position);
+    onWalkStep(position);
+}
+
+void MovableGameEntity::update(Ogre::Real timeSinceLastFrame)
+{
+    // Advance the animation
+    double addedTime = advanceAnimationTime(timeSinceLastFrame);
     if (!getIsOnServerMap() && getAnimationState() != nullptr)
     {
         // If the animation has stopped we set it to idle if we have to
@@ -93,6 +93,19 @@ public:
     //! \param timeSinceLastFrame the elapsed time since last displayed frame in seconds.
     virtual void update(Ogre::Real timeSinceLastFrame);
 
+    //! \brief Advances the animation clock and returns the added time. Used by update and
+    //! by the server batched movement step in GameMap::updateAnimations
+    double advanceAnimationTime(Ogre::Real timeSinceLastFrame);
+
+    //! \brief Gets the waypoint the entity is currently walking to. Returns false if the
+    //! entity is not walking
+    bool getNextWalkDestination(Ogre::Vector3& destination) const;
+
+    //! \brief Server side function used by the batched movement step when the entity moves
+    //! without reaching its next waypoint nor leaving its position tile. In this case, there
+    //! is no need to update the tile the entity is on
+    void applyWalkStep(const Ogre::Vector3& position, const Ogre::Vector3& direction);
+
     void setWalkDirection(const Ogre::Vector3& direction);
 
     virtual void setPosition(const Ogre::Vector3& v) override;
@@ -113,6 +126,11 @@ protected:
     virtual void exportToPacket(ODPacket& os, const Seat* seat) const override;
     virtual void importFromPacket(ODPacket& is) override;
 
+    //! \brief Called by applyWalkStep after the position has been changed. Entities that have
+    //! to follow the move (like carried entities) should be updated here as setPosition is not called
+    virtual void onWalkStep(const Ogre::Vector3& position)
+    {}
+
     std::deque<Ogre::Vector3> mWalkQueue;
     std::string mPrevAnimationState;
     bool mPrevAnimationStateLoop;
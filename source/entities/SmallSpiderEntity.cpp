@@ -88,7 +88,7 @@ void SmallSpiderEntity::doUpkeep()
     // We randomly choose some tiles to walk
     int posX = tile->getX();
     int posY = tile->getY();
-    while((Random::Int(1,3) > 1) && (moves.size() < 3))
+    while((Random::Int(Random::Stream::creatures, 1,3) > 1) && (moves.size() < 3))
     {
         std::vector<Tile*> possibleTileMove;
         addTileToListIfPossible(posX - 1, posY, currentCrypt, possibleTileMove);
@@ -104,7 +104,7 @@ void SmallSpiderEntity::doUpkeep()
         if(possibleTileMove.empty())
             break;
 
-        Tile* tileDest = possibleTileMove[Random::Uint(0, possibleTileMove.size() - 1)];
+        Tile* tileDest = possibleTileMove[Random::Uint(Random::Stream::creatures, 0, possibleTileMove.size() - 1)];
         Ogre::Vector3 dest(static_cast<Ogre::Real>(tileDest->getX()), static_cast<Ogre::Real>(tileDest->getY()), 0.0);
         moves.push_back(dest);
         posX = tileDest->getX();
@@ -145,13 +145,13 @@ void SmallSpiderEntity::correctEntityMovePosition(Ogre::Vector3& position)
 {
     static const double offset = 0.3;
     if(position.x > 0)
-        position.x += Random::Double(-offset, offset);
+        position.x += Random::Double(Random::Stream::creatures, -offset, offset);
 
     if(position.y > 0)
-        position.y += Random::Double(-offset, offset);
+        position.y += Random::Double(Random::Stream::creatures, -offset, offset);
 
     if(position.z > 0)
-        position.z += Random::Double(-offset, offset);
+        position.z += Random::Double(Random::Stream::creatures, -offset, offset);
 }
 
 void SmallSpiderEntity::addTileToListIfPossible(int x, int y, Room* currentCrypt, std::vector<Tile*>& possibleTileMove)
@@ -21,10 +21,12 @@
 #include "entities/Building.h"
 #include "entities/Creature.h"
 #include "entities/GameEntityType.h"
+#include "entities/TileEntitySelection.h"
 #include "entities/TreasuryObject.h"
 #include "game/Player.h"
 #include "game/Seat.h"
 #include "gamemap/GameMap.h"
+#include "gamemap/SaveGameSnapshot.h"
 #include "network/ODPacket.h"
 #include "render/RenderManager.h"
 #include "rooms/Room.h"
@@ -33,6 +35,7 @@
 #include "utils/ConfigManager.h"
 #include "utils/Helper.h"
 #include "utils/LogManager.h"
+#include "utils/TextTokenizer.h"
 
 #include <cstddef>
 #include <bitset>
@@ -58,14 +61,22 @@ Tile::Tile(GameMap* gameMap, int x, int y, TileType type, double fullness) :
     mFullness           (fullness),
     mRefundPriceRoom    (0),
     mRefundPriceTrap    (0),
+    mPlayersMarkingTileMask (0),
+    mSeatsMask          (0),
+    mChangedForSeatsMask    (0),
+    mSeatsWithVisionMask    (0),
+    mVisionStamp        (0),
     mCoveringBuilding   (nullptr),
     mClaimedPercentage  (0.0),
+    mClaimedSeatCounted (nullptr),
     mIsRoom             (false),
     mIsTrap             (false),
     mDisplayTileMesh    (true),
     mColorCustomMesh    (true),
     mHasBridge          (false),
     mLocalPlayerHasVision   (false),
+    mMeshRefreshQueued  (false),
+    mLinkMask           (0),
     mTileCulling        (CullingType::HIDE),
     mNbWorkersClaiming(0)
 {
@@ -210,12 +221,30 @@ std::string Tile::getFormat()
 
 void Tile::exportToStream(std::ostream& os) const
 {
-    os << getX() << "\t" << getY() << "\t";
-    os << getType() << "\t" << getFullness();
-    if(getSeat() == nullptr)
+    TileSaveState state;
+    exportToSaveState(state);
+    exportSaveStateToStream(state, os);
+}
+
+void Tile::exportToSaveState(TileSaveState& state) const
+{
+    state.mX = getX();
+    state.mY = getY();
+    state.mType = getType();
+    state.mFullness = getFullness();
+    state.mSeatId = -1;
+    if(getSeat() != nullptr)
+        state.mSeatId = getSeat()->getId();
+}
+
+void Tile::exportSaveStateToStream(const TileSaveState& state, std::ostream& os)
+{
+    os << state.mX << "\t" << state.mY << "\t";
+    os << state.mType << "\t" << state.mFullness;
+    if(state.mSeatId == -1)
         return;
 
-    os << "\t" << getSeat()->getId();
+    os << "\t" << state.mSeatId;
 }
 
 ODPacket& operator<<(ODPacket& os, const TileType& type)
@@ -403,29 +432,34 @@ void Tile::setMarkedForDigging(bool ss, const Player *pp)
 
 bool Tile::getMarkedForDigging(const Player *p) const
 {
-    if(std::find(mPlayersMarkingTile.begin(), mPlayersMarkingTile.end(), p) != mPlayersMarkingTile.end())
-        return true;
+    if((p == nullptr) || (p->getSeat() == nullptr))
+        return false;
 
-    return false;
+    return (mPlayersMarkingTileMask & p->getSeat()->getSeatMask()) != 0;
 }
 
 bool Tile::isMarkedForDiggingByAnySeat()
 {
-    return !mPlayersMarkingTile.empty();
+    return mPlayersMarkingTileMask != 0;
 }
 
 void Tile::addPlayerMarkingTile(const Player *p)
 {
-    mPlayersMarkingTile.push_back(p);
+    if(p->getSeat() == nullptr)
+    {
+        OD_LOG_ERR("tile=" + Tile::displayAsString(this) + ", player=" + p->getNick());
+        return;
+    }
+
+    mPlayersMarkingTileMask |= p->getSeat()->getSeatMask();
 }
 
 void Tile::removePlayerMarkingTile(const Player *p)
 {
-    auto it = std::find(mPlayersMarkingTile.begin(), mPlayersMarkingTile.end(), p);
-    if(it == mPlayersMarkingTile.end())
+    if(p->getSeat() == nullptr)
         return;
 
-    mPlayersMarkingTile.erase(it);
+    mPlayersMarkingTileMask &= ~p->getSeat()->getSeatMask();
 }
 
 void Tile::addNeighbor(Tile *n)
@@ -447,12 +481,7 @@ Tile* Tile::getNeighbor(unsigned int index)
 
 std::string Tile::buildName(int x, int y)
 {
-    std::stringstream ss;
-    ss << TILE_PREFIX;
-    ss << x;
-    ss << "_";
-    ss << y;
-    return ss.str();
+    return TILE_PREFIX + std::to_string(x) + "_" + std::to_string(y);
 }
 
 bool Tile::checkTileName(const std::string& tileName, int& x, int& y)
@@ -682,6 +711,25 @@ void Tile::logFloodFill() const
     OD_LOG_INF(str);
 }
 
+std::size_t Tile::getMemoryUsed() const
+{
+    return sizeof(Tile)
+        + mNeighbors.capacity() * sizeof(Tile*)
+        + mSeatsWithVision.capacity() * sizeof(Seat*)
+        + mEntitiesInTile.capacity() * sizeof(GameEntity*)
+        + mNbWorkersDigging.capacity() * sizeof(uint32_t)
+        + mStateListeners.capacity() * sizeof(TileStateListener*);
+}
+
+std::size_t Tile::getFloodFillMemoryUsed() const
+{
+    std::size_t bytes = mFloodFillColor.capacity() * sizeof(std::vector<uint32_t>);
+    for(const std::vector<uint32_t>& values : mFloodFillColor)
+        bytes += values.capacity() * sizeof(uint32_t);
+
+    return bytes;
+}
+
 bool Tile::isClaimedForSeat(const Seat* seat) const
 {
     if(!isClaimed())
@@ -719,58 +767,67 @@ bool Tile::isClaimed() const
     return true;
 }
 
-void Tile::clearVision()
+void Tile::refreshVisionStamp()
 {
+    uint32_t stamp = getGameMap()->getTilesVisionStamp();
+    if(mVisionStamp == stamp)
+        return;
+
+    mVisionStamp = stamp;
+    mSeatsWithVisionMask = 0;
     mSeatsWithVision.clear();
 }
 
 void Tile::notifyVision(Seat* seat)
 {
-    if(std::find(mSeatsWithVision.begin(), mSeatsWithVision.end(), seat) != mSeatsWithVision.end())
+    refreshVisionStamp();
+
+    // We also notify vision for allied seats
+    uint64_t newSeatsMask = seat->getAlliedSeatsMask() & ~mSeatsWithVisionMask;
+    if(newSeatsMask == 0)
         return;
 
-    seat->notifyVisionOnTile(this);
-    mSeatsWithVision.push_back(seat);
+    mSeatsWithVisionMask |= newSeatsMask;
+    for(Seat* newSeat : getGameMap()->getSeats())
+    {
+        if((newSeatsMask & newSeat->getSeatMask()) == 0)
+            continue;
+
+        newSeat->notifyVisionOnTile(this);
+        mSeatsWithVision.push_back(newSeat);
+    }
+}
 
-    // We also notify vision for allied seats
-    for(Seat* alliedSeat : seat->getAlliedSeats())
-        notifyVision(alliedSeat);
+const std::vector<Seat*>& Tile::getSeatsWithVision()
+{
+    refreshVisionStamp();
+    return mSeatsWithVision;
 }
 
 void Tile::setSeats(const std::vector<Seat*>& seats)
 {
-    mTileChangedForSeats.clear();
+    mSeatsMask = 0;
     for(Seat* seat : seats)
-    {
-        // Every tile should be notified by default
-        std::pair<Seat*, bool> p(seat, true);
-        mTileChangedForSeats.push_back(p);
-    }
+        mSeatsMask |= seat->getSeatMask();
+
+    // Every tile should be notified by default
+    mChangedForSeatsMask = mSeatsMask;
 }
 
 bool Tile::hasChangedForSeat(Seat* seat) const
 {
-    for(const std::pair<Seat*, bool>& seatChanged : mTileChangedForSeats)
+    if((mSeatsMask & seat->getSeatMask()) == 0)
     {
-        if(seatChanged.first != seat)
-            continue;
-
-        return seatChanged.second;
+        OD_LOG_ERR("tile=" + Tile::displayAsString(this) + ", unknown seat id=" + Helper::toString(seat->getId()));
+        return false;
     }
-    OD_LOG_ERR("tile=" + Tile::displayAsString(this) + ", unknown seat id=" + Helper::toString(seat->getId()));
-    return false;
+
+    return (mChangedForSeatsMask & seat->getSeatMask()) != 0;
 }
 
 void Tile::changeNotifiedForSeat(Seat* seat)
 {
-    for(std::pair<Seat*, bool>& seatChanged : mTileChangedForSeats)
-    {
-        if(seatChanged.first != seat)
-            continue;
-
-        seatChanged.second = false;
-        break;
-    }
+    mChangedForSeatsMask &= ~seat->getSeatMask();
 }
 
 void Tile::computeTileVisual()
@@ -902,6 +959,10 @@ void Tile::setFullness(double f)
     double oldFullness = getFullness();
 
     mFullness = f;
+    // Partial digging does not change the tiles layout. Only a tile becoming walkable (or
+    // full again) does
+    if((oldFullness > 0.0) != (mFullness > 0.0))
+        getGameMap()->tileLayoutChanged(this);
 
     // If the tile was marked for digging and has been dug out, unmark it and set its fullness to 0.
     if (mFullness == 0.0 && isMarkedForDiggingByAnySeat())
@@ -920,6 +981,10 @@ void Tile::setFullness(double f)
                 getGameMap()->refreshFloodFill(seat, this);
         }
     }
+
+    // The listeners only care when the tile starts or stops blocking vision
+    if((oldFullness > 0.0) != (mFullness > 0.0))
+        fireTileStateChanged();
 }
 
 void Tile::createMeshLocal()
@@ -962,16 +1027,10 @@ void Tile::setCoveringBuilding(Building *building)
     // We set the tile as dirty for all seats if needed (we have to check because we
     // don't want to refresh tiles for traps for enemy players)
     if(mCoveringBuilding != nullptr)
-    {
-        for(std::pair<Seat*, bool>& seatChanged : mTileChangedForSeats)
-        {
-            if(!mCoveringBuilding->shouldSetCoveringTileDirty(seatChanged.first, this))
-                continue;
+        setDirtyForSeatsIfCoveringBuildingShould();
 
-            seatChanged.second = true;
-        }
-    }
     mCoveringBuilding = building;
+    getGameMap()->tileLayoutChanged(this);
     mIsRoom = false;
     if(getCoveringRoom() != nullptr)
     {
@@ -988,18 +1047,15 @@ void Tile::setCoveringBuilding(Building *building)
 
     if(mCoveringBuilding != nullptr)
     {
-        for(std::pair<Seat*, bool>& seatChanged : mTileChangedForSeats)
-        {
-            if(!mCoveringBuilding->shouldSetCoveringTileDirty(seatChanged.first, this))
-                continue;
-
-            seatChanged.second = true;
-        }
+        setDirtyForSeatsIfCoveringBuildingShould();
 
         // Set the tile as claimed and of the team color of the building
         setSeat(mCoveringBuilding->getSeat());
         mClaimedPercentage = 1.0;
+        updateClaimedTilesCount();
     }
+
+    fireTileStateChanged();
 }
 
 bool Tile::isGroundClaimable(Seat* seat) const
@@ -1090,29 +1146,28 @@ void Tile::updateFromPacket(ODPacket& is)
     fireTileStateChanged();
 }
 
-void Tile::loadFromLine(const std::string& line, Tile *t)
+bool Tile::loadFromLine(const TextView& line, Tile *t)
 {
-    std::vector<std::string> elems = Helper::split(line, '\t');
-
-    int xLocation = Helper::toInt(elems[0]);
-    int yLocation = Helper::toInt(elems[1]);
-
-    std::stringstream tileName("");
-    tileName << TILE_PREFIX;
-    tileName << xLocation;
-    tileName << "_";
-    tileName << yLocation;
+    TextTokenizer tokenizer(line);
+    int xLocation;
+    int yLocation;
+    int tileTypeInt;
+    double fullness;
+    if(!(tokenizer >> xLocation >> yLocation >> tileTypeInt >> fullness))
+    {
+        OD_LOG_ERR("Invalid tile line=" + line.toString());
+        return false;
+    }
 
-    t->setName(tileName.str());
+    t->setName(buildName(xLocation, yLocation));
     t->mX = xLocation;
     t->mY = yLocation;
     t->mPosition = Ogre::Vector3(static_cast<Ogre::Real>(t->mX), static_cast<Ogre::Real>(t->mY), 0.0f);
 
-    TileType tileType = static_cast<TileType>(Helper::toInt(elems[2]));
+    TileType tileType = static_cast<TileType>(tileTypeInt);
     t->setType(tileType);
 
     // If the tile type is lava or water, we ignore fullness
-    double fullness;
     switch(tileType)
     {
         case TileType::water:
@@ -1121,14 +1176,14 @@ void Tile::loadFromLine(const std::string& line, Tile *t)
             break;
 
         default:
-            fullness = Helper::toDouble(elems[3]);
             break;
     }
     t->setFullnessValue(fullness);
 
+    int seatId = 0;
     bool shouldSetSeat = false;
     // We allow to set seat if the tile is dirt (full or not) or if it is gold (ground only)
-    if(elems.size() >= 5)
+    if(tokenizer >> seatId)
     {
         if(tileType == TileType::dirt)
         {
@@ -1144,15 +1199,17 @@ void Tile::loadFromLine(const std::string& line, Tile *t)
     if(!shouldSetSeat)
     {
         t->setSeat(nullptr);
-        return;
+        t->updateClaimedTilesCount();
+        return true;
     }
 
-    int seatId = Helper::toInt(elems[4]);
     Seat* seat = t->getGameMap()->getSeatById(seatId);
     if(seat == nullptr)
-        return;
+        return true;
     t->setSeat(seat);
     t->mClaimedPercentage = 1.0;
+    t->updateClaimedTilesCount();
+    return true;
 }
 
 void Tile::refreshMesh()
@@ -1178,6 +1235,12 @@ void Tile::setSelected(bool ss, const Player* pp)
 
 void Tile::setMarkedForDiggingForAllPlayersExcept(bool s, Seat* exceptSeat)
 {
+    if(!s && (exceptSeat == nullptr))
+    {
+        mPlayersMarkingTileMask = 0;
+        return;
+    }
+
     for (Player* player : getGameMap()->getPlayers())
     {
         if(exceptSeat == nullptr || (player->getSeat() != nullptr && !exceptSeat->isAlliedSeat(player->getSeat())))
@@ -1257,6 +1320,8 @@ void Tile::claimForSeat(Seat* seat, double nDanceRate)
         }
     }
 
+    updateClaimedTilesCount();
+
     if ((getSeat() != nullptr) && (mClaimedPercentage >= 1.0) &&
         (getSeat()->isAlliedSeat(seat)))
     {
@@ -1273,6 +1338,8 @@ void Tile::claimTile(Seat* seat)
     // We need this because if we are a client, the tile may be from a non allied seat
     setSeat(seat);
     mClaimedPercentage = 1.0;
+    updateClaimedTilesCount();
+    getGameMap()->tileLayoutChanged(this);
 
     if(isFullTile())
         fireTileSound(TileSound::ClaimWall);
@@ -1308,6 +1375,8 @@ void Tile::unclaimTile()
 
     setSeat(nullptr);
     mClaimedPercentage = 0.0;
+    updateClaimedTilesCount();
+    getGameMap()->tileLayoutChanged(this);
 
     computeTileVisual();
     setDirtyForAllSeats();
@@ -1327,6 +1396,27 @@ void Tile::unclaimTile()
     fireTileStateChanged();
 }
 
+void Tile::updateClaimedTilesCount()
+{
+    if(!getIsOnServerMap())
+        return;
+
+    Seat* seat = isClaimed() ? getSeat() : nullptr;
+    if(seat == mClaimedSeatCounted)
+        return;
+
+    if(mClaimedSeatCounted != nullptr)
+        mClaimedSeatCounted->notifyClaimedTilesChanged(-1);
+
+    if(seat != nullptr)
+        seat->notifyClaimedTilesChanged(1);
+
+    if((seat == nullptr) != (mClaimedSeatCounted == nullptr))
+        getGameMap()->tileClaimedChanged(this, seat != nullptr);
+
+    mClaimedSeatCounted = seat;
+}
+
 double Tile::digOut(double digRate)
 {
     // We scle dig rate depending on the tile type
@@ -1392,13 +1482,16 @@ double Tile::digOut(double digRate)
     return digRateScaled;
 }
 
-void Tile::fillWithCarryableEntities(Creature* carrier, std::vector<GameEntity*>& entities)
+namespace
 {
-    for(GameEntity* entity : mEntitiesInTile)
+template<typename EntityList>
+void fillWithCarryable(const std::vector<GameEntity*>& entitiesInTile, Tile* tile, Creature* carrier, EntityList& entities)
+{
+    for(GameEntity* entity : entitiesInTile)
     {
         if(entity == nullptr)
         {
-            OD_LOG_ERR("unexpected null entity in tile=" + Tile::displayAsString(this));
+            OD_LOG_ERR("unexpected null entity in tile=" + Tile::displayAsString(tile));
             continue;
         }
 
@@ -1413,6 +1506,17 @@ void Tile::fillWithCarryableEntities(Creature* carrier, std::vector<GameEntity*>
             entities.push_back(entity);
     }
 }
+}
+
+void Tile::fillWithCarryableEntities(Creature* carrier, std::vector<GameEntity*>& entities)
+{
+    fillWithCarryable(mEntitiesInTile, this, carrier, entities);
+}
+
+void Tile::fillWithCarryableEntities(Creature* carrier, TurnVector<GameEntity*>& entities)
+{
+    fillWithCarryable(mEntitiesInTile, this, carrier, entities);
+}
 
 bool Tile::isEntityOnTile(GameEntity* entity) const
 {
@@ -1456,174 +1560,79 @@ uint32_t Tile::countEntitiesOnTile(GameEntityType entityType) const
     return nbItems;
 }
 
-void Tile::fillWithEntities(std::vector<GameEntity*>& entities, SelectionEntityWanted entityWanted, Player* player)
+namespace
 {
-    for(GameEntity* entity : mEntitiesInTile)
+//! \brief Fills entities (a std::vector or a TurnVector) with the entities of entitiesInTile matching entityWanted
+template<typename EntityList>
+void fillWithSelectedEntities(const std::vector<GameEntity*>& entitiesInTile, Tile* tile, Player* player,
+    EntityList& entities, SelectionEntityWanted entityWanted, bool checkDuplicates)
+{
+    using namespace TileEntitySelection;
+    uint32_t nbNullEntities = 0;
+    switch(entityWanted)
     {
-        if(entity == nullptr)
-        {
-            OD_LOG_ERR("unexpected null entity in tile=" + Tile::displayAsString(this));
-            continue;
-        }
-
-        switch(entityWanted)
+        case SelectionEntityWanted::any:
+            nbNullEntities = fillWithFilteredEntities<SelectAny>(entitiesInTile, tile, player, entities, checkDuplicates);
+            break;
+        case SelectionEntityWanted::creatureAliveOwned:
+            nbNullEntities = fillWithFilteredEntities<SelectCreatureAlive<Creature, CreatureOwned>>(entitiesInTile, tile, player, entities, checkDuplicates);
+            break;
+        case SelectionEntityWanted::chicken:
+            nbNullEntities = fillWithFilteredEntities<SelectType<GameEntityType::chickenEntity>>(entitiesInTile, tile, player, entities, checkDuplicates);
+            break;
+        case SelectionEntityWanted::treasuryObjects:
+            nbNullEntities = fillWithFilteredEntities<SelectType<GameEntityType::treasuryObject>>(entitiesInTile, tile, player, entities, checkDuplicates);
+            break;
+        case SelectionEntityWanted::creatureAliveOwnedHurt:
+            nbNullEntities = fillWithFilteredEntities<SelectCreatureAlive<Creature, CreatureOwnedHurt>>(entitiesInTile, tile, player, entities, checkDuplicates);
+            break;
+        case SelectionEntityWanted::creatureAliveAllied:
+            nbNullEntities = fillWithFilteredEntities<SelectCreatureAlive<Creature, CreatureAllied>>(entitiesInTile, tile, player, entities, checkDuplicates);
+            break;
+        case SelectionEntityWanted::creatureAliveEnemy:
+            nbNullEntities = fillWithFilteredEntities<SelectCreatureAlive<Creature, CreatureEnemy>>(entitiesInTile, tile, player, entities, checkDuplicates);
+            break;
+        case SelectionEntityWanted::creatureAlive:
+            nbNullEntities = fillWithFilteredEntities<SelectCreatureAlive<Creature, CreatureAny>>(entitiesInTile, tile, player, entities, checkDuplicates);
+            break;
+        case SelectionEntityWanted::creatureAliveOrDead:
+            nbNullEntities = fillWithFilteredEntities<SelectType<GameEntityType::creature>>(entitiesInTile, tile, player, entities, checkDuplicates);
+            break;
+        case SelectionEntityWanted::creatureAliveInOwnedPrisonHurt:
+            nbNullEntities = fillWithFilteredEntities<SelectCreatureAlive<Creature, CreatureInOwnedPrison>>(entitiesInTile, tile, player, entities, checkDuplicates);
+            break;
+        case SelectionEntityWanted::creatureAliveEnemyAttackable:
+            nbNullEntities = fillWithFilteredEntities<SelectCreatureAlive<Creature, CreatureEnemyAttackable>>(entitiesInTile, tile, player, entities, checkDuplicates);
+            break;
+        default:
         {
-            case SelectionEntityWanted::any:
-            {
-                // We accept any entity
-                break;
-            }
-            case SelectionEntityWanted::creatureAliveOwned:
-            {
-                if(entity->getObjectType() != GameEntityType::creature)
-                    continue;
-
-                if(player->getSeat() != entity->getSeat())
-                    continue;
-
-                Creature* creature = static_cast<Creature*>(entity);
-                if(!creature->isAlive())
-                    continue;
-
-                break;
-            }
-            case SelectionEntityWanted::chicken:
-            {
-                if(entity->getObjectType() != GameEntityType::chickenEntity)
-                    continue;
-
-                break;
-            }
-            case SelectionEntityWanted::treasuryObjects:
-            {
-                if(entity->getObjectType() != GameEntityType::treasuryObject)
-                    continue;
-
-                break;
-            }
-            case SelectionEntityWanted::creatureAliveOwnedHurt:
-            {
-                if(entity->getObjectType() != GameEntityType::creature)
-                    continue;
-
-                if(player->getSeat() != entity->getSeat())
-                    continue;
-
-                Creature* creature = static_cast<Creature*>(entity);
-                if(!creature->isAlive())
-                    continue;
-
-                if(!creature->isHurt())
-                    continue;
-
-                break;
-            }
-            case SelectionEntityWanted::creatureAliveAllied:
-            {
-                if(entity->getObjectType() != GameEntityType::creature)
-                    continue;
-
-                if(entity->getSeat() == nullptr)
-                    continue;
-
-                if(!player->getSeat()->isAlliedSeat(entity->getSeat()))
-                    continue;
-
-                Creature* creature = static_cast<Creature*>(entity);
-                if(!creature->isAlive())
-                    continue;
-
-                break;
-            }
-            case SelectionEntityWanted::creatureAliveEnemy:
-            {
-                if(entity->getObjectType() != GameEntityType::creature)
-                    continue;
-
-                if(entity->getSeat() == nullptr)
-                    continue;
-
-                if(player->getSeat()->isAlliedSeat(entity->getSeat()))
-                    continue;
-
-                Creature* creature = static_cast<Creature*>(entity);
-                if(!creature->isAlive())
-                    continue;
-
-                break;
-            }
-            case SelectionEntityWanted::creatureAlive:
+            static bool logMsg = false;
+            if(!logMsg)
             {
-                if(entity->getObjectType() != GameEntityType::creature)
-                    continue;
-
-                Creature* creature = static_cast<Creature*>(entity);
-                if(!creature->isAlive())
-                    continue;
-
-                break;
-            }
-            case SelectionEntityWanted::creatureAliveOrDead:
-            {
-                if(entity->getObjectType() != GameEntityType::creature)
-                    continue;
-
-                break;
-            }
-            case SelectionEntityWanted::creatureAliveInOwnedPrisonHurt:
-            {
-                if(entity->getObjectType() != GameEntityType::creature)
-                    continue;
-
-                Creature* creature = static_cast<Creature*>(entity);
-                if(!creature->isAlive())
-                    continue;
-
-                if(!creature->isInPrison())
-                    continue;
-
-                if(!creature->getSeatPrison()->canOwnedCreatureBePickedUpBy(player->getSeat()))
-                    continue;
-
-                break;
-            }
-            case SelectionEntityWanted::creatureAliveEnemyAttackable:
-            {
-                if(entity->getObjectType() != GameEntityType::creature)
-                    continue;
-
-                if(entity->getSeat() == nullptr)
-                    continue;
-
-                if(player->getSeat()->isAlliedSeat(entity->getSeat()))
-                    continue;
-
-                Creature* creature = static_cast<Creature*>(entity);
-                if(!creature->isAlive())
-                    continue;
-
-                if(!creature->isAttackable(this, player->getSeat()))
-                    continue;
-
-                break;
-            }
-            default:
-            {
-                static bool logMsg = false;
-                if(!logMsg)
-                {
-                    logMsg = true;
-                    OD_LOG_ERR("Wrong SelectionEntityWanted int=" + Helper::toString(static_cast<uint32_t>(entityWanted)));
-                }
-                continue;
+                logMsg = true;
+                OD_LOG_ERR("Wrong SelectionEntityWanted int=" + Helper::toString(static_cast<uint32_t>(entityWanted)));
             }
+            break;
         }
+    }
 
-        if (std::find(entities.begin(), entities.end(), entity) != entities.end())
-            continue;
+    if(nbNullEntities > 0)
+        OD_LOG_ERR("unexpected null entity in tile=" + Tile::displayAsString(tile));
+}
+}
 
-        entities.push_back(entity);
-    }
+void Tile::fillWithEntities(std::vector<GameEntity*>& entities, SelectionEntityWanted entityWanted, Player* player,
+    bool checkDuplicates)
+{
+    // The filter is chosen once for the whole tile. Then, the loop over the entities only
+    // runs the checks of the wanted selection
+    fillWithSelectedEntities(mEntitiesInTile, this, player, entities, entityWanted, checkDuplicates);
+}
+
+void Tile::fillWithEntities(TurnVector<GameEntity*>& entities, SelectionEntityWanted entityWanted, Player* player,
+    bool checkDuplicates)
+{
+    fillWithSelectedEntities(mEntitiesInTile, this, player, entities, entityWanted, checkDuplicates);
 }
 
 bool Tile::addTreasuryObject(TreasuryObject* obj)
@@ -1733,15 +1742,32 @@ void Tile::setDirtyForAllSeats()
     if(!getIsOnServerMap())
         return;
 
-    for(std::pair<Seat*, bool>& seatChanged : mTileChangedForSeats)
-        seatChanged.second = true;
+    mChangedForSeatsMask = mSeatsMask;
+}
+
+void Tile::setDirtyForSeatsIfCoveringBuildingShould()
+{
+    if(mSeatsMask == 0)
+        return;
+
+    for(Seat* seat : getGameMap()->getSeats())
+    {
+        if((mSeatsMask & seat->getSeatMask()) == 0)
+            continue;
+
+        if(!mCoveringBuilding->shouldSetCoveringTileDirty(seat, this))
+            continue;
+
+        mChangedForSeatsMask |= seat->getSeatMask();
+    }
 }
 
 void Tile::notifyEntitiesSeatsWithVision()
 {
+    const std::vector<Seat*>& seatsWithVision = getSeatsWithVision();
     for(GameEntity* entity : mEntitiesInTile)
     {
-        entity->notifySeatsWithVision(mSeatsWithVision);
+        entity->notifySeatsWithVision(seatsWithVision);
     }
 }
 
@@ -1863,15 +1889,16 @@ bool Tile::removeWorkerClaiming(const Creature& worker)
     return true;
 }
 
-void Tile::canWorkerDig(const Creature& worker, std::vector<Tile*>& tiles)
+TurnSpan<Tile*> Tile::canWorkerDig(const Creature& worker)
 {
     Tile* myTile = worker.getPositionTile();
     if (myTile == nullptr)
     {
         OD_LOG_ERR("worker=" + worker.getName() + ", pos=" + Helper::toString(worker.getPosition()));
-        return;
+        return TurnSpan<Tile*>();
     }
 
+    TurnVector<Tile*> tiles(getGameMap()->getTurnArena(), mNeighbors.size());
     for(uint32_t i = 0; i < mNeighbors.size(); ++i)
     {
         Tile* neigh = mNeighbors[i];
@@ -1899,6 +1926,8 @@ void Tile::canWorkerDig(const Creature& worker, std::vector<Tile*>& tiles)
 
         tiles.push_back(neigh);
     }
+
+    return tiles.span();
 }
 
 bool Tile::addWorkerDigging(const Creature& worker, Tile& tile)
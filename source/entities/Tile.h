@@ -19,6 +19,7 @@
 #define TILE_H
 
 #include "entities/GameEntity.h"
+#include "utils/TurnArena.h"
 
 #include <OgreVector3.h>
 
@@ -42,6 +43,9 @@ class CraftedTrap;
 class BuildingObject;
 class PersistentObject;
 class ODPacket;
+class TextView;
+
+struct TileSaveState;
 
 enum class RoomType;
 enum class SelectionEntityWanted;
@@ -230,6 +234,20 @@ public:
     inline bool getLocalPlayerHasVision() const
     { return mLocalPlayerHasVision; }
 
+    //! \brief Used on client side by GameMap to know if the tile is already waiting for its mesh to be refreshed
+    inline void setMeshRefreshQueued(bool meshRefreshQueued)
+    { mMeshRefreshQueued = meshRefreshQueued; }
+
+    inline bool getMeshRefreshQueued() const
+    { return mMeshRefreshQueued; }
+
+    //! \brief Used on client side by GameMap to cache the tileset links with the neighbour tiles (see GameMap::updateTileLinkMask)
+    inline void setLinkMask(uint8_t linkMask)
+    { mLinkMask = linkMask; }
+
+    inline uint8_t getLinkMask() const
+    { return mLinkMask; }
+
     //! \brief Set/unset the value of the mask depending on boolean value
     void setTileCullingFlags(uint32_t mask, bool value);
 
@@ -327,8 +345,8 @@ public:
 
     static std::string getFormat();
 
-    //! \brief Loads the tile data from a level line.
-    static void loadFromLine(const std::string& line, Tile *t);
+    //! \brief Loads the tile data from a level line. Returns false if the line is invalid
+    static bool loadFromLine(const TextView& line, Tile *t);
 
     /*! \brief This is a helper function which just converts the tile type enum into a string.
      *
@@ -358,17 +376,23 @@ public:
 
     //! \brief fills the given vector with the carryable entities on this tile
     void fillWithCarryableEntities(Creature* carrier, std::vector<GameEntity*>& entities);
+    void fillWithCarryableEntities(Creature* carrier, TurnVector<GameEntity*>& entities);
     uint32_t countEntitiesOnTile(GameEntityType entityType) const;
 
     //! \brief Returns true if the given entity is on the tile and false otherwise
     bool isEntityOnTile(GameEntity* entity) const;
 
-    //! Fills the given vector with corresponding entities on this tile.
-    void fillWithEntities(std::vector<GameEntity*>& entities, SelectionEntityWanted entityWanted, Player* player);
+    //! Fills the given vector with corresponding entities on this tile. If checkDuplicates is true, entities
+    //! already in the vector are not added again. Since an entity is only on one tile, it can be set to false
+    //! when filling the vector from a list of distinct tiles
+    void fillWithEntities(std::vector<GameEntity*>& entities, SelectionEntityWanted entityWanted, Player* player,
+        bool checkDuplicates = true);
+    void fillWithEntities(TurnVector<GameEntity*>& entities, SelectionEntityWanted entityWanted, Player* player,
+        bool checkDuplicates = true);
 
     //! \brief Computes the visible tiles and tags them to know which are visible
     void computeVisibleTiles();
-    void clearVision();
+    //! \brief Gives vision on this tile to the given seat and its allies
     void notifyVision(Seat* seat);
 
     void setSeats(const std::vector<Seat*>& seats);
@@ -377,8 +401,7 @@ public:
 
     void notifyEntitiesSeatsWithVision();
 
-    const std::vector<Seat*>& getSeatsWithVision()
-    { return mSeatsWithVision; }
+    const std::vector<Seat*>& getSeatsWithVision();
 
     void resetFloodFill();
 
@@ -399,6 +422,12 @@ public:
 
     void logFloodFill() const;
 
+    //! \brief Returns the memory used by the tile object and its containers (flood fill values excepted)
+    std::size_t getMemoryUsed() const;
+
+    //! \brief Returns the memory used by the flood fill values of the tile
+    std::size_t getFloodFillMemoryUsed() const;
+
     bool isFloodFillFilled(Seat* seat) const;
 
     //! \brief Returns true if the given type can be set for the current tile
@@ -450,14 +479,19 @@ public:
     bool canWorkerClaim(const Creature& worker);
     bool addWorkerClaiming(const Creature& worker);
     bool removeWorkerClaiming(const Creature& worker);
-    //! \brief Feels the tile vector with the available tiles the worker can
-    //! go to
-    void canWorkerDig(const Creature& worker, std::vector<Tile*>& tiles);
+    //! \brief Returns the neighbor tiles the worker can go to for digging this tile. The list is
+    //! allocated in the turn arena (see GameMap::getTurnArena)
+    TurnSpan<Tile*> canWorkerDig(const Creature& worker);
     bool addWorkerDigging(const Creature& worker, Tile& tile);
     bool removeWorkerDigging(const Creature& worker, Tile& tile);
 
     static void exportToStream(Tile* tile, std::ostream& os);
 
+    //! \brief Copies the fields written by Tile::exportToStream (see SaveGameSnapshot)
+    void exportToSaveState(TileSaveState& state) const;
+    //! \brief Writes the given state with the format of Tile::exportToStream
+    static void exportSaveStateToStream(const TileSaveState& state, std::ostream& os);
+
     virtual void exportToPacketForUpdate(ODPacket& os, const Seat* seat) const override;
     virtual void updateFromPacket(ODPacket& is) override;
     void exportToPacketForUpdate(ODPacket& os, const Seat* seat, bool hideSeatId) const;
@@ -465,6 +499,10 @@ public:
     bool addTileStateListener(TileStateListener& listener);
     bool removeTileStateListener(TileStateListener& listener);
 
+    //! \brief Notifies the listeners that something changed on this tile. Should be called by entities when
+    //! a change not visible from the tile itself happens (like a door being locked)
+    void fireTileStateChanged();
+
 protected:
     virtual void exportHeadersToStream(std::ostream& os) const override
     {}
@@ -506,8 +544,14 @@ private:
     uint32_t mRefundPriceTrap;
 
     std::vector<Tile*> mNeighbors;
-    std::vector<const Player*> mPlayersMarkingTile;
-    std::vector<std::pair<Seat*, bool>> mTileChangedForSeats;
+    //! \brief Bitmasks indexed by Seat::getSeatIndex. The players marking the tile are represented by their seat
+    uint64_t mPlayersMarkingTileMask;
+    //! \brief Seats set with setSeats and seats for which the tile changed since last notified
+    uint64_t mSeatsMask;
+    uint64_t mChangedForSeatsMask;
+    //! \brief Seats with vision on the tile. Only valid if mVisionStamp is the gamemap vision stamp
+    uint64_t mSeatsWithVisionMask;
+    uint32_t mVisionStamp;
     std::vector<Seat*> mSeatsWithVision;
 
     //! \brief List of the entities actually on this tile. Most of the creatures actions will rely on this list
@@ -520,6 +564,11 @@ private:
     //! \brief The tile claiming. Used on server side only
     double mClaimedPercentage;
 
+    //! \brief The seat this tile is currently counted as claimed for (nullptr if none). Allows to update the
+    //! seats claimed tiles counters when the tile state changes instead of counting them every turn.
+    //! Used on server side only
+    Seat* mClaimedSeatCounted;
+
     //! \brief True if a building is on this tile. False otherwise. It is used on client side because the clients do not know about
     //! buildings. However, it needs to know the tiles where a building is to display the room/trap costs.
     bool mIsRoom;
@@ -534,6 +583,13 @@ private:
     //! \brief Used on client side. true if the local player has vision, false otherwise.
     bool mLocalPlayerHasVision;
 
+    //! \brief Used on client side. true if the tile is in the GameMap queue of tiles to refresh.
+    bool mMeshRefreshQueued;
+
+    //! \brief Used on client side. Bit i is set if the tile is linked (according to the tileset) with its
+    //! neighbour in direction i (0 = y-1, 1 = x+1, 2 = y+1, 3 = x-1). Used as index in the tileset values
+    uint8_t mLinkMask;
+
     uint32_t mTileCulling;
 
     /*! \brief Set the fullness value for the tile.
@@ -545,13 +601,21 @@ private:
 
     void setDirtyForAllSeats();
 
+    //! \brief Updates the claimed tiles counter of the seats if the claimed state of this tile changed.
+    //! Should be called each time the tile seat or its claimed percentage is changed
+    void updateClaimedTilesCount();
+
+    //! \brief Resets the seats with vision if they were computed for an older gamemap vision stamp
+    void refreshVisionStamp();
+
+    //! \brief Sets the tile as changed for the seats the covering building asks to
+    void setDirtyForSeatsIfCoveringBuildingShould();
+
     //! \brief Vector with the number of workers digging the tile. The index corresponds
     //! to the index in mNeighbors
     std::vector<uint32_t> mNbWorkersDigging;
     uint32_t mNbWorkersClaiming;
     std::vector<TileStateListener*> mStateListeners;
-
-    void fireTileStateChanged();
 };
 
 #endif // TILE_H
@@ -0,0 +1,144 @@
+/*
+ *  Copyright (C) 2011-2016  OpenDungeons Team
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef TILEENTITYSELECTION_H
+#define TILEENTITYSELECTION_H
+
+#include "entities/GameEntityType.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+
+//! \brief Compile time filters used by Tile::fillWithEntities. Each one has a static accept function telling
+//! if the given entity is wanted. The entity type is always checked first since it is the cheapest test.
+//! They are templates on the entity, tile and player types so that they can be checked with light stubs
+namespace TileEntitySelection
+{
+struct SelectAny
+{
+    template<typename Entity, typename TileT, typename PlayerT>
+    static inline bool accept(Entity*, TileT*, PlayerT*)
+    { return true; }
+};
+
+template<GameEntityType Type>
+struct SelectType
+{
+    template<typename Entity, typename TileT, typename PlayerT>
+    static inline bool accept(Entity* entity, TileT*, PlayerT*)
+    { return entity->getObjectType() == Type; }
+};
+
+//! \brief Alive creatures also matching the given filter
+template<typename CreatureT, typename CreatureFilter>
+struct SelectCreatureAlive
+{
+    template<typename Entity, typename TileT, typename PlayerT>
+    static inline bool accept(Entity* entity, TileT* tile, PlayerT* player)
+    {
+        if(entity->getObjectType() != GameEntityType::creature)
+            return false;
+
+        CreatureT* creature = static_cast<CreatureT*>(entity);
+        return creature->isAlive() && CreatureFilter::accept(creature, tile, player);
+    }
+};
+
+struct CreatureAny
+{
+    template<typename CreatureT, typename TileT, typename PlayerT>
+    static inline bool accept(CreatureT*, TileT*, PlayerT*)
+    { return true; }
+};
+
+struct CreatureOwned
+{
+    template<typename CreatureT, typename TileT, typename PlayerT>
+    static inline bool accept(CreatureT* creature, TileT*, PlayerT* player)
+    { return player->getSeat() == creature->getSeat(); }
+};
+
+struct CreatureOwnedHurt
+{
+    template<typename CreatureT, typename TileT, typename PlayerT>
+    static inline bool accept(CreatureT* creature, TileT*, PlayerT* player)
+    { return (player->getSeat() == creature->getSeat()) && creature->isHurt(); }
+};
+
+struct CreatureAllied
+{
+    template<typename CreatureT, typename TileT, typename PlayerT>
+    static inline bool accept(CreatureT* creature, TileT*, PlayerT* player)
+    { return (creature->getSeat() != nullptr) && player->getSeat()->isAlliedSeat(creature->getSeat()); }
+};
+
+struct CreatureEnemy
+{
+    template<typename CreatureT, typename TileT, typename PlayerT>
+    static inline bool accept(CreatureT* creature, TileT*, PlayerT* player)
+    { return (creature->getSeat() != nullptr) && !player->getSeat()->isAlliedSeat(creature->getSeat()); }
+};
+
+struct CreatureEnemyAttackable
+{
+    template<typename CreatureT, typename TileT, typename PlayerT>
+    static inline bool accept(CreatureT* creature, TileT* tile, PlayerT* player)
+    { return CreatureEnemy::accept(creature, tile, player) && creature->isAttackable(tile, player->getSeat()); }
+};
+
+struct CreatureInOwnedPrison
+{
+    template<typename CreatureT, typename TileT, typename PlayerT>
+    static inline bool accept(CreatureT* creature, TileT*, PlayerT* player)
+    { return creature->isInPrison() && creature->getSeatPrison()->canOwnedCreatureBePickedUpBy(player->getSeat()); }
+};
+
+//! \brief Adds the entities of entitiesInTile accepted by Filter to entities (a std::vector or a TurnVector).
+//! Entities on a tile are unique. Thus, we only have to check for duplicates against the entities that were
+//! in the vector before the call. Returns the number of null entities found (they are skipped)
+template<typename Filter, typename Entity, typename TileT, typename PlayerT, typename EntityList>
+uint32_t fillWithFilteredEntities(const std::vector<Entity*>& entitiesInTile, TileT* tile, PlayerT* player,
+    EntityList& entities, bool checkDuplicates)
+{
+    uint32_t nbNullEntities = 0;
+    std::size_t nbEntitiesBefore = checkDuplicates ? entities.size() : 0;
+    for(Entity* entity : entitiesInTile)
+    {
+        if(entity == nullptr)
+        {
+            ++nbNullEntities;
+            continue;
+        }
+
+        if(!Filter::accept(entity, tile, player))
+            continue;
+
+        if((nbEntitiesBefore > 0) &&
+           (std::find(entities.begin(), entities.begin() + nbEntitiesBefore, entity) != entities.begin() + nbEntitiesBefore))
+        {
+            continue;
+        }
+
+        entities.push_back(entity);
+    }
+
+    return nbNullEntities;
+}
+}
+
+#endif // TILEENTITYSELECTION_H
@@ -22,11 +22,12 @@
 #include "utils/ConfigManager.h"
 #include "utils/Helper.h"
 #include "utils/LogManager.h"
+#include "utils/TextTokenizer.h"
 
 #include <sstream>
 #include <fstream>
 
-Weapon* Weapon::load(std::stringstream& defFile)
+Weapon* Weapon::load(TextTokenizer& defFile)
 {
     if (!defFile.good())
         return nullptr;
@@ -39,7 +40,7 @@ Weapon* Weapon::load(std::stringstream& defFile)
     }
     return weapon;
 }
-bool Weapon::update(Weapon* weapon, std::stringstream& defFile)
+bool Weapon::update(Weapon* weapon, TextTokenizer& defFile)
 {
     std::string nextParam;
     bool exit = false;
@@ -162,7 +163,7 @@ bool Weapon::update(Weapon* weapon, std::stringstream& defFile)
     return true;
 }
 
-void Weapon::writeWeaponDiff(const Weapon* def1, const Weapon* def2, std::ofstream& file)
+void Weapon::writeWeaponDiff(const Weapon* def1, const Weapon* def2, std::ostream& file)
 {
     file << "[Equipment]" << std::endl;
     file << "    Name\t" << def2->mName << std::endl;
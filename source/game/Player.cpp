@@ -372,9 +372,8 @@ void Player::notifyNoMoreDungeonTemple()
 
     // We check if there is still a player in the team with a dungeon temple. If yes, we notify the player he lost his dungeon
     // if no, we notify the team they lost
-    std::vector<Room*> dungeonTemples = mGameMap->getRoomsByType(RoomType::dungeonTemple);
     bool hasTeamLost = true;
-    for(Room* dungeonTemple : dungeonTemples)
+    for(Room* dungeonTemple : mGameMap->getRoomsByType(RoomType::dungeonTemple))
     {
         if(getSeat()->isAlliedSeat(dungeonTemple->getSeat()))
         {
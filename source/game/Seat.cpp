@@ -27,6 +27,7 @@
 #include "game/SkillManager.h"
 #include "game/SkillType.h"
 #include "gamemap/GameMap.h"
+#include "gamemap/SaveGameSnapshot.h"
 #include "goals/Goal.h"
 #include "network/ODServer.h"
 #include "network/ServerNotification.h"
@@ -42,6 +43,7 @@
 #include "utils/Helper.h"
 #include "utils/LogManager.h"
 #include "utils/Random.h"
+#include "utils/TextTokenizer.h"
 
 #include <istream>
 #include <ostream>
@@ -71,8 +73,11 @@ Seat::Seat(GameMap* gameMap) :
     mGameMap(gameMap),
     mPlayer(nullptr),
     mGoldMined(0),
+    mStartingGold(0),
     mDefaultWorkerClass(nullptr),
     mTeamIndex(0),
+    mSeatIndex(0),
+    mAlliedSeatsMask(1),
     mIsDebuggingVision(false),
     mSkillPoints(0),
     mCurrentSkill(nullptr),
@@ -223,6 +228,7 @@ bool Seat::canBuildingBeDestroyedBy(const Seat* seat) const
 void Seat::addAlliedSeat(Seat* seat)
 {
     mAlliedSeats.push_back(seat);
+    mAlliedSeatsMask |= seat->getSeatMask();
 }
 
 void Seat::clearTilesWithVision()
@@ -232,13 +238,20 @@ void Seat::clearTilesWithVision()
     if(!mPlayer->getIsHuman())
         return;
 
-    for(std::vector<TileStateNotified>& vec : mTilesStates)
+    // Chunks where the seat had no vision last turn nor this turn do not need to be updated
+    int nbChunks = mTilesStates.getNbChunks();
+    for(int chunkIndex = 0; chunkIndex < nbChunks; ++chunkIndex)
     {
-        for(TileStateNotified& p : vec)
+        if((mNbTilesVisionCurrent[chunkIndex] == 0) && (mNbTilesVisionLast[chunkIndex] == 0))
+            continue;
+
+        mTilesStates.forEachInChunk(chunkIndex, [](int, int, TileStateNotified& tileState)
         {
-            p.mVisionTurnLast = p.mVisionTurnCurrent;
-            p.mVisionTurnCurrent = false;
-        }
+            tileState.mVisionTurnLast = tileState.mVisionTurnCurrent;
+            tileState.mVisionTurnCurrent = false;
+        });
+        mNbTilesVisionLast[chunkIndex] = mNbTilesVisionCurrent[chunkIndex];
+        mNbTilesVisionCurrent[chunkIndex] = 0;
     }
 }
 
@@ -249,19 +262,11 @@ void Seat::notifyVisionOnTile(Tile* tile)
     if(!mPlayer->getIsHuman())
         return;
 
-    if(tile->getX() >= static_cast<int>(mTilesStates.size()))
-    {
-        OD_LOG_ERR("Tile=" + Tile::displayAsString(tile));
+    TileStateNotified* tileStateNotified = getTileState(tile);
+    if(tileStateNotified == nullptr)
         return;
-    }
-    if(tile->getY() >= static_cast<int>(mTilesStates[tile->getX()].size()))
-    {
-        OD_LOG_ERR("Tile=" + Tile::displayAsString(tile));
-        return;
-    }
 
-    TileStateNotified& tileState = mTilesStates[tile->getX()][tile->getY()];
-    tileState.mVisionTurnCurrent = true;
+    setTileVisionCurrent(tile, *tileStateNotified);
 }
 
 void Seat::notifyTileClaimedByEnemy(Tile* tile)
@@ -271,23 +276,16 @@ void Seat::notifyTileClaimedByEnemy(Tile* tile)
     if(!mPlayer->getIsHuman())
         return;
 
-    if(tile->getX() >= static_cast<int>(mTilesStates.size()))
-    {
-        OD_LOG_ERR("Tile=" + Tile::displayAsString(tile));
+    TileStateNotified* tileStateNotified = getTileState(tile);
+    if(tileStateNotified == nullptr)
         return;
-    }
-    if(tile->getY() >= static_cast<int>(mTilesStates[tile->getX()].size()))
-    {
-        OD_LOG_ERR("Tile=" + Tile::displayAsString(tile));
-        return;
-    }
 
-    TileStateNotified& tileState = mTilesStates[tile->getX()][tile->getY()];
+    TileStateNotified& tileState = *tileStateNotified;
 
     // By default, we set the tile like if it was not claimed anymore
     tileState.mSeatIdOwner = -1;
     tileState.mTileVisual = TileVisual::dirtGround;
-    tileState.mVisionTurnCurrent = true;
+    setTileVisionCurrent(tile, tileState);
 }
 
 const std::string Seat::getFactionFromLine(const std::string& line)
@@ -344,18 +342,12 @@ bool Seat::hasVisionOnTile(Tile* tile)
     if(!mPlayer->getIsHuman())
         return true;
 
-    if(tile->getX() >= static_cast<int>(mTilesStates.size()))
-    {
-        OD_LOG_ERR("Tile=" + Tile::displayAsString(tile));
-        return false;
-    }
-    if(tile->getY() >= static_cast<int>(mTilesStates[tile->getX()].size()))
-    {
-        OD_LOG_ERR("Tile=" + Tile::displayAsString(tile));
+    TileStateNotified defaultTileState;
+    const TileStateNotified* tileStateNotified = findTileState(tile, defaultTileState);
+    if(tileStateNotified == nullptr)
         return false;
-    }
 
-    TileStateNotified& stateTile = mTilesStates[tile->getX()][tile->getY()];
+    TileStateNotified& stateTile = *tileStateNotified;
 
     return stateTile.mVisionTurnCurrent;
 }
@@ -450,17 +442,13 @@ void Seat::initSeat()
 
                 // We set the tile visual to make sure the tile state is exported if
                 // game is saved again
-                if(tile->getX() >= static_cast<int>(mTilesStates.size()))
-                {
-                    OD_LOG_ERR("Tile=" + Tile::displayAsString(tile));
+                TileStateNotified* tileStateNotified = getTileState(tile);
+                if(tileStateNotified == nullptr)
                     continue;
-                }
-                if(tile->getY() >= static_cast<int>(mTilesStates[tile->getX()].size()))
-                {
-                    OD_LOG_ERR("Tile=" + Tile::displayAsString(tile));
-                    continue;
-                }
-                mTilesStates[tile->getX()][tile->getY()] = tileState;
+
+                tileStateNotified->mTileVisual = tileState.mTileVisual;
+                tileStateNotified->mSeatIdOwner = tileState.mSeatIdOwner;
+                tileStateNotified->mMarkedForDigging = tileState.mMarkedForDigging;
 
                 // Then, we export tile state to the client
                 mGameMap->tileToPacket(serverNotification->mPacket, tile);
@@ -480,33 +468,85 @@ void Seat::setMapSize(int x, int y)
     if(!mPlayer->getIsHuman())
         return;
 
-    mTilesStates = std::vector<std::vector<TileStateNotified>>(x, std::vector<TileStateNotified>(y));
+    // The tile states are allocated by chunks when first needed (see getTileState)
+    mTilesStates.reset(x, y);
+    mNbTilesVisionCurrent.assign(mTilesStates.getNbChunks(), 0);
+    mNbTilesVisionLast.assign(mTilesStates.getNbChunks(), 0);
+}
+
+void Seat::initTileState(int x, int y, TileStateNotified& tileState) const
+{
     // By default, we know that rock (ground & full) will be set as rock full tiles,
     // gold (ground & full) will be set as gold full tiles,
-    // other tiles will be set as dirt full tiles
-    for(int xxx = 0; xxx < x; ++xxx)
+    // other tiles will be set as dirt full tiles.
+    // Note that gold and rock tiles keep their type during the game so it doesn't matter
+    // if the state is initialized after the map is loaded
+    Tile* tile = mGameMap->getTile(x, y);
+    if(tile == nullptr)
+        return;
+
+    if(tile->getType() == TileType::gold)
+    {
+        tileState.mTileVisual = TileVisual::goldFull;
+        return;
+    }
+
+    if(tile->getType() == TileType::rock)
     {
-        for(int yyy = 0; yyy < y; ++yyy)
+        tileState.mTileVisual = TileVisual::rockFull;
+        return;
+    }
+
+    tileState.mTileVisual = TileVisual::dirtFull;
+}
+
+TileStateNotified* Seat::getTileState(const Tile* tile)
+{
+    TileStateNotified* tileState = mTilesStates.get(tile->getX(), tile->getY(),
+        [this](int x, int y, TileStateNotified& newTileState)
         {
-            Tile* tile = mGameMap->getTile(xxx, yyy);
-            if(tile == nullptr)
-                continue;
+            initTileState(x, y, newTileState);
+        });
 
-            if(tile->getType() == TileType::gold)
-            {
-                mTilesStates[xxx][yyy].mTileVisual = TileVisual::goldFull;
-                continue;
-            }
+    if(tileState == nullptr)
+    {
+        OD_LOG_ERR("Tile=" + Tile::displayAsString(tile));
+        return nullptr;
+    }
 
-            if(tile->getType() == TileType::rock)
-            {
-                mTilesStates[xxx][yyy].mTileVisual = TileVisual::rockFull;
-                continue;
-            }
+    return tileState;
+}
 
-            mTilesStates[xxx][yyy].mTileVisual = TileVisual::dirtFull;
-        }
+const TileStateNotified* Seat::findTileState(const Tile* tile, TileStateNotified& defaultTileState) const
+{
+    if(!mTilesStates.isInside(tile->getX(), tile->getY()))
+    {
+        OD_LOG_ERR("Tile=" + Tile::displayAsString(tile));
+        return nullptr;
     }
+
+    const TileStateNotified* tileState = mTilesStates.find(tile->getX(), tile->getY());
+    if(tileState != nullptr)
+        return tileState;
+
+    // The state was never needed. The seat only knows the default state
+    initTileState(tile->getX(), tile->getY(), defaultTileState);
+    return &defaultTileState;
+}
+
+std::size_t Seat::getTilesStatesMemoryUsed() const
+{
+    return mTilesStates.getMemoryUsed()
+        + (mNbTilesVisionCurrent.capacity() + mNbTilesVisionLast.capacity()) * sizeof(uint32_t);
+}
+
+void Seat::setTileVisionCurrent(const Tile* tile, TileStateNotified& tileState)
+{
+    if(tileState.mVisionTurnCurrent)
+        return;
+
+    tileState.mVisionTurnCurrent = true;
+    ++mNbTilesVisionCurrent[mTilesStates.getChunkIndex(tile->getX(), tile->getY())];
 }
 
 unsigned int Seat::checkAllGoals()
@@ -603,22 +643,24 @@ void Seat::notifyChangedVisibleTiles()
         return;
 
     std::vector<Tile*> tilesToNotify;
-    int xMax = static_cast<int>(mTilesStates.size());
-    for(int xxx = 0; xxx < xMax; ++xxx)
+    int nbChunks = mTilesStates.getNbChunks();
+    for(int chunkIndex = 0; chunkIndex < nbChunks; ++chunkIndex)
     {
-        int yMax = static_cast<int>(mTilesStates[xxx].size());
-        for(int yyy = 0; yyy < yMax; ++yyy)
+        if(mNbTilesVisionCurrent[chunkIndex] == 0)
+            continue;
+
+        mTilesStates.forEachInChunk(chunkIndex, [this, &tilesToNotify](int x, int y, TileStateNotified& tileState)
         {
-            if(!mTilesStates[xxx][yyy].mVisionTurnCurrent)
-                continue;
+            if(!tileState.mVisionTurnCurrent)
+                return;
 
-            Tile* tile = mGameMap->getTile(xxx, yyy);
+            Tile* tile = mGameMap->getTile(x, y);
             if(!tile->hasChangedForSeat(this))
-                continue;
+                return;
 
             tilesToNotify.push_back(tile);
             tile->changeNotifiedForSeat(this);
-        }
+        });
     }
 
     if(tilesToNotify.empty())
@@ -709,18 +751,19 @@ void Seat::refreshSeatVisualDebug()
     if(mIsDebuggingVision)
     {
         std::vector<Tile*> tiles;
-        int xMax = static_cast<int>(mTilesStates.size());
-        for(int xxx = 0; xxx < xMax; ++xxx)
+        int nbChunks = mTilesStates.getNbChunks();
+        for(int chunkIndex = 0; chunkIndex < nbChunks; ++chunkIndex)
         {
-            int yMax = static_cast<int>(mTilesStates[xxx].size());
-            for(int yyy = 0; yyy < yMax; ++yyy)
+            if(mNbTilesVisionCurrent[chunkIndex] == 0)
+                continue;
+
+            mTilesStates.forEachInChunk(chunkIndex, [this, &tiles](int x, int y, TileStateNotified& tileState)
             {
-                if(!mTilesStates[xxx][yyy].mVisionTurnCurrent)
-                    continue;
+                if(!tileState.mVisionTurnCurrent)
+                    return;
 
-                Tile* tile = mGameMap->getTile(xxx, yyy);
-                tiles.push_back(tile);
-            }
+                tiles.push_back(mGameMap->getTile(x, y));
+            });
         }
         uint32_t nbTiles = tiles.size();
         ServerNotification *serverNotification = new ServerNotification(
@@ -761,17 +804,19 @@ void Seat::sendVisibleTiles()
     std::vector<Tile*> tilesVisionGained;
     std::vector<Tile*> tilesVisionLost;
     // Tiles we gained vision
-    int xMax = static_cast<int>(mTilesStates.size());
-    for(int xxx = 0; xxx < xMax; ++xxx)
+    int nbChunks = mTilesStates.getNbChunks();
+    for(int chunkIndex = 0; chunkIndex < nbChunks; ++chunkIndex)
     {
-        int yMax = static_cast<int>(mTilesStates[xxx].size());
-        for(int yyy = 0; yyy < yMax; ++yyy)
+        if((mNbTilesVisionCurrent[chunkIndex] == 0) && (mNbTilesVisionLast[chunkIndex] == 0))
+            continue;
+
+        mTilesStates.forEachInChunk(chunkIndex, [this, &tilesVisionGained, &tilesVisionLost](int x, int y, TileStateNotified& tileState)
         {
-            if(mTilesStates[xxx][yyy].mVisionTurnCurrent == mTilesStates[xxx][yyy].mVisionTurnLast)
-                continue;
+            if(tileState.mVisionTurnCurrent == tileState.mVisionTurnLast)
+                return;
 
-            Tile* tile = mGameMap->getTile(xxx, yyy);
-            if(mTilesStates[xxx][yyy].mVisionTurnCurrent)
+            Tile* tile = mGameMap->getTile(x, y);
+            if(tileState.mVisionTurnCurrent)
             {
                 // Vision gained
                 tilesVisionGained.push_back(tile);
@@ -781,7 +826,7 @@ void Seat::sendVisibleTiles()
                 // Vision lost
                 tilesVisionLost.push_back(tile);
             }
-        }
+        });
     }
 
     // Notify tiles we gained vision
@@ -806,26 +851,35 @@ void Seat::computeSeatBeginTurn()
 {
     if(mPlayer != nullptr)
     {
-        std::fill(mNbRooms.begin(), mNbRooms.end(), 0);
-        for(Room* room : mGameMap->getRooms())
-        {
-            if(room->getSeat() != this)
-                continue;
-
-            if(room->getHP(nullptr) <= 0.0)
-                continue;
+        for(uint32_t index = 0; index < mNbRooms.size(); ++index)
+            mNbRooms[index] = mGameMap->numRoomsByTypeAndSeat(static_cast<RoomType>(index), this);
+    }
+}
 
-            uint32_t index = static_cast<uint32_t>(room->getType());
-            if(index >= mNbRooms.size())
-            {
-                OD_LOG_ERR("wrong index=" + Helper::toString(index) + ", size=" + Helper::toString(mNbRooms.size()));
-                return;
-            }
-            ++mNbRooms[index];
-        }
+void Seat::notifyClaimedTilesChanged(int delta)
+{
+    int nbTiles = static_cast<int>(mNumClaimedTiles) + delta;
+    if(nbTiles < 0)
+    {
+        OD_LOG_ERR("seatId=" + Helper::toString(getId()) + ", nbTiles=" + Helper::toString(nbTiles));
+        nbTiles = 0;
     }
+    mNumClaimedTiles = static_cast<unsigned int>(nbTiles);
+}
+
+void Seat::notifyGoldStoredChanged(int goldDelta, int goldMaxDelta)
+{
+    mGold += goldDelta;
+    mGoldMax += goldMaxDelta;
 }
 
+void Seat::notifyCreaturesCountChanged(bool isWorker, int delta)
+{
+    if(isWorker)
+        mNumCreaturesWorkers += delta;
+    else
+        mNumCreaturesFighters += delta;
+}
 
 Seat* Seat::createRogueSeat(GameMap* gameMap)
 {
@@ -839,6 +893,7 @@ Seat* Seat::createRogueSeat(GameMap* gameMap)
     seat->mGold = 0;
     seat->mGoldMax = 0;
     seat->mGoldMined = 0;
+    seat->mStartingGold = 0;
     seat->mColorId = "0";
     seat->mMana = 0;
 
@@ -856,7 +911,7 @@ Seat* Seat::createRogueSeat(GameMap* gameMap)
 }
 
 
-bool Seat::importSeatFromStream(std::istream& is)
+bool Seat::importSeatFromStream(TextTokenizer& is)
 {
     std::string str;
     OD_ASSERT_TRUE(is >> str);
@@ -939,7 +994,7 @@ bool Seat::importSeatFromStream(std::istream& is)
         OD_LOG_INF("WARNING: expected gold and read " + str);
         return false;
     }
-    OD_ASSERT_TRUE(is >> mGold);
+    OD_ASSERT_TRUE(is >> mStartingGold);
 
     OD_ASSERT_TRUE(is >> str);
     if(str != "goldMined")
@@ -1092,16 +1147,16 @@ bool Seat::importSeatFromStream(std::istream& is)
         return false;
     }
 
+    TextView token;
     while(true)
     {
-        OD_ASSERT_TRUE(is >> str);
-        if(str == "[/markedTiles]")
+        OD_ASSERT_TRUE(is >> token);
+        if(token == "[/markedTiles]")
             break;
 
-        std::pair<int, int> tilecoords;
-        tilecoords.first = Helper::toInt(str);
-        OD_ASSERT_TRUE(is >> str);
-        tilecoords.second = Helper::toInt(str);
+        std::pair<int, int> tilecoords(0, 0);
+        OD_ASSERT_TRUE(TextTokenizer::parseInt32(token, tilecoords.first));
+        OD_ASSERT_TRUE(is >> tilecoords.second);
 
         TileStateNotified& tileState = mTilesStateLoaded[tilecoords];
         tileState.mMarkedForDigging = true;
@@ -1119,22 +1174,72 @@ bool Seat::importSeatFromStream(std::istream& is)
 }
 
 
-bool Seat::exportSeatToStream(std::ostream& os) const
+void Seat::exportSeatToSaveState(SeatSaveState& state) const
+{
+    state.mId = mId;
+    state.mTeamId = mTeamId;
+    state.mAvailableTeamIds = mAvailableTeamIds;
+    // On editor, we write the original player type. If we are saving a game, we keep the assigned type
+    if((mGameMap->isInEditorMode()) ||
+        (getPlayer() == nullptr))
+    {
+        state.mPlayerType = mPlayerType;
+    }
+    else if(getPlayer()->getIsHuman())
+        state.mPlayerType = PLAYER_TYPE_HUMAN;
+    else
+        state.mPlayerType = PLAYER_TYPE_AI;
+
+    state.mFaction = mFaction;
+    state.mStartingX = mStartingX;
+    state.mStartingY = mStartingY;
+    state.mColorId = mColorId;
+    // In the editor, we keep the gold from the level file. In game, we save what the treasuries contain
+    if(mGameMap->isInEditorMode())
+        state.mGold = mStartingGold;
+    else
+        state.mGold = mGold;
+
+    state.mGoldMined = mGoldMined;
+    state.mMana = mMana;
+    state.mSkillDone = mSkillDone;
+    state.mSkillNotAllowed = mSkillNotAllowed;
+    state.mSkillPending = mSkillPending;
+
+    // In editor mode, we don't save tile states. In game, they are only saved for human players
+    state.mExportTilesStates = !mGameMap->isInEditorMode() &&
+        (getPlayer() != nullptr) &&
+        getPlayer()->getIsHuman();
+    state.mTilesStates.clear();
+    if(!state.mExportTilesStates)
+        return;
+
+    // Tiles in chunks not allocated have their default visual which is never exported
+    mTilesStates.forEach([&state](int x, int y, const TileStateNotified& tileState)
+    {
+        if(!tileState.mMarkedForDigging && !isTileVisualExported(tileState.mTileVisual))
+            return;
+
+        state.mTilesStates.push_back({x, y, tileState.mTileVisual, tileState.mSeatIdOwner, tileState.mMarkedForDigging});
+    });
+}
+
+void Seat::exportSeatSaveStateToStream(const SeatSaveState& state, std::ostream& os)
 {
     os << "seatId\t";
-    os << mId;
+    os << state.mId;
     os << std::endl;
     // If the team id is set, we save it. Otherwise, we save all the available team ids
     // That way, save map will work in both editor and in game.
     os << "teamId\t";
-    if(mTeamId != -1)
+    if(state.mTeamId != -1)
     {
-        os << mTeamId;
+        os << state.mTeamId;
     }
     else
     {
         int cpt = 0;
-        for(int teamId : mAvailableTeamIds)
+        for(int teamId : state.mAvailableTeamIds)
         {
             if(cpt > 0)
                 os << "/";
@@ -1145,137 +1250,111 @@ bool Seat::exportSeatToStream(std::ostream& os) const
     }
     os << std::endl;
 
-    // On editor, we write the original player type. If we are saving a game, we keep the assigned type
-    if((mGameMap->isInEditorMode()) ||
-        (getPlayer() == nullptr))
-    {
-        os << "player\t";
-        os << mPlayerType;
-        os << std::endl;
-    }
-    else
-    {
-        os << "player\t";
-        if(getPlayer()->getIsHuman())
-            os << PLAYER_TYPE_HUMAN;
-        else
-            os << PLAYER_TYPE_AI;
-
-        os << std::endl;
-    }
+    os << "player\t";
+    os << state.mPlayerType;
+    os << std::endl;
 
     os << "faction\t";
-    os << mFaction;
+    os << state.mFaction;
     os << std::endl;
 
     os << "startingX\t";
-    os << mStartingX;
+    os << state.mStartingX;
     os << std::endl;
 
     os << "startingY\t";
-    os << mStartingY;
+    os << state.mStartingY;
     os << std::endl;
 
     os << "colorId\t";
-    os << mColorId;
+    os << state.mColorId;
     os << std::endl;
 
     os << "gold\t";
-    os << mGold;
+    os << state.mGold;
     os << std::endl;
 
     os << "goldMined\t";
-    os << mGoldMined;
+    os << state.mGoldMined;
     os << std::endl;
 
     os << "mana\t";
-    os << mMana;
+    os << state.mMana;
     os << std::endl;
 
     os << "[SkillDone]" << std::endl;
-    for(SkillType type : mSkillDone)
+    for(SkillType type : state.mSkillDone)
     {
         os << Skills::toString(type) << std::endl;
     }
     os << "[/SkillDone]" << std::endl;
 
     os << "[SkillNotAllowed]" << std::endl;
-    for(SkillType type : mSkillNotAllowed)
+    for(SkillType type : state.mSkillNotAllowed)
     {
         os << Skills::toString(type) << std::endl;
     }
     os << "[/SkillNotAllowed]" << std::endl;
 
     os << "[SkillPending]" << std::endl;
-    for(SkillType type : mSkillPending)
+    for(SkillType type : state.mSkillPending)
     {
         os << Skills::toString(type) << std::endl;
     }
     os << "[/SkillPending]" << std::endl;
 
-    // In editor mode, we don't save tile states
-    if(mGameMap->isInEditorMode())
-        return true;
-
-    // Tile states are only saved for human players
-    if((getPlayer() == nullptr) ||
-        (!getPlayer()->getIsHuman()))
-    {
-        return true;
-    }
+    if(!state.mExportTilesStates)
+        return;
 
     // We save the visible tiles last state
     uint32_t nb = static_cast<uint32_t>(TileVisual::countTileVisual);
     for(uint32_t k = 0; k < nb; ++k)
     {
         TileVisual tileVisual = static_cast<TileVisual>(k);
-        // Full dirt tiles, full gold tiles and full rock tiles are automatically
-        // set so we don't have to bother about them
-        switch(tileVisual)
-        {
-            case TileVisual::nullTileVisual:
-            case TileVisual::goldFull:
-            case TileVisual::dirtFull:
-            case TileVisual::rockFull:
-                continue;
+        if(!isTileVisualExported(tileVisual))
+            continue;
 
-            default:
-                break;
-        }
-        exportTilesVisualInitialStates(tileVisual, os);
+        exportTilesVisualInitialStates(state, tileVisual, os);
     }
 
     os << "[markedTiles]" << std::endl;
-    for(uint32_t xxx = 0; xxx < mTilesStates.size(); ++xxx)
+    for(const SeatTileSaveState& tileState : state.mTilesStates)
     {
-        for(uint32_t yyy = 0; yyy < mTilesStates[xxx].size(); ++yyy)
-        {
-            const TileStateNotified& tileState = mTilesStates[xxx][yyy];
-            if(!tileState.mMarkedForDigging)
-                continue;
+        if(!tileState.mMarkedForDigging)
+            continue;
 
-            os << xxx << "\t" << yyy << std::endl;
-        }
+        os << tileState.mX << "\t" << tileState.mY << std::endl;
     }
     os << "[/markedTiles]" << std::endl;
+}
 
-    return true;
+bool Seat::isTileVisualExported(TileVisual tileVisual)
+{
+    // Full dirt tiles, full gold tiles and full rock tiles are automatically
+    // set so we don't have to bother about them
+    switch(tileVisual)
+    {
+        case TileVisual::nullTileVisual:
+        case TileVisual::goldFull:
+        case TileVisual::dirtFull:
+        case TileVisual::rockFull:
+            return false;
+
+        default:
+            return true;
+    }
 }
 
-void Seat::exportTilesVisualInitialStates(TileVisual tileVisual, std::ostream& os) const
+void Seat::exportTilesVisualInitialStates(const SeatSaveState& state, TileVisual tileVisual, std::ostream& os)
 {
     os << "[" + Tile::tileVisualToString(tileVisual) + "]" << std::endl;
 
-    for(uint32_t xxx = 0; xxx < mTilesStates.size(); ++xxx)
+    for(const SeatTileSaveState& tileState : state.mTilesStates)
     {
-        for(uint32_t yyy = 0; yyy < mTilesStates[xxx].size(); ++yyy)
-        {
-            const TileStateNotified& tileState = mTilesStates[xxx][yyy];
-            if(tileState.mTileVisual != tileVisual)
-                continue;
+        if(tileState.mTileVisual != tileVisual)
+            continue;
 
-            os << xxx << "\t" << yyy << "\t" << tileState.mSeatIdOwner << std::endl;
-        }
+        os << tileState.mX << "\t" << tileState.mY << "\t" << tileState.mSeatIdOwner << std::endl;
     }
 
     os << "[/" + Tile::tileVisualToString(tileVisual) + "]" << std::endl;
@@ -1537,18 +1616,11 @@ void Seat::setSkillTree(const std::vector<SkillType>& skills)
 
 void Seat::updateTileStateForSeat(Tile* tile, bool hideSeatId)
 {
-    if(tile->getX() >= static_cast<int>(mTilesStates.size()))
-    {
-        OD_LOG_ERR("Tile=" + Tile::displayAsString(tile));
+    TileStateNotified* tileStateNotified = getTileState(tile);
+    if(tileStateNotified == nullptr)
         return;
-    }
-    if(tile->getY() >= static_cast<int>(mTilesStates[tile->getX()].size()))
-    {
-        OD_LOG_ERR("Tile=" + Tile::displayAsString(tile));
-        return;
-    }
 
-    TileStateNotified& tileState = mTilesStates[tile->getX()][tile->getY()];
+    TileStateNotified& tileState = *tileStateNotified;
     tileState.mTileVisual = tile->getTileVisual();
     switch(tileState.mTileVisual)
     {
@@ -1610,18 +1682,11 @@ void Seat::setVisibleBuildingOnTile(Building* building, Tile* tile)
     if(!getPlayer()->getIsHuman())
         return;
 
-    if(tile->getX() >= static_cast<int>(mTilesStates.size()))
-    {
-        OD_LOG_ERR("Tile=" + Tile::displayAsString(tile));
-        return;
-    }
-    if(tile->getY() >= static_cast<int>(mTilesStates[tile->getX()].size()))
-    {
-        OD_LOG_ERR("Tile=" + Tile::displayAsString(tile));
+    TileStateNotified* tileStateNotified = getTileState(tile);
+    if(tileStateNotified == nullptr)
         return;
-    }
 
-    TileStateNotified& tileState = mTilesStates[tile->getX()][tile->getY()];
+    TileStateNotified& tileState = *tileStateNotified;
 
     if(building == tileState.mBuilding)
         return;
@@ -1644,18 +1709,12 @@ void Seat::exportTileToPacket(ODPacket& os, const Tile* tile,
         return;
     }
 
-    if(tile->getX() >= static_cast<int>(mTilesStates.size()))
-    {
-        OD_LOG_ERR("Tile=" + Tile::displayAsString(tile));
+    TileStateNotified defaultTileState;
+    const TileStateNotified* tileStateNotified = findTileState(tile, defaultTileState);
+    if(tileStateNotified == nullptr)
         return;
-    }
-    if(tile->getY() >= static_cast<int>(mTilesStates[tile->getX()].size()))
-    {
-        OD_LOG_ERR("Tile=" + Tile::displayAsString(tile));
-        return;
-    }
 
-    const TileStateNotified& tileState = mTilesStates[tile->getX()][tile->getY()];
+    const TileStateNotified& tileState = *tileStateNotified;
 
     int tileSeatId = -1;
     // We only pass the tile seat to the client if the tile is fully claimed
@@ -1738,20 +1797,13 @@ void Seat::notifyBuildingRemovedFromGameMap(Building* building, Tile* tile)
     if(!getPlayer()->getIsHuman())
         return;
 
-    if(tile->getX() >= static_cast<int>(mTilesStates.size()))
-    {
-        OD_LOG_ERR("Tile=" + Tile::displayAsString(tile));
-        return;
-    }
-    if(tile->getY() >= static_cast<int>(mTilesStates[tile->getX()].size()))
-    {
-        OD_LOG_ERR("Tile=" + Tile::displayAsString(tile));
+    // If the tile state was never stored, the seat never saw a building on it
+    TileStateNotified* tileState = mTilesStates.find(tile->getX(), tile->getY());
+    if(tileState == nullptr)
         return;
-    }
 
-    TileStateNotified& tileState = mTilesStates[tile->getX()][tile->getY()];
-    if(tileState.mBuilding == building)
-        tileState.mBuilding = nullptr;
+    if(tileState->mBuilding == building)
+        tileState->mBuilding = nullptr;
 }
 
 void Seat::tileMarkedDiggingNotifiedToPlayer(Tile* tile, bool isDigSet)
@@ -1761,18 +1813,11 @@ void Seat::tileMarkedDiggingNotifiedToPlayer(Tile* tile, bool isDigSet)
     if(!getPlayer()->getIsHuman())
         return;
 
-    if(tile->getX() >= static_cast<int>(mTilesStates.size()))
-    {
-        OD_LOG_ERR("Tile=" + Tile::displayAsString(tile));
-        return;
-    }
-    if(tile->getY() >= static_cast<int>(mTilesStates[tile->getX()].size()))
-    {
-        OD_LOG_ERR("Tile=" + Tile::displayAsString(tile));
+    TileStateNotified* tileStateNotified = getTileState(tile);
+    if(tileStateNotified == nullptr)
         return;
-    }
 
-    TileStateNotified& tileState = mTilesStates[tile->getX()][tile->getY()];
+    TileStateNotified& tileState = *tileStateNotified;
     tileState.mMarkedForDigging = isDigSet;
 }
 
@@ -1780,18 +1825,12 @@ bool Seat::isTileDiggableForClient(Tile* tile) const
 {
     if(!getPlayer()->getIsHuman())
         return false;
-    if(tile->getX() >= static_cast<int>(mTilesStates.size()))
-    {
-        OD_LOG_ERR("Tile=" + Tile::displayAsString(tile));
-        return false;
-    }
-    if(tile->getY() >= static_cast<int>(mTilesStates[tile->getX()].size()))
-    {
-        OD_LOG_ERR("Tile=" + Tile::displayAsString(tile));
+    TileStateNotified defaultTileState;
+    const TileStateNotified* tileStateNotified = findTileState(tile, defaultTileState);
+    if(tileStateNotified == nullptr)
         return false;
-    }
 
-    const TileStateNotified& tileState = mTilesStates[tile->getX()][tile->getY()];
+    const TileStateNotified& tileState = *tileStateNotified;
     // Handle non claimed
     switch(tileState.mTileVisual)
     {
@@ -1887,7 +1926,7 @@ const CreatureDefinition* Seat::getNextFighterClassToSpawn(const GameMap& gameMa
     return nullptr;
 }
 
-int Seat::readTilesVisualInitialStates(TileVisual tileVisual, std::istream& is)
+int Seat::readTilesVisualInitialStates(TileVisual tileVisual, TextTokenizer& is)
 {
     // We check if it is the Seat end tag
     std::string str;
@@ -1902,17 +1941,17 @@ int Seat::readTilesVisualInitialStates(TileVisual tileVisual, std::istream& is)
     }
 
 
+    const std::string endTag = "[/" + Tile::tileVisualToString(tileVisual) + "]";
+    TextView token;
     while(true)
     {
-        OD_ASSERT_TRUE(is >> str);
-        if(str == "[/" + Tile::tileVisualToString(tileVisual) + "]")
+        OD_ASSERT_TRUE(is >> token);
+        if(token == endTag)
             break;
 
-        std::pair<int, int> tilecoords;
-        tilecoords.first = Helper::toInt(str);
-
-        OD_ASSERT_TRUE(is >> str);
-        tilecoords.second = Helper::toInt(str);
+        std::pair<int, int> tilecoords(0, 0);
+        OD_ASSERT_TRUE(TextTokenizer::parseInt32(token, tilecoords.first));
+        OD_ASSERT_TRUE(is >> tilecoords.second);
 
         int seatId;
         OD_ASSERT_TRUE(is >> seatId);
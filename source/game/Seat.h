@@ -19,6 +19,7 @@
 #define SEAT_H
 
 #include "game/SeatData.h"
+#include "utils/ChunkedGrid.h"
 
 #include <OgreVector3.h>
 #include <OgreColourValue.h>
@@ -36,8 +37,11 @@ class CreatureDefinition;
 class Player;
 class Skill;
 class Seat;
+class TextTokenizer;
 class Tile;
 
+struct SeatSaveState;
+
 enum class KeeperAIType;
 enum class RoomType;
 enum class SkillType;
@@ -129,6 +133,19 @@ public:
     inline void setTeamIndex(uint32_t index)
     { mTeamIndex = index; }
 
+    //! \brief Index of the seat in the gamemap seats. Set by the gamemap when the seat is added. Used to
+    //! represent sets of seats as bitmasks (for example on tiles)
+    inline uint32_t getSeatIndex() const
+    { return mSeatIndex; }
+
+    //! \brief Bitmask with only this seat bit set
+    inline uint64_t getSeatMask() const
+    { return static_cast<uint64_t>(1) << mSeatIndex; }
+
+    //! \brief Bitmask with this seat and all its allied seats. Used on server side only
+    inline uint64_t getAlliedSeatsMask() const
+    { return mAlliedSeatsMask; }
+
     inline int32_t getConfigPlayerId() const
     { return mConfigPlayerId; }
 
@@ -156,6 +173,9 @@ public:
     inline int getGoldMined() const
     { return mGoldMined; }
 
+    inline int getStartingGold() const
+    { return mStartingGold; }
+
     inline bool getKoCreatures() const
     { return mKoCreatures; }
 
@@ -227,6 +247,13 @@ public:
 
     void computeSeatBeginTurn();
 
+    //! \brief Incremental counters update. They are called each time a tile is claimed/unclaimed,
+    //! gold is deposited/withdrawn or a creature is added/removed/changes side so that we do not
+    //! have to recount everything each turn. Used on server side only
+    void notifyClaimedTilesChanged(int delta);
+    void notifyGoldStoredChanged(int goldDelta, int goldMaxDelta);
+    void notifyCreaturesCountChanged(bool isWorker, int delta);
+
     //! \brief Gets whether a skill is being done
     bool isSkilling() const
     { return mCurrentSkill != nullptr; }
@@ -284,6 +311,9 @@ public:
     //! Called on server side only
     bool isTileDiggableForClient(Tile* tile) const;
 
+    //! \brief Returns the memory used by the tile states of this seat
+    std::size_t getTilesStatesMemoryUsed() const;
+
     //! \brief Called for each seat when a building is removed from the gamemap. That allows
     //! the seats to clear the pointers to the building that they may have
     void notifyBuildingRemovedFromGameMap(Building* building, Tile* tile);
@@ -304,8 +334,11 @@ public:
 
     static Seat* createRogueSeat(GameMap* gameMap);
 
-    bool importSeatFromStream(std::istream& is);
-    bool exportSeatToStream(std::ostream& os) const;
+    bool importSeatFromStream(TextTokenizer& is);
+    //! \brief Copies the seat fields written in the level files
+    void exportSeatToSaveState(SeatSaveState& state) const;
+    //! \brief Writes the given seat state with the level file format
+    static void exportSeatSaveStateToStream(const SeatSaveState& state, std::ostream& os);
     static void loadFromLine(const std::string& line, Seat *s);
     static const std::string getFactionFromLine(const std::string& line);
 
@@ -317,6 +350,9 @@ public:
     static const int32_t PLAYER_TYPE_INACTIVE_ID;
     static const int32_t PLAYER_ID_HUMAN_MIN;
 
+    //! \brief Maximum number of seats in a gamemap (including the rogue seat). Limited by the bitmasks size
+    static const uint32_t MAX_NB_SEATS = 64;
+
     static const std::string PLAYER_FACTION_CHOICE;
 
     //! \brief Converts PlayerID used in the GUI into keeper AI enum
@@ -333,6 +369,10 @@ private:
     //! \brief The total amount of gold coins mined by workers under this seat's control.
     int mGoldMined;
 
+    //! \brief The gold read from the level file. It will be deposited in the treasuries when the game starts.
+    //! We do not store it in mGold because mGold is updated incrementally with the treasuries content
+    int mStartingGold;
+
     //! \brief The actual color that this color index translates into.
     Ogre::ColourValue mColorValue;
 
@@ -356,10 +396,16 @@ private:
     //! \brief The default workers spawned in temples.
     const CreatureDefinition* mDefaultWorkerClass;
 
-    //! \brief List of all the tiles in the gamemap (used for human players seats only). The first vector stores the X position.
-    //! The second vector stores the Y position. TileStateNotified contains information about the tile
-    //! state (last tile state notified, vision last turn for this seat, vision for current turn, ...
-    std::vector<std::vector<TileStateNotified>> mTilesStates;
+    //! \brief State of the tiles in the gamemap (used for human players seats only). TileStateNotified contains information
+    //! about the tile state (last tile state notified, vision last turn for this seat, vision for current turn, ...).
+    //! The states are allocated by chunks the first time they are needed so that big maps do not cost a state for each
+    //! tile the seat never saw
+    ChunkedGrid<TileStateNotified> mTilesStates;
+
+    //! \brief Number of tiles with vision during the current turn and during the last turn for each mTilesStates chunk.
+    //! The per turn vision passes skip the chunks where the seat has no vision
+    std::vector<uint32_t> mNbTilesVisionCurrent;
+    std::vector<uint32_t> mNbTilesVisionLast;
 
     std::map<std::pair<int, int>, TileStateNotified> mTilesStateLoaded;
 
@@ -369,6 +415,12 @@ private:
     //! and never changed after
     uint32_t mTeamIndex;
 
+    //! \brief See getSeatIndex
+    uint32_t mSeatIndex;
+
+    //! \brief Computed once when allied seats are set so that vision can be shared with allies in one operation
+    uint64_t mAlliedSeatsMask;
+
     bool mIsDebuggingVision;
 
     //! \brief Counter for skill points
@@ -400,12 +452,30 @@ private:
     //! researchedType is the currently researched type if any (nullSkillType if none)
     void setNextSkill(SkillType researchedType);
 
-    //! Fills mTilesStateLoaded with the tiles of the given tileVisual is the given istream.
+    //! Fills mTilesStateLoaded with the tiles of the given tileVisual read from the given tokenizer.
     //! Returns 0 if the seat end tile has been reached, 1 if the read success and -1 if there is an error
-    int readTilesVisualInitialStates(TileVisual tileVisual, std::istream& is);
+    int readTilesVisualInitialStates(TileVisual tileVisual, TextTokenizer& is);
+
+    //! \brief Returns false for the tile visuals set automatically when loading a level. Tiles
+    //! with these visuals are not written in the level files
+    static bool isTileVisualExported(TileVisual tileVisual);
+
+    //! exports the tiles of the corresponding TileVisual the seat have seen
+    static void exportTilesVisualInitialStates(const SeatSaveState& state, TileVisual tileVisual, std::ostream& os);
+
+    //! \brief Sets the state the seat knows for a tile it never had to store a state for
+    void initTileState(int x, int y, TileStateNotified& tileState) const;
+
+    //! \brief Returns the state of the given tile, allocating its chunk if needed. Returns nullptr
+    //! if the tile is outside the map
+    TileStateNotified* getTileState(const Tile* tile);
+
+    //! \brief Returns the state of the given tile without allocating it. If it was never stored, defaultTileState
+    //! is filled with the default state and returned. Returns nullptr if the tile is outside the map
+    const TileStateNotified* findTileState(const Tile* tile, TileStateNotified& defaultTileState) const;
 
-    //! exports the tiles of the corresponding TileVisual this seat have seen
-    void exportTilesVisualInitialStates(TileVisual tileVisual, std::ostream& os) const;
+    //! \brief Sets the vision for the current turn on the given tile state and updates mNbTilesVisionCurrent
+    void setTileVisionCurrent(const Tile* tile, TileStateNotified& tileState);
 };
 
 #endif // SEAT_H
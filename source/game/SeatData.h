@@ -137,7 +137,8 @@ protected:
     int mStartingX;
     int mStartingY;
 
-    //! \brief The number of living creatures fighters under this seat's control
+    //! \brief The number of living creatures fighters under this seat's control. Fighters and workers
+    //! counts are updated incrementally when creatures are added/removed, die or change seat
     int mNumCreaturesFighters;
     int mNumCreaturesFightersMax;
     int mNumCreaturesWorkers;
@@ -148,12 +149,13 @@ protected:
     //! \brief Team ids this seat can use defined in the level file.
     std::vector<int> mAvailableTeamIds;
 
-    //! \brief How many tiles have been claimed by this seat, updated in GameMap::doTurn().
+    //! \brief How many tiles have been claimed by this seat, updated each time a tile is claimed/unclaimed.
     unsigned int mNumClaimedTiles;
 
     bool mHasGoalsChanged;
 
     //! \brief The total amount of gold coins in the keeper's treasury and in the dungeon heart.
+    //! Updated each time gold is deposited/withdrawn.
     int mGold;
 
     //! \brief The total amount of gold coins that the keeper treasuries can have.
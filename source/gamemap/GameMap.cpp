@@ -59,7 +59,10 @@
 #include "utils/ConfigManager.h"
 #include "utils/Helper.h"
 #include "utils/LogManager.h"
+#include "utils/MemoryReport.h"
 #include "utils/ResourceManager.h"
+#include "utils/WorkerPool.h"
+#include "ODApplication.h"
 
 #include <OgreTimer.h>
 
@@ -70,9 +73,17 @@
 #include <iostream>
 #include <sstream>
 #include <string>
+#include <thread>
 
 const std::string DEFAULT_NICK = "You";
 
+namespace
+{
+    //! \brief Minimum number of creatures in each range of creatures whose vision is computed by the turn
+    //! workers. Under that, waking up a worker costs more than what it saves
+    const std::size_t MIN_CREATURES_PER_VISION_RANGE = 32;
+}
+
 using namespace std;
 
 /*! \brief A helper class for the A* search in the GameMap::path function.
@@ -149,6 +160,25 @@ private:
     bool        mHasBeenProcessed;
 };
 
+//! \brief Returns the additional cost of going through the given diggable tile when searching a
+//! path for the given seat through diggable tiles
+static double computeDigPathCost(const Tile* tile, const Seat* seat)
+{
+    // Tiles already marked by the seat will be dug anyway
+    if(tile->getMarkedForDigging(seat->getPlayer()))
+        return 0.0;
+
+    const ConfigManager& config = ConfigManager::getSingleton();
+    double cost = config.getDigPathCostFullTile() * tile->getFullness() / 100.0;
+    if(tile->getType() == TileType::gold)
+        cost += config.getDigPathPenaltyGold();
+
+    if(tile->isClaimed())
+        cost += config.getDigPathPenaltyClaimedWall();
+
+    return cost;
+}
+
 
 GameMap::GameMap(bool isServerGameMap) :
         TileContainer(isServerGameMap ? 15 : 0),
@@ -158,8 +188,11 @@ GameMap::GameMap(bool isServerGameMap) :
         mTurnNumber(-1),
         mIsPaused(false),
         mTimePayDay(0),
+        mGameSeed(0),
+        mTilesVisionStamp(0),
         mFloodFillEnabled(false),
         mIsFOWActivated(true),
+        mNbTileMeshRefreshedLastCall(0),
         mNumCallsTo_path(0),
         mAiManager(*this),
         mTileSet(nullptr)
@@ -226,6 +259,8 @@ bool GameMap::createNewMap(int sizeX, int sizeY)
     if (!allocateMapMemory(sizeX, sizeY))
         return false;
 
+    mClaimedTiles.reset(sizeX, sizeY);
+
     for (int jj = 0; jj < mMapSizeY; ++jj)
     {
         for (int ii = 0; ii < mMapSizeX; ++ii)
@@ -270,6 +305,8 @@ void GameMap::clearAll()
 
     processDeletionQueues();
 
+    mTilesMeshToRefresh.clear();
+    mNbTileMeshRefreshedLastCall = 0;
     clearTiles();
     processDeletionQueues();
 
@@ -285,6 +322,7 @@ void GameMap::clearAll()
     resetUniqueNumbers();
     mIsFOWActivated = true;
     mTimePayDay = 0;
+    mGameSeed = 0;
 
     // We check if the different vectors are empty
     if(!mActiveObjects.empty())
@@ -473,7 +511,7 @@ uint32_t GameMap::numWeapons()
     return mWeapons.size();
 }
 
-void GameMap::saveLevelEquipments(std::ofstream& levelFile)
+void GameMap::saveLevelEquipments(std::ostream& levelFile)
 {
     for (std::pair<const Weapon*,Weapon*>& def : mWeapons)
     {
@@ -563,9 +601,9 @@ std::vector<Creature*> GameMap::getCreaturesByAlliedSeat(const Seat* seat) const
     return tempVector;
 }
 
-std::vector<Creature*> GameMap::getCreaturesBySeat(const Seat* seat) const
+TurnSpan<Creature*> GameMap::getCreaturesBySeat(const Seat* seat) const
 {
-    std::vector<Creature*> tempVector;
+    TurnVector<Creature*> tempVector(mTurnArena);
 
     // Loop over all the creatures in the GameMap and add them to the temp vector if their seat matches the one in parameter.
     for (Creature* creature : mCreatures)
@@ -574,7 +612,7 @@ std::vector<Creature*> GameMap::getCreaturesBySeat(const Seat* seat) const
             tempVector.push_back(creature);
     }
 
-    return tempVector;
+    return tempVector.span();
 }
 
 Creature* GameMap::getWorkerToPickupBySeat(Seat* seat)
@@ -596,7 +634,7 @@ Creature* GameMap::getWorkerToPickupBySeat(Seat* seat)
     Creature* diggerWorker = nullptr;
     uint32_t otherWorkerLevel = 0;
     Creature* otherWorker = nullptr;
-    std::vector<Creature*> creatures = getCreaturesBySeat(seat);
+    TurnSpan<Creature*> creatures = getCreaturesBySeat(seat);
     for(Creature* creature : creatures)
     {
         if(!creature->getDefinition()->isWorker())
@@ -718,7 +756,7 @@ Creature* GameMap::getFighterToPickupBySeat(Seat* seat)
     Creature* busyFighter = nullptr;
     uint32_t otherFighterLevel = 0;
     Creature* otherFighter = nullptr;
-    std::vector<Creature*> creatures = getCreaturesBySeat(seat);
+    TurnSpan<Creature*> creatures = getCreaturesBySeat(seat);
     for(Creature* creature : creatures)
     {
         if(creature->getDefinition()->isWorker())
@@ -889,7 +927,7 @@ unsigned int GameMap::numClassDescriptions()
     return mClassDescriptions.size();
 }
 
-void GameMap::saveLevelClassDescriptions(std::ofstream& levelFile)
+void GameMap::saveLevelClassDescriptions(std::ostream& levelFile)
 {
     for (std::pair<const CreatureDefinition*,CreatureDefinition*>& def : mClassDescriptions)
     {
@@ -949,6 +987,8 @@ void GameMap::createAllEntities()
     else
     {
         // On client we create meshes
+        computeAllTileLinkMasks();
+
         // Create OGRE entities for map tiles
         for (int jj = 0; jj < getMapSizeY(); ++jj)
         {
@@ -1025,6 +1065,24 @@ void GameMap::createAllEntities()
     OD_LOG_INF("entities created");
 }
 
+void GameMap::tileClaimedChanged(const Tile* tile, bool isClaimed)
+{
+    uint8_t* cell;
+    if(isClaimed)
+        cell = mClaimedTiles.get(tile->getX(), tile->getY(), [](int, int, uint8_t& claimed) { claimed = 0; });
+    else
+        cell = mClaimedTiles.find(tile->getX(), tile->getY());
+
+    if(cell == nullptr)
+    {
+        if(isClaimed)
+            OD_LOG_ERR("tile=" + Tile::displayAsString(tile));
+        return;
+    }
+
+    *cell = isClaimed ? 1 : 0;
+}
+
 void GameMap::destroyAllEntities()
 {
     // Destroy OGRE entities for map tiles
@@ -1076,6 +1134,9 @@ void GameMap::doTurn(double timeSinceLastTurn)
 {
     OD_LOG_INF("Computing turn " + Helper::toString(mTurnNumber) + ", timeSinceLastTurn=" + Helper::toString(timeSinceLastTurn));
     unsigned int numCallsTo_path_atStart = mNumCallsTo_path;
+    uint64_t nbTileVectorsAllocatedAtStart = getNbTileVectorsAllocated();
+    uint64_t nbArenaAllocationsAtStart = mTurnArena.getNbAllocations();
+    uint64_t nbArenaBlocksAtStart = mTurnArena.getNbBlocksAllocated();
 
     uint32_t miscUpkeepTime = doMiscUpkeep(timeSinceLastTurn);
 
@@ -1088,7 +1149,11 @@ void GameMap::doTurn(double timeSinceLastTurn)
     }
 
     OD_LOG_INF("During this turn there were " + Helper::toString(mNumCallsTo_path - numCallsTo_path_atStart)
-        + " calls to GameMap::path(), miscUpkeepTime=" + Helper::toString(miscUpkeepTime));
+        + " calls to GameMap::path(), " + Helper::toString(getNbTileVectorsAllocated() - nbTileVectorsAllocatedAtStart)
+        + " tile vectors allocated, " + Helper::toString(mTurnArena.getNbAllocations() - nbArenaAllocationsAtStart)
+        + " turn arena allocations (" + Helper::toString(mTurnArena.getBytesUsed()) + " bytes, "
+        + Helper::toString(mTurnArena.getNbBlocksAllocated() - nbArenaBlocksAtStart) + " new blocks), miscUpkeepTime="
+        + Helper::toString(miscUpkeepTime));
 }
 
 void GameMap::doPlayerAITurn(double timeSinceLastTurn)
@@ -1098,7 +1163,6 @@ void GameMap::doPlayerAITurn(double timeSinceLastTurn)
 
 unsigned long int GameMap::doMiscUpkeep(double timeSinceLastTurn)
 {
-    Tile *tempTile;
     Ogre::Timer stopwatch;
     unsigned long int timeTaken;
 
@@ -1116,20 +1180,7 @@ unsigned long int GameMap::doMiscUpkeep(double timeSinceLastTurn)
                 continue;
 
             // We notify the player if he owns a fighter only
-            bool isCreatureSeat = false;
-            for(Creature* creature : mCreatures)
-            {
-                if(creature->getSeat() != player->getSeat())
-                    continue;
-
-                if(creature->getDefinition()->isWorker())
-                    continue;
-
-                isCreatureSeat = true;
-                break;
-            }
-
-            if(!isCreatureSeat)
+            if(player->getSeat()->getNumCreaturesFighters() <= 0)
                 continue;
 
             ServerNotification *serverNotification = new ServerNotification(
@@ -1160,57 +1211,39 @@ unsigned long int GameMap::doMiscUpkeep(double timeSinceLastTurn)
             addWinningSeat(seat);
 
         seat->mNumCreaturesFightersMax = getMaxNumberCreatures(seat);
-
-        // Set the creatures count to 0. It will be reset by the next count in doTurn()
-        seat->mNumCreaturesFighters = 0;
-        seat->mNumCreaturesWorkers = 0;
-    }
-
-    // Count how many creatures the player controls
-    for(Creature* creature : mCreatures)
-    {
-        // Check to see if the creature has died.
-        if (!creature->isAlive())
-            continue;
-
-        Seat *tempSeat = creature->getSeat();
-        if(tempSeat == nullptr)
-            continue;
-
-        // We only count fighters
-        if (creature->getDefinition()->isWorker())
-            ++(tempSeat->mNumCreaturesWorkers);
-        else
-            ++(tempSeat->mNumCreaturesFighters);
     }
 
     // At each upkeep, we re-compute tiles with vision
     for (Seat* seat : mSeats)
         seat->clearTilesWithVision();
 
-    for (int jj = 0; jj < getMapSizeY(); ++jj)
-    {
-        for (int ii = 0; ii < getMapSizeX(); ++ii)
-        {
-            getTile(ii,jj)->clearVision();
-        }
-    }
+    // Every tile vision is reset when it is next used
+    ++mTilesVisionStamp;
 
     // Compute vision. We need to compute every seats including AI because
     // a human can be allied with an AI and they would share vision
-    for (int jj = 0; jj < getMapSizeY(); ++jj)
+    if(!getIsFOWActivated())
     {
-        for (int ii = 0; ii < getMapSizeX(); ++ii)
+        for (int jj = 0; jj < getMapSizeY(); ++jj)
         {
-            getTile(ii,jj)->computeVisibleTiles();
+            for (int ii = 0; ii < getMapSizeX(); ++ii)
+            {
+                getTile(ii,jj)->computeVisibleTiles();
+            }
         }
     }
-
-    for (Creature* creature : mCreatures)
+    else
     {
-        creature->computeVisibleTiles();
+        // Only claimed tiles give vision. We skip the chunks where no tile has ever been claimed
+        mClaimedTiles.forEach([this](int x, int y, uint8_t isClaimed)
+        {
+            if(isClaimed != 0)
+                getTile(x, y)->computeVisibleTiles();
+        });
     }
 
+    computeCreaturesVisibleTiles();
+
     for (Spell* spell : mSpells)
     {
         spell->computeVisibleTiles();
@@ -1258,43 +1291,118 @@ unsigned long int GameMap::doMiscUpkeep(double timeSinceLastTurn)
             if (seat->mMana > maxMana)
                 seat->mMana = maxMana;
         }
+    }
 
-        // Update the count on how much gold is available in all of the treasuries claimed by the given seat.
-        seat->mGold = 0;
-        seat->mGoldMax = 0;
-        for (Room* room : getRooms())
-        {
-            if(room->getSeat() != seat)
-                continue;
+    // Gold, creatures and claimed tiles counters are updated incrementally when they change.
+    // In debug, we check they are consistent with a full recount
+#ifdef OD_DEBUG
+    checkSeatCounters();
+#endif
 
-            seat->mGold += room->getTotalGoldStored();
-            seat->mGoldMax += room->getTotalGoldStorage();
-        }
+    timeTaken = stopwatch.getMicroseconds();
+    return timeTaken;
+}
+
+void GameMap::checkSeatCounters() const
+{
+    std::map<Seat*, int> gold;
+    std::map<Seat*, int> goldMax;
+    for(Room* room : mRooms)
+    {
+        gold[room->getSeat()] += room->getTotalGoldStored();
+        goldMax[room->getSeat()] += room->getTotalGoldStorage();
     }
 
-    // Determine the number of tiles claimed by each seat.
-    // Begin by setting the number of claimed tiles for each seat to 0.
-    for (Seat* seat : mSeats)
-        seat->setNumClaimedTiles(0);
+    std::map<Seat*, int> fighters;
+    std::map<Seat*, int> workers;
+    for(Creature* creature : mCreatures)
+    {
+        if(!creature->isAlive())
+            continue;
 
-    // Now loop over all of the tiles, if the tile is claimed increment the given seats count.
-    for (int jj = 0; jj < getMapSizeY(); ++jj)
+        if(creature->getDefinition()->isWorker())
+            ++workers[creature->getSeat()];
+        else
+            ++fighters[creature->getSeat()];
+    }
+
+    std::map<Seat*, int> claimedTiles;
+    for(int jj = 0; jj < getMapSizeY(); ++jj)
     {
-        for (int ii = 0; ii < getMapSizeX(); ++ii)
+        for(int ii = 0; ii < getMapSizeX(); ++ii)
         {
-            tempTile = getTile(ii,jj);
+            Tile* tile = getTile(ii, jj);
+            if(tile->isClaimed())
+                ++claimedTiles[tile->getSeat()];
+        }
+    }
 
-            // Check to see if the current tile is claimed by anyone.
-            if (tempTile->isClaimed())
-            {
-                // Increment the count of the seat who owns the tile.
-                tempTile->getSeat()->incrementNumClaimedTiles();
-            }
+    for(Seat* seat : mSeats)
+    {
+        if((seat->getGold() != gold[seat]) ||
+           (seat->getGoldMax() != goldMax[seat]) ||
+           (seat->getNumCreaturesFighters() != fighters[seat]) ||
+           (seat->getNumCreaturesWorkers() != workers[seat]) ||
+           (static_cast<int>(seat->getNumClaimedTiles()) != claimedTiles[seat]))
+        {
+            OD_LOG_ERR("Inconsistent counters for seatId=" + Helper::toString(seat->getId())
+                + ", gold=" + Helper::toString(seat->getGold()) + "/" + Helper::toString(gold[seat])
+                + ", goldMax=" + Helper::toString(seat->getGoldMax()) + "/" + Helper::toString(goldMax[seat])
+                + ", fighters=" + Helper::toString(seat->getNumCreaturesFighters()) + "/" + Helper::toString(fighters[seat])
+                + ", workers=" + Helper::toString(seat->getNumCreaturesWorkers()) + "/" + Helper::toString(workers[seat])
+                + ", claimedTiles=" + Helper::toString(seat->getNumClaimedTiles()) + "/" + Helper::toString(claimedTiles[seat]));
         }
     }
+}
 
-    timeTaken = stopwatch.getMicroseconds();
-    return timeTaken;
+void GameMap::computeCreaturesVisibleTiles()
+{
+    mVisionCreatures.clear();
+    int maxSightRadius = 0;
+    for (Creature* creature : mCreatures)
+    {
+        if(!creature->givesVision())
+            continue;
+
+        mVisionCreatures.push_back(creature);
+        maxSightRadius = std::max(maxSightRadius, creature->getDefinition()->getSightRadius());
+    }
+
+    std::size_t nbCreatures = mVisionCreatures.size();
+    if(nbCreatures == 0)
+        return;
+
+    // The workers are created once and kept waiting between turns. The server thread takes part to the work
+    if(mTurnWorkerPool == nullptr)
+    {
+        uint32_t nbCores = std::thread::hardware_concurrency();
+        mTurnWorkerPool.reset(new WorkerPool(nbCores > 1 ? nbCores - 1 : 0));
+    }
+
+    std::size_t nbRanges = mTurnWorkerPool->getNbWorkers() + 1;
+    nbRanges = std::min(nbRanges, nbCreatures / MIN_CREATURES_PER_VISION_RANGE);
+    nbRanges = std::max(nbRanges, static_cast<std::size_t>(1));
+
+    // The tile distances are shared by the threads. We compute them now so that they are only read
+    prepareTileDistance(maxSightRadius);
+    while(mVisionWorks.size() < nbRanges)
+        mVisionWorks.emplace_back(new TileVisibilityWork);
+
+    // Each range of creatures is handled by one thread at a time with its own work vectors. Only the creatures
+    // sight vectors are written. Note that the queries returning a TurnSpan must not be called from here as the
+    // turn arena can only be used by the server thread
+    std::size_t nbCreaturesPerRange = (nbCreatures + nbRanges - 1) / nbRanges;
+    mTurnWorkerPool->parallelFor(static_cast<uint32_t>(nbRanges), [this, nbCreatures, nbCreaturesPerRange](uint32_t k)
+    {
+        TileVisibilityWork& work = *mVisionWorks[k];
+        std::size_t end = std::min(nbCreatures, (k + 1) * nbCreaturesPerRange);
+        for(std::size_t i = k * nbCreaturesPerRange; i < end; ++i)
+            mVisionCreatures[i]->updateTilesInSight(work);
+    });
+
+    // The tiles are tagged serially in creatures order so that the result does not depend on the threads
+    for(Creature* creature : mVisionCreatures)
+        creature->notifyVisibleTiles();
 }
 
 void GameMap::updateAnimations(Ogre::Real timeSinceLastFrame)
@@ -1305,11 +1413,126 @@ void GameMap::updateAnimations(Ogre::Real timeSinceLastFrame)
     if(getTurnNumber() <= 0)
         return;
 
+    if(isServerGameMap())
+    {
+        updateMovementBatch(timeSinceLastFrame);
+        return;
+    }
+
     // Update the animations on all AnimatedObjects
     for(MovableGameEntity* mge : mAnimatedObjects)
         mge->update(timeSinceLastFrame);
 }
 
+void GameMap::MovementBatch::clear()
+{
+    mEntities.clear();
+    mPosX.clear();
+    mPosY.clear();
+    mPosZ.clear();
+    mDestX.clear();
+    mDestY.clear();
+    mDestZ.clear();
+    mMoveDist.clear();
+}
+
+void GameMap::MovementBatch::resize(std::size_t size)
+{
+    mDirX.resize(size);
+    mDirY.resize(size);
+    mDirZ.resize(size);
+    mReached.resize(size);
+}
+
+void GameMap::updateMovementBatch(Ogre::Real timeSinceLastFrame)
+{
+    MovementBatch& batch = mMovementBatch;
+    batch.clear();
+
+    // Gather the walking entities. The others only need their animation clock to be advanced
+    // (on server side, there is nothing else to do for them)
+    Ogre::Vector3 dest;
+    for(MovableGameEntity* mge : mAnimatedObjects)
+    {
+        if(!mge->getNextWalkDestination(dest))
+        {
+            mge->advanceAnimationTime(timeSinceLastFrame);
+            continue;
+        }
+
+        const Ogre::Vector3& pos = mge->getPosition();
+        batch.mEntities.push_back(mge);
+        batch.mPosX.push_back(pos.x);
+        batch.mPosY.push_back(pos.y);
+        batch.mPosZ.push_back(pos.z);
+        batch.mDestX.push_back(dest.x);
+        batch.mDestY.push_back(dest.y);
+        batch.mDestZ.push_back(dest.z);
+        batch.mMoveDist.push_back(static_cast<float>(ODApplication::turnsPerSecond
+            * mge->getMoveSpeed() * timeSinceLastFrame));
+    }
+
+    std::size_t nb = batch.mEntities.size();
+    if(nb == 0)
+        return;
+
+    batch.resize(nb);
+
+    // Motion integration. This loop has no branch nor call so that it can be vectorized.
+    // Entities reaching their waypoint are flagged and left untouched
+    const float* destX = batch.mDestX.data();
+    const float* destY = batch.mDestY.data();
+    const float* destZ = batch.mDestZ.data();
+    const float* moveDist = batch.mMoveDist.data();
+    float* posX = batch.mPosX.data();
+    float* posY = batch.mPosY.data();
+    float* posZ = batch.mPosZ.data();
+    float* dirX = batch.mDirX.data();
+    float* dirY = batch.mDirY.data();
+    float* dirZ = batch.mDirZ.data();
+    uint8_t* reached = batch.mReached.data();
+    for(std::size_t i = 0; i < nb; ++i)
+    {
+        float dx = destX[i] - posX[i];
+        float dy = destY[i] - posY[i];
+        float dz = destZ[i] - posZ[i];
+        float dist = std::sqrt(dx * dx + dy * dy + dz * dz);
+        reached[i] = (dist <= moveDist[i]) ? 1 : 0;
+        float invDist = (dist > 0.0f) ? 1.0f / dist : 0.0f;
+        dirX[i] = dx * invDist;
+        dirY[i] = dy * invDist;
+        dirZ[i] = dz * invDist;
+        float step = reached[i] ? 0.0f : moveDist[i];
+        posX[i] += dirX[i] * step;
+        posY[i] += dirY[i] * step;
+        posZ[i] += dirZ[i] * step;
+    }
+
+    // Sync the entities. Entities reaching a waypoint or changing tile go through the full update
+    // because the walk queue, the animation and the tile they are on have to be updated
+    for(std::size_t i = 0; i < nb; ++i)
+    {
+        MovableGameEntity* mge = batch.mEntities[i];
+        if(reached[i] != 0)
+        {
+            mge->update(timeSinceLastFrame);
+            continue;
+        }
+
+        const Ogre::Vector3& oldPos = mge->getPosition();
+        if((Helper::round(oldPos.x) != Helper::round(posX[i])) ||
+           (Helper::round(oldPos.y) != Helper::round(posY[i])))
+        {
+            mge->update(timeSinceLastFrame);
+            continue;
+        }
+
+        mge->advanceAnimationTime(timeSinceLastFrame);
+        mge->applyWalkStep(Ogre::Vector3(posX[i], posY[i], posZ[i]),
+            Ogre::Vector3(dirX[i], dirY[i], dirZ[i]));
+    }
+}
+
 void GameMap::playerIsFighting(Player* player, Tile* tile)
 {
     if (player == nullptr)
@@ -1432,9 +1655,13 @@ bool GameMap::pathExists(const Creature* creature, Tile* tileStart, Tile* tileEn
     }
 }
 
-std::list<Tile*> GameMap::path(int x1, int y1, int x2, int y2, const Creature* creature, Seat* seat, bool throughDiggableTiles)
+std::list<Tile*> GameMap::path(int x1, int y1, int x2, int y2, const Creature* creature, Seat* seat, bool throughDiggableTiles,
+    bool* nodeBudgetReached)
 {
     ++mNumCallsTo_path;
+    if(nodeBudgetReached != nullptr)
+        *nodeBudgetReached = false;
+
     std::list<Tile*> returnList;
 
     // If the start tile was not found return an empty path
@@ -1454,23 +1681,56 @@ std::list<Tile*> GameMap::path(int x1, int y1, int x2, int y2, const Creature* c
     if (!throughDiggableTiles && !pathExists(creature, start, destination))
         return returnList;
 
+    // mPathEntries will contain the processed and the to process entries allowing to quickly know if a
+    // tile has been processed or not. The cells used are set back to 0 at the end so that the cost of a
+    // call doesn't depend on the map size. Only the chunks reached by path searches use memory
+    if((mPathEntries.getSizeX() != getMapSizeX()) || (mPathEntries.getSizeY() != getMapSizeY()))
+        mPathEntries.reset(getMapSizeX(), getMapSizeY());
+
+    // Every created entry is stored here to be deleted at the end
+    std::vector<AstarEntry*> createdEntries;
+    auto getProcessedEntry = [this, &createdEntries](Tile* tile) -> AstarEntry*
+    {
+        const uint32_t* cell = mPathEntries.find(tile->getX(), tile->getY());
+        if((cell == nullptr) || (*cell == 0))
+            return nullptr;
+
+        return createdEntries[*cell - 1];
+    };
+    auto setProcessedEntry = [this, &createdEntries](AstarEntry* entry)
+    {
+        createdEntries.push_back(entry);
+        uint32_t* cell = mPathEntries.get(entry->getTile()->getX(), entry->getTile()->getY(),
+            [](int, int, uint32_t& newCell) { newCell = 0; });
+        *cell = static_cast<uint32_t>(createdEntries.size());
+    };
+
     AstarEntry *currentEntry = new AstarEntry(start, x1, y1, x2, y2);
     AstarEntry neighbor;
 
     std::vector<AstarEntry*> openList;
     openList.push_back(currentEntry);
-
-    // This list will contain the processed and the to process entries
-    // allowing to quickly know if a tile has been processed or not
-    std::vector<std::vector<AstarEntry*>> processList(getMapSizeX(), std::vector<AstarEntry*>(getMapSizeY(), nullptr));
-    processList[currentEntry->getTile()->getX()][currentEntry->getTile()->getY()] = currentEntry;
+    setProcessedEntry(currentEntry);
     AstarEntry* destinationEntry = nullptr;
+    // When digging, a lot of tiles can be processed. We limit the search to keep it bounded in time
+    uint32_t nodeBudget = throughDiggableTiles ? ConfigManager::getSingleton().getDigPathNodeBudget() : 0;
+    uint32_t nbProcessedNodes = 0;
     while (true)
     {
         // if the openList is empty we failed to find a path
         if (openList.empty())
             break;
 
+        if((nodeBudget > 0) && (nbProcessedNodes >= nodeBudget))
+        {
+            // The caller is responsible for reporting it if needed: this can happen every turn
+            if(nodeBudgetReached != nullptr)
+                *nodeBudgetReached = true;
+
+            break;
+        }
+        ++nbProcessedNodes;
+
         // openList being sorted, the last element is the smallest
         AstarEntry* smallestAstar = *openList.rbegin();
         openList.pop_back();
@@ -1533,6 +1793,8 @@ std::list<Tile*> GameMap::path(int x1, int y1, int x2, int y2, const Creature* c
             neighbor.setTile(neighborTile);
 
             bool processNeighbor = false;
+            // Cost of digging the tile if it has to be dug
+            double digCost = 0.0;
             // We process the tile if the creature can go through. But if it is the first tile that is
             // not passable, we also process it. That happens if a door is closed
             if((creature->canGoThroughTile(neighbor.getTile())) ||
@@ -1544,13 +1806,16 @@ std::list<Tile*> GameMap::path(int x1, int y1, int x2, int y2, const Creature* c
                     areTilesPassable[i] = true;
              }
             else if(throughDiggableTiles && neighbor.getTile()->isDiggable(seat))
+            {
                 processNeighbor = true;
+                digCost = computeDigPathCost(neighbor.getTile(), seat);
+            }
 
             if (!processNeighbor)
                 continue;
 
             // See if the neighbor has already been processed
-            AstarEntry* neighborEntry = processList[neighbor.getTile()->getX()][neighbor.getTile()->getY()];
+            AstarEntry* neighborEntry = getProcessedEntry(neighbor.getTile());
             if ((neighborEntry != nullptr) && (neighborEntry->getHasBeenProcessed()))
                 continue;
 
@@ -1564,6 +1829,7 @@ std::list<Tile*> GameMap::path(int x1, int y1, int x2, int y2, const Creature* c
                     weightToParent /= creature->getMoveSpeed(currentEntry->getTile());
                 else
                     weightToParent /= creature->getMoveSpeedGround();
+                weightToParent += digCost;
                 neighbor.setG(currentEntry->getG() + weightToParent);
 
                 // Use the manhattan distance for the heuristic
@@ -1579,7 +1845,7 @@ std::list<Tile*> GameMap::path(int x1, int y1, int x2, int y2, const Creature* c
                 }
 
                 openList.insert(itr, entry);
-                processList[neighbor.getTile()->getX()][neighbor.getTile()->getY()] = entry;
+                setProcessedEntry(entry);
             }
             else
             {
@@ -1592,6 +1858,7 @@ std::list<Tile*> GameMap::path(int x1, int y1, int x2, int y2, const Creature* c
                     weightToParent /= creature->getMoveSpeed(currentEntry->getTile());
                 else
                     weightToParent /= creature->getMoveSpeedGround();
+                weightToParent += digCost;
 
                 if (currentEntry->getG() + weightToParent < neighborEntry->getG())
                 {
@@ -1638,12 +1905,11 @@ std::list<Tile*> GameMap::path(int x1, int y1, int x2, int y2, const Creature* c
         } while (curEntry != nullptr);
     }
 
-    // Clean up the memory we allocated by deleting the astarEntries.  Note that
-    // processList contains all the created entries so it is enough to clean it.
-    for (std::vector<AstarEntry*>& column : processList)
+    // Clean up the memory we allocated by deleting the astarEntries.
+    for (AstarEntry* entry : createdEntries)
     {
-        for (AstarEntry* entry : column)
-            delete entry;
+        *mPathEntries.find(entry->getTile()->getX(), entry->getTile()->getY()) = 0;
+        delete entry;
     }
 
     return returnList;
@@ -1702,9 +1968,9 @@ Player* GameMap::getPlayerBySeat(Seat* seat) const
     return nullptr;
 }
 
-std::vector<GameEntity*> GameMap::getVisibleForce(const std::vector<Tile*>& visibleTiles, Seat* seat, bool enemyForce)
+TurnSpan<GameEntity*> GameMap::getVisibleForce(const std::vector<Tile*>& visibleTiles, Seat* seat, bool enemyForce)
 {
-    std::vector<GameEntity*> returnList;
+    TurnVector<GameEntity*> returnList(mTurnArena);
 
     // Loop over the visible tiles
     for (Tile* tile : visibleTiles)
@@ -1717,7 +1983,7 @@ std::vector<GameEntity*> GameMap::getVisibleForce(const std::vector<Tile*>& visi
 
         if(enemyForce)
         {
-            tile->fillWithEntities(returnList, SelectionEntityWanted::creatureAliveEnemyAttackable, seat->getPlayer());
+            tile->fillWithEntities(returnList, SelectionEntityWanted::creatureAliveEnemyAttackable, seat->getPlayer(), false);
             Building* building = tile->getCoveringBuilding();
             if((building != nullptr) &&
                (!building->getSeat()->isAlliedSeat(seat)) &&
@@ -1729,7 +1995,7 @@ std::vector<GameEntity*> GameMap::getVisibleForce(const std::vector<Tile*>& visi
         }
         else
         {
-            tile->fillWithEntities(returnList, SelectionEntityWanted::creatureAliveAllied, seat->getPlayer());
+            tile->fillWithEntities(returnList, SelectionEntityWanted::creatureAliveAllied, seat->getPlayer(), false);
             Building* building = tile->getCoveringBuilding();
             if((building != nullptr) &&
                (building->getSeat()->isAlliedSeat(seat)) &&
@@ -1740,7 +2006,7 @@ std::vector<GameEntity*> GameMap::getVisibleForce(const std::vector<Tile*>& visi
         }
     }
 
-    return returnList;
+    return returnList.span();
 }
 
 std::vector<GameEntity*> GameMap::getVisibleCreatures(const std::vector<Tile*>& visibleTiles, Seat* seat, bool enemyCreatures)
@@ -1758,20 +2024,20 @@ std::vector<GameEntity*> GameMap::getVisibleCreatures(const std::vector<Tile*>&
 
         if(enemyCreatures)
         {
-            tile->fillWithEntities(returnList, SelectionEntityWanted::creatureAliveEnemyAttackable, seat->getPlayer());
+            tile->fillWithEntities(returnList, SelectionEntityWanted::creatureAliveEnemyAttackable, seat->getPlayer(), false);
         }
         else
         {
-            tile->fillWithEntities(returnList, SelectionEntityWanted::creatureAliveAllied, seat->getPlayer());
+            tile->fillWithEntities(returnList, SelectionEntityWanted::creatureAliveAllied, seat->getPlayer(), false);
         }
     }
 
     return returnList;
 }
 
-std::vector<GameEntity*> GameMap::getCarryableEntities(Creature* carrier, const std::vector<Tile*>& tiles)
+TurnSpan<GameEntity*> GameMap::getCarryableEntities(Creature* carrier, const std::vector<Tile*>& tiles)
 {
-    std::vector<GameEntity*> returnList;
+    TurnVector<GameEntity*> returnList(mTurnArena);
 
     // Loop over the visible tiles
     for (Tile* tile : tiles)
@@ -1785,7 +2051,7 @@ std::vector<GameEntity*> GameMap::getCarryableEntities(Creature* carrier, const
         tile->fillWithCarryableEntities(carrier, returnList);
     }
 
-    return returnList;
+    return returnList.span();
 }
 
 void GameMap::clearRooms()
@@ -1799,6 +2065,7 @@ void GameMap::clearRooms()
     }
 
     mRooms.clear();
+    mRoomIndex.clear();
 }
 
 void GameMap::addRoom(Room *r)
@@ -1812,6 +2079,7 @@ void GameMap::addRoom(Room *r)
     }
 
     mRooms.push_back(r);
+    mRoomIndex.addRoom(r);
 }
 
 void GameMap::removeRoom(Room *r)
@@ -1827,64 +2095,47 @@ void GameMap::removeRoom(Room *r)
     }
 
     mRooms.erase(it);
+    mRoomIndex.removeRoom(r);
 }
 
-std::vector<Room*> GameMap::getRoomsByType(RoomType type) const
+RoomsView GameMap::getRoomsByType(RoomType type) const
 {
-    std::vector<Room*> returnList;
-    for (Room* room : mRooms)
-    {
-        if (room->getType() == type  && room->getHP(nullptr) > 0.0)
-            returnList.push_back(room);
-    }
-
-    return returnList;
+    return mRoomIndex.getRooms(type);
 }
 
-std::vector<Room*> GameMap::getRoomsByTypeAndSeat(RoomType type, const Seat* seat)
+RoomsView GameMap::getRoomsByTypeAndSeat(RoomType type, const Seat* seat) const
 {
-    std::vector<Room*> returnList;
-    for (Room* room : mRooms)
-    {
-        if (room->getType() == type && room->getSeat() == seat && room->getHP(nullptr) > 0.0)
-            returnList.push_back(room);
-    }
+    return mRoomIndex.getRooms(type, seat);
+}
 
-    return returnList;
+unsigned int GameMap::numRoomsByTypeAndSeat(RoomType type, const Seat* seat) const
+{
+    return mRoomIndex.getRooms(type, seat).size();
 }
 
-std::vector<const Room*> GameMap::getRoomsByTypeAndSeat(RoomType type, const Seat* seat) const
+int32_t GameMap::getRoomsFreeCapacity(RoomType type, const Seat* seat) const
 {
-    std::vector<const Room*> returnList;
-    for (const Room* room : mRooms)
-    {
-        if (room->getType() == type && room->getSeat() == seat && room->getHP(nullptr) > 0.0)
-            returnList.push_back(room);
-    }
+    return mRoomIndex.getFreeCapacity(type, seat);
+}
 
-    return returnList;
+void GameMap::notifyRoomSeatChanged(Room* room, const Seat* oldSeat)
+{
+    mRoomIndex.notifyRoomSeatChanged(room, oldSeat);
 }
 
-unsigned int GameMap::numRoomsByTypeAndSeat(RoomType type, const Seat* seat) const
+void GameMap::notifyRoomFreeCapacityChanged(const Room* room, int32_t delta)
 {
-    int cptRooms = 0;
-    for (Room* room : mRooms)
-    {
-        if (room->getType() == type && room->getSeat() == seat && room->getHP(nullptr) > 0.0)
-            ++cptRooms;
-    }
-    return cptRooms;
+    mRoomIndex.notifyRoomFreeCapacityChanged(room, delta);
 }
 
-std::vector<Room*> GameMap::getReachableRooms(const std::vector<Room*>& vec,
+std::vector<Room*> GameMap::getReachableRooms(const RoomsView& rooms,
                                               Tile* startTile,
                                               const Creature* creature)
 {
     std::vector<Room*> returnVector;
 
-    for (unsigned int i = 0; i < vec.size(); ++i)
+    for (Room* room : rooms)
     {
-        Room* room = vec[i];
         Tile* coveredTile = room->getCoveredTile(0);
         if (pathExists(creature, startTile, coveredTile))
         {
@@ -1995,11 +2246,8 @@ bool GameMap::withdrawFromTreasuries(int gold, Seat* seat)
 
     // Loop over the treasuries withdrawing gold until the full amount has been withdrawn.
     int goldStillNeeded = gold;
-    for (Room* room : getRooms())
+    for (Room* room : getRoomsByTypeAndSeat(RoomType::treasury, seat))
     {
-        if(room->getSeat() != seat)
-            continue;
-
         int goldTaken = room->withdrawGold(goldStillNeeded);
         goldStillNeeded -= goldTaken;
         if(goldStillNeeded <= 0)
@@ -2078,6 +2326,15 @@ bool GameMap::addSeat(Seat *s)
             return false;
         }
     }
+
+    if(mSeats.size() >= Seat::MAX_NB_SEATS)
+    {
+        OD_LOG_ERR("Too many seats. Cannot add seat id=" + Helper::toString(s->getId()));
+        return false;
+    }
+
+    s->mSeatIndex = static_cast<uint32_t>(mSeats.size());
+    s->mAlliedSeatsMask = s->getSeatMask();
     mSeats.push_back(s);
     // We set the Seat color value
     const Ogre::ColourValue& colorValue = ConfigManager::getSingleton().getColorFromId(s->getColorId());
@@ -2447,9 +2704,10 @@ std::list<Tile*> GameMap::path(Creature *c1, Creature *c2, const Creature* creat
                 c2->getPositionTile()->getX(), c2->getPositionTile()->getY(), creature, seat, throughDiggableTiles);
 }
 
-std::list<Tile*> GameMap::path(Tile *t1, Tile *t2, const Creature* creature, Seat* seat, bool throughDiggableTiles)
+std::list<Tile*> GameMap::path(Tile *t1, Tile *t2, const Creature* creature, Seat* seat, bool throughDiggableTiles,
+    bool* nodeBudgetReached)
 {
-    return path(t1->getX(), t1->getY(), t2->getX(), t2->getY(), creature, seat, throughDiggableTiles);
+    return path(t1->getX(), t1->getY(), t2->getX(), t2->getY(), creature, seat, throughDiggableTiles, nodeBudgetReached);
 }
 
 std::list<Tile*> GameMap::path(const Creature* creature, Tile* destination, bool throughDiggableTiles)
@@ -2476,15 +2734,48 @@ void GameMap::processDeletionQueues()
 
 void GameMap::refreshBorderingTilesOf(const std::vector<Tile*>& affectedTiles)
 {
-    // Add the tiles which border the affected region to the affectedTiles vector since they may need to have their meshes changed.
-    std::vector<Tile*> borderTiles = tilesBorderedByRegion(affectedTiles);
+    // The affected tiles are forced to examine their neighbors.  This allows them to switch to a mesh
+    // with fewer polygons if some are hidden by the neighbors, etc.
+    // The bordering tiles did not change. Their mesh only depends on the links with their neighbours
+    // so they are only refreshed if their link mask changed
+    forEachTileBorderedByRegion(affectedTiles, [this](Tile* tile, bool isAffected)
+    {
+        if(updateTileLinkMask(tile) || isAffected)
+            queueTileMeshRefresh(tile);
+    });
+}
 
-    borderTiles.insert(borderTiles.end(), affectedTiles.begin(), affectedTiles.end());
+void GameMap::queueTileMeshRefresh(Tile* tile)
+{
+    if(tile->getMeshRefreshQueued())
+        return;
+
+    tile->setMeshRefreshQueued(true);
+    mTilesMeshToRefresh.push_back(tile);
+}
+
+void GameMap::processTileMeshRefreshQueue(uint64_t timeBudgetMicroseconds)
+{
+    mNbTileMeshRefreshedLastCall = 0;
+    if(mTilesMeshToRefresh.empty())
+        return;
+
+    Ogre::Timer stopwatch;
+    uint32_t index = 0;
+    while(index < mTilesMeshToRefresh.size())
+    {
+        if((index > 0) && (stopwatch.getMicroseconds() >= timeBudgetMicroseconds))
+            break;
 
-    // Loop over all the affected tiles and force them to examine their neighbors.  This allows
-    // them to switch to a mesh with fewer polygons if some are hidden by the neighbors, etc.
-    for (Tile* tile : borderTiles)
+        // We unflag the tile before refreshing it in case the refresh queues it again
+        Tile* tile = mTilesMeshToRefresh[index];
+        ++index;
+        tile->setMeshRefreshQueued(false);
         tile->refreshMesh();
+    }
+
+    mNbTileMeshRefreshedLastCall = index;
+    mTilesMeshToRefresh.erase(mTilesMeshToRefresh.begin(), mTilesMeshToRefresh.begin() + index);
 }
 
 std::vector<Tile*> GameMap::getBuildableTilesForPlayerInArea(int x1, int y1, int x2, int y2,
@@ -2719,6 +3010,45 @@ void GameMap::logFloodFileTiles()
     }
 }
 
+void GameMap::fillMemoryReport(MemoryReport& report) const
+{
+    TileContainer::fillMemoryReport(report);
+
+    std::size_t seatsBytes = 0;
+    for(Seat* seat : mSeats)
+        seatsBytes += seat->getTilesStatesMemoryUsed();
+    report.add("seatTilesStates", seatsBytes);
+
+    report.add("entityLists", MemoryReport::vectorBytes(mCreatures)
+        + MemoryReport::vectorBytes(mAnimatedObjects)
+        + MemoryReport::vectorBytes(mActiveObjects)
+        + MemoryReport::vectorBytes(mEntitiesToDelete)
+        + MemoryReport::vectorBytes(mGameEntityClientUpkeep)
+        + MemoryReport::vectorBytes(mRooms)
+        + MemoryReport::vectorBytes(mTraps)
+        + MemoryReport::vectorBytes(mMapLights)
+        + MemoryReport::vectorBytes(mRenderedMovableEntities)
+        + MemoryReport::vectorBytes(mSpells)
+        + MemoryReport::vectorBytes(mTilesMeshToRefresh)
+        + MemoryReport::vectorBytes(mVisionCreatures)
+        + MemoryReport::vectorBytes(mMovementBatch.mEntities)
+        + (mMovementBatch.mPosX.capacity() + mMovementBatch.mPosY.capacity() + mMovementBatch.mPosZ.capacity()
+            + mMovementBatch.mDestX.capacity() + mMovementBatch.mDestY.capacity() + mMovementBatch.mDestZ.capacity()
+            + mMovementBatch.mMoveDist.capacity() + mMovementBatch.mDirX.capacity() + mMovementBatch.mDirY.capacity()
+            + mMovementBatch.mDirZ.capacity()) * sizeof(float)
+        + MemoryReport::vectorBytes(mMovementBatch.mReached));
+
+    std::size_t creaturesBytes = mCreatures.size() * sizeof(Creature);
+    for(Creature* creature : mCreatures)
+        creature->fillMemoryReport(report);
+    report.add("creatures", creaturesBytes);
+
+    report.add("turnArena", mTurnArena.getCapacity());
+
+    report.add("pathfinding", mPathEntries.getMemoryUsed());
+    report.add("claimedTiles", mClaimedTiles.getMemoryUsed());
+}
+
 void GameMap::consoleSetCreatureDestination(const std::string& creatureName, int x, int y)
 {
     Creature* creature = getCreature(creatureName);
@@ -2895,7 +3225,16 @@ const std::string& GameMap::getMeshForDefaultTile() const
 
 const TileSetValue& GameMap::getMeshForTile(const Tile* tile) const
 {
-    int index = 0;
+    return mTileSet->getTileValues(tile->getTileVisual()).at(tile->getLinkMask());
+}
+
+bool GameMap::updateTileLinkMask(Tile* tile)
+{
+    // The tileset is set when the entities are created. The masks will be computed at that time
+    if(mTileSet == nullptr)
+        return true;
+
+    uint8_t index = 0;
     for(int i = 0; i < 4; ++i)
     {
         int diffX;
@@ -2928,15 +3267,60 @@ const TileSetValue& GameMap::getMeshForTile(const Tile* tile) const
             index |= (1 << i);
     }
 
-    return mTileSet->getTileValues(tile->getTileVisual()).at(index);
+    if(tile->getLinkMask() == index)
+        return false;
+
+    tile->setLinkMask(index);
+    return true;
+}
+
+void GameMap::computeAllTileLinkMasks()
+{
+    if((mMapSizeX <= 0) || (mMapSizeY <= 0))
+        return;
+
+    // We gather the visual bit and the links of every tile (column by column like mTiles). Then,
+    // the masks are computed with bit operations only. Tiles outside the map are not linked
+    const int sizeX = mMapSizeX;
+    const int sizeY = mMapSizeY;
+    std::vector<uint32_t> visualBits(sizeX * sizeY);
+    std::vector<uint32_t> links(sizeX * sizeY);
+    for (int xx = 0; xx < sizeX; ++xx)
+    {
+        for (int yy = 0; yy < sizeY; ++yy)
+        {
+            TileVisual tileVisual = getTile(xx, yy)->getTileVisual();
+            visualBits[xx * sizeY + yy] = 1 << static_cast<uint32_t>(tileVisual);
+            links[xx * sizeY + yy] = mTileSet->getTileLinks(tileVisual);
+        }
+    }
+
+    for (int xx = 0; xx < sizeX; ++xx)
+    {
+        for (int yy = 0; yy < sizeY; ++yy)
+        {
+            const int index = xx * sizeY + yy;
+            const uint32_t tileLinks = links[index];
+            uint8_t mask = 0;
+            if(yy > 0)
+                mask |= ((tileLinks & visualBits[index - 1]) != 0) ? 1 : 0;
+            if(xx < sizeX - 1)
+                mask |= ((tileLinks & visualBits[index + sizeY]) != 0) ? 2 : 0;
+            if(yy < sizeY - 1)
+                mask |= ((tileLinks & visualBits[index + 1]) != 0) ? 4 : 0;
+            if(xx > 0)
+                mask |= ((tileLinks & visualBits[index - sizeY]) != 0) ? 8 : 0;
+
+            getTile(xx, yy)->setLinkMask(mask);
+        }
+    }
 }
 
 uint32_t GameMap::getMaxNumberCreatures(Seat* seat) const
 {
     uint32_t nbCreatures = ConfigManager::getSingleton().getMaxCreaturesPerSeatDefault();
 
-    std::vector<const Room*> portals = getRoomsByTypeAndSeat(RoomType::portal, seat);
-    for(const Room* room : portals)
+    for(const Room* room : getRoomsByTypeAndSeat(RoomType::portal, seat))
     {
         const RoomPortal* roomPortal = static_cast<const RoomPortal*>(room);
         nbCreatures += roomPortal->getNbCreatureMaxIncrease();
@@ -3104,7 +3488,7 @@ void GameMap::doorLock(Tile* tileDoor, Seat* seat, bool locked)
             continue;
         }
 
-        std::vector<Creature*> alliedCreatures = getCreaturesBySeat(seat);
+        TurnSpan<Creature*> alliedCreatures = getCreaturesBySeat(seat);
         for(Creature* creature : alliedCreatures)
         {
             if(!pathExists(creature, tileDoor, creature->getPositionTile()))
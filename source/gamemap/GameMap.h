@@ -21,6 +21,9 @@
 #include "gamemap/TileContainer.h"
 
 #include "ai/AIManager.h"
+#include "gamemap/RoomIndex.h"
+#include "utils/ChunkedGrid.h"
+#include "utils/TurnArena.h"
 
 #ifdef __MINGW32__
 #ifndef mode_t
@@ -32,9 +35,11 @@
 #include <map>
 #include <memory>
 #include <string>
+#include <vector>
 
 #include <OgreVector3.h>
 
+class AstarEntry;
 class Building;
 class Tile;
 class Creature;
@@ -44,6 +49,7 @@ class Trap;
 class Seat;
 class Goal;
 class MapLight;
+class MemoryReport;
 class MovableGameEntity;
 class CreatureDefinition;
 class Weapon;
@@ -53,6 +59,7 @@ class Room;
 class Spell;
 class TileSet;
 class TileSetValue;
+class WorkerPool;
 
 enum class GameEntityType;
 enum class FloodFillType;
@@ -159,7 +166,8 @@ public:
 
     //! \brief Returns a vector containing all the creatures controlled by the given seat.
     std::vector<Creature*> getCreaturesByAlliedSeat(const Seat* seat) const;
-    std::vector<Creature*> getCreaturesBySeat(const Seat* seat) const;
+    //! \brief Returns the alive creatures controlled by the given seat. The list is allocated in the turn arena
+    TurnSpan<Creature*> getCreaturesBySeat(const Seat* seat) const;
 
     inline const std::vector<Creature*>& getCreatures() const
     { return mCreatures; }
@@ -203,14 +211,14 @@ public:
     //! \brief Returns the total number of class descriptions stored in this game map.
     unsigned int numClassDescriptions();
 
-    void saveLevelClassDescriptions(std::ofstream& levelFile);
+    void saveLevelClassDescriptions(std::ostream& levelFile);
 
     void addWeapon(const Weapon* weapon);
     const Weapon* getWeapon(int index);
     const Weapon* getWeapon(const std::string& name);
     Weapon* getWeaponForTuning(const std::string& name);
     uint32_t numWeapons();
-    void saveLevelEquipments(std::ofstream& levelFile);
+    void saveLevelEquipments(std::ostream& levelFile);
 
     //! \brief Calls the deleteYourself() method on each of the rooms in the game map as well as clearing the vector of stored rooms.
     void clearRooms();
@@ -226,14 +234,23 @@ public:
     inline const std::vector<Room*>& getRooms() const
     { return mRooms; }
 
-    std::vector<Room*> getRoomsByType(RoomType type) const;
-    std::vector<Room*> getRoomsByTypeAndSeat(RoomType type,
-                        const Seat* seat);
-    std::vector<const Room*> getRoomsByTypeAndSeat(RoomType type,
-                          const Seat* seat) const;
+    //! \brief Returns a view on the rooms of the given type (and seat). The view does not copy
+    //! the rooms and should not be kept after rooms are added/removed
+    RoomsView getRoomsByType(RoomType type) const;
+    RoomsView getRoomsByTypeAndSeat(RoomType type,
+                        const Seat* seat) const;
     unsigned int numRoomsByTypeAndSeat(RoomType type,
                       const Seat* seat) const;
-    std::vector<Room*> getReachableRooms(const std::vector<Room*> &vec,
+
+    //! \brief Returns the sum of the free capacity of the rooms of the given type owned by the seat
+    //! (see Room::getFreeCapacity). Allows to know if there is a room with space without scanning them
+    int32_t getRoomsFreeCapacity(RoomType type, const Seat* seat) const;
+
+    //! \brief Should be called when a room changes seat (when claimed for example) or its free capacity changes
+    void notifyRoomSeatChanged(Room* room, const Seat* oldSeat);
+    void notifyRoomFreeCapacityChanged(const Room* room, int32_t delta);
+
+    std::vector<Room*> getReachableRooms(const RoomsView& rooms,
                        Tile *startTile, const Creature* creature);
     std::vector<Building*> getReachableBuildingsPerSeat(Seat* seat,
         Tile *startTile, const Creature* creature);
@@ -329,6 +346,13 @@ public:
     inline void setLevelMusicFile(const std::string& levelMusicFile)
     { mMapInfoMusicFile = levelMusicFile; }
 
+    //! \brief Seed of the random streams read from the level (savegames). 0 if the level has none
+    inline uint64_t getGameSeed() const
+    { return mGameSeed; }
+
+    inline void setGameSeed(uint64_t gameSeed)
+    { mGameSeed = gameSeed; }
+
     inline const std::string& getLevelFightMusicFile() const
     { return mMapInfoFightMusicFile; }
 
@@ -367,23 +391,42 @@ public:
      * if the creature can go through the 4 tiles.
      * \param seat The seat is used when searching a diggable path to know
      * what tile actually diggable for the given team.
+     * \param throughDiggableTiles If true, the diggable tiles are passable with a cost depending on their
+     * fullness, gold and claimed walls having additional penalties (see DigPath* in the global config).
+     * The number of processed tiles is then limited by DigPathNodeBudget and an empty path is returned
+     * if it is reached before finding the destination.
+     * \param nodeBudgetReached If not null, set to true if the search was stopped by DigPathNodeBudget
+     * and to false otherwise.
      */
-    std::list<Tile*> path(int x1, int y1, int x2, int y2, const Creature* creature, Seat* seat, bool throughDiggableTiles = false);
+    std::list<Tile*> path(int x1, int y1, int x2, int y2, const Creature* creature, Seat* seat, bool throughDiggableTiles = false,
+        bool* nodeBudgetReached = nullptr);
     std::list<Tile*> path(Creature *c1, Creature *c2, const Creature* creature, Seat* seat, bool throughDiggableTiles = false);
-    std::list<Tile*> path(Tile *t1, Tile *t2, const Creature* creature, Seat* seat, bool throughDiggableTiles = false);
+    std::list<Tile*> path(Tile *t1, Tile *t2, const Creature* creature, Seat* seat, bool throughDiggableTiles = false,
+        bool* nodeBudgetReached = nullptr);
     //! \note Returns a path for the given creature to the given destination.
     std::list<Tile*> path(const Creature* creature, Tile* destination, bool throughDiggableTiles = false);
 
     //! \brief Loops over the visibleTiles and returns any creature/room/trap in those tiles allied with the given seat
-    //! (or if enemyForce is true, is not allied)
-    std::vector<GameEntity*> getVisibleForce(const std::vector<Tile*>& visibleTiles, Seat* seat, bool enemyForce);
+    //! (or if enemyForce is true, is not allied). The tiles in visibleTiles are expected to be distinct. The list
+    //! is allocated in the turn arena
+    TurnSpan<GameEntity*> getVisibleForce(const std::vector<Tile*>& visibleTiles, Seat* seat, bool enemyForce);
 
     //! \brief Loops over the visibleTiles and returns any creature in those tiles allied with the given seat.
-    //! (or if enemyCreatures is true, is not allied)
+    //! (or if enemyCreatures is true, is not allied). The tiles in visibleTiles are expected to be distinct
     std::vector<GameEntity*> getVisibleCreatures(const std::vector<Tile*>& visibleTiles, Seat* seat, bool enemyCreatures);
 
-    //! \brief Loops over the given tiles and returns any carryable entity in those tiles
-    std::vector<GameEntity*> getCarryableEntities(Creature* carrier, const std::vector<Tile*>& tiles);
+    //! \brief Loops over the given tiles and returns any carryable entity in those tiles. The list is allocated
+    //! in the turn arena
+    TurnSpan<GameEntity*> getCarryableEntities(Creature* carrier, const std::vector<Tile*>& tiles);
+
+    //! \brief Arena where the lists returned by the server queries during a turn are allocated (see TurnArena).
+    //! What is allocated in it is only valid until the end of the turn
+    inline TurnArena& getTurnArena() const
+    { return mTurnArena; }
+
+    //! \brief Releases what has been allocated in the turn arena. Called by the server at the end of each turn
+    inline void resetTurnArena()
+    { mTurnArena.reset(); }
 
     //! \brief Checks the neighboor tiles to see if the floodfill can be used. Floodfill consists on tagging all contiguous tiles
     //! to be able to know before computing it if a path exists between 2 tiles. We do that to avoid computing paths when we
@@ -434,9 +477,26 @@ public:
     inline void setGamePaused(bool paused)
     { mIsPaused = paused; }
 
-    //! \brief Refresh the tiles borders based a recent change on the map
+    //! \brief Refresh the tiles borders based a recent change on the map. The tiles are queued (see queueTileMeshRefresh)
+    //! The bordering tiles whose link mask did not change are not refreshed
     void refreshBorderingTilesOf(const std::vector<Tile*>& affectedTiles);
 
+    //! \brief Queues the given tile so that its mesh is refreshed during the next call to processTileMeshRefreshQueue.
+    //! A tile queued several times before being refreshed is only refreshed once. Used on client side
+    void queueTileMeshRefresh(Tile* tile);
+
+    //! \brief Refreshes the meshes of the queued tiles. Once timeBudgetMicroseconds is elapsed, the remaining tiles
+    //! are kept for the next call (at least one tile is refreshed per call)
+    void processTileMeshRefreshQueue(uint64_t timeBudgetMicroseconds);
+
+    //! \brief Number of tiles refreshed during the last call to processTileMeshRefreshQueue
+    inline uint32_t getNbTileMeshRefreshedLastCall() const
+    { return mNbTileMeshRefreshedLastCall; }
+
+    //! \brief Number of tiles waiting for their mesh to be refreshed
+    inline uint32_t getNbTileMeshRefreshQueued() const
+    { return mTilesMeshToRefresh.size(); }
+
     std::vector<Tile*> getBuildableTilesForPlayerInArea(int x1, int y1, int x2, int y2,
         Player* player);
 
@@ -449,6 +509,10 @@ public:
     uint32_t getMaxNumberCreatures(Seat* seat) const;
 
     void logFloodFileTiles();
+
+    //! \brief Adds the memory used by the gamemap main containers (tiles, seats tile states, entity lists,
+    //! creatures, pathfinding) to the given report
+    void fillMemoryReport(MemoryReport& report) const;
     void consoleSetCreatureDestination(const std::string& creatureName, int x, int y);
     void consoleToggleCreatureVisualDebug(const std::string& creatureName);
     void consoleToggleSeatVisualDebug(int seatId);
@@ -494,6 +558,15 @@ public:
 
     void updateVisibleEntities();
 
+    //! \brief Tiles vision is only valid for the current stamp. Incrementing it clears the vision of every
+    //! tile at once (see Tile::notifyVision)
+    inline uint32_t getTilesVisionStamp() const
+    { return mTilesVisionStamp; }
+
+    //! \brief Called by the server tiles when they get claimed or unclaimed. Only the claimed tiles give
+    //! vision so the vision pass of doMiscUpkeep only goes through the regions where tiles have been claimed
+    void tileClaimedChanged(const Tile* tile, bool isClaimed);
+
     void fireRefreshEntities();
 
     inline const std::vector<RenderedMovableEntity*>& getRenderedMovableEntities() const
@@ -508,9 +581,19 @@ public:
     //! \brief getMeshForDefaultTile returns a mesh for some default dirt tile. This
     //! is used as a workaround to avoid lightning issues
     const std::string& getMeshForDefaultTile() const;
-    //! \brief get the tileset infos for the given tile
+    //! \brief get the tileset infos for the given tile. Uses the tile link mask (see updateTileLinkMask)
     const TileSetValue& getMeshForTile(const Tile* tile) const;
 
+    //! \brief Computes the link mask of the given tile with its neighbours and stores it in the tile.
+    //! Returns true if the mask changed. Used on client side
+    bool updateTileLinkMask(Tile* tile);
+
+    //! \brief Computes the link mask of every tile. Called once the level is loaded on client side
+    void computeAllTileLinkMasks();
+
+    inline const TileSet* getTileSet() const
+    { return mTileSet; }
+
     void playerSelects(std::vector<GameEntity*>& entities, int tileX1, int tileY1, int tileX2,
         int tileY2, SelectionTileAllowed tileAllowed, SelectionEntityWanted entityWanted, Player* player);
 
@@ -575,9 +658,35 @@ private:
     std::string mMapInfoDescription;
     std::string mMapInfoMusicFile;
     std::string mMapInfoFightMusicFile;
+    uint64_t mGameSeed;
+
+    //! \brief See getTilesVisionStamp
+    uint32_t mTilesVisionStamp;
+
+    //! \brief 1 for the claimed tiles (see tileClaimedChanged). A chunk is only allocated once one of its tiles
+    //! gets claimed so that, on big maps, the regions nobody claimed are skipped by the vision pass
+    ChunkedGrid<uint8_t> mClaimedTiles;
+
+    //! \brief Entries of the current path search by tile: index + 1 of the entry in the search created entries
+    //! or 0 if the tile has no entry. Chunked so that only the regions reached by path searches use memory
+    //! (4 bytes per tile) and set back to 0 at the end of each search so that it never has to be cleared
+    ChunkedGrid<uint32_t> mPathEntries;
 
     std::vector<Creature*> mCreatures;
 
+    //! \brief Creatures giving vision during the current turn. Kept between turns to avoid allocations
+    std::vector<Creature*> mVisionCreatures;
+
+    //! \brief Work vectors for each range of creatures whose vision is computed by mTurnWorkerPool
+    std::vector<std::unique_ptr<TileVisibilityWork>> mVisionWorks;
+
+    //! \brief Threads helping the server thread during the parallel parts of the turn. Created on first use
+    std::unique_ptr<WorkerPool> mTurnWorkerPool;
+
+    //! \brief Computes creatures vision. The tiles in sight are computed by mTurnWorkerPool (each
+    //! creature only modifies its own vectors). Then, the tiles are tagged as visible in mCreatures order
+    void computeCreaturesVisibleTiles();
+
     //! \brief The creature definition data. We use a pair to be able to make the difference between the original
     //! data from the global creature definition file and the specific data from the level file. With this trick,
     //! we will be able to compare and write the differences in the level file.
@@ -588,8 +697,41 @@ private:
     //Mutable to allow locking in const functions.
     std::vector<MovableGameEntity*> mAnimatedObjects;
 
+    //! \brief Packed motion data of the walking entities used by the server side movement step
+    //! in updateAnimations. The arrays are indexed the same way as mEntities and are kept between
+    //! turns to avoid reallocations
+    struct MovementBatch
+    {
+        std::vector<MovableGameEntity*> mEntities;
+        std::vector<float> mPosX;
+        std::vector<float> mPosY;
+        std::vector<float> mPosZ;
+        std::vector<float> mDestX;
+        std::vector<float> mDestY;
+        std::vector<float> mDestZ;
+        std::vector<float> mMoveDist;
+        std::vector<float> mDirX;
+        std::vector<float> mDirY;
+        std::vector<float> mDirZ;
+        std::vector<uint8_t> mReached;
+
+        void clear();
+        void resize(std::size_t size);
+    };
+    MovementBatch mMovementBatch;
+
+    //! \brief See getTurnArena. Mutable because the const queries allocate their results in it
+    mutable TurnArena mTurnArena;
+
+    //! \brief Server side movement step. Entities walking towards a waypoint are integrated
+    //! in a single loop over mMovementBatch. Only entities reaching a waypoint or changing tile
+    //! go through MovableGameEntity::update
+    void updateMovementBatch(Ogre::Real timeSinceLastFrame);
+
     //! \brief Map Entities
     std::vector<Room*> mRooms;
+    //! \brief Rooms from mRooms sorted by type and seat
+    RoomIndex mRoomIndex;
     std::vector<Trap*> mTraps;
     std::vector<MapLight*> mMapLights;
 
@@ -615,6 +757,12 @@ private:
     //! \brief Useless entities that need to be deleted. They will be deleted when processDeletionQueues is called
     std::vector<GameEntity*> mEntitiesToDelete;
 
+    //! \brief Tiles waiting for their mesh to be refreshed (see queueTileMeshRefresh). Used on client side
+    std::vector<Tile*> mTilesMeshToRefresh;
+
+    //! \brief See getNbTileMeshRefreshedLastCall
+    uint32_t mNbTileMeshRefreshedLastCall;
+
     //! \brief Debug member used to know how many call to pathfinding has been made within the same turn.
     unsigned int mNumCallsTo_path;
 
@@ -632,9 +780,13 @@ private:
     std::string mTileSetName;
 
     //! \brief Updates different entities states.
-    //! Updates active objects (creatures, rooms, ...), goals, count each team Workers, gold, mana and claimed tiles.
+    //! Updates active objects (creatures, rooms, ...), goals and mana.
     unsigned long int doMiscUpkeep(double timeSinceLastTurn);
 
+    //! \brief Recomputes gold, creatures and claimed tiles counters from scratch and logs an error
+    //! if they do not match the ones maintained incrementally by the seats. Used in debug only
+    void checkSeatCounters() const;
+
     //! \brief Resets the unique numbers
     void resetUniqueNumbers();
 };
@@ -0,0 +1,304 @@
+/*
+ *  Copyright (C) 2011-2016  OpenDungeons Team
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "gamemap/LevelInfoIndex.h"
+
+#include "utils/Helper.h"
+#include "utils/LogManager.h"
+
+#include "ODApplication.h"
+
+#include <SFML/System.hpp>
+
+#include <boost/filesystem.hpp>
+
+#include <fstream>
+#include <set>
+#include <sstream>
+
+template<> LevelInfoIndex* Ogre::Singleton<LevelInfoIndex>::msSingleton = nullptr;
+
+namespace
+{
+//! \brief Escapes the characters that would prevent a value to be saved on one line in the index file
+std::string escapeValue(const std::string& value)
+{
+    std::string escaped;
+    escaped.reserve(value.size());
+    for(char c : value)
+    {
+        switch(c)
+        {
+            case '\\':
+                escaped += "\\\\";
+                break;
+            case '\n':
+                escaped += "\\n";
+                break;
+            default:
+                escaped += c;
+                break;
+        }
+    }
+    return escaped;
+}
+
+std::string unescapeValue(const std::string& value)
+{
+    std::string unescaped;
+    unescaped.reserve(value.size());
+    for(uint32_t i = 0; i < value.size(); ++i)
+    {
+        if((value[i] != '\\') || (i + 1 >= value.size()))
+        {
+            unescaped += value[i];
+            continue;
+        }
+
+        ++i;
+        if(value[i] == 'n')
+            unescaped += '\n';
+        else
+            unescaped += value[i];
+    }
+    return unescaped;
+}
+
+//! \brief Gets the modification time and size of the given file. Returns false if the file cannot be accessed
+bool getFileStamp(const std::string& fileName, std::time_t& lastWriteTime, uintmax_t& fileSize)
+{
+    boost::system::error_code ec;
+    lastWriteTime = boost::filesystem::last_write_time(fileName, ec);
+    if(ec)
+        return false;
+
+    fileSize = boost::filesystem::file_size(fileName, ec);
+    if(ec)
+        return false;
+
+    return true;
+}
+}
+
+LevelInfoIndex::LevelInfoIndex(const std::string& indexFileName) :
+    mIndexFileName(indexFileName),
+    mIsDirty(false),
+    mRefreshThread(nullptr),
+    mIsRefreshing(false),
+    mStopRefresh(false)
+{
+    load();
+}
+
+LevelInfoIndex::~LevelInfoIndex()
+{
+    mStopRefresh = true;
+    waitRefreshThread();
+    save();
+}
+
+bool LevelInfoIndex::getLevelInfo(const std::string& fileName, LevelInfo& levelInfo)
+{
+    std::time_t lastWriteTime;
+    uintmax_t fileSize;
+    if(!getFileStamp(fileName, lastWriteTime, fileSize))
+    {
+        OD_LOG_WRN("File not found=" + fileName);
+        return false;
+    }
+
+    {
+        sf::Lock lock(mLock);
+        auto it = mEntries.find(fileName);
+        if((it != mEntries.end()) &&
+           (it->second.mLastWriteTime == lastWriteTime) &&
+           (it->second.mFileSize == fileSize))
+        {
+            if(!it->second.mIsValid)
+                return false;
+
+            levelInfo = it->second.mLevelInfo;
+            return true;
+        }
+    }
+
+    // The entry is missing or stale. We parse the level header without holding the lock
+    LevelInfoEntry entry;
+    entry.mLastWriteTime = lastWriteTime;
+    entry.mFileSize = fileSize;
+    entry.mIsValid = MapHandler::readMapInfo(fileName, entry.mLevelInfo);
+
+    sf::Lock lock(mLock);
+    mEntries[fileName] = entry;
+    mIsDirty = true;
+
+    if(!entry.mIsValid)
+        return false;
+
+    levelInfo = entry.mLevelInfo;
+    return true;
+}
+
+void LevelInfoIndex::startBackgroundRefresh(const std::vector<std::string>& levelPaths)
+{
+    if(mIsRefreshing)
+        return;
+
+    // The previous thread is done. We can delete it
+    waitRefreshThread();
+
+    mRefreshLevelPaths = levelPaths;
+    mStopRefresh = false;
+    mIsRefreshing = true;
+    mRefreshThread = new sf::Thread(&LevelInfoIndex::refreshThread, this);
+    mRefreshThread->launch();
+}
+
+bool LevelInfoIndex::save()
+{
+    sf::Lock lock(mLock);
+    if(!mIsDirty)
+        return true;
+
+    std::ofstream indexFile(mIndexFileName.c_str(), std::ofstream::out);
+    if (!indexFile.good())
+    {
+        OD_LOG_WRN("Couldn't open file for writing: " + mIndexFileName);
+        return false;
+    }
+
+    indexFile << ODApplication::VERSIONSTRING << std::endl;
+    indexFile << mEntries.size() << std::endl;
+    for(const std::pair<const std::string, LevelInfoEntry>& p : mEntries)
+    {
+        const LevelInfoEntry& entry = p.second;
+        indexFile << p.first << std::endl;
+        indexFile << entry.mLastWriteTime << "\t" << entry.mFileSize << "\t" << (entry.mIsValid ? 1 : 0) << std::endl;
+        indexFile << escapeValue(entry.mLevelInfo.mLevelName) << std::endl;
+        indexFile << escapeValue(entry.mLevelInfo.mLevelDescription) << std::endl;
+    }
+
+    indexFile.close();
+    if(!indexFile.good())
+    {
+        OD_LOG_WRN("Unexpected failure on file: " + mIndexFileName);
+        return false;
+    }
+
+    mIsDirty = false;
+    return true;
+}
+
+bool LevelInfoIndex::load()
+{
+    std::ifstream indexFile(mIndexFileName.c_str(), std::ifstream::in);
+    if (!indexFile.good())
+        return false;
+
+    // The level info depends on the level format. If the version changed, we rebuild the index
+    std::string line;
+    std::getline(indexFile, line);
+    if(line != ODApplication::VERSIONSTRING)
+    {
+        OD_LOG_INF("Level info index from another version, ignoring it: " + mIndexFileName);
+        return false;
+    }
+
+    std::getline(indexFile, line);
+    uint32_t nbEntries = Helper::toUInt32(line);
+
+    sf::Lock lock(mLock);
+    for(uint32_t i = 0; i < nbEntries; ++i)
+    {
+        std::string fileName;
+        std::string stamp;
+        std::string levelName;
+        std::string levelDescription;
+        if(!std::getline(indexFile, fileName) ||
+           !std::getline(indexFile, stamp) ||
+           !std::getline(indexFile, levelName) ||
+           !std::getline(indexFile, levelDescription))
+        {
+            OD_LOG_WRN("Corrupted level info index: " + mIndexFileName);
+            mEntries.clear();
+            return false;
+        }
+
+        LevelInfoEntry entry;
+        int isValid = 0;
+        std::stringstream ss(stamp);
+        ss >> entry.mLastWriteTime >> entry.mFileSize >> isValid;
+        entry.mIsValid = (isValid != 0);
+        entry.mLevelInfo.mLevelName = unescapeValue(levelName);
+        entry.mLevelInfo.mLevelDescription = unescapeValue(levelDescription);
+        mEntries[fileName] = entry;
+    }
+
+    OD_LOG_INF("Loaded " + Helper::toString(nbEntries) + " level info(s) from " + mIndexFileName);
+    return true;
+}
+
+void LevelInfoIndex::refreshThread()
+{
+    std::set<std::string> levelFiles;
+    for(const std::string& levelPath : mRefreshLevelPaths)
+    {
+        std::vector<std::string> filesList;
+        if(!Helper::fillFilesList(levelPath, filesList, MapHandler::LEVEL_EXTENSION))
+            continue;
+
+        for(const std::string& fileName : filesList)
+        {
+            if(mStopRefresh)
+                break;
+
+            levelFiles.insert(fileName);
+            LevelInfo levelInfo;
+            getLevelInfo(fileName, levelInfo);
+        }
+    }
+
+    // We remove the entries of the levels that do not exist anymore
+    if(!mStopRefresh)
+    {
+        sf::Lock lock(mLock);
+        for(auto it = mEntries.begin(); it != mEntries.end();)
+        {
+            boost::system::error_code ec;
+            if((levelFiles.count(it->first) > 0) || boost::filesystem::exists(it->first, ec))
+            {
+                ++it;
+                continue;
+            }
+
+            it = mEntries.erase(it);
+            mIsDirty = true;
+        }
+    }
+
+    save();
+    mIsRefreshing = false;
+}
+
+void LevelInfoIndex::waitRefreshThread()
+{
+    if(mRefreshThread == nullptr)
+        return;
+
+    delete mRefreshThread; // Delete waits for the thread to finish
+    mRefreshThread = nullptr;
+}
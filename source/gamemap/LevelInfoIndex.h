@@ -0,0 +1,108 @@
+/*
+ *  Copyright (C) 2011-2016  OpenDungeons Team
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef LEVELINFOINDEX_H
+#define LEVELINFOINDEX_H
+
+#include "gamemap/MapHandler.h"
+
+#include <OgreSingleton.h>
+
+#include <SFML/System/Mutex.hpp>
+
+#include <atomic>
+#include <cstdint>
+#include <ctime>
+#include <map>
+#include <string>
+#include <vector>
+
+namespace sf
+{
+class Thread;
+}
+
+//! \brief Keeps the LevelInfo of the level files so that the level lists in the menus do not have
+//! to parse every level each time they are displayed. An entry is used as long as the modification
+//! time and the size of the level file did not change. Otherwise, the level header is parsed again
+//! (see MapHandler::readMapInfo). The index is saved in the user data path so that it can be used
+//! the next time the game is launched. The level directories can be refreshed on a background thread
+//! when the game starts so that the stale entries are already updated when a menu is opened.
+//! getLevelInfo can be called from any thread.
+class LevelInfoIndex : public Ogre::Singleton<LevelInfoIndex>
+{
+public:
+    //! \brief Loads the index from the given file (if it exists)
+    LevelInfoIndex(const std::string& indexFileName);
+
+    //! \brief Stops the background refresh (if any) and saves the index if it changed
+    ~LevelInfoIndex();
+
+    //! \brief Returns the level info of the given level. Same behaviour as MapHandler::getMapInfo
+    bool getLevelInfo(const std::string& fileName, LevelInfo& levelInfo);
+
+    //! \brief Refreshes the levels in the given directories on a background thread. Entries of level
+    //! files that do not exist anymore are removed. Does nothing if a refresh is already in progress
+    void startBackgroundRefresh(const std::vector<std::string>& levelPaths);
+
+    //! \brief Saves the index if it changed since it was loaded/saved
+    bool save();
+
+private:
+    struct LevelInfoEntry
+    {
+        LevelInfoEntry() :
+            mLastWriteTime(0),
+            mFileSize(0),
+            mIsValid(false)
+        {}
+
+        std::time_t mLastWriteTime;
+        uintmax_t mFileSize;
+        //! \brief Result of MapHandler::readMapInfo. We also keep invalid levels to not parse them again
+        bool mIsValid;
+        LevelInfo mLevelInfo;
+    };
+
+    bool load();
+
+    void refreshThread();
+
+    //! \brief Waits for the refresh thread to finish (if any)
+    void waitRefreshThread();
+
+    const std::string mIndexFileName;
+
+    //! \brief Level info by level file name
+    std::map<std::string, LevelInfoEntry> mEntries;
+
+    //! \brief True if mEntries changed since it was loaded/saved
+    bool mIsDirty;
+
+    //! \brief Protects mEntries and mIsDirty
+    sf::Mutex mLock;
+
+    sf::Thread* mRefreshThread;
+
+    //! \brief Directories to refresh. Only accessed by the refresh thread while it runs
+    std::vector<std::string> mRefreshLevelPaths;
+
+    std::atomic<bool> mIsRefreshing;
+    std::atomic<bool> mStopRefresh;
+};
+
+#endif // LEVELINFOINDEX_H
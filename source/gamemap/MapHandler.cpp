@@ -45,34 +45,82 @@
 #include "utils/Helper.h"
 #include "utils/LogManager.h"
 #include "utils/ResourceManager.h"
+#include "utils/TextTokenizer.h"
+
+#include "gamemap/LevelInfoIndex.h"
+#include "gamemap/SaveGameSnapshot.h"
 
 #include "ODApplication.h"
 
+#include <chrono>
+#include <fstream>
 #include <iostream>
 #include <sstream>
 
+namespace
+{
+//! \brief Reads the level file until the map size (first 2 lines after [Tiles]) and feeds the
+//! lines stripped of comments in the given stream. Unlike Helper::readFileWithoutComments, the
+//! tiles and entities are not read as they are not needed to get the level info.
+bool readLevelHeaderWithoutComments(const std::string& fileName, std::stringstream& stream)
+{
+    std::ifstream levelFile(fileName.c_str(), std::ifstream::in);
+    if (!levelFile.good())
+    {
+        OD_LOG_WRN("File not found=" + fileName);
+        return false;
+    }
+
+    bool isTilesSection = false;
+    uint32_t nbMapSizeLines = 0;
+    std::string line;
+    while (levelFile.good() && (nbMapSizeLines < 2))
+    {
+        std::getline(levelFile, line);
+        line = line.substr(0, line.find('#'));
+        stream << line << "\n";
+
+        Helper::trim(line);
+        if(line.empty())
+            continue;
+
+        if(isTilesSection)
+            ++nbMapSizeLines;
+        else if(line == "[Tiles]")
+            isTilesSection = true;
+    }
+
+    return true;
+}
+}
+
 namespace MapHandler {
 
 bool readGameMapFromFile(const std::string& fileName, GameMap& gameMap)
 {
-    std::stringstream levelFile;
-    if(!Helper::readFileWithoutComments(fileName, levelFile))
+    std::chrono::steady_clock::time_point startTime = std::chrono::steady_clock::now();
+    TextTokenizer levelFile;
+    if(!levelFile.loadFile(fileName))
+    {
+        OD_LOG_WRN("File not found=" + fileName);
         return false;
+    }
 
-    std::string nextParam;
+    TextView nextParam;
+    TextView line;
     // Read in the version number from the level file
     levelFile >> nextParam;
-    if (nextParam.compare(ODApplication::VERSIONSTRING) != 0)
+    if (nextParam != ODApplication::VERSIONSTRING)
     {
         OD_LOG_WRN("Attempting to load a file produced by a different version of OpenDungeons, filename="
-            + fileName + ", file version=" + nextParam + ", odversion=" + ODApplication::VERSION);
+            + fileName + ", file version=" + nextParam.toString() + ", odversion=" + ODApplication::VERSION);
         return false;
     }
 
     levelFile >> nextParam;
     if (nextParam != "[Info]")
     {
-        OD_LOG_WRN("Invalid info start format: " + nextParam);
+        OD_LOG_WRN("Invalid info start format: " + nextParam.toString());
         return false;
     }
 
@@ -82,62 +130,64 @@ bool readGameMapFromFile(const std::string& fileName, GameMap& gameMap)
     // Read in the seats from the level file
     while (true)
     {
-        if(!levelFile.good())
+        // Information can contain spaces. We need to read the whole line to get content
+        if(!levelFile.nextLine(line))
             return false;
-        // Information can contain spaces. We need to use std::getline to get content
-        std::getline(levelFile, nextParam);
-        std::string param;
-        if (nextParam == "[/Info]")
+
+        if (line == "[/Info]")
         {
             break;
         }
 
-        param = "Name\t";
-        if (nextParam.compare(0, param.size(), param) == 0)
+        if (line.startsWith("Name\t"))
         {
-            gameMap.setLevelName(nextParam.substr(param.size()));
+            gameMap.setLevelName(line.substr(5).toString());
             continue;
         }
 
-        param = "Description\t";
-        if (nextParam.compare(0, param.size(), param) == 0)
+        if (line.startsWith("Description\t"))
         {
-            gameMap.setLevelDescription(nextParam.substr(param.size()));
+            gameMap.setLevelDescription(line.substr(12).toString());
             continue;
         }
 
-        param = "Music\t";
-        if (nextParam.compare(0, param.size(), param) == 0)
+        if (line.startsWith("Music\t"))
         {
-            std::string musicFile = nextParam.substr(param.size());
+            std::string musicFile = line.substr(6).toString();
             gameMap.setLevelMusicFile(musicFile);
             OD_LOG_INF("Level Music: " + musicFile);
             continue;
         }
 
-        param = "FightMusic\t";
-        if (nextParam.compare(0, param.size(), param) == 0)
+        if (line.startsWith("FightMusic\t"))
         {
-            std::string musicFile = nextParam.substr(param.size());
-            gameMap.setLevelFightMusicFile(nextParam.substr(param.size()));
+            std::string musicFile = line.substr(11).toString();
+            gameMap.setLevelFightMusicFile(musicFile);
             OD_LOG_INF("Level Fight Music: " + musicFile);
             continue;
         }
 
-        param = "TileSet\t";
-        if (nextParam.compare(0, param.size(), param) == 0)
+        if (line.startsWith("TileSet\t"))
         {
-            std::string tileSet = nextParam.substr(param.size());
+            std::string tileSet = line.substr(8).toString();
             gameMap.setTileSetName(tileSet);
             OD_LOG_INF("TileSet: " + tileSet);
             continue;
         }
+
+        if (line.startsWith("Seed\t"))
+        {
+            uint64_t gameSeed = 0;
+            TextTokenizer::parseUInt64(line.substr(5).trimmed(), gameSeed);
+            gameMap.setGameSeed(gameSeed);
+            continue;
+        }
     }
 
     levelFile >> nextParam;
     if (nextParam != "[Seats]")
     {
-        OD_LOG_WRN("Invalid seats start format=" + nextParam);
+        OD_LOG_WRN("Invalid seats start format=" + nextParam.toString());
         return false;
     }
 
@@ -153,7 +203,7 @@ bool readGameMapFromFile(const std::string& fileName, GameMap& gameMap)
 
         if (nextParam != "[Seat]")
         {
-            OD_LOG_WRN("Expected a Seat tag but got " + nextParam);
+            OD_LOG_WRN("Expected a Seat tag but got " + nextParam.toString());
             return false;
         }
 
@@ -176,20 +226,27 @@ bool readGameMapFromFile(const std::string& fileName, GameMap& gameMap)
     levelFile >> nextParam;
     if (nextParam != "[Goals]")
     {
-        OD_LOG_WRN("Invalid Goals start format=" + nextParam);
+        OD_LOG_WRN("Invalid Goals start format=" + nextParam.toString());
         return false;
     }
 
+    // The goals loader needs a std::istream. We give it the goals section only
+    std::string block;
+    if(!levelFile.nextBlock("[/Goals]", block))
+        return false;
+
+    std::stringstream goalsStream(block);
+    std::string goalName;
     while(true)
     {
-        if(!levelFile.good())
+        if(!goalsStream.good())
             return false;
 
-        levelFile >> nextParam;
-        if (nextParam == "[/Goals]")
+        goalsStream >> goalName;
+        if (goalName == "[/Goals]")
             break;
 
-        std::unique_ptr<Goal> tempGoal = Goals::loadGoalFromStream(nextParam, levelFile);
+        std::unique_ptr<Goal> tempGoal = Goals::loadGoalFromStream(goalName, goalsStream);
 
         if (tempGoal.get() != nullptr)
             gameMap.addGoalForAllSeats(std::move(tempGoal));
@@ -198,7 +255,7 @@ bool readGameMapFromFile(const std::string& fileName, GameMap& gameMap)
     levelFile >> nextParam;
     if (nextParam != "[Tiles]")
     {
-        OD_LOG_WRN("Invalid tile start format:" + nextParam);
+        OD_LOG_WRN("Invalid tile start format:" + nextParam.toString());
         return false;
     }
 
@@ -207,6 +264,11 @@ bool readGameMapFromFile(const std::string& fileName, GameMap& gameMap)
     int mapSizeY;
     levelFile >> mapSizeX;
     levelFile >> mapSizeY;
+    if(!levelFile.good())
+    {
+        OD_LOG_WRN("Invalid map size");
+        return false;
+    }
 
     if (!gameMap.createNewMap(mapSizeX, mapSizeY))
         return false;
@@ -216,24 +278,22 @@ bool readGameMapFromFile(const std::string& fileName, GameMap& gameMap)
 
     while (true)
     {
-        if(!levelFile.good())
+        if(!levelFile.nextLine(line))
         {
             OD_LOG_WRN("unexpected EOF reached");
             return false;
         }
 
-        levelFile >> nextParam;
-        if (nextParam == "[/Tiles]")
+        if (line == "[/Tiles]")
             break;
 
-        // Get all the params together in order to prepare for the new parsing function
-        std::string entire_line = nextParam;
-        std::getline(levelFile, nextParam);
-        entire_line += nextParam;
-
         Tile* tile = new Tile(&gameMap, true);
 
-        Tile::loadFromLine(entire_line, tile);
+        if(!Tile::loadFromLine(line, tile))
+        {
+            delete tile;
+            return false;
+        }
         tile->computeTileVisual();
 
         gameMap.addTile(tile);
@@ -245,7 +305,7 @@ bool readGameMapFromFile(const std::string& fileName, GameMap& gameMap)
     levelFile >> nextParam;
     if (nextParam != "[Rooms]")
     {
-        OD_LOG_WRN("Invalid Rooms start format:" + nextParam);
+        OD_LOG_WRN("Invalid Rooms start format:" + nextParam.toString());
         return false;
     }
 
@@ -263,14 +323,21 @@ bool readGameMapFromFile(const std::string& fileName, GameMap& gameMap)
 
         if (gameMap.isServerGameMap() && (nextParam != "[Room]"))
         {
-            OD_LOG_WRN("Expected [Room] but got:" + nextParam);
+            OD_LOG_WRN("Expected [Room] but got:" + nextParam.toString());
             return false;
         }
 
         if(!gameMap.isServerGameMap())
             continue;
 
-        Room* tempRoom = RoomManager::getRoomFromStream(&gameMap, levelFile);
+        if(!levelFile.nextBlock("[/Room]", block))
+        {
+            OD_LOG_WRN("unexpected EOF reached");
+            return false;
+        }
+
+        std::stringstream roomStream(block);
+        Room* tempRoom = RoomManager::getRoomFromStream(&gameMap, roomStream);
         if(tempRoom == nullptr)
         {
             OD_LOG_ERR("unexpected null room");
@@ -279,10 +346,11 @@ bool readGameMapFromFile(const std::string& fileName, GameMap& gameMap)
 
         tempRoom->addToGameMap();
 
-        levelFile >> nextParam;
-        if (nextParam != "[/Room]")
+        std::string endTag;
+        roomStream >> endTag;
+        if (endTag != "[/Room]")
         {
-            OD_LOG_WRN("Expected [/Room] but got:" + nextParam);
+            OD_LOG_WRN("Expected [/Room] but got:" + endTag);
             return false;
         }
     }
@@ -291,7 +359,7 @@ bool readGameMapFromFile(const std::string& fileName, GameMap& gameMap)
     levelFile >> nextParam;
     if (nextParam != "[Traps]")
     {
-        OD_LOG_WRN("Invalid Traps start format:" + nextParam);
+        OD_LOG_WRN("Invalid Traps start format:" + nextParam.toString());
         return false;
     }
 
@@ -309,11 +377,18 @@ bool readGameMapFromFile(const std::string& fileName, GameMap& gameMap)
 
         if (nextParam != "[Trap]")
         {
-            OD_LOG_WRN("Expected [Trap] but got:" + nextParam);
+            OD_LOG_WRN("Expected [Trap] but got:" + nextParam.toString());
             return false;
         }
 
-        Trap* tempTrap = TrapManager::getTrapFromStream(&gameMap, levelFile);
+        if(!levelFile.nextBlock("[/Trap]", block))
+        {
+            OD_LOG_WRN("unexpected EOF reached");
+            return false;
+        }
+
+        std::stringstream trapStream(block);
+        Trap* tempTrap = TrapManager::getTrapFromStream(&gameMap, trapStream);
         if(tempTrap == nullptr)
         {
             OD_LOG_ERR("unexpected null trap");
@@ -322,10 +397,11 @@ bool readGameMapFromFile(const std::string& fileName, GameMap& gameMap)
 
         tempTrap->addToGameMap();
 
-        levelFile >> nextParam;
-        if (nextParam != "[/Trap]")
+        std::string endTag;
+        trapStream >> endTag;
+        if (endTag != "[/Trap]")
         {
-            OD_LOG_WRN("Expected [/Trap] but got:" + nextParam);
+            OD_LOG_WRN("Expected [/Trap] but got:" + endTag);
             return false;
         }
     }
@@ -334,24 +410,19 @@ bool readGameMapFromFile(const std::string& fileName, GameMap& gameMap)
     levelFile >> nextParam;
     if (nextParam != "[Lights]")
     {
-        OD_LOG_WRN("Invalid Lights start format:" + nextParam);
+        OD_LOG_WRN("Invalid Lights start format:" + nextParam.toString());
         return false;
     }
 
     while(true)
     {
-        if(!levelFile.good())
+        if(!levelFile.nextLine(line))
             return false;
 
-        levelFile >> nextParam;
-        if (nextParam == "[/Lights]")
+        if (line == "[/Lights]")
             break;
 
-        std::string entire_line = nextParam;
-        std::getline(levelFile, nextParam);
-        entire_line += nextParam;
-
-        std::stringstream ss(entire_line);
+        std::stringstream ss(line.toString());
         MapLight* tempLight = MapLight::getMapLightFromStream(&gameMap, ss);
         if(tempLight == nullptr)
         {
@@ -362,6 +433,8 @@ bool readGameMapFromFile(const std::string& fileName, GameMap& gameMap)
         tempLight->addToGameMap();
     }
 
+    // The definitions are read with their own tokenizer so that an ill-formed one cannot read the next ones
+    TextView defBlock;
     levelFile >> nextParam;
     if (nextParam == "[CreatureDefinitions]")
     {
@@ -377,7 +450,7 @@ bool readGameMapFromFile(const std::string& fileName, GameMap& gameMap)
             // Seek the [Creature] tag
             if (nextParam != "[Creature]")
             {
-                OD_LOG_WRN("Invalid Creature start format:" + nextParam);
+                OD_LOG_WRN("Invalid Creature start format:" + nextParam.toString());
                 return false;
             }
 
@@ -385,13 +458,17 @@ bool readGameMapFromFile(const std::string& fileName, GameMap& gameMap)
             if (nextParam == "Name")
             {
                 levelFile >> nextParam;
-                CreatureDefinition* def = gameMap.getClassDescriptionForTuning(nextParam);
+                CreatureDefinition* def = gameMap.getClassDescriptionForTuning(nextParam.toString());
                 if (def == nullptr)
                 {
-                    OD_LOG_WRN("Invalid Creature definition format for " + nextParam);
+                    OD_LOG_WRN("Invalid Creature definition format for " + nextParam.toString());
                     return false;
                 }
-                if(!CreatureDefinition::update(def, levelFile, ConfigManager::getSingleton().getCreatureDefinitions()))
+                if(!levelFile.nextBlock("[/Creature]", defBlock))
+                    return false;
+
+                TextTokenizer defStream(defBlock);
+                if(!CreatureDefinition::update(def, defStream, ConfigManager::getSingleton().getCreatureDefinitions()))
                     return false;
             }
         }
@@ -412,7 +489,7 @@ bool readGameMapFromFile(const std::string& fileName, GameMap& gameMap)
 
             if (nextParam != "[Equipment]")
             {
-                OD_LOG_WRN("Invalid Weapon start format:" + nextParam);
+                OD_LOG_WRN("Invalid Weapon start format:" + nextParam.toString());
                 return false;
             }
 
@@ -420,13 +497,17 @@ bool readGameMapFromFile(const std::string& fileName, GameMap& gameMap)
             if (nextParam == "Name")
             {
                 levelFile >> nextParam;
-                Weapon* def = gameMap.getWeaponForTuning(nextParam);
+                Weapon* def = gameMap.getWeaponForTuning(nextParam.toString());
                 if (def == nullptr)
                 {
-                    OD_LOG_WRN("Invalid Weapon definition format for " + nextParam);
+                    OD_LOG_WRN("Invalid Weapon definition format for " + nextParam.toString());
                     return false;
                 }
-                if(!Weapon::update(def, levelFile))
+                if(!levelFile.nextBlock("[/Equipment]", defBlock))
+                    return false;
+
+                TextTokenizer defStream(defBlock);
+                if(!Weapon::update(def, defStream))
                     return false;
             }
         }
@@ -437,25 +518,20 @@ bool readGameMapFromFile(const std::string& fileName, GameMap& gameMap)
     // Read in the actual creatures themselves
     if (nextParam != "[Creatures]")
     {
-        OD_LOG_WRN("Invalid Creatures start format:" + nextParam);
+        OD_LOG_WRN("Invalid Creatures start format:" + nextParam.toString());
         return false;
     }
 
     uint32_t nbCreatures = 0;
     while(true)
     {
-        if(!levelFile.good())
+        if(!levelFile.nextLine(line))
             return false;
 
-        levelFile >> nextParam;
-        if (nextParam == "[/Creatures]")
+        if (line == "[/Creatures]")
             break;
 
-        std::string entire_line = nextParam;
-        std::getline(levelFile, nextParam);
-        entire_line += nextParam;
-
-        std::stringstream ss(entire_line);
+        std::stringstream ss(line.toString());
         Creature* tempCreature = Creature::getCreatureFromStream(&gameMap, ss);
         if(tempCreature == nullptr)
         {
@@ -510,31 +586,31 @@ bool readGameMapFromFile(const std::string& fileName, GameMap& gameMap)
         return false;
     }
 
+    std::chrono::milliseconds duration = std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::steady_clock::now() - startTime);
+    OD_LOG_INF("Level " + fileName + " read in " + Helper::toString(static_cast<uint64_t>(duration.count())) + " ms");
     return true;
 }
 
-bool readGameEntity(GameMap& gameMap, const std::string& item, GameEntityType type, std::stringstream& levelFile)
+bool readGameEntity(GameMap& gameMap, const std::string& item, GameEntityType type, TextTokenizer& levelFile)
 {
-    std::string nextParam;
+    TextView nextParam;
     levelFile >> nextParam;
     if (nextParam != "[" + item + "]")
         return false;
 
+    const std::string endTag = "[/" + item + "]";
+    TextView line;
     uint32_t nbEntity = 0;
     while(true)
     {
-        if(!levelFile.good())
+        if(!levelFile.nextLine(line))
             return false;
 
-        levelFile >> nextParam;
-        if (nextParam == "[/" + item + "]")
+        if (line == endTag)
             break;
 
-        std::string entire_line = nextParam;
-        std::getline(levelFile, nextParam);
-        entire_line += nextParam;
-
-        std::stringstream ss(entire_line);
+        std::stringstream ss(line.toString());
         GameEntity* entity = Entities::getGameEntityFromStream(&gameMap, type, ss);
         if(entity == nullptr)
         {
@@ -560,224 +636,7 @@ bool writeGameMapToFile(const std::string& fileName, GameMap& gameMap)
         return false;
     }
 
-    // Write the identifier string and the version number
-    levelFile << ODApplication::VERSIONSTRING
-            << "  # The version of OpenDungeons which created this file (for compatibility reasons).\n";
-
-    // Write map info
-    levelFile << "\n[Info]\n";
-    levelFile << "Name\t" << (gameMap.getLevelName().empty() ? "No name" : gameMap.getLevelName()) << std::endl;
-    if (!gameMap.getLevelDescription().empty())
-        levelFile << "Description\t" << gameMap.getLevelDescription() << std::endl;
-    if (!gameMap.getLevelMusicFile().empty())
-        levelFile << "Music\t" << gameMap.getLevelMusicFile() << std::endl;
-    if (!gameMap.getLevelFightMusicFile().empty())
-        levelFile << "FightMusic\t" << gameMap.getLevelFightMusicFile() << std::endl;
-    if(!gameMap.getTileSetName().empty())
-        levelFile << "TileSet\t" << gameMap.getTileSetName() << std::endl;
-
-    levelFile << "[/Info]" << std::endl;
-
-    // Write out the seats to the file
-    levelFile << "\n[Seats]\n";
-    const std::vector<Seat*> seats = gameMap.getSeats();
-    for (Seat* seat : seats)
-    {
-        // We don't save rogue seat
-        if(seat->isRogueSeat())
-            continue;
-
-        levelFile << "[Seat]" << std::endl;
-        seat->exportSeatToStream(levelFile);
-        levelFile << "[/Seat]" << std::endl;
-    }
-    levelFile << "[/Seats]" << std::endl;
-
-    // Write out the goals shared by all players to the file.
-    levelFile << "\n[Goals]\n";
-    levelFile << "# " << Goal::getFormat() << "\n";
-    for (auto& goal : gameMap.getGoalsForAllSeats())
-    {
-        levelFile << *goal.get();
-    }
-    levelFile << "[/Goals]" << std::endl;
-
-    levelFile << "\n[Tiles]\n";
-    int mapSizeX = gameMap.getMapSizeX();
-    int mapSizeY = gameMap.getMapSizeY();
-    levelFile << "# Map Size" << std::endl;
-    levelFile << mapSizeX << " # MapSizeX" << std::endl;
-    levelFile << mapSizeY << " # MapSizeY" << std::endl;
-
-    // Write out the tiles to the file
-    levelFile << "# " << Tile::getFormat() << "\n";
-
-    for(int ii = 0; ii < mapSizeX; ++ii)
-    {
-        for(int jj = 0; jj < mapSizeY; ++jj)
-        {
-            Tile* tile = gameMap.getTile(ii, jj);
-            if (tile == nullptr)
-                continue;
-
-            // Don't save standard tiles as they're auto filled in at load time.
-            if (!tile->isClaimed() && tile->getType() == TileType::dirt && tile->getFullness() >= 100.0)
-                continue;
-
-            Tile::exportToStream(tile, levelFile);
-            levelFile << std::endl;
-        }
-    }
-    levelFile << "[/Tiles]" << std::endl;
-
-    std::vector<Room*> rooms = gameMap.getRooms();
-    std::sort(rooms.begin(), rooms.end(), Room::sortForMapSave);
-
-    // Write out the rooms to the file
-    levelFile << "\n[Rooms]\n";
-    levelFile << "# " << Room::getRoomStreamFormat() << "\n";
-    for (Room* room : rooms)
-    {
-        // Rooms with 0 tiles are removed during upkeep. In editor mode, we don't use upkeep so there might be some rooms with
-        // 0 tiles (if a room has been erased for example). For this reason, we don't save rooms with 0 tiles
-        if((gameMap.isInEditorMode()) && (room->numCoveredTiles() <= 0))
-            continue;
-
-        levelFile << "[Room]" << std::endl;
-        GameEntity::exportToStream(room, levelFile);
-        levelFile << "[/Room]" << std::endl;
-    }
-    levelFile << "[/Rooms]" << std::endl;
-
-    std::vector<Trap*> traps = gameMap.getTraps();
-    std::sort(traps.begin(), traps.end(), Trap::sortForMapSave);
-
-    // Write out the traps to the file
-    levelFile << "\n[Traps]\n";
-    levelFile << "# " << Trap::getTrapStreamFormat() << "\n";
-    for (Trap* trap : traps)
-    {
-        // In editor mode, we don't use upkeep so there might be some traps with
-        // 0 tiles (if a trap has been erased for example). For this reason, we don't save traps with 0 tiles
-        if(gameMap.isInEditorMode() && trap->numCoveredTiles() <= 0)
-            continue;
-
-        levelFile << "[Trap]" << std::endl;
-        GameEntity::exportToStream(trap, levelFile);
-        levelFile << "[/Trap]" << std::endl;
-    }
-    levelFile << "[/Traps]" << std::endl;
-
-    // Write out the lights to the file.
-    levelFile << "\n[Lights]\n";
-    levelFile << "# " << MapLight::getMapLightStreamFormat() << "\n";
-    for (MapLight* mapLight : gameMap.getMapLights())
-    {
-        GameEntity::exportToStream(mapLight, levelFile);
-        levelFile << std::endl;
-    }
-    levelFile << "[/Lights]" << std::endl;
-
-    levelFile << std::endl << "[CreatureDefinitions]" << std::endl;
-    gameMap.saveLevelClassDescriptions(levelFile);
-    levelFile << "[/CreatureDefinitions]" << std::endl;
-
-    levelFile << std::endl << "[EquipmentDefinitions]" << std::endl;
-    gameMap.saveLevelEquipments(levelFile);
-    levelFile << "[/EquipmentDefinitions]" << std::endl;
-
-    // Write out the individual creatures to the file
-    levelFile << "\n[Creatures]\n";
-    levelFile << "# " << Creature::getCreatureStreamFormat() << "\n";
-    for (Creature* creature : gameMap.getCreatures())
-    {
-        GameEntity::exportToStream(creature, levelFile);
-        levelFile << std::endl;
-    }
-    levelFile << "[/Creatures]" << std::endl;
-
-    // Write out the RenderedMovableEntities that need to
-    const std::vector<RenderedMovableEntity*>& rendereds = gameMap.getRenderedMovableEntities();
-    levelFile << "\n[Spells]\n";
-    levelFile << "# " << Spell::getSpellStreamFormat() << "\n";
-    for (Spell* spell : gameMap.getSpells())
-    {
-        GameEntity::exportToStream(spell, levelFile);
-        levelFile << std::endl;
-    }
-    levelFile << "[/Spells]" << std::endl;
-
-    levelFile << "\n[CraftedTraps]\n";
-    levelFile << "# " << CraftedTrap::getCraftedTrapStreamFormat() << "\n";
-    for (RenderedMovableEntity* rendered : rendereds)
-    {
-        if(rendered->getObjectType() != GameEntityType::craftedTrap)
-            continue;
-
-        GameEntity::exportToStream(rendered, levelFile);
-        levelFile << std::endl;
-    }
-    levelFile << "[/CraftedTraps]" << std::endl;
-
-    levelFile << "\n[SkillEntity]\n";
-    levelFile << "# " << SkillEntity::getSkillEntityStreamFormat() << "\n";
-    for (RenderedMovableEntity* rendered : rendereds)
-    {
-        if(rendered->getObjectType() != GameEntityType::skillEntity)
-            continue;
-
-        GameEntity::exportToStream(rendered, levelFile);
-        levelFile << std::endl;
-    }
-    levelFile << "[/SkillEntity]" << std::endl;
-
-    levelFile << "\n[GiftBoxEntity]\n";
-    levelFile << "# " << GiftBoxEntity::getGiftBoxEntityStreamFormat() << "\n";
-    for (RenderedMovableEntity* rendered : rendereds)
-    {
-        if(rendered->getObjectType() != GameEntityType::giftBoxEntity)
-            continue;
-
-        GameEntity::exportToStream(rendered, levelFile);
-        levelFile << std::endl;
-    }
-    levelFile << "[/GiftBoxEntity]" << std::endl;
-
-    levelFile << "\n[Missiles]\n";
-    levelFile << "# " << MissileObject::getMissileObjectStreamFormat() << "\n";
-    for (RenderedMovableEntity* rendered : rendereds)
-    {
-        if(rendered->getObjectType() != GameEntityType::missileObject)
-            continue;
-
-        GameEntity::exportToStream(rendered, levelFile);
-        levelFile << std::endl;
-    }
-    levelFile << "[/Missiles]" << std::endl;
-
-    levelFile << "\n[TreasuryObject]\n";
-    levelFile << "# " << TreasuryObject::getTreasuryObjectStreamFormat() << "\n";
-    for (RenderedMovableEntity* rendered : rendereds)
-    {
-        if(rendered->getObjectType() != GameEntityType::treasuryObject)
-            continue;
-
-        GameEntity::exportToStream(rendered, levelFile);
-        levelFile << std::endl;
-    }
-    levelFile << "[/TreasuryObject]" << std::endl;
-
-    levelFile << "\n[Chickens]\n";
-    levelFile << "# " << ChickenEntity::getChickenEntityStreamFormat() << "\n";
-    for (RenderedMovableEntity* rendered : rendereds)
-    {
-        if(rendered->getObjectType() != GameEntityType::chickenEntity)
-            continue;
-
-        GameEntity::exportToStream(rendered, levelFile);
-        levelFile << std::endl;
-    }
-    levelFile << "[/Chickens]" << std::endl;
+    writeGameMapToStream(levelFile, gameMap);
 
     if (!levelFile.good()) {
         OD_LOG_WRN("Unexpected failure on file: " + fileName);
@@ -788,11 +647,27 @@ bool writeGameMapToFile(const std::string& fileName, GameMap& gameMap)
     return true;
 }
 
+void writeGameMapToStream(std::ostream& levelFile, GameMap& gameMap)
+{
+    SaveGameSnapshot snapshot;
+    snapshot.capture(gameMap);
+    snapshot.writeToStream(levelFile);
+}
+
 bool getMapInfo(const std::string& fileName, LevelInfo& levelInfo)
+{
+    LevelInfoIndex* levelInfoIndex = LevelInfoIndex::getSingletonPtr();
+    if(levelInfoIndex != nullptr)
+        return levelInfoIndex->getLevelInfo(fileName, levelInfo);
+
+    return readMapInfo(fileName, levelInfo);
+}
+
+bool readMapInfo(const std::string& fileName, LevelInfo& levelInfo)
 {
     // Prepare an invalid level reference
     std::stringstream levelFile;
-    if(!Helper::readFileWithoutComments(fileName, levelFile))
+    if(!readLevelHeaderWithoutComments(fileName, levelFile))
         return false;
 
     std::string nextParam;
@@ -19,9 +19,11 @@
 #ifndef MAPHANDLER_H
 #define MAPHANDLER_H
 
+#include <iosfwd>
 #include <string>
 
 class GameMap;
+class TextTokenizer;
 
 enum class GameEntityType;
 
@@ -44,16 +46,25 @@ namespace MapHandler
 
     bool writeGameMapToFile(const std::string& fileName, GameMap& gameMap);
 
-    bool readGameEntity(GameMap& gameMap, const std::string& item, GameEntityType type, std::stringstream& levelFile);
+    //! \brief Writes the gamemap in the given stream with the level file format. To write the
+    //! file without blocking the gamemap, use a SaveGameSnapshot instead
+    void writeGameMapToStream(std::ostream& levelFile, GameMap& gameMap);
+
+    bool readGameEntity(GameMap& gameMap, const std::string& item, GameEntityType type, TextTokenizer& levelFile);
 
     bool loadEquipments(const std::string& fileName, GameMap& gameMap);
 
     bool loadCreatureDefinition(const std::string& fileName, GameMap& gameMap);
 
     //! \brief Reads the main user map info. Returns true if the level could be read and levelInfo is set to
-    //! corresponding info. Returns false otherwise.
+    //! corresponding info. Returns false otherwise. If the LevelInfoIndex exists, the info is taken from it
+    //! when the file did not change since it was indexed.
     bool getMapInfo(const std::string& fileName, LevelInfo& levelInfo);
 
+    //! \brief Same as getMapInfo but always reads the file (only the header, not the tiles). Used
+    //! by the LevelInfoIndex to refresh its entries.
+    bool readMapInfo(const std::string& fileName, LevelInfo& levelInfo);
+
     //! \brief Level extension constant, used in different GUI modes.
     static const std::string LEVEL_EXTENSION = ".level";
 };
@@ -19,6 +19,7 @@
 #define PATHFINDING_H
 
 #include <cmath>
+#include <limits>
 
 namespace Pathfinding
 {
@@ -42,6 +43,79 @@ namespace Pathfinding
     {
         return squaredDistance(ent1.getX(), ent2.getX(), ent1.getY(), ent2.getY());
     }
+
+    /*! \brief Walks through the grid cells crossed by a segment without allocating memory (DDA traversal,
+     * see "A Fast Voxel Traversal Algorithm for Ray Tracing" by Amanatides and Woo).
+     * Like tiles, the cell (x, y) covers [x - 0.5, x + 0.5[ x [y - 0.5, y + 0.5[. The segment starts at
+     * (startX, startY) and ends at (startX, startY) + length * (dirX, dirY). When the segment crosses a cell
+     * corner exactly, the cell adjacent along X is visited before the diagonal one (the one adjacent along Y
+     * is not). Consecutive cells always share a side so that a missile cannot go diagonally between 2 walls.
+     */
+    class GridTraversal
+    {
+    public:
+        GridTraversal(double startX, double startY, double dirX, double dirY, double length) :
+            mX(static_cast<int>(std::floor(startX + 0.5))),
+            mY(static_cast<int>(std::floor(startY + 0.5))),
+            mStepX(dirX > 0.0 ? 1 : (dirX < 0.0 ? -1 : 0)),
+            mStepY(dirY > 0.0 ? 1 : (dirY < 0.0 ? -1 : 0)),
+            mDistance(0.0),
+            mLength(length),
+            mDeltaX(mStepX == 0 ? std::numeric_limits<double>::infinity() : 1.0 / std::fabs(dirX)),
+            mDeltaY(mStepY == 0 ? std::numeric_limits<double>::infinity() : 1.0 / std::fabs(dirY)),
+            mNextX(mStepX == 0 ? std::numeric_limits<double>::infinity() : (mX + 0.5 * mStepX - startX) / dirX),
+            mNextY(mStepY == 0 ? std::numeric_limits<double>::infinity() : (mY + 0.5 * mStepY - startY) / dirY)
+        {}
+
+        //! \brief Coordinates of the current cell
+        inline int getX() const
+        { return mX; }
+
+        inline int getY() const
+        { return mY; }
+
+        //! \brief Distance (in direction units) at which the segment enters the current cell. 0 for the first cell
+        inline double getDistance() const
+        { return mDistance; }
+
+        //! \brief Moves to the next cell crossed by the segment. Returns false if the segment ends in the current cell.
+        //! On a tie between both axis (cell corner), X is stepped first
+        bool next()
+        {
+            if(mNextX <= mNextY)
+            {
+                if(mNextX > mLength)
+                    return false;
+
+                mX += mStepX;
+                mDistance = mNextX;
+                mNextX += mDeltaX;
+                return true;
+            }
+
+            if(mNextY > mLength)
+                return false;
+
+            mY += mStepY;
+            mDistance = mNextY;
+            mNextY += mDeltaY;
+            return true;
+        }
+
+    private:
+        int mX;
+        int mY;
+        int mStepX;
+        int mStepY;
+        double mDistance;
+        double mLength;
+        //! \brief Distance needed to cross a whole cell along each axis
+        double mDeltaX;
+        double mDeltaY;
+        //! \brief Distance at which the next cell border is crossed along each axis
+        double mNextX;
+        double mNextY;
+    };
 }
 
 #endif // PATHFINDING_H
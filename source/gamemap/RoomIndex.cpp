@@ -0,0 +1,215 @@
+/*!
+ *  Copyright (C) 2011-2016  OpenDungeons Team
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "gamemap/RoomIndex.h"
+
+#include "rooms/Room.h"
+#include "utils/Helper.h"
+#include "utils/LogManager.h"
+
+#include <algorithm>
+
+RoomsView::const_iterator::const_iterator(std::vector<Room*>::const_iterator it, std::vector<Room*>::const_iterator end) :
+    mIt(it),
+    mEnd(end)
+{
+    skipDeadRooms();
+}
+
+RoomsView::const_iterator& RoomsView::const_iterator::operator++()
+{
+    ++mIt;
+    skipDeadRooms();
+    return *this;
+}
+
+void RoomsView::const_iterator::skipDeadRooms()
+{
+    while((mIt != mEnd) && ((*mIt)->getHP(nullptr) <= 0.0))
+        ++mIt;
+}
+
+uint32_t RoomsView::size() const
+{
+    uint32_t nbRooms = 0;
+    for(const_iterator it = begin(); it != end(); ++it)
+        ++nbRooms;
+
+    return nbRooms;
+}
+
+Room* RoomsView::front() const
+{
+    const_iterator it = begin();
+    if(it == end())
+        return nullptr;
+
+    return *it;
+}
+
+RoomIndex::RoomIndex() :
+    mRoomsPerType(static_cast<uint32_t>(RoomType::nbRooms))
+{
+}
+
+void RoomIndex::addRoom(Room* room)
+{
+    uint32_t index = static_cast<uint32_t>(room->getType());
+    if(index >= mRoomsPerType.size())
+    {
+        OD_LOG_ERR("room=" + room->getName() + ", index=" + Helper::toString(index));
+        return;
+    }
+
+    mRoomsPerType[index].push_back(room);
+    addRoomForSeat(room, room->getSeat());
+}
+
+void RoomIndex::removeRoom(Room* room)
+{
+    uint32_t index = static_cast<uint32_t>(room->getType());
+    if(index >= mRoomsPerType.size())
+    {
+        OD_LOG_ERR("room=" + room->getName() + ", index=" + Helper::toString(index));
+        return;
+    }
+
+    std::vector<Room*>& rooms = mRoomsPerType[index];
+    std::vector<Room*>::iterator it = std::find(rooms.begin(), rooms.end(), room);
+    if(it == rooms.end())
+    {
+        OD_LOG_ERR("room=" + room->getName());
+        return;
+    }
+    rooms.erase(it);
+    removeRoomForSeat(room, room->getSeat());
+}
+
+void RoomIndex::notifyRoomSeatChanged(Room* room, const Seat* oldSeat)
+{
+    if(oldSeat == room->getSeat())
+        return;
+
+    removeRoomForSeat(room, oldSeat);
+    addRoomForSeat(room, room->getSeat());
+}
+
+void RoomIndex::notifyRoomFreeCapacityChanged(const Room* room, int32_t delta)
+{
+    RoomsBucket* bucket = getBucket(room->getType(), room->getSeat());
+    if(bucket == nullptr)
+    {
+        OD_LOG_ERR("room=" + room->getName());
+        return;
+    }
+
+    bucket->mFreeCapacity += delta;
+}
+
+void RoomIndex::clear()
+{
+    for(std::vector<Room*>& rooms : mRoomsPerType)
+        rooms.clear();
+
+    mRoomsPerSeat.clear();
+}
+
+RoomsView RoomIndex::getRooms(RoomType type) const
+{
+    uint32_t index = static_cast<uint32_t>(type);
+    if(index >= mRoomsPerType.size())
+    {
+        OD_LOG_ERR("index=" + Helper::toString(index));
+        return RoomsView(mEmptyRooms);
+    }
+
+    return RoomsView(mRoomsPerType[index]);
+}
+
+RoomsView RoomIndex::getRooms(RoomType type, const Seat* seat) const
+{
+    const RoomsBucket* bucket = getBucket(type, seat);
+    if(bucket == nullptr)
+        return RoomsView(mEmptyRooms);
+
+    return RoomsView(bucket->mRooms);
+}
+
+int32_t RoomIndex::getFreeCapacity(RoomType type, const Seat* seat) const
+{
+    const RoomsBucket* bucket = getBucket(type, seat);
+    if(bucket == nullptr)
+        return 0;
+
+    return bucket->mFreeCapacity;
+}
+
+RoomIndex::RoomsBucket* RoomIndex::getBucket(RoomType type, const Seat* seat)
+{
+    uint32_t index = static_cast<uint32_t>(type);
+    auto it = mRoomsPerSeat.find(seat);
+    if(it == mRoomsPerSeat.end())
+        return nullptr;
+
+    if(index >= it->second.size())
+        return nullptr;
+
+    return &it->second[index];
+}
+
+const RoomIndex::RoomsBucket* RoomIndex::getBucket(RoomType type, const Seat* seat) const
+{
+    uint32_t index = static_cast<uint32_t>(type);
+    auto it = mRoomsPerSeat.find(seat);
+    if(it == mRoomsPerSeat.end())
+        return nullptr;
+
+    if(index >= it->second.size())
+        return nullptr;
+
+    return &it->second[index];
+}
+
+void RoomIndex::addRoomForSeat(Room* room, const Seat* seat)
+{
+    std::vector<RoomsBucket>& buckets = mRoomsPerSeat[seat];
+    if(buckets.empty())
+        buckets.resize(static_cast<uint32_t>(RoomType::nbRooms));
+
+    RoomsBucket& bucket = buckets[static_cast<uint32_t>(room->getType())];
+    bucket.mRooms.push_back(room);
+    bucket.mFreeCapacity += room->getFreeCapacityIndexed();
+}
+
+void RoomIndex::removeRoomForSeat(Room* room, const Seat* seat)
+{
+    RoomsBucket* bucket = getBucket(room->getType(), seat);
+    if(bucket == nullptr)
+    {
+        OD_LOG_ERR("room=" + room->getName());
+        return;
+    }
+
+    std::vector<Room*>::iterator it = std::find(bucket->mRooms.begin(), bucket->mRooms.end(), room);
+    if(it == bucket->mRooms.end())
+    {
+        OD_LOG_ERR("room=" + room->getName());
+        return;
+    }
+    bucket->mRooms.erase(it);
+    bucket->mFreeCapacity -= room->getFreeCapacityIndexed();
+}
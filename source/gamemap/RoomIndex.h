@@ -0,0 +1,138 @@
+/*!
+ *  Copyright (C) 2011-2016  OpenDungeons Team
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef ROOMINDEX_H
+#define ROOMINDEX_H
+
+#include "rooms/RoomType.h"
+
+#include <cstdint>
+#include <map>
+#include <vector>
+
+class Room;
+class Seat;
+
+//! \brief Non owning view over a list of rooms maintained by the RoomIndex. Rooms
+//! without HP (absorbed or destroyed rooms waiting to be removed from the gamemap)
+//! are skipped while iterating. The view is invalidated if a room is added/removed.
+class RoomsView
+{
+public:
+    class const_iterator
+    {
+    public:
+        const_iterator(std::vector<Room*>::const_iterator it, std::vector<Room*>::const_iterator end);
+
+        inline Room* operator*() const
+        { return *mIt; }
+
+        const_iterator& operator++();
+
+        inline bool operator==(const const_iterator& other) const
+        { return mIt == other.mIt; }
+
+        inline bool operator!=(const const_iterator& other) const
+        { return mIt != other.mIt; }
+
+    private:
+        //! \brief Moves mIt to the next room having HP (or to mEnd)
+        void skipDeadRooms();
+
+        std::vector<Room*>::const_iterator mIt;
+        std::vector<Room*>::const_iterator mEnd;
+    };
+
+    RoomsView(const std::vector<Room*>& rooms) :
+        mRooms(rooms)
+    {}
+
+    inline const_iterator begin() const
+    { return const_iterator(mRooms.begin(), mRooms.end()); }
+
+    inline const_iterator end() const
+    { return const_iterator(mRooms.end(), mRooms.end()); }
+
+    inline bool empty() const
+    { return begin() == end(); }
+
+    //! \brief Returns the number of rooms with HP. Note that it iterates the rooms
+    uint32_t size() const;
+
+    //! \brief Returns the first room with HP or nullptr if there is none
+    Room* front() const;
+
+private:
+    const std::vector<Room*>& mRooms;
+};
+
+//! \brief Keeps the rooms of the gamemap sorted by type and by (seat, type) so that
+//! queries like "treasuries of this seat" do not have to go through every room.
+//! For the room types where it makes sense (treasury, hatchery, dormitory), the sum of
+//! the free capacity of the rooms of each (seat, type) is also kept so that we can know
+//! if there is a room with space without scanning them.
+class RoomIndex
+{
+public:
+    RoomIndex();
+
+    void addRoom(Room* room);
+    void removeRoom(Room* room);
+
+    //! \brief Should be called when a room already in the index changes seat (for example,
+    //! when a portal is claimed)
+    void notifyRoomSeatChanged(Room* room, const Seat* oldSeat);
+
+    //! \brief Should be called when the free capacity of a room in the index changes
+    void notifyRoomFreeCapacityChanged(const Room* room, int32_t delta);
+
+    void clear();
+
+    RoomsView getRooms(RoomType type) const;
+    RoomsView getRooms(RoomType type, const Seat* seat) const;
+
+    //! \brief Returns the sum of the free capacity of the rooms of the given type owned by the given seat
+    int32_t getFreeCapacity(RoomType type, const Seat* seat) const;
+
+private:
+    struct RoomsBucket
+    {
+        RoomsBucket() :
+            mFreeCapacity(0)
+        {}
+
+        std::vector<Room*> mRooms;
+        int32_t mFreeCapacity;
+    };
+
+    //! \brief Rooms of every seat by room type
+    std::vector<std::vector<Room*>> mRoomsPerType;
+
+    //! \brief Rooms by seat then by room type
+    std::map<const Seat*, std::vector<RoomsBucket>> mRoomsPerSeat;
+
+    //! \brief Returned when a (seat, type) has no room
+    const std::vector<Room*> mEmptyRooms;
+
+    RoomsBucket* getBucket(RoomType type, const Seat* seat);
+    const RoomsBucket* getBucket(RoomType type, const Seat* seat) const;
+
+    void addRoomForSeat(Room* room, const Seat* seat);
+    void removeRoomForSeat(Room* room, const Seat* seat);
+};
+
+#endif // ROOMINDEX_H
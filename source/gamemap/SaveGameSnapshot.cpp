@@ -0,0 +1,326 @@
+/*
+ *  Copyright (C) 2011-2016  OpenDungeons Team
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "gamemap/SaveGameSnapshot.h"
+
+#include "entities/ChickenEntity.h"
+#include "entities/CraftedTrap.h"
+#include "entities/Creature.h"
+#include "entities/GameEntityType.h"
+#include "entities/GiftBoxEntity.h"
+#include "entities/MapLight.h"
+#include "entities/MissileObject.h"
+#include "entities/RenderedMovableEntity.h"
+#include "entities/SkillEntity.h"
+#include "entities/Tile.h"
+#include "entities/TreasuryObject.h"
+#include "game/Seat.h"
+#include "gamemap/GameMap.h"
+#include "goals/Goal.h"
+#include "rooms/Room.h"
+#include "spells/Spell.h"
+#include "traps/Trap.h"
+#include "utils/Random.h"
+#include "ODApplication.h"
+
+#include <algorithm>
+#include <ostream>
+#include <sstream>
+
+SaveGameSnapshot::SaveGameSnapshot() :
+    mIsSeedSaved(false),
+    mSeed(0),
+    mMapSizeX(0),
+    mMapSizeY(0)
+{
+}
+
+void SaveGameSnapshot::capture(GameMap& gameMap)
+{
+    mLevelName = gameMap.getLevelName();
+    mLevelDescription = gameMap.getLevelDescription();
+    mLevelMusicFile = gameMap.getLevelMusicFile();
+    mLevelFightMusicFile = gameMap.getLevelFightMusicFile();
+    mTileSetName = gameMap.getTileSetName();
+    mIsSeedSaved = !gameMap.isInEditorMode();
+    if(mIsSeedSaved)
+        mSeed = Random::getResumeSeed();
+
+    mSeats.clear();
+    for(Seat* seat : gameMap.getSeats())
+    {
+        // We don't save rogue seat
+        if(seat->isRogueSeat())
+            continue;
+
+        mSeats.emplace_back();
+        seat->exportSeatToSaveState(mSeats.back());
+    }
+
+    std::ostringstream goals;
+    for(auto& goal : gameMap.getGoalsForAllSeats())
+        goals << *goal.get();
+    mGoals = goals.str();
+
+    mMapSizeX = gameMap.getMapSizeX();
+    mMapSizeY = gameMap.getMapSizeY();
+    mTiles.clear();
+    for(int ii = 0; ii < mMapSizeX; ++ii)
+    {
+        for(int jj = 0; jj < mMapSizeY; ++jj)
+        {
+            Tile* tile = gameMap.getTile(ii, jj);
+            if (tile == nullptr)
+                continue;
+
+            // Don't save standard tiles as they're auto filled in at load time.
+            if (!tile->isClaimed() && tile->getType() == TileType::dirt && tile->getFullness() >= 100.0)
+                continue;
+
+            mTiles.emplace_back();
+            tile->exportToSaveState(mTiles.back());
+        }
+    }
+
+    std::vector<Room*> rooms = gameMap.getRooms();
+    std::sort(rooms.begin(), rooms.end(), Room::sortForMapSave);
+    std::ostringstream roomsStream;
+    for (Room* room : rooms)
+    {
+        // Rooms with 0 tiles are removed during upkeep. In editor mode, we don't use upkeep so there might be some rooms with
+        // 0 tiles (if a room has been erased for example). For this reason, we don't save rooms with 0 tiles
+        if((gameMap.isInEditorMode()) && (room->numCoveredTiles() <= 0))
+            continue;
+
+        roomsStream << "[Room]" << std::endl;
+        GameEntity::exportToStream(room, roomsStream);
+        roomsStream << "[/Room]" << std::endl;
+    }
+    mRooms = roomsStream.str();
+
+    std::vector<Trap*> traps = gameMap.getTraps();
+    std::sort(traps.begin(), traps.end(), Trap::sortForMapSave);
+    std::ostringstream trapsStream;
+    for (Trap* trap : traps)
+    {
+        // In editor mode, we don't use upkeep so there might be some traps with
+        // 0 tiles (if a trap has been erased for example). For this reason, we don't save traps with 0 tiles
+        if(gameMap.isInEditorMode() && trap->numCoveredTiles() <= 0)
+            continue;
+
+        trapsStream << "[Trap]" << std::endl;
+        GameEntity::exportToStream(trap, trapsStream);
+        trapsStream << "[/Trap]" << std::endl;
+    }
+    mTraps = trapsStream.str();
+
+    std::ostringstream lightsStream;
+    for (MapLight* mapLight : gameMap.getMapLights())
+    {
+        GameEntity::exportToStream(mapLight, lightsStream);
+        lightsStream << std::endl;
+    }
+    mLights = lightsStream.str();
+
+    std::ostringstream creatureDefinitions;
+    gameMap.saveLevelClassDescriptions(creatureDefinitions);
+    mCreatureDefinitions = creatureDefinitions.str();
+
+    std::ostringstream equipmentDefinitions;
+    gameMap.saveLevelEquipments(equipmentDefinitions);
+    mEquipmentDefinitions = equipmentDefinitions.str();
+
+    mCreatures.clear();
+    mCreatures.reserve(gameMap.getCreatures().size());
+    for (Creature* creature : gameMap.getCreatures())
+    {
+        mCreatures.emplace_back();
+        creature->exportToSaveState(mCreatures.back());
+    }
+
+    std::ostringstream spellsStream;
+    for (Spell* spell : gameMap.getSpells())
+    {
+        GameEntity::exportToStream(spell, spellsStream);
+        spellsStream << std::endl;
+    }
+    mSpells = spellsStream.str();
+
+    std::ostringstream craftedTraps;
+    std::ostringstream skillEntities;
+    std::ostringstream giftBoxEntities;
+    std::ostringstream missiles;
+    std::ostringstream treasuryObjects;
+    std::ostringstream chickens;
+    for (RenderedMovableEntity* rendered : gameMap.getRenderedMovableEntities())
+    {
+        std::ostringstream* os;
+        switch(rendered->getObjectType())
+        {
+            case GameEntityType::craftedTrap:
+                os = &craftedTraps;
+                break;
+            case GameEntityType::skillEntity:
+                os = &skillEntities;
+                break;
+            case GameEntityType::giftBoxEntity:
+                os = &giftBoxEntities;
+                break;
+            case GameEntityType::missileObject:
+                os = &missiles;
+                break;
+            case GameEntityType::treasuryObject:
+                os = &treasuryObjects;
+                break;
+            case GameEntityType::chickenEntity:
+                os = &chickens;
+                break;
+            default:
+                continue;
+        }
+
+        GameEntity::exportToStream(rendered, *os);
+        *os << std::endl;
+    }
+    mCraftedTraps = craftedTraps.str();
+    mSkillEntities = skillEntities.str();
+    mGiftBoxEntities = giftBoxEntities.str();
+    mMissiles = missiles.str();
+    mTreasuryObjects = treasuryObjects.str();
+    mChickens = chickens.str();
+}
+
+void SaveGameSnapshot::writeToStream(std::ostream& levelFile) const
+{
+    // Write the identifier string and the version number
+    levelFile << ODApplication::VERSIONSTRING
+            << "  # The version of OpenDungeons which created this file (for compatibility reasons).\n";
+
+    // Write map info
+    levelFile << "\n[Info]\n";
+    levelFile << "Name\t" << (mLevelName.empty() ? "No name" : mLevelName) << std::endl;
+    if (!mLevelDescription.empty())
+        levelFile << "Description\t" << mLevelDescription << std::endl;
+    if (!mLevelMusicFile.empty())
+        levelFile << "Music\t" << mLevelMusicFile << std::endl;
+    if (!mLevelFightMusicFile.empty())
+        levelFile << "FightMusic\t" << mLevelFightMusicFile << std::endl;
+    if(!mTileSetName.empty())
+        levelFile << "TileSet\t" << mTileSetName << std::endl;
+    if(mIsSeedSaved)
+        levelFile << "Seed\t" << mSeed << std::endl;
+
+    levelFile << "[/Info]" << std::endl;
+
+    // Write out the seats to the file
+    levelFile << "\n[Seats]\n";
+    for (const SeatSaveState& seat : mSeats)
+    {
+        levelFile << "[Seat]" << std::endl;
+        Seat::exportSeatSaveStateToStream(seat, levelFile);
+        levelFile << "[/Seat]" << std::endl;
+    }
+    levelFile << "[/Seats]" << std::endl;
+
+    // Write out the goals shared by all players to the file.
+    levelFile << "\n[Goals]\n";
+    levelFile << "# " << Goal::getFormat() << "\n";
+    levelFile << mGoals;
+    levelFile << "[/Goals]" << std::endl;
+
+    levelFile << "\n[Tiles]\n";
+    levelFile << "# Map Size" << std::endl;
+    levelFile << mMapSizeX << " # MapSizeX" << std::endl;
+    levelFile << mMapSizeY << " # MapSizeY" << std::endl;
+
+    // Write out the tiles to the file
+    levelFile << "# " << Tile::getFormat() << "\n";
+    for(const TileSaveState& tile : mTiles)
+    {
+        Tile::exportSaveStateToStream(tile, levelFile);
+        levelFile << std::endl;
+    }
+    levelFile << "[/Tiles]" << std::endl;
+
+    levelFile << "\n[Rooms]\n";
+    levelFile << "# " << Room::getRoomStreamFormat() << "\n";
+    levelFile << mRooms;
+    levelFile << "[/Rooms]" << std::endl;
+
+    levelFile << "\n[Traps]\n";
+    levelFile << "# " << Trap::getTrapStreamFormat() << "\n";
+    levelFile << mTraps;
+    levelFile << "[/Traps]" << std::endl;
+
+    levelFile << "\n[Lights]\n";
+    levelFile << "# " << MapLight::getMapLightStreamFormat() << "\n";
+    levelFile << mLights;
+    levelFile << "[/Lights]" << std::endl;
+
+    levelFile << std::endl << "[CreatureDefinitions]" << std::endl;
+    levelFile << mCreatureDefinitions;
+    levelFile << "[/CreatureDefinitions]" << std::endl;
+
+    levelFile << std::endl << "[EquipmentDefinitions]" << std::endl;
+    levelFile << mEquipmentDefinitions;
+    levelFile << "[/EquipmentDefinitions]" << std::endl;
+
+    // Write out the individual creatures to the file
+    levelFile << "\n[Creatures]\n";
+    levelFile << "# " << Creature::getCreatureStreamFormat() << "\n";
+    for (const CreatureSaveState& creature : mCreatures)
+    {
+        Creature::exportSaveStateToStream(creature, levelFile);
+        levelFile << std::endl;
+    }
+    levelFile << "[/Creatures]" << std::endl;
+
+    levelFile << "\n[Spells]\n";
+    levelFile << "# " << Spell::getSpellStreamFormat() << "\n";
+    levelFile << mSpells;
+    levelFile << "[/Spells]" << std::endl;
+
+    levelFile << "\n[CraftedTraps]\n";
+    levelFile << "# " << CraftedTrap::getCraftedTrapStreamFormat() << "\n";
+    levelFile << mCraftedTraps;
+    levelFile << "[/CraftedTraps]" << std::endl;
+
+    levelFile << "\n[SkillEntity]\n";
+    levelFile << "# " << SkillEntity::getSkillEntityStreamFormat() << "\n";
+    levelFile << mSkillEntities;
+    levelFile << "[/SkillEntity]" << std::endl;
+
+    levelFile << "\n[GiftBoxEntity]\n";
+    levelFile << "# " << GiftBoxEntity::getGiftBoxEntityStreamFormat() << "\n";
+    levelFile << mGiftBoxEntities;
+    levelFile << "[/GiftBoxEntity]" << std::endl;
+
+    levelFile << "\n[Missiles]\n";
+    levelFile << "# " << MissileObject::getMissileObjectStreamFormat() << "\n";
+    levelFile << mMissiles;
+    levelFile << "[/Missiles]" << std::endl;
+
+    levelFile << "\n[TreasuryObject]\n";
+    levelFile << "# " << TreasuryObject::getTreasuryObjectStreamFormat() << "\n";
+    levelFile << mTreasuryObjects;
+    levelFile << "[/TreasuryObject]" << std::endl;
+
+    levelFile << "\n[Chickens]\n";
+    levelFile << "# " << ChickenEntity::getChickenEntityStreamFormat() << "\n";
+    levelFile << mChickens;
+    levelFile << "[/Chickens]" << std::endl;
+}
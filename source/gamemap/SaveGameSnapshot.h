@@ -0,0 +1,159 @@
+/*
+ *  Copyright (C) 2011-2016  OpenDungeons Team
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef SAVEGAMESNAPSHOT_H
+#define SAVEGAMESNAPSHOT_H
+
+#include <OgreVector3.h>
+
+#include <cstdint>
+#include <iosfwd>
+#include <string>
+#include <vector>
+
+class GameMap;
+
+enum class SkillType;
+enum class TileType;
+enum class TileVisual;
+
+//! \brief Fields of a GameEntity written in the level files
+struct GameEntitySaveState
+{
+    int mSeatId;
+    std::string mName;
+    std::string mMeshName;
+    Ogre::Vector3 mPosition;
+};
+
+//! \brief Fields of a Creature written in the level files
+struct CreatureSaveState : public GameEntitySaveState
+{
+    std::string mClassName;
+    unsigned int mLevel;
+    double mExp;
+    //! \brief True if the creature has all its HP. In this case, mHp is not written
+    bool mIsHpMax;
+    double mHp;
+    double mWakefulness;
+    double mHunger;
+    int32_t mGoldCarried;
+    //! \brief Weapon names ("none" if no weapon)
+    std::string mWeaponL;
+    std::string mWeaponR;
+    SkillType mSkillTypeDropDeath;
+    std::string mWeaponDropDeath;
+    uint32_t mNbEffects;
+    //! \brief Creature effects are few and polymorphic. They are kept in their stream format
+    std::vector<std::string> mEffects;
+};
+
+//! \brief Fields of a Tile written in the level files
+struct TileSaveState
+{
+    int mX;
+    int mY;
+    TileType mType;
+    double mFullness;
+    //! \brief -1 if the tile is not claimed
+    int mSeatId;
+};
+
+//! \brief State of a tile known by a seat
+struct SeatTileSaveState
+{
+    int mX;
+    int mY;
+    TileVisual mTileVisual;
+    int mSeatIdOwner;
+    bool mMarkedForDigging;
+};
+
+//! \brief Fields of a Seat written in the level files
+struct SeatSaveState
+{
+    int mId;
+    int mTeamId;
+    std::vector<int> mAvailableTeamIds;
+    std::string mPlayerType;
+    std::string mFaction;
+    int mStartingX;
+    int mStartingY;
+    std::string mColorId;
+    int mGold;
+    int mGoldMined;
+    double mMana;
+    std::vector<SkillType> mSkillDone;
+    std::vector<SkillType> mSkillNotAllowed;
+    std::vector<SkillType> mSkillPending;
+    //! \brief Tile states are only saved for human players while in game
+    bool mExportTilesStates;
+    //! \brief Tiles with a non default visual or marked for digging
+    std::vector<SeatTileSaveState> mTilesStates;
+};
+
+//! \brief Copy of the gamemap state needed to write a level file. The copy is taken on the server
+//! thread between 2 turns (see capture). Then, the text can be formatted by any thread without
+//! accessing the gamemap (see writeToStream).
+//! Tiles, seats and creatures, which make most of a savegame, are copied as plain values. The other
+//! entities (rooms, traps, spells, ...) are few and use many polymorphic formats. They are
+//! kept in their level file format.
+class SaveGameSnapshot
+{
+public:
+    SaveGameSnapshot();
+
+    //! \brief Copies the state of the given gamemap. Must be called by the thread owning the gamemap
+    void capture(GameMap& gameMap);
+
+    //! \brief Writes the captured state with the level file format
+    void writeToStream(std::ostream& levelFile) const;
+
+private:
+    std::string mLevelName;
+    std::string mLevelDescription;
+    std::string mLevelMusicFile;
+    std::string mLevelFightMusicFile;
+    std::string mTileSetName;
+    //! \brief Savegames keep the state of the random streams. Not written in editor mode
+    bool mIsSeedSaved;
+    uint64_t mSeed;
+
+    int mMapSizeX;
+    int mMapSizeY;
+
+    std::vector<SeatSaveState> mSeats;
+    std::vector<TileSaveState> mTiles;
+    std::vector<CreatureSaveState> mCreatures;
+
+    //! \brief Sections kept in the level file format
+    std::string mGoals;
+    std::string mRooms;
+    std::string mTraps;
+    std::string mLights;
+    std::string mCreatureDefinitions;
+    std::string mEquipmentDefinitions;
+    std::string mSpells;
+    std::string mCraftedTraps;
+    std::string mSkillEntities;
+    std::string mGiftBoxEntities;
+    std::string mMissiles;
+    std::string mTreasuryObjects;
+    std::string mChickens;
+};
+
+#endif // SAVEGAMESNAPSHOT_H
@@ -0,0 +1,112 @@
+/*
+ *  Copyright (C) 2011-2016  OpenDungeons Team
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "gamemap/SaveGameWriter.h"
+
+#include "gamemap/SaveGameSnapshot.h"
+#include "utils/LogManager.h"
+
+#include <SFML/System.hpp>
+
+#include <boost/filesystem.hpp>
+
+#include <fstream>
+
+SaveGameWriter::SaveGameWriter() :
+    mWriterThread(nullptr),
+    mSuccess(false),
+    mIsWriting(false),
+    mIsFinished(false)
+{
+}
+
+SaveGameWriter::~SaveGameWriter()
+{
+    waitWriterThread();
+}
+
+bool SaveGameWriter::startWriting(const std::string& fileName, std::unique_ptr<SaveGameSnapshot> snapshot)
+{
+    if(mIsWriting)
+        return false;
+
+    // The previous thread is done. We can delete it
+    waitWriterThread();
+
+    mFileName = fileName;
+    mSnapshot = std::move(snapshot);
+    mSuccess = false;
+    mIsFinished = false;
+    mIsWriting = true;
+    mWriterThread = new sf::Thread(&SaveGameWriter::writerThread, this);
+    mWriterThread->launch();
+    return true;
+}
+
+bool SaveGameWriter::isWriting() const
+{
+    return mIsWriting;
+}
+
+bool SaveGameWriter::popFinishedSave(std::string& fileName, bool& success)
+{
+    if(mIsWriting || !mIsFinished)
+        return false;
+
+    mIsFinished = false;
+    fileName = mFileName;
+    success = mSuccess;
+    return true;
+}
+
+void SaveGameWriter::writerThread()
+{
+    boost::system::error_code ec;
+    // If the file exists, we make a backup
+    if (boost::filesystem::exists(mFileName, ec))
+        boost::filesystem::rename(mFileName, mFileName + ".bak", ec);
+
+    std::ofstream levelFile(mFileName.c_str(), std::ofstream::out);
+    if (!levelFile.good())
+    {
+        OD_LOG_WRN("Couldn't open file for writing: " + mFileName);
+        mSuccess = false;
+    }
+    else
+    {
+        mSnapshot->writeToStream(levelFile);
+        levelFile.close();
+        mSuccess = levelFile.good();
+        if(!mSuccess)
+            OD_LOG_WRN("Unexpected failure on file: " + mFileName);
+    }
+
+    // We release the memory now as savegames can be big
+    mSnapshot.reset();
+
+    mIsFinished = true;
+    mIsWriting = false;
+}
+
+void SaveGameWriter::waitWriterThread()
+{
+    if(mWriterThread == nullptr)
+        return;
+
+    delete mWriterThread; // Delete waits for the thread to finish
+    mWriterThread = nullptr;
+}
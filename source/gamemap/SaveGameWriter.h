@@ -0,0 +1,72 @@
+/*
+ *  Copyright (C) 2011-2016  OpenDungeons Team
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef SAVEGAMEWRITER_H
+#define SAVEGAMEWRITER_H
+
+#include <atomic>
+#include <memory>
+#include <string>
+
+class SaveGameSnapshot;
+
+namespace sf
+{
+class Thread;
+}
+
+//! \brief Writes a savegame file on a background thread. The gamemap state is first copied in a
+//! SaveGameSnapshot at a turn boundary. Then, the level file is formatted and written (and the
+//! previous one backed up) by the writer thread so that the server does not wait for it.
+//! Only one save can be in progress at a time.
+class SaveGameWriter
+{
+public:
+    SaveGameWriter();
+
+    //! \brief Waits for the save in progress (if any) to finish
+    ~SaveGameWriter();
+
+    //! \brief Starts writing the given snapshot in fileName. If the file exists, it is renamed with a .bak
+    //! extension first. Returns false if a save is already in progress
+    bool startWriting(const std::string& fileName, std::unique_ptr<SaveGameSnapshot> snapshot);
+
+    //! \brief Returns true if a save is in progress
+    bool isWriting() const;
+
+    //! \brief Returns true once for each finished save. In this case, fileName and success are set
+    //! according to the finished save
+    bool popFinishedSave(std::string& fileName, bool& success);
+
+private:
+    void writerThread();
+
+    //! \brief Waits for the writer thread to finish (if any)
+    void waitWriterThread();
+
+    sf::Thread* mWriterThread;
+
+    //! \brief File and snapshot of the save in progress. Only accessed by the writer thread while mIsWriting is true
+    std::string mFileName;
+    std::unique_ptr<SaveGameSnapshot> mSnapshot;
+    bool mSuccess;
+
+    std::atomic<bool> mIsWriting;
+    std::atomic<bool> mIsFinished;
+};
+
+#endif // SAVEGAMEWRITER_H
@@ -22,6 +22,9 @@
 #include "network/ODPacket.h"
 #include "utils/Helper.h"
 #include "utils/LogManager.h"
+#include "utils/MemoryReport.h"
+
+#include <algorithm>
 
 const std::vector<Tile*> EMPTY_TILES;
 
@@ -328,12 +331,24 @@ bool sortByDistSquared(const TileDistance& tileDist1, const TileDistance& tileDi
     return tileDist1.getDistSquared() < tileDist2.getDistSquared();
 }
 
+TileVisibilityWork::TileVisibilityWork()
+{
+}
+
+TileVisibilityWork::~TileVisibilityWork()
+{
+}
+
 TileContainer::TileContainer(int initTileDistance):
     mMapSizeX(0),
     mMapSizeY(0),
     mRr(0),
     mTiles(nullptr),
-    mTileDistanceComputed(0)
+    mTileDistanceComputed(0),
+    mNbTileVectorsAllocated(0),
+    mTileBorderStamp(0),
+    mTilesLayoutVersion(0),
+    mLayoutChangedTilesFirstVersion(0)
 {
     buildTileDistance(initTileDistance);
 }
@@ -361,6 +376,37 @@ void TileContainer::clearTiles()
     }
     mMapSizeX = 0;
     mMapSizeY = 0;
+    resetLayoutChangedTiles();
+}
+
+void TileContainer::tileLayoutChanged(const Tile* tile)
+{
+    ++mTilesLayoutVersion;
+    if(mLayoutChangedTiles.size() >= static_cast<uint32_t>(mMapSizeX * mMapSizeY))
+    {
+        mLayoutChangedTiles.clear();
+        mLayoutChangedTilesFirstVersion = mTilesLayoutVersion - 1;
+    }
+    mLayoutChangedTiles.push_back(static_cast<uint32_t>(tile->getX() * mMapSizeY + tile->getY()));
+}
+
+void TileContainer::resetLayoutChangedTiles()
+{
+    // The changed tiles indexes are not valid anymore
+    ++mTilesLayoutVersion;
+    mLayoutChangedTiles.clear();
+    mLayoutChangedTilesFirstVersion = mTilesLayoutVersion;
+}
+
+bool TileContainer::getTilesLayoutChangedSince(uint64_t version, std::vector<uint32_t>& changedTiles) const
+{
+    changedTiles.clear();
+    if((version < mLayoutChangedTilesFirstVersion) || (version > mTilesLayoutVersion))
+        return false;
+
+    changedTiles.assign(mLayoutChangedTiles.begin() + (version - mLayoutChangedTilesFirstVersion),
+        mLayoutChangedTiles.end());
+    return true;
 }
 
 bool TileContainer::addTile(Tile* t)
@@ -473,12 +519,24 @@ bool TileContainer::allocateMapMemory(int xSize, int ySize)
         }
     }
 
+    mTileBorderStamps.assign(static_cast<std::size_t>(mMapSizeX * mMapSizeY), 0);
+    mTileBorderStamp = 0;
+    resetLayoutChangedTiles();
+
     return true;
 }
 
 std::vector<Tile*> TileContainer::rectangularRegion(int x1, int y1, int x2, int y2)
 {
     std::vector<Tile*> returnList;
+    rectangularRegion(x1, y1, x2, y2, returnList);
+    ++mNbTileVectorsAllocated;
+    return returnList;
+}
+
+void TileContainer::rectangularRegion(int x1, int y1, int x2, int y2, std::vector<Tile*>& returnList)
+{
+    returnList.clear();
     Tile *tempTile;
 
     if (x1 > x2)
@@ -496,15 +554,21 @@ std::vector<Tile*> TileContainer::rectangularRegion(int x1, int y1, int x2, int
                 returnList.push_back(tempTile);
         }
     }
+}
 
+std::vector<Tile*> TileContainer::circularRegion(int x, int y, int radius)
+{
+    std::vector<Tile*> returnList;
+    circularRegion(x, y, radius, returnList);
+    ++mNbTileVectorsAllocated;
     return returnList;
 }
 
-std::vector<Tile*> TileContainer::circularRegion(int x, int y, int radius)
+void TileContainer::circularRegion(int x, int y, int radius, std::vector<Tile*>& returnList)
 {
     // To compute the tiles within this region, we use the symmetry of the square. That's why we mix tile x/y coordinate
     // with tileDist diffX/diffY. More explanation can be found in the buildTileDistance function
-    std::vector<Tile*> returnList;
+    returnList.clear();
 
     if(radius > mTileDistanceComputed)
         buildTileDistance(radius);
@@ -602,35 +666,49 @@ std::vector<Tile*> TileContainer::circularRegion(int x, int y, int radius)
             }
         }
     }
-
-    return returnList;
 }
 
 std::vector<Tile*> TileContainer::tilesBorderedByRegion(const std::vector<Tile*> &region)
 {
     std::vector<Tile*> returnList;
+    tilesBorderedByRegion(region, returnList);
+    ++mNbTileVectorsAllocated;
+    return returnList;
+}
 
-    std::vector<std::vector<bool>> tilesToRefresh(getMapSizeX(), std::vector<bool>(getMapSizeY(), false));
-    for (Tile* t1 : region)
+void TileContainer::tilesBorderedByRegion(const std::vector<Tile*> &region, std::vector<Tile*>& tiles)
+{
+    tiles.clear();
+    forEachTileBorderedByRegion(region, [&tiles](Tile* tile, bool)
     {
-        if(!tilesToRefresh[t1->getX()][t1->getY()])
-        {
-            tilesToRefresh[t1->getX()][t1->getY()] = true;
-            returnList.push_back(t1);
-        }
+        tiles.push_back(tile);
+    });
+}
 
-        // Get the tiles bordering the current tile and loop over them.
-        for (Tile* t2 : t1->getAllNeighbors())
-        {
-            if(tilesToRefresh[t2->getX()][t2->getY()])
-                continue;
+void TileContainer::nextTileBorderStamp()
+{
+    ++mTileBorderStamp;
+    if(mTileBorderStamp != 0)
+        return;
 
-            tilesToRefresh[t2->getX()][t2->getY()] = true;
-            returnList.push_back(t2);
-        }
-    }
+    // The stamp wrapped. We reset the tiles so that none is considered as already processed
+    std::fill(mTileBorderStamps.begin(), mTileBorderStamps.end(), 0);
+    mTileBorderStamp = 1;
+}
 
-    return returnList;
+bool TileContainer::markTileBorder(const Tile* tile)
+{
+    uint32_t& stamp = mTileBorderStamps[tile->getX() * mMapSizeY + tile->getY()];
+    if(stamp == mTileBorderStamp)
+        return false;
+
+    stamp = mTileBorderStamp;
+    return true;
+}
+
+const std::vector<Tile*>& TileContainer::tileNeighbors(const Tile* tile)
+{
+    return tile->getAllNeighbors();
 }
 
 const std::vector<Tile*>& TileContainer::neighborTiles(int x, int y) const
@@ -810,12 +888,67 @@ std::list<Tile*> TileContainer::tilesBetween(int x1, int y1, int x2, int y2) con
 
 std::vector<Tile*> TileContainer::visibleTiles(int x, int y, int radius)
 {
-    // To compute the tiles within this region, we use the symmetry of the square. That's why we mix tile x/y coordinate
-    // with tileDist diffX/diffY. More explanation can be found in the buildTileDistance function
     std::vector<Tile*> returnList;
+    visibleTiles(x, y, radius, returnList);
+    ++mNbTileVectorsAllocated;
+    return returnList;
+}
+
+void TileContainer::visibleTiles(int x, int y, int radius, std::vector<Tile*>& returnList)
+{
+    prepareTileDistance(radius);
+    visibleTiles(x, y, radius, returnList, mVisibilityWork);
+}
+
+void TileContainer::fillMemoryReport(MemoryReport& report) const
+{
+    std::size_t tilesBytes = 0;
+    std::size_t floodFillBytes = 0;
+    if(mTiles != nullptr)
+    {
+        tilesBytes += mMapSizeX * sizeof(Tile**) + mMapSizeX * mMapSizeY * sizeof(Tile*);
+        for(int ii = 0; ii < mMapSizeX; ++ii)
+        {
+            for(int jj = 0; jj < mMapSizeY; ++jj)
+            {
+                tilesBytes += mTiles[ii][jj]->getMemoryUsed();
+                floodFillBytes += mTiles[ii][jj]->getFloodFillMemoryUsed();
+            }
+        }
+    }
+    report.add("tiles", tilesBytes);
+    report.add("floodFill", floodFillBytes);
 
+    std::size_t tileDistanceBytes = MemoryReport::vectorBytes(mTileDistance);
+    for(const TileDistance& tileDistance : mTileDistance)
+    {
+        tileDistanceBytes += MemoryReport::vectorBytes(tileDistance.getHiddenTilesNorth());
+        tileDistanceBytes += MemoryReport::vectorBytes(tileDistance.getHiddenTilesSouth());
+    }
+    for(const std::vector<TileDistanceProcess>& tilesProcess : mVisibilityWork.mTilesProcess)
+        tileDistanceBytes += MemoryReport::vectorBytes(tilesProcess);
+
+    report.add("tileDistance", tileDistanceBytes);
+    report.add("tilesLayoutChanges", MemoryReport::vectorBytes(mLayoutChangedTiles));
+}
+
+void TileContainer::prepareTileDistance(int radius)
+{
     if(radius > mTileDistanceComputed)
         buildTileDistance(radius);
+}
+
+void TileContainer::visibleTiles(int x, int y, int radius, std::vector<Tile*>& returnList, TileVisibilityWork& work) const
+{
+    // To compute the tiles within this region, we use the symmetry of the square. That's why we mix tile x/y coordinate
+    // with tileDist diffX/diffY. More explanation can be found in the buildTileDistance function
+    returnList.clear();
+
+    if(radius > mTileDistanceComputed)
+    {
+        OD_LOG_ERR("radius=" + Helper::toString(radius) + ", computed=" + Helper::toString(mTileDistanceComputed));
+        return;
+    }
 
     int radiusSquared = radius * radius;
 
@@ -826,9 +959,10 @@ std::vector<Tile*> TileContainer::visibleTiles(int x, int y, int radius)
     // 637
     // Then, we will have to merge diagonal/horizontal tiles
     // Because we want the index to be correct, we will add tiles even when null in tilesProcess
-    std::vector<TileDistanceProcess> tilesProcess[8];
+    std::vector<TileDistanceProcess>* tilesProcess = work.mTilesProcess;
     for(uint32_t k = 0; k < 8; ++k)
     {
+        tilesProcess[k].clear();
         for(const TileDistance& tileDist : mTileDistance)
         {
             if(tileDist.getDistSquared() > radiusSquared)
@@ -967,5 +1101,4 @@ std::vector<Tile*> TileContainer::visibleTiles(int x, int y, int radius)
             returnList.push_back(tileDistanceProcess.getTile());
         }
     }
-    return returnList;
 }
@@ -19,15 +19,33 @@
 #define TILECONTAINER_H
 
 #include <cassert>
+#include <cstdint>
 #include <list>
 #include <vector>
 
+class MemoryReport;
 class ODPacket;
 class TileDistance;
+class TileDistanceProcess;
 class Tile;
 
 enum class TileType;
 
+//! \brief Work vectors used by visibleTiles. They are kept from one call to another to avoid
+//! allocating memory each time. Threads computing visible tiles at the same time must each
+//! use their own
+class TileVisibilityWork
+{
+public:
+    TileVisibilityWork();
+    ~TileVisibilityWork();
+
+    TileVisibilityWork(const TileVisibilityWork&) = delete;
+    TileVisibilityWork& operator=(const TileVisibilityWork&) = delete;
+
+    std::vector<TileDistanceProcess> mTilesProcess[8];
+};
+
 class TileContainer
 {
 public:
@@ -65,15 +83,48 @@ public:
     //! \brief Returns all the valid tiles in the rectangular region specified by the two corner points given.
     std::vector<Tile*> rectangularRegion(int x1, int y1, int x2, int y2);
 
+    //! \brief Same as rectangularRegion but the tiles are put in the given vector (that will be cleared
+    //! first). Callers that reuse the same vector each turn will not need to allocate memory once it is big enough.
+    void rectangularRegion(int x1, int y1, int x2, int y2, std::vector<Tile*>& tiles);
+
     //! \brief Returns all the valid tiles in the curcular region
     //! surrounding the given point and extending outward to the specified radius.
     std::vector<Tile*> circularRegion(int x, int y, int radius);
 
+    //! \brief Same as circularRegion but the tiles are put in the given vector (cleared first)
+    void circularRegion(int x, int y, int radius, std::vector<Tile*>& tiles);
+
     //! \brief Returns a vector of all the valid tiles which are a neighbor
     //! to one or more tiles in the specified region,
     //! i.e. the "perimeter" of the region extended out one tile.
     std::vector<Tile*> tilesBorderedByRegion(const std::vector<Tile*> &region);
 
+    //! \brief Same as tilesBorderedByRegion but the tiles are put in the given vector (cleared first)
+    void tilesBorderedByRegion(const std::vector<Tile*> &region, std::vector<Tile*>& tiles);
+
+    //! \brief Calls f(tile, isInRegion) once for each tile of the given region (isInRegion = true) and
+    //! then once for each tile bordering it (isInRegion = false). Duplicates are skipped with a stamp so that
+    //! the cost only depends on the region size. f must not modify the region nor call this function again
+    template<typename F>
+    void forEachTileBorderedByRegion(const std::vector<Tile*>& region, F f)
+    {
+        nextTileBorderStamp();
+        for(Tile* tile : region)
+        {
+            if(markTileBorder(tile))
+                f(tile, true);
+        }
+
+        for(Tile* tile : region)
+        {
+            for(Tile* neighbor : tileNeighbors(tile))
+            {
+                if(markTileBorder(neighbor))
+                    f(neighbor, false);
+            }
+        }
+    }
+
     //! \brief Returns the (up to) 4 nearest neighbor tiles of the tile located at (x, y).
     const std::vector<Tile*>& neighborTiles(int x, int y) const;
 
@@ -97,6 +148,45 @@ public:
     //! the furthest
     std::vector<Tile*> visibleTiles(int x, int y, int radius);
 
+    //! \brief Same as visibleTiles but the tiles are put in the given vector (cleared first)
+    void visibleTiles(int x, int y, int radius, std::vector<Tile*>& tiles);
+
+    //! \brief Same as visibleTiles but uses the given work vectors. The tile distances must have been
+    //! computed for radius with prepareTileDistance. Then, it can be called from several threads at the
+    //! same time (each with its own work) as long as the tiles are not modified
+    void visibleTiles(int x, int y, int radius, std::vector<Tile*>& tiles, TileVisibilityWork& work) const;
+
+    //! \brief Makes sure the tile distances used by circularRegion and visibleTiles are computed up
+    //! to the given radius. Once called, these functions do not modify the TileContainer for smaller radius
+    void prepareTileDistance(int radius);
+
+    //! \brief Work vectors used by visibleTiles when called without its own. Only the server thread should use them
+    inline TileVisibilityWork& getVisibilityWork()
+    { return mVisibilityWork; }
+
+    //! \brief Returns the number of tile vectors allocated by the functions returning them by value since the
+    //! beginning. Can be used to check the per turn allocations
+    inline uint64_t getNbTileVectorsAllocated() const
+    { return mNbTileVectorsAllocated; }
+
+    //! \brief Adds the memory used by the tiles, their flood fill values and the tile distances to the given report
+    void fillMemoryReport(MemoryReport& report) const;
+
+    //! \brief Returns a value that changes each time a tile gets dug out or filled, or when the claimed seat or
+    //! the covering building of a tile changes. Partial fullness changes while digging do not change it.
+    //! Allows to cache data computed from the tiles layout and to know when it is outdated
+    inline uint64_t getTilesLayoutVersion() const
+    { return mTilesLayoutVersion; }
+
+    //! \brief Called by the tiles when they get dug out or filled or when their claimed seat or covering building changes
+    void tileLayoutChanged(const Tile* tile);
+
+    //! \brief Fills changedTiles with the indexes (x * mapSizeY + y) of the tiles changed since the given layout
+    //! version. A tile changed several times is given several times. Returns false if the changes since that
+    //! version are not known anymore (too old or the map has been cleared). Then, every tile should be
+    //! considered as changed
+    bool getTilesLayoutChangedSince(uint64_t version, std::vector<uint32_t>& changedTiles) const;
+
 protected:
     //! \brief The map size
     int mMapSizeX;
@@ -118,6 +208,37 @@ private:
     //! \brief Stores the highest distance computed. If a bigger distance is asked, mTileDistance will have to be updated by
     //! calling buildTileDistance with the higher distance
     int mTileDistanceComputed;
+
+    //! \brief Work vectors used by visibleTiles when called without its own
+    TileVisibilityWork mVisibilityWork;
+
+    //! \brief See getNbTileVectorsAllocated
+    uint64_t mNbTileVectorsAllocated;
+
+    //! \brief Stamp of the last forEachTileBorderedByRegion call that went through each tile (indexed by
+    //! x * mMapSizeY + y). A tile is already processed during the current call if its stamp is mTileBorderStamp
+    std::vector<uint32_t> mTileBorderStamps;
+    uint32_t mTileBorderStamp;
+
+    //! \brief See getTilesLayoutVersion
+    uint64_t mTilesLayoutVersion;
+
+    //! \brief Indexes of the tiles changed from mLayoutChangedTilesFirstVersion to mTilesLayoutVersion (one per
+    //! version). It is cleared when it gets bigger than the map as reading the whole map is then cheaper
+    std::vector<uint32_t> mLayoutChangedTiles;
+    uint64_t mLayoutChangedTilesFirstVersion;
+
+    //! \brief Called when the map is cleared or reallocated
+    void resetLayoutChangedTiles();
+
+    //! \brief Starts a new forEachTileBorderedByRegion call
+    void nextTileBorderStamp();
+
+    //! \brief Marks the given tile as processed by the current forEachTileBorderedByRegion call. Returns false
+    //! if it was already marked
+    bool markTileBorder(const Tile* tile);
+
+    static const std::vector<Tile*>& tileNeighbors(const Tile* tile);
 };
 
 #endif //TILECONTAINER_H
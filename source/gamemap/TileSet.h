@@ -82,6 +82,11 @@ public:
     //! Used on client side only
     bool areLinked(const Tile* tile1, const Tile* tile2) const;
 
+    //! Returns the tile visuals linked to the given one as a bit array (bit n set
+    //! if the TileVisual n is linked)
+    inline uint32_t getTileLinks(TileVisual tileVisual) const
+    { return mTileLinks[static_cast<uint32_t>(tileVisual)]; }
+
     void addTileLink(TileVisual tileVisual1, TileVisual tileVisual2);
 
 private:
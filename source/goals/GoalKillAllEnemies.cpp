@@ -42,15 +42,13 @@ bool GoalKillAllEnemies::isMet(const Seat &s, const GameMap& gameMap)
 
     // Considers also creature spawner rooms as enemy to be killed.
     // Temples
-    std::vector<Room*> temples = gameMap.getRoomsByType(RoomType::dungeonTemple);
-    for (Room* temple : temples)
+    for (Room* temple : gameMap.getRoomsByType(RoomType::dungeonTemple))
     {
         if (!temple->getSeat()->isAlliedSeat(&s))
             return false;
     }
     // Portals
-    std::vector<Room*> portals = gameMap.getRoomsByType(RoomType::portal);
-    for (Room* portal : portals)
+    for (Room* portal : gameMap.getRoomsByType(RoomType::portal))
     {
         if (!portal->getSeat()->isAlliedSeat(&s))
             return false;
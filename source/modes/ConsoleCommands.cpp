@@ -56,7 +56,8 @@ const std::string HELPMESSAGE =
         "\n\tcatmullspline - Triggers the catmullspline camera movement type."
         "\n\tcirclearound - Triggers the circle camera movement type."
         "\n\tsetcamerafovy - Sets the camera vertical field of view aspect ratio value."
-        "\n\tlogfloodfill - Displays the FloodFillValues of all the Tiles in the GameMap.";
+        "\n\tlogfloodfill - Displays the FloodFillValues of all the Tiles in the GameMap."
+        "\n\tmemoryreport - Displays the memory used by the server subsystems.";
 
 //! \brief Template function to get/set a variable from the ODFrameListener object
 template<typename ValType, typename Getter, typename Setter>
@@ -418,6 +419,14 @@ Command::Result cSrvLogFloodFill(const Command::ArgumentList_t&, ConsoleInterfac
     return Command::Result::SUCCESS;
 }
 
+Command::Result cSrvMemoryReport(const Command::ArgumentList_t&, ConsoleInterface& c, GameMap&)
+{
+    std::vector<std::string> lines = ODServer::getSingleton().getMemoryReportLines();
+    for(const std::string& line : lines)
+        c.print(line);
+    return Command::Result::SUCCESS;
+}
+
 Command::Result cSetCameraFOVy(const Command::ArgumentList_t& args, ConsoleInterface& c, AbstractModeManager&)
 {
     Ogre::Camera* cam = ODFrameListener::getSingleton().getCameraManager()->getActiveCamera();
@@ -662,6 +671,12 @@ void addConsoleCommands(ConsoleInterface& cl)
                    cSrvLogFloodFill,
                    {AbstractModeManager::ModeType::GAME},
                    {});
+    cl.addCommand("memoryreport",
+                   "'memoryreport' displays the memory used by the main server subsystems and how fast it grew since the last periodic report.",
+                   cSendCmdToServer,
+                   cSrvMemoryReport,
+                   {AbstractModeManager::ModeType::GAME},
+                   {});
     cl.addCommand("listmeshanims",
                    "'listmeshanims' lists all the animations for the given mesh.",
                    cListMeshAnims,
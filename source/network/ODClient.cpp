@@ -768,7 +768,7 @@ bool ODClient::processMessage(ServerNotificationType cmd, ODPacket& packetReceiv
                     continue;
 
                 tile->setLocalPlayerHasVision(true);
-                tile->refreshMesh();
+                gameMap->queueTileMeshRefresh(tile);
             }
             // Tiles we lost vision
             OD_ASSERT_TRUE(packetReceived >> nbTiles);
@@ -780,7 +780,7 @@ bool ODClient::processMessage(ServerNotificationType cmd, ODPacket& packetReceiv
                     continue;
 
                 tile->setLocalPlayerHasVision(false);
-                tile->refreshMesh();
+                gameMap->queueTileMeshRefresh(tile);
             }
             break;
         }
@@ -821,7 +821,7 @@ bool ODClient::processMessage(ServerNotificationType cmd, ODPacket& packetReceiv
                     continue;
 
                 tile->setMarkedForDigging(digSet, player);
-                tile->refreshMesh();
+                gameMap->queueTileMeshRefresh(tile);
             }
             break;
         }
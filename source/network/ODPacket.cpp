@@ -243,6 +243,23 @@ void ODPacket::clear()
     mPacket.clear();
 }
 
+std::size_t ODPacket::getDataSize() const
+{
+    return mPacket.getDataSize();
+}
+
+void ODPacket::appendToNetworkBuffer(std::vector<char>& buffer) const
+{
+    // Like sf::TcpSocket, the size is sent in network byte order
+    uint32_t packetSize = static_cast<uint32_t>(mPacket.getDataSize());
+    buffer.push_back(static_cast<char>((packetSize >> 24) & 0xFF));
+    buffer.push_back(static_cast<char>((packetSize >> 16) & 0xFF));
+    buffer.push_back(static_cast<char>((packetSize >> 8) & 0xFF));
+    buffer.push_back(static_cast<char>(packetSize & 0xFF));
+    const char* data = static_cast<const char*>(mPacket.getData());
+    buffer.insert(buffer.end(), data, data + packetSize);
+}
+
 void ODPacket::writePacket(int32_t timestamp, std::ofstream& os)
 {
     int32_t bufferSize = mPacket.getDataSize();
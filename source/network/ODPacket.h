@@ -22,6 +22,7 @@
 #include <SFML/Network.hpp>
 
 #include <string>
+#include <vector>
 #include <cstdint>
 
 /*! \brief This class is an utility class to transfer data through ODSocketClient.
@@ -125,6 +126,15 @@ class ODPacket
          */
         void clear();
 
+        /*! \brief Returns the size in bytes of the data written in the packet.
+         */
+        std::size_t getDataSize() const;
+
+        /*! \brief Appends the packet to buffer the way sf::TcpSocket sends it (size then content). The
+         * buffer can then be sent with ODSocketClient::sendRaw.
+         */
+        void appendToNetworkBuffer(std::vector<char>& buffer) const;
+
         /*! \brief Writes the packet content to the given ofstream.
          */
         void writePacket(int32_t timestamp, std::ofstream& os);
@@ -0,0 +1,398 @@
+/*
+ *  Copyright (C) 2011-2016  OpenDungeons Team
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "network/ODRelay.h"
+
+#include "network/ClientNotification.h"
+#include "network/ServerNotification.h"
+#include "utils/Helper.h"
+#include "utils/LogManager.h"
+
+#include <SFML/System.hpp>
+
+#include <cstdio>
+
+//! \brief Time given to the relay thread to handle the spectators before checking the server packets
+static const int32_t RELAY_TASK_MS = 10;
+
+//! \brief Timeout when connecting to the server
+static const uint32_t RELAY_CONNECT_TIMEOUT_MS = 5000;
+
+//! \brief The send buffer of a spectator is filled until it contains that many bytes
+static const std::size_t RELAY_SPECTATOR_BUFFER_BYTES = 64 * 1024;
+
+//! \brief Spectators for which nothing could be sent for this long are dropped
+static const int32_t RELAY_SPECTATOR_STALL_MS = 10000;
+
+//! \brief Size of a packet header in the spool file (timestamp and size, see ODPacket::writePacket)
+static const uint64_t RELAY_SPOOL_HEADER_BYTES = 2 * sizeof(int32_t);
+
+bool ODRelay::Upstream::connectToServer(const std::string& host, int32_t port, const std::string& outputReplayFilename)
+{
+    if(!connect(host, port, RELAY_CONNECT_TIMEOUT_MS, outputReplayFilename))
+        return false;
+
+    // Send a hello request to start the conversation with the server
+    ODPacket packSend;
+    packSend << ClientNotificationType::hello << mRelay.mClientVersion;
+    send(packSend);
+    return true;
+}
+
+bool ODRelay::Upstream::processMessage(ServerNotificationType cmd, ODPacket& packetReceived)
+{
+    switch(cmd)
+    {
+        case ServerNotificationType::loadLevel:
+        {
+            // The relay does not need the level. It only forwards it to the spectators
+            ODPacket packSend;
+            packSend << ClientNotificationType::levelOK;
+            send(packSend);
+            break;
+        }
+
+        case ServerNotificationType::pickNick:
+        {
+            ODPacket packSend;
+            packSend << ClientNotificationType::setNick << mRelay.mNick;
+            send(packSend);
+
+            packSend.clear();
+            packSend << ClientNotificationType::readyForSeatConfiguration;
+            send(packSend);
+            break;
+        }
+
+        case ServerNotificationType::turnStarted:
+        {
+            int64_t turnNum;
+            OD_ASSERT_TRUE(packetReceived >> turnNum);
+            ODPacket packSend;
+            packSend << ClientNotificationType::ackNewTurn << turnNum;
+            send(packSend);
+            break;
+        }
+
+        default:
+            break;
+    }
+
+    // The packet is sent as a whole even if it was read so we can forward it as is
+    mRelay.addPacket(packetReceived);
+    return true;
+}
+
+void ODRelay::Upstream::playerDisconnected()
+{
+    uint32_t nbPackets = mRelay.mFirstPacketIndex + static_cast<uint32_t>(mRelay.mPackets.size());
+    OD_LOG_INF("Relay disconnected from server after " + Helper::toString(nbPackets) + " packets");
+    mRelay.mIsServerDisconnected = true;
+}
+
+ODRelay::ODRelay(const std::string& nick, const std::string& clientVersion, uint32_t delayMs,
+        std::size_t maxMemoryBytes) :
+    mNick(nick),
+    mClientVersion(clientVersion),
+    mDelayMs(delayMs),
+    mMaxMemoryBytes(maxMemoryBytes),
+    mUpstream(*this),
+    mFirstPacketIndex(0),
+    mPacketsBytes(0),
+    mNbReleasedPackets(0),
+    mIsServerDisconnected(false),
+    mIsRelaying(false),
+    mNbSpectators(0),
+    mNbPacketsInMemory(0)
+{
+}
+
+ODRelay::~ODRelay()
+{
+    stopRelay();
+}
+
+bool ODRelay::startRelay(const std::string& host, int32_t serverPort, int32_t listeningPort,
+    const std::string& outputReplayFilename)
+{
+    if(isConnected())
+    {
+        OD_LOG_INF("Couldn't start relay: The relay is already connected");
+        return false;
+    }
+
+    mPackets.clear();
+    mPacketsTime.clear();
+    mFirstPacketIndex = 0;
+    mPacketsBytes = 0;
+    mNbPacketsInMemory = 0;
+    mNbReleasedPackets = 0;
+    mIsServerDisconnected = false;
+    mClock.restart();
+
+    mSpoolFilename.clear();
+    if(!outputReplayFilename.empty())
+    {
+        std::string spoolFilename = outputReplayFilename + ".spool";
+        mSpoolOutput.open(spoolFilename, std::ios::out | std::ios::binary | std::ios::trunc);
+        mSpoolInput.open(spoolFilename, std::ios::in | std::ios::binary);
+        if(mSpoolOutput.good() && mSpoolInput.good())
+        {
+            mSpoolFilename = spoolFilename;
+        }
+        else
+        {
+            OD_LOG_WRN("Couldn't open relay spool file " + spoolFilename + ". The stream will be kept in memory");
+            mSpoolOutput.close();
+            mSpoolInput.close();
+        }
+    }
+
+    if(!mUpstream.connectToServer(host, serverPort, outputReplayFilename))
+    {
+        OD_LOG_ERR("Relay could not connect to server " + host + ":" + Helper::toString(serverPort));
+        return false;
+    }
+
+    mIsRelaying = true;
+    if(!createServer(listeningPort))
+    {
+        OD_LOG_ERR("Relay could not listen to spectators on port " + Helper::toString(listeningPort));
+        mIsRelaying = false;
+        mUpstream.disconnect(true);
+        return false;
+    }
+
+    OD_LOG_INF("Relay connected to " + host + ":" + Helper::toString(serverPort)
+        + ", delay=" + Helper::toString(mDelayMs) + "ms");
+    return true;
+}
+
+void ODRelay::stopRelay()
+{
+    // The relay thread is stopped by stopServer. After that, we can disconnect the upstream client
+    if(isConnected())
+        stopServer();
+
+    mSpectators.clear();
+    mNbSpectators = 0;
+    mUpstream.disconnect(true);
+    mIsRelaying = false;
+
+    if(!mSpoolFilename.empty())
+    {
+        mSpoolOutput.close();
+        mSpoolInput.close();
+        std::remove(mSpoolFilename.c_str());
+        mSpoolFilename.clear();
+    }
+}
+
+ODSocketClient* ODRelay::notifyNewConnection(sf::TcpListener& sockListener)
+{
+    ODSocketClient* newClient = new ODSocketClient;
+    sf::Socket::Status status = sockListener.accept(newClient->getSockClient());
+    if (status != sf::Socket::Done)
+    {
+        OD_LOG_ERR("Error while listening to socket status=" + Helper::toString(static_cast<uint32_t>(status)));
+        delete newClient;
+        return nullptr;
+    }
+
+    // A slow spectator should not block the relay thread (and the other spectators)
+    newClient->getSockClient().setBlocking(false);
+
+    // The new spectator starts from the beginning of the stream so that it gets the level and
+    // catches up with the game
+    mSpectators.emplace(newClient, SpectatorState(mClock.getElapsedTime().asMilliseconds()));
+    mNbSpectators = static_cast<uint32_t>(mSpectators.size());
+    OD_LOG_INF("New spectator. Nb spectators=" + Helper::toString(static_cast<uint32_t>(mNbSpectators)));
+    return newClient;
+}
+
+bool ODRelay::notifyClientMessage(ODSocketClient* sock)
+{
+    // What the spectators send (nick, turn acknowledgements, ...) is not needed
+    ODPacket packetReceived;
+    if(sock->recv(packetReceived) != ODSocketClient::ODComStatus::Error)
+        return true;
+
+    mSpectators.erase(sock);
+    mNbSpectators = static_cast<uint32_t>(mSpectators.size());
+    OD_LOG_INF("Spectator disconnected. Nb spectators=" + Helper::toString(static_cast<uint32_t>(mNbSpectators)));
+    return false;
+}
+
+void ODRelay::serverThread()
+{
+    while(isConnected())
+    {
+        doTask(RELAY_TASK_MS);
+
+        mUpstream.processClientSocketMessages();
+        bool isEverythingSent = sendReleasedPackets();
+        trimPackets();
+
+        // Once the server is gone and every packet is sent, there is nothing more to relay
+        if(mIsServerDisconnected &&
+           (mNbReleasedPackets == mFirstPacketIndex + static_cast<uint32_t>(mPackets.size())) &&
+           isEverythingSent)
+        {
+            mIsRelaying = false;
+        }
+    }
+}
+
+void ODRelay::addPacket(const ODPacket& packet)
+{
+    int32_t time = mClock.getElapsedTime().asMilliseconds();
+    mPackets.push_back(packet);
+    mPacketsTime.push_back(time);
+    mPacketsBytes += packet.getDataSize();
+    mNbPacketsInMemory = static_cast<uint32_t>(mPackets.size());
+
+    if(!mSpoolFilename.empty())
+        mPackets.back().writePacket(time, mSpoolOutput);
+}
+
+bool ODRelay::sendReleasedPackets()
+{
+    int32_t time = mClock.getElapsedTime().asMilliseconds();
+    int32_t releaseTime = time - static_cast<int32_t>(mDelayMs);
+    uint32_t nbPackets = mFirstPacketIndex + static_cast<uint32_t>(mPackets.size());
+    while((mNbReleasedPackets < nbPackets) &&
+          (mPacketsTime[mNbReleasedPackets - mFirstPacketIndex] <= releaseTime))
+    {
+        ++mNbReleasedPackets;
+    }
+
+    bool isEverythingSent = true;
+    std::vector<ODSocketClient*> droppedSpectators;
+    for(std::pair<ODSocketClient* const, SpectatorState>& p : mSpectators)
+    {
+        ODSocketClient* spectator = p.first;
+        SpectatorState& state = p.second;
+        if(!fillSendBuffer(state))
+        {
+            droppedSpectators.push_back(spectator);
+            continue;
+        }
+
+        if(state.mSendOffset >= state.mSendBuffer.size())
+        {
+            state.mLastSendTime = time;
+            continue;
+        }
+
+        isEverythingSent = false;
+        std::size_t sent = 0;
+        ODSocketClient::ODComStatus status = spectator->sendRaw(state.mSendBuffer.data() + state.mSendOffset,
+            state.mSendBuffer.size() - state.mSendOffset, sent);
+        if(status == ODSocketClient::ODComStatus::Error)
+        {
+            OD_LOG_INF("Could not send to spectator. Dropping it");
+            droppedSpectators.push_back(spectator);
+            continue;
+        }
+
+        if(sent > 0)
+        {
+            state.mSendOffset += sent;
+            state.mLastSendTime = time;
+            continue;
+        }
+
+        // The spectator does not read what we send
+        if(time - state.mLastSendTime > RELAY_SPECTATOR_STALL_MS)
+        {
+            OD_LOG_INF("Spectator lagging too far behind. Dropping it");
+            droppedSpectators.push_back(spectator);
+        }
+    }
+
+    for(ODSocketClient* spectator : droppedSpectators)
+    {
+        mSpectators.erase(spectator);
+        removeClient(spectator);
+    }
+
+    if(!droppedSpectators.empty())
+    {
+        mNbSpectators = static_cast<uint32_t>(mSpectators.size());
+        OD_LOG_INF("Nb spectators=" + Helper::toString(static_cast<uint32_t>(mNbSpectators)));
+    }
+
+    return isEverythingSent;
+}
+
+bool ODRelay::fillSendBuffer(SpectatorState& state)
+{
+    // We remove what is already sent
+    if(state.mSendOffset > 0)
+    {
+        state.mSendBuffer.erase(state.mSendBuffer.begin(), state.mSendBuffer.begin() + state.mSendOffset);
+        state.mSendOffset = 0;
+    }
+
+    while((state.mSendBuffer.size() < RELAY_SPECTATOR_BUFFER_BYTES) &&
+          (state.mNextPacketIndex < mNbReleasedPackets))
+    {
+        if(state.mNextPacketIndex >= mFirstPacketIndex)
+        {
+            const ODPacket& packet = mPackets[state.mNextPacketIndex - mFirstPacketIndex];
+            packet.appendToNetworkBuffer(state.mSendBuffer);
+            state.mSpoolOffset += RELAY_SPOOL_HEADER_BYTES + packet.getDataSize();
+            ++state.mNextPacketIndex;
+            continue;
+        }
+
+        // The packet is not in memory anymore. We read it from the spool file
+        ODPacket packet;
+        mSpoolInput.clear();
+        mSpoolInput.seekg(static_cast<std::streamoff>(state.mSpoolOffset));
+        if(packet.readPacket(mSpoolInput) == -1)
+        {
+            OD_LOG_ERR("Couldn't read packet " + Helper::toString(state.mNextPacketIndex) + " from relay spool file");
+            return false;
+        }
+        packet.appendToNetworkBuffer(state.mSendBuffer);
+        state.mSpoolOffset += RELAY_SPOOL_HEADER_BYTES + packet.getDataSize();
+        ++state.mNextPacketIndex;
+    }
+
+    return true;
+}
+
+void ODRelay::trimPackets()
+{
+    if(mSpoolFilename.empty())
+        return;
+
+    if((mPacketsBytes <= mMaxMemoryBytes) || (mFirstPacketIndex >= mNbReleasedPackets))
+        return;
+
+    // The packets removed from memory will be read from the spool file
+    mSpoolOutput.flush();
+    while((mPacketsBytes > mMaxMemoryBytes) && (mFirstPacketIndex < mNbReleasedPackets))
+    {
+        mPacketsBytes -= mPackets.front().getDataSize();
+        mPackets.pop_front();
+        mPacketsTime.pop_front();
+        ++mFirstPacketIndex;
+    }
+    mNbPacketsInMemory = static_cast<uint32_t>(mPackets.size());
+}
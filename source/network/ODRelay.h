@@ -0,0 +1,177 @@
+/*
+ *  Copyright (C) 2011-2016  OpenDungeons Team
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef ODRELAY_H
+#define ODRELAY_H
+
+#include "network/ODSocketServer.h"
+
+#include <SFML/System/Clock.hpp>
+
+#include <atomic>
+#include <cstdint>
+#include <deque>
+#include <fstream>
+#include <map>
+#include <string>
+#include <vector>
+
+//! \brief Relays a game to spectators. The relay connects to a server as a regular client (it has
+//! to be given a seat by the host like any other player) and receives the game stream once. Every
+//! packet received from the server is then sent to the spectators connected to the relay. For the
+//! spectators, the relay looks like a server: they can join with the usual multiplayer menu and
+//! watch the game from the relay seat point of view as if they were watching a replay. What the
+//! spectators send is ignored.
+//! Late spectators receive the whole stream when they connect so that they can catch up (the server
+//! only sends the level once and then the changes). The stream can be delayed so that spectators
+//! cannot give information to the players.
+//! To keep the memory bounded, the stream is also written in a spool file next to the replay and only
+//! the last packets are kept in memory. The spectators needing older packets read them from the spool file.
+//! The spectators sockets are not blocking: each spectator has its own send buffer and spectators not
+//! reading what is sent to them are dropped.
+//! The server only has one client to send the game to, whatever the number of spectators.
+class ODRelay : public ODSocketServer
+{
+public:
+    //! \brief nick is the name the relay uses on the server. clientVersion is the version sent
+    //! to the server in the hello message. The spectators receive the packets delayMs milliseconds
+    //! after the relay received them. Once sent to the spectators, the packets are kept in memory until
+    //! they use more than maxMemoryBytes
+    ODRelay(const std::string& nick, const std::string& clientVersion, uint32_t delayMs,
+        std::size_t maxMemoryBytes = 16 * 1024 * 1024);
+
+    ~ODRelay();
+
+    //! \brief Connects to the given server and starts listening for spectators on listeningPort.
+    //! The stream received from the server is also saved in the given replay file. If outputReplayFilename
+    //! is empty, there is no spool file and the whole stream is kept in memory
+    bool startRelay(const std::string& host, int32_t serverPort, int32_t listeningPort,
+        const std::string& outputReplayFilename);
+
+    void stopRelay();
+
+    //! \brief Returns true while the relay is connected to the server or has packets that are
+    //! not sent to the spectators yet
+    bool isRelaying() const
+    { return mIsRelaying; }
+
+    //! \brief Can be called from any thread
+    uint32_t getNbSpectators() const
+    { return mNbSpectators; }
+
+    //! \brief Can be called from any thread
+    uint32_t getNbPacketsInMemory() const
+    { return mNbPacketsInMemory; }
+
+protected:
+    ODSocketClient* notifyNewConnection(sf::TcpListener& sockListener) override;
+    bool notifyClientMessage(ODSocketClient* sock) override;
+    void serverThread() override;
+
+private:
+    //! \brief Connection with the server. It answers what the server expects from a client (level loaded,
+    //! nick, turn acknowledgements) and gives every packet to the relay
+    class Upstream : public ODSocketClient
+    {
+    public:
+        Upstream(ODRelay& relay) :
+            mRelay(relay)
+        {}
+
+        bool connectToServer(const std::string& host, int32_t port, const std::string& outputReplayFilename);
+
+    protected:
+        bool processMessage(ServerNotificationType cmd, ODPacket& packetReceived) override;
+        void playerDisconnected() override;
+
+    private:
+        ODRelay& mRelay;
+    };
+
+    struct SpectatorState
+    {
+        SpectatorState(int32_t time) :
+            mNextPacketIndex(0),
+            mSpoolOffset(0),
+            mSendOffset(0),
+            mLastSendTime(time)
+        {}
+
+        //! \brief Index in the stream of the next packet to put in mSendBuffer
+        uint32_t mNextPacketIndex;
+
+        //! \brief Offset of the packet mNextPacketIndex in the spool file
+        uint64_t mSpoolOffset;
+
+        //! \brief Packets waiting to be sent in the network format. The bytes before mSendOffset are sent
+        std::vector<char> mSendBuffer;
+        std::size_t mSendOffset;
+
+        //! \brief Last time (in ms since the relay started) some bytes could be sent or nothing was waiting
+        int32_t mLastSendTime;
+    };
+
+    //! \brief Adds a packet received from the server to the stream
+    void addPacket(const ODPacket& packet);
+
+    //! \brief Sends to the spectators the packets for which the delay is over. Drops the spectators not
+    //! reading the stream. Returns true if every spectator received every released packet
+    bool sendReleasedPackets();
+
+    //! \brief Fills the send buffer of the given spectator with the next released packets. Returns false
+    //! if a packet could not be read from the spool file
+    bool fillSendBuffer(SpectatorState& state);
+
+    //! \brief Removes the oldest released packets from memory while they use more than mMaxMemoryBytes
+    void trimPackets();
+
+    const std::string mNick;
+    const std::string mClientVersion;
+    const uint32_t mDelayMs;
+    const std::size_t mMaxMemoryBytes;
+
+    Upstream mUpstream;
+
+    //! \brief The last packets received from the server and the time they were received (in ms since the
+    //! relay started). mPackets[0] is the packet mFirstPacketIndex in the stream. Only accessed from the relay thread
+    std::deque<ODPacket> mPackets;
+    std::deque<int32_t> mPacketsTime;
+    uint32_t mFirstPacketIndex;
+    std::size_t mPacketsBytes;
+
+    //! \brief Number of packets in the stream for which the delay is over
+    uint32_t mNbReleasedPackets;
+
+    //! \brief The whole stream is written in the spool file (with the replay format). The packets not in
+    //! mPackets anymore are read from it. Only used if mSpoolFilename is not empty
+    std::string mSpoolFilename;
+    std::ofstream mSpoolOutput;
+    std::ifstream mSpoolInput;
+
+    std::map<ODSocketClient*, SpectatorState> mSpectators;
+
+    sf::Clock mClock;
+
+    //! \brief Set when the server disconnects. Only accessed from the relay thread
+    bool mIsServerDisconnected;
+
+    std::atomic<bool> mIsRelaying;
+    std::atomic<uint32_t> mNbSpectators;
+    std::atomic<uint32_t> mNbPacketsInMemory;
+};
+
+#endif // ODRELAY_H
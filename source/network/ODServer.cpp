@@ -31,6 +31,7 @@
 #include "game/Seat.h"
 #include "gamemap/GameMap.h"
 #include "gamemap/MapHandler.h"
+#include "gamemap/SaveGameSnapshot.h"
 #include "modes/ConsoleCommands.h"
 #include "network/ODClient.h"
 #include "network/ServerMode.h"
@@ -46,6 +47,7 @@
 #include "utils/Helper.h"
 #include "utils/LogManager.h"
 #include "utils/MasterServer.h"
+#include "utils/Random.h"
 #include "utils/ResourceManager.h"
 #include "ODApplication.h"
 
@@ -60,6 +62,7 @@
 
 const std::string SAVEGAME_SKIRMISH_PREFIX = "SK-";
 const std::string SAVEGAME_MULTIPLAYER_PREFIX = "MP-";
+const std::string AUTOSAVE_PREFIX = "Autosave-";
 static const double MASTER_SERVER_UPDATE_PERIOD_MS = 30000.0;
 static const int32_t MASTER_SERVER_STATUS_PENDING = 0;
 static const int32_t MASTER_SERVER_STATUS_STARTED = 1;
@@ -74,14 +77,21 @@ ODServer::ODServer() :
     mGameMap(new GameMap(true)),
     mSeatsConfigured(false),
     mPlayerConfig(nullptr),
+    mServerThreadId(std::thread::id()),
+    mExitRequested(false),
+    mNbPendingNotifications(0),
+    mPendingNotificationsBytes(0),
+    mLastMemoryReportTurn(-1),
     mConsoleInterface(std::bind(&ODServer::printConsoleMsg, this, std::placeholders::_1)),
-    mMasterServerGameStatusUpdateTime(0)
+    mMasterServerGameStatusUpdateTime(0),
+    mIsAutosaving(false)
 {
     ConsoleCommands::addConsoleCommands(mConsoleInterface);
 }
 
 ODServer::~ODServer()
 {
+    clearNotificationQueues();
     delete mGameMap;
 }
 
@@ -94,6 +104,9 @@ bool ODServer::startServer(const std::string& creator, const std::string& levelF
     mMasterServerGameId.clear();
     mMasterServerGameStatusUpdateTime = 0.0;
     mPlayerConfig = nullptr;
+    mExitRequested = false;
+    mLastMemoryReport = MemoryReport();
+    mLastMemoryReportTurn = -1;
 
     // Start the server socket listener as well as the server socket thread
     if (isConnected())
@@ -123,6 +136,13 @@ bool ODServer::startServer(const std::string& creator, const std::string& levelF
         return false;
     }
 
+    // Savegames come with the seed to continue the game. Otherwise, we start a new sequence
+    uint64_t gameSeed = gameMap->getGameSeed();
+    if(gameSeed == 0)
+        gameSeed = Random::generateGameSeed();
+    Random::setGameSeed(gameSeed);
+    OD_LOG_INF("Game seed: " + Helper::toString(gameSeed));
+
     // Set up the socket to listen on the specified port
     int32_t port = getNetworkPort();
     if (!createServer(port))
@@ -239,12 +259,25 @@ void ODServer::queueServerNotification(ServerNotification* n)
         delete n;
         return;
     }
-    mServerNotificationQueue.push_back(n);
+    notificationQueued(*n);
+    mServerNotificationQueue.push(n);
 }
 
 void ODServer::sendAsyncMsg(ServerNotification& notif)
 {
-    sendMsg(notif.mConcernedPlayer, notif.mPacket);
+    if(std::this_thread::get_id() == mServerThreadId.load())
+    {
+        sendMsg(notif.mConcernedPlayer, notif.mPacket);
+        return;
+    }
+
+    // The sockets can only be used by the server thread. We keep a copy of the message
+    // that will be sent at the next server thread iteration
+    if(!isConnected())
+        return;
+
+    notificationQueued(notif);
+    mAsyncNotificationQueue.push(new ServerNotification(notif));
 }
 
 void ODServer::sendMsg(Player* player, ODPacket& packet)
@@ -306,6 +339,8 @@ void ODServer::startNewTurn(double timeSinceLastTurn)
     GameMap* gameMap = mGameMap;
     int64_t turn = gameMap->getTurnNumber();
 
+    checkSaveGameFinished();
+
     // We wait until every client acknowledge the turn to start the next one. This way, we ensure
     // synchronisation is not too bad
     for (ODSocketClient* client : mSockClients)
@@ -373,6 +408,17 @@ void ODServer::startNewTurn(double timeSinceLastTurn)
         {
             gameMap->doTurn(timeSinceLastTurn);
             gameMap->doPlayerAITurn(timeSinceLastTurn);
+
+            uint32_t autosavePeriod = ConfigManager::getSingleton().getAutosavePeriodTurns();
+            if((autosavePeriod > 0) && (turn > 0) && ((turn % autosavePeriod) == 0))
+            {
+                const boost::filesystem::path levelPath(gameMap->getLevelFileName());
+                std::string fileLevel = levelPath.filename().string();
+                std::string savePath = ResourceManager::getSingleton().getSaveGamePath()
+                    + AUTOSAVE_PREFIX + getSaveGameLevelName(fileLevel);
+                if(!startSavingGame(savePath, true))
+                    OD_LOG_WRN("Autosave skipped because a save is already in progress");
+            }
             break;
         }
         case ServerMode::ModeEditor:
@@ -388,6 +434,162 @@ void ODServer::startNewTurn(double timeSinceLastTurn)
 
     gameMap->fireRefreshEntities();
     gameMap->processDeletionQueues();
+
+    logMemoryReport(turn);
+
+    // The lists allocated during the turn are not used anymore
+    gameMap->resetTurnArena();
+}
+
+void ODServer::fillMemoryReport(MemoryReport& report) const
+{
+    mGameMap->fillMemoryReport(report);
+    report.add("serverNotifications", mPendingNotificationsBytes.load());
+}
+
+std::vector<std::string> ODServer::getMemoryReportLines() const
+{
+    MemoryReport report;
+    fillMemoryReport(report);
+
+    std::vector<std::string> lines;
+    lines.push_back("Pending notifications: " + Helper::toString(mNbPendingNotifications.load()));
+    std::vector<std::string> reportLines;
+    if(mLastMemoryReportTurn < 0)
+        reportLines = report.toLines(nullptr, 0.0);
+    else
+    {
+        double elapsed = static_cast<double>(mGameMap->getTurnNumber() - mLastMemoryReportTurn) / ODApplication::turnsPerSecond;
+        reportLines = report.toLines(&mLastMemoryReport, elapsed);
+    }
+    lines.insert(lines.end(), reportLines.begin(), reportLines.end());
+    return lines;
+}
+
+void ODServer::logMemoryReport(int64_t turn)
+{
+    uint32_t period = ConfigManager::getSingleton().getMemoryReportPeriod();
+    if((period == 0) || (turn <= 0) || ((turn % period) != 0))
+        return;
+
+    MemoryReport report;
+    fillMemoryReport(report);
+    if(mLastMemoryReportTurn < 0)
+        OD_LOG_INF("Memory report: " + report.toString(nullptr, 0.0));
+    else
+    {
+        double elapsed = static_cast<double>(turn - mLastMemoryReportTurn) / ODApplication::turnsPerSecond;
+        OD_LOG_INF("Memory report: " + report.toString(&mLastMemoryReport, elapsed));
+    }
+
+    mLastMemoryReport = report;
+    mLastMemoryReportTurn = turn;
+}
+
+std::string ODServer::getSaveGameLevelName(const std::string& fileLevel) const
+{
+    std::ostringstream ss;
+    switch(mServerMode)
+    {
+        case ServerMode::ModeGameSinglePlayer:
+            ss << SAVEGAME_SKIRMISH_PREFIX;
+            ss << fileLevel;
+            break;
+        case ServerMode::ModeGameMultiPlayer:
+            ss << SAVEGAME_MULTIPLAYER_PREFIX;
+            ss << fileLevel;
+            break;
+        case ServerMode::ModeGameLoaded:
+        {
+            // We look for the Skirmish or multiplayer prefix and keep it.
+            size_t indexSk = fileLevel.find(SAVEGAME_SKIRMISH_PREFIX);
+            size_t indexMp = fileLevel.find(SAVEGAME_MULTIPLAYER_PREFIX);
+            if((indexSk != std::string::npos) && (indexMp == std::string::npos))
+            {
+                // Skirmish savegame
+                ss << SAVEGAME_SKIRMISH_PREFIX;
+                ss << fileLevel.substr(indexSk + SAVEGAME_SKIRMISH_PREFIX.length());
+
+            }
+            else if((indexSk == std::string::npos) && (indexMp != std::string::npos))
+            {
+                // Multiplayer savegame
+                ss << SAVEGAME_MULTIPLAYER_PREFIX;
+                ss << fileLevel.substr(indexMp + SAVEGAME_MULTIPLAYER_PREFIX.length());
+            }
+            else if((indexSk != std::string::npos) && (indexMp != std::string::npos))
+            {
+                // We found both prefixes. That can happen if the name contains the other
+                // prefix. Because of filename construction, we know that the lowest is the good
+                if(indexSk < indexMp)
+                {
+                    ss << SAVEGAME_SKIRMISH_PREFIX;
+                    ss << fileLevel.substr(indexSk + SAVEGAME_SKIRMISH_PREFIX.length());
+                }
+                else
+                {
+                    ss << SAVEGAME_MULTIPLAYER_PREFIX;
+                    ss << fileLevel.substr(indexMp + SAVEGAME_MULTIPLAYER_PREFIX.length());
+                }
+            }
+            else
+            {
+                // We couldn't find any prefix. That's not normal
+                OD_LOG_ERR("fileLevel=" + fileLevel);
+                ss << fileLevel;
+            }
+            break;
+        }
+        default:
+            OD_LOG_ERR("mode=" + Helper::toString(static_cast<int>(mServerMode)));
+            ss << fileLevel;
+            break;
+    }
+    return ss.str();
+}
+
+bool ODServer::startSavingGame(const std::string& fileName, bool isAutosave)
+{
+    if(mSaveGameWriter.isWriting())
+        return false;
+
+    // We copy the gamemap state now, between 2 turns. Formatting and writing the file will be done
+    // by the savegame writer thread
+    std::unique_ptr<SaveGameSnapshot> snapshot(new SaveGameSnapshot);
+    snapshot->capture(*mGameMap);
+    if(!mSaveGameWriter.startWriting(fileName, std::move(snapshot)))
+        return false;
+
+    mIsAutosaving = isAutosave;
+    return true;
+}
+
+void ODServer::checkSaveGameFinished()
+{
+    std::string fileName;
+    bool success;
+    if(!mSaveGameWriter.popFinishedSave(fileName, success))
+        return;
+
+    // Autosaves are not requested by the players. We do not bother them with it
+    if(mIsAutosaving)
+    {
+        if(success)
+            OD_LOG_INF("Autosave written in " + fileName);
+        else
+            OD_LOG_WRN("Autosave failed for " + fileName);
+        return;
+    }
+
+    std::string msg = "Map saved successfully as: " + fileName;
+    if (!success)
+    {
+        msg = "Couldn't not save map file as: " + fileName + "\nPlease check logs.";
+    }
+    // We notify all the players that the game was saved
+    ServerNotification notif(ServerNotificationType::chatServer, nullptr);
+    notif.mPacket << msg << EventShortNoticeType::genericGameInfo;
+    sendAsyncMsg(notif);
 }
 
 void ODServer::serverThread()
@@ -396,11 +598,13 @@ void ODServer::serverThread()
     sf::Clock clock;
     double turnLengthMs = 1000.0 / ODApplication::turnsPerSecond;
     bool isClientConnected = true;
+    mServerThreadId = std::this_thread::get_id();
     while(isConnected() && isClientConnected)
     {
         // doTask should return after the length of 1 turn even if their are communications. When
         // it returns, we can launch next turn.
         doTask(static_cast<int32_t>(turnLengthMs));
+        processAsyncNotifications();
         // If all the clients are disconnected during a game, we close the server
         if((mServerState == ServerState::StateGame) &&
            (mSockClients.empty()))
@@ -482,8 +686,8 @@ void ODServer::serverThread()
                     if(seat->getPlayer() == nullptr)
                         continue;
 
-                    if(seat->getGold() > 0)
-                        gameMap->addGoldToSeat(seat->getGold(), seat->getId());
+                    if(seat->getStartingGold() > 0)
+                        gameMap->addGoldToSeat(seat->getStartingGold(), seat->getId());
                 }
             }
             else
@@ -520,6 +724,8 @@ void ODServer::serverThread()
         mMasterServerGameStatusUpdateTime = 0.0;
         MasterServer::updateGame(mMasterServerGameId, MASTER_SERVER_STATUS_FINISHED);
     }
+
+    mServerThreadId = std::thread::id();
 }
 
 void ODServer::processServerNotifications()
@@ -527,23 +733,28 @@ void ODServer::processServerNotifications()
     GameMap* gameMap = mGameMap;
 
     bool running = true;
+    ServerNotification* event = nullptr;
 
-    while (running)
+    // Take the messages out of the front of the notification queue until it is empty
+    while (running && mServerNotificationQueue.pop(event))
     {
-        // If the queue is empty, let's get out of the loop.
-        if (mServerNotificationQueue.empty())
-            break;
-
-        // Take a message out of the front of the notification queue
-        ServerNotification *event = mServerNotificationQueue.front();
-        mServerNotificationQueue.pop_front();
-
         if(event == nullptr)
         {
             OD_LOG_ERR("unexpected null event");
             continue;
         }
 
+        // If we are exiting, the only message we care about is the exit one
+        if(mExitRequested && (event->mType != ServerNotificationType::exit))
+        {
+            notificationPopped(*event);
+            delete event;
+            event = nullptr;
+            continue;
+        }
+
+        notificationPopped(*event);
+
         OD_LOG_DBG("processServerNotifications type=" + ServerNotification::typeString(event->mType));
         switch (event->mType)
         {
@@ -586,6 +797,44 @@ void ODServer::processServerNotifications()
     }
 }
 
+void ODServer::processAsyncNotifications()
+{
+    ServerNotification* notif = nullptr;
+    while(mAsyncNotificationQueue.pop(notif))
+    {
+        notificationPopped(*notif);
+        if(!mExitRequested)
+            sendMsg(notif->mConcernedPlayer, notif->mPacket);
+
+        delete notif;
+    }
+}
+
+void ODServer::clearNotificationQueues()
+{
+    ServerNotification* notif = nullptr;
+    while(mServerNotificationQueue.pop(notif))
+        delete notif;
+
+    while(mAsyncNotificationQueue.pop(notif))
+        delete notif;
+
+    mNbPendingNotifications = 0;
+    mPendingNotificationsBytes = 0;
+}
+
+void ODServer::notificationQueued(const ServerNotification& notif)
+{
+    ++mNbPendingNotifications;
+    mPendingNotificationsBytes += sizeof(ServerNotification) + notif.mPacket.getDataSize();
+}
+
+void ODServer::notificationPopped(const ServerNotification& notif)
+{
+    --mNbPendingNotifications;
+    mPendingNotificationsBytes -= sizeof(ServerNotification) + notif.mPacket.getDataSize();
+}
+
 bool ODServer::processClientNotifications(ODSocketClient* clientSocket)
 {
     if (!clientSocket)
@@ -1332,8 +1581,7 @@ bool ODServer::processClientNotifications(ODSocketClient* clientSocket)
             if(player->getHasLost())
                 break;
 
-            std::vector<Room*> rooms = gameMap->getRoomsByTypeAndSeat(RoomType::workshop, player->getSeat());
-            if(!rooms.empty())
+            if(!gameMap->getRoomsByTypeAndSeat(RoomType::workshop, player->getSeat()).empty())
                 break;
 
             ServerNotification *serverNotification = new ServerNotification(
@@ -1492,79 +1740,19 @@ bool ODServer::processClientNotifications(ODSocketClient* clientSocket)
                 std::ostringstream ss;
                 ss.imbue(loc);
                 ss << boost::posix_time::second_clock::local_time() << "-";
-                switch(mServerMode)
-                {
-                    case ServerMode::ModeGameSinglePlayer:
-                        ss << SAVEGAME_SKIRMISH_PREFIX;
-                        ss << fileLevel;
-                        break;
-                    case ServerMode::ModeGameMultiPlayer:
-                        ss << SAVEGAME_MULTIPLAYER_PREFIX;
-                        ss << fileLevel;
-                        break;
-                    case ServerMode::ModeGameLoaded:
-                    {
-                        // We look for the Skirmish or multiplayer prefix and keep it.
-                        size_t indexSk = fileLevel.find(SAVEGAME_SKIRMISH_PREFIX);
-                        size_t indexMp = fileLevel.find(SAVEGAME_MULTIPLAYER_PREFIX);
-                        if((indexSk != std::string::npos) && (indexMp == std::string::npos))
-                        {
-                            // Skirmish savegame
-                            ss << SAVEGAME_SKIRMISH_PREFIX;
-                            ss << fileLevel.substr(indexSk + SAVEGAME_SKIRMISH_PREFIX.length());
-
-                        }
-                        else if((indexSk == std::string::npos) && (indexMp != std::string::npos))
-                        {
-                            // Multiplayer savegame
-                            ss << SAVEGAME_MULTIPLAYER_PREFIX;
-                            ss << fileLevel.substr(indexMp + SAVEGAME_MULTIPLAYER_PREFIX.length());
-                        }
-                        else if((indexSk != std::string::npos) && (indexMp != std::string::npos))
-                        {
-                            // We found both prefixes. That can happen if the name contains the other
-                            // prefix. Because of filename construction, we know that the lowest is the good
-                            if(indexSk < indexMp)
-                            {
-                                ss << SAVEGAME_SKIRMISH_PREFIX;
-                                ss << fileLevel.substr(indexSk + SAVEGAME_SKIRMISH_PREFIX.length());
-                            }
-                            else
-                            {
-                                ss << SAVEGAME_MULTIPLAYER_PREFIX;
-                                ss << fileLevel.substr(indexMp + SAVEGAME_MULTIPLAYER_PREFIX.length());
-                            }
-                        }
-                        else
-                        {
-                            // We couldn't find any prefix. That's not normal
-                            OD_LOG_ERR("fileLevel=" + fileLevel);
-                            ss << fileLevel;
-                        }
-                        break;
-                    }
-                    default:
-                        OD_LOG_ERR("mode=" + Helper::toString(static_cast<int>(mServerMode)));
-                        ss << fileLevel;
-                        break;
-                }
+                ss << getSaveGameLevelName(fileLevel);
                 std::string savePath = ResourceManager::getSingleton().getSaveGamePath() + ss.str();
                 levelSave = boost::filesystem::path(savePath);
             }
 
-            // If the file exists, we make a backup
-            if (boost::filesystem::exists(levelSave))
-                boost::filesystem::rename(levelSave, levelSave.string() + ".bak");
-
-            std::string msg = "Map saved successfully as: " + levelSave.string();
-            if (!MapHandler::writeGameMapToFile(levelSave.string(), *gameMap))
+            // The file is written by the savegame writer. The players will be notified once it is done
+            if(!startSavingGame(levelSave.string()))
             {
-                msg = "Couldn't not save map file as: " + levelSave.string() + "\nPlease check logs.";
+                std::string msg = "Map could not be saved because a save is already in progress";
+                ServerNotification notif(ServerNotificationType::chatServer, player);
+                notif.mPacket << msg << EventShortNoticeType::genericGameInfo;
+                sendAsyncMsg(notif);
             }
-            // We notify all the players that the game was saved successfully
-            ServerNotification notif(ServerNotificationType::chatServer, nullptr);
-            notif.mPacket << msg << EventShortNoticeType::genericGameInfo;
-            sendAsyncMsg(notif);
             break;
         }
 
@@ -1912,21 +2100,15 @@ void ODServer::stopServer()
     mPlayerConfig = nullptr;
 
     // Now that the server is stopped, we can remove all pending messages
-    while(!mServerNotificationQueue.empty())
-    {
-        delete mServerNotificationQueue.front();
-        mServerNotificationQueue.pop_front();
-    }
+    clearNotificationQueues();
     mGameMap->clearAll();
 }
 
 void ODServer::notifyExit()
 {
-    while(!mServerNotificationQueue.empty())
-    {
-        delete mServerNotificationQueue.front();
-        mServerNotificationQueue.pop_front();
-    }
+    // The queue can only be consumed by the server thread. The pending notifications
+    // will be dropped when it processes them
+    mExitRequested = true;
 
     ServerNotification* exitServerNotification = new ServerNotification(
         ServerNotificationType::exit, nullptr);
@@ -19,10 +19,16 @@
 #define ODSERVER_H
 
 #include "ODSocketServer.h"
+#include "gamemap/SaveGameWriter.h"
 #include "modes/ConsoleInterface.h"
+#include "utils/MemoryReport.h"
+#include "utils/MPSCQueue.h"
 
 #include <OgreSingleton.h>
 
+#include <atomic>
+#include <thread>
+
 class ServerNotification;
 class GameMap;
 
@@ -77,13 +83,15 @@ class ODServer: public Ogre::Singleton<ODServer>,
     bool startServer(const std::string& creator, const std::string& levelFilename, ServerMode mode, bool useMasterServer);
     void stopServer() override;
 
-    //! \brief Adds a server notification to the server notification queue. The message will be sent to the concerned player
+    //! \brief Adds a server notification to the server notification queue. The message will be sent to the concerned player.
+    //! This function can be called from any thread. Notifications queued by a given thread are sent in the order they were queued
     void queueServerNotification(ServerNotification* n);
 
     //! \brief Sends an asynchronous message to the concerned player. This function should be used really carefully as it can easily
     //! make the game crash by sending messages in an unexpected order (changing the state of an entity that was not created, for example).
     //! In most of the can, we will use it for messages that do not need synchronization with the game (example : chat) or
     //! for messages that need to show reactivity (after a player does something like building a room or tried to pickup a creature).
+    //! When called from another thread than the server one, the message is copied and sent by the server thread at its next iteration.
     void sendAsyncMsg(ServerNotification& notif);
 
     void notifyExit();
@@ -95,6 +103,13 @@ class ODServer: public Ogre::Singleton<ODServer>,
 
     int32_t getNetworkPort() const;
 
+    //! \brief Adds the memory used by the gamemap and the pending notifications to the given report
+    void fillMemoryReport(MemoryReport& report) const;
+
+    //! \brief Returns the current memory report (one line per subsystem) with the growth rates since
+    //! the last periodic report. Should be called from the server thread
+    std::vector<std::string> getMemoryReportLines() const;
+
 protected:
     ODSocketClient* notifyNewConnection(sf::TcpListener& sockListener) override;
     bool notifyClientMessage(ODSocketClient *sock) override;
@@ -110,7 +125,27 @@ private:
     Player* mPlayerConfig;
     std::vector<Player*> mDisconnectedPlayers;
 
-    std::deque<ServerNotification*> mServerNotificationQueue;
+    //! \brief Notifications to process at the end of the turn. Filled from any thread, consumed by the server thread
+    MPSCQueue<ServerNotification*> mServerNotificationQueue;
+
+    //! \brief Asynchronous messages sent from another thread than the server one. They are sent as soon as
+    //! the server thread gets them
+    MPSCQueue<ServerNotification*> mAsyncNotificationQueue;
+
+    //! \brief Id of the thread running serverThread. Used to know if asynchronous messages can be sent directly
+    std::atomic<std::thread::id> mServerThreadId;
+
+    //! \brief Set by notifyExit. Pending notifications are then dropped until the exit one is processed
+    std::atomic<bool> mExitRequested;
+
+    //! \brief Number and size (in bytes) of the notifications waiting in mServerNotificationQueue
+    //! and mAsyncNotificationQueue. Updated when a notification is queued or popped
+    std::atomic<uint32_t> mNbPendingNotifications;
+    std::atomic<std::size_t> mPendingNotificationsBytes;
+
+    //! \brief Last memory report written in the log and the turn it was done (-1 if none)
+    MemoryReport mLastMemoryReport;
+    int64_t mLastMemoryReportTurn;
 
     std::map<ODSocketClient*, std::vector<std::string>> mCreaturesInfoWanted;
 
@@ -119,6 +154,12 @@ private:
     std::string mMasterServerGameId;
     double mMasterServerGameStatusUpdateTime;
 
+    //! \brief Writes the savegames without blocking the server thread
+    SaveGameWriter mSaveGameWriter;
+
+    //! \brief True if the save in progress (or the last one) is an autosave
+    bool mIsAutosaving;
+
     void printConsoleMsg(const std::string& text);
 
     ODSocketClient* getClientFromPlayer(Player* player);
@@ -127,6 +168,17 @@ private:
     //! \brief Called when a new turn started.
     void startNewTurn(double timeSinceLastTurn);
 
+    //! \brief Returns the savegame name (without the date) for the given level file name. It starts with
+    //! the skirmish or multiplayer prefix depending on the current game
+    std::string getSaveGameLevelName(const std::string& fileLevel) const;
+
+    //! \brief Copies the server gamemap state and starts writing it in the given file on the
+    //! savegame writer thread. Returns false if a save is already in progress
+    bool startSavingGame(const std::string& fileName, bool isAutosave = false);
+
+    //! \brief Notifies the players if a savegame has been written since the last call
+    void checkSaveGameFinished();
+
     /*! \brief Monitors mServerNotificationQueue for new events and informs the clients about them.
      *
      * This function is used in server mode and acts as a "consumer" on
@@ -136,6 +188,19 @@ private:
      */
     void processServerNotifications();
 
+    //! \brief Sends the asynchronous messages queued from other threads than the server one
+    void processAsyncNotifications();
+
+    //! \brief Deletes every pending notification. Should only be called when the server thread is not running
+    void clearNotificationQueues();
+
+    //! \brief Updates the pending notifications counters when the given notification is queued or popped
+    void notificationQueued(const ServerNotification& notif);
+    void notificationPopped(const ServerNotification& notif);
+
+    //! \brief Writes the memory report in the log if the configured number of turns has elapsed
+    void logMemoryReport(int64_t turn);
+
     /*! \brief The function running in server-mode which listens for messages from an individual, already connected, client.
      *
      * This function receives TCP packets one at a time from a connected client,
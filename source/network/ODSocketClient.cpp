@@ -25,6 +25,30 @@
 #include <boost/date_time/posix_time/posix_time.hpp>
 #include <boost/filesystem.hpp>
 
+//! \brief Max number of packets received but not processed yet. If the main thread is
+//! late by that many packets, the receive thread waits for it to catch up
+static const uint32_t RECEIVED_PACKETS_CAPACITY = 4096;
+
+//! \brief Max time the receive thread waits for data before checking if it should stop
+static const int32_t RECEIVE_THREAD_WAIT_MS = 50;
+
+ODSocketClient::ODSocketClient():
+    mSource(ODSource::none),
+    mPlayer(nullptr),
+    mLastTurnAck(-1),
+    mPendingTimestamp(-1),
+    mReceiveThread(nullptr),
+    mReceivedPackets(RECEIVED_PACKETS_CAPACITY),
+    mIsReceiveThreadRunning(false),
+    mIsServerDisconnected(false)
+{
+}
+
+ODSocketClient::~ODSocketClient()
+{
+    stopReceiveThread();
+}
+
 bool ODSocketClient::connect(const std::string& host, const int port, uint32_t timeout, const std::string& outputReplayFilename)
 {
     mSource = ODSource::none;
@@ -46,6 +70,12 @@ bool ODSocketClient::connect(const std::string& host, const int port, uint32_t t
     mReplayOutputStream.open(mOutputReplayFilename, std::ios::out | std::ios::binary);
     mGameClock.restart();
     mSource = ODSource::network;
+
+    // From now on, the socket will only be read from the receive thread
+    mIsServerDisconnected = false;
+    mIsReceiveThreadRunning = true;
+    mReceiveThread = new sf::Thread(&ODSocketClient::receiveThread, this);
+    mReceiveThread->launch();
     return true;
 }
 
@@ -72,6 +102,10 @@ void ODSocketClient::disconnect(bool keepReplay)
         }
         case ODSource::network:
         {
+            // The receive thread uses the socket and the replay stream. We stop it first
+            stopReceiveThread();
+            mReceivedPackets.clear();
+            mIsServerDisconnected = false;
             // Remove any remaining client sockets from the socket selector,
             // if there is any left.
             mSockSelector.clear();
@@ -149,6 +183,32 @@ ODSocketClient::ODComStatus ODSocketClient::send(ODPacket& s)
     return ODComStatus::Error;
 }
 
+ODSocketClient::ODComStatus ODSocketClient::sendRaw(const char* data, std::size_t size, std::size_t& sent)
+{
+    sent = 0;
+    if(mSource != ODSource::network)
+    {
+        sent = size;
+        return ODComStatus::OK;
+    }
+
+    sf::Socket::Status status = mSockClient.send(data, size, sent);
+    switch(status)
+    {
+        case sf::Socket::Done:
+        case sf::Socket::Partial:
+            return ODComStatus::OK;
+        case sf::Socket::NotReady:
+            return (sent > 0) ? ODComStatus::OK : ODComStatus::NotReady;
+        default:
+            break;
+    }
+
+    OD_LOG_ERR("Could not send data from client status="
+        + Helper::toString(status));
+    return ODComStatus::Error;
+}
+
 ODSocketClient::ODComStatus ODSocketClient::recv(ODPacket& s)
 {
     switch(mSource)
@@ -211,17 +271,31 @@ void ODSocketClient::processClientSocketMessages()
 
 bool ODSocketClient::processOneClientSocketMessage()
 {
-    if(!isDataAvailable())
-        return false;
-
     ODPacket packetReceived;
+    if(mReceiveThread != nullptr)
+    {
+        // We never wait here. Packets are received by the receive thread
+        if(!mReceivedPackets.pop(packetReceived))
+        {
+            // We only notify the disconnection once every packet received before is processed
+            if(mIsServerDisconnected.exchange(false))
+                playerDisconnected();
 
-    // Check if data available
-    ODComStatus comStatus = recv(packetReceived);
-    if(comStatus != ODComStatus::OK)
+            return false;
+        }
+    }
+    else
     {
-        playerDisconnected();
-        return false;
+        if(!isDataAvailable())
+            return false;
+
+        // Check if data available
+        ODComStatus comStatus = recv(packetReceived);
+        if(comStatus != ODComStatus::OK)
+        {
+            playerDisconnected();
+            return false;
+        }
     }
 
     ServerNotificationType serverCommand;
@@ -229,3 +303,41 @@ bool ODSocketClient::processOneClientSocketMessage()
 
     return processMessage(serverCommand, packetReceived);
 }
+
+void ODSocketClient::receiveThread()
+{
+    sf::SocketSelector selector;
+    selector.add(mSockClient);
+    while(mIsReceiveThreadRunning)
+    {
+        if(!selector.wait(sf::milliseconds(RECEIVE_THREAD_WAIT_MS)))
+            continue;
+
+        ODPacket packet;
+        ODComStatus comStatus = recv(packet);
+        if(comStatus != ODComStatus::OK)
+        {
+            mIsServerDisconnected = true;
+            break;
+        }
+
+        // If the main thread is late, we wait for it to process the pending packets
+        while(!mReceivedPackets.push(packet))
+        {
+            if(!mIsReceiveThreadRunning)
+                return;
+
+            sf::sleep(sf::milliseconds(1));
+        }
+    }
+}
+
+void ODSocketClient::stopReceiveThread()
+{
+    if(mReceiveThread == nullptr)
+        return;
+
+    mIsReceiveThreadRunning = false;
+    delete mReceiveThread; // Delete waits for the thread to finish
+    mReceiveThread = nullptr;
+}
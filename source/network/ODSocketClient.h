@@ -19,9 +19,11 @@
 #define ODSOCKETCLIENT_H
 
 #include "network/ODPacket.h"
+#include "utils/SPSCQueue.h"
 
 #include <SFML/Network.hpp>
 
+#include <atomic>
 #include <string>
 #include <cstdint>
 #include <fstream>
@@ -45,15 +47,9 @@ class ODSocketClient
             file
         };
 
-        ODSocketClient():
-            mSource(ODSource::none),
-            mPlayer(nullptr),
-            mLastTurnAck(-1),
-            mPendingTimestamp(-1)
-        {}
+        ODSocketClient();
 
-        virtual ~ODSocketClient()
-        {}
+        virtual ~ODSocketClient();
 
         // Client initialization
         bool isConnected();
@@ -61,7 +57,9 @@ class ODSocketClient
         //! \brief Disconnect the client and tell whether to keep the replay file.
         virtual void disconnect(bool keepReplay = false);
 
-        /*! \brief This function should be called periodically. It will
+        /*! \brief This function should be called periodically. It will process the messages
+         * received since the last call. When connected to a server, the messages are received by
+         * a dedicated thread so this function never waits for the network.
          */
         void processClientSocketMessages();
 
@@ -90,6 +88,12 @@ class ODSocketClient
          */
         ODComStatus send(ODPacket& s);
 
+        /*! \brief Sends as many bytes from data as the socket accepts without blocking and sets sent
+         * to their number. The socket should be in non blocking mode. The bytes should come from
+         * ODPacket::appendToNetworkBuffer. Returns NotReady if nothing could be sent.
+         */
+        ODComStatus sendRaw(const char* data, std::size_t size, std::size_t& sent);
+
         /*! \brief Receives a packet through the network
          * ODPacket should preserve integrity. That means that if an ODSocketClient
          * sends an ODPacket, the server should receive exactly 1 similar ODPacket (same data,
@@ -111,6 +115,13 @@ class ODSocketClient
     private :
         bool processOneClientSocketMessage();
 
+        //! \brief Receives the packets from the server while mIsReceiveThreadRunning is true. The received
+        //! packets are written in the replay file and pushed in mReceivedPackets
+        void receiveThread();
+
+        //! \brief Stops the receive thread (if running) and waits for it to finish
+        void stopReceiveThread();
+
         ODSource mSource;
         sf::SocketSelector mSockSelector;
         sf::TcpSocket mSockClient;
@@ -127,6 +138,19 @@ class ODSocketClient
         //! \brief the replay filename being written. Used to later optionally delete it
         //! if asked to.
         std::string mOutputReplayFilename;
+
+        //! \brief Thread receiving the packets when connected to a server (see receiveThread)
+        sf::Thread* mReceiveThread;
+
+        //! \brief Packets received by mReceiveThread not processed yet. Filled by the receive thread
+        //! and consumed by processClientSocketMessages
+        SPSCQueue<ODPacket> mReceivedPackets;
+
+        std::atomic<bool> mIsReceiveThreadRunning;
+
+        //! \brief Set by the receive thread when the connection with the server is lost. The
+        //! disconnection is notified once the packets received before are processed
+        std::atomic<bool> mIsServerDisconnected;
 };
 
 #endif // ODSOCKETCLIENT_H
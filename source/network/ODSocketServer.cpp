@@ -24,6 +24,8 @@
 
 #include <SFML/System.hpp>
 
+#include <algorithm>
+
 ODSocketServer::ODSocketServer():
     mThread(nullptr),
     mIsConnected(false)
@@ -124,6 +126,21 @@ void ODSocketServer::doTask(int timeoutMs)
     }
 }
 
+void ODSocketServer::removeClient(ODSocketClient* client)
+{
+    std::vector<ODSocketClient*>::iterator it = std::find(mSockClients.begin(), mSockClients.end(), client);
+    if(it == mSockClients.end())
+    {
+        OD_LOG_ERR("Unknown client");
+        return;
+    }
+
+    mSockClients.erase(it);
+    mSockSelector.remove(client->getSockClient());
+    client->disconnect();
+    delete client;
+}
+
 void ODSocketServer::stopServer()
 {
     mIsConnected = false;
@@ -62,6 +62,11 @@ class ODSocketServer
          * timeoutMs milliseconds, even if new clients connected or clients are sending messages.
          */
         void doTask(int timeoutMs);
+
+        /*! \brief Disconnects and deletes the given client. It should not be called from notifyClientMessage
+         * (returning false removes the client)
+         */
+        void removeClient(ODSocketClient* client);
         std::vector<ODSocketClient*> mSockClients;
         virtual void serverThread() = 0;
         sf::Thread* mThread;
@@ -64,6 +64,10 @@ template<> ODFrameListener* Ogre::Singleton<ODFrameListener>::msSingleton = null
 namespace
 {
     const unsigned int DEFAULT_FRAME_RATE = 60;
+
+    //! \brief Time we allow each frame to refresh the tile meshes. Tiles not refreshed
+    //! within that time will be refreshed during the next frames
+    const uint64_t TILE_MESH_REFRESH_BUDGET_MICROSECONDS = 4000;
 }
 
 /*! \brief This constructor is where the OGRE rendering system is initialized and started.
@@ -210,6 +214,8 @@ bool ODFrameListener::frameRenderingQueued(const Ogre::FrameEvent& evt)
     mGameMap.get()->processDeletionQueues();
     ODClient::getSingleton().processClientSocketMessages();
     ODClient::getSingleton().processClientNotifications();
+    // Tiles changed by the received messages are refreshed once per frame
+    mGameMap.get()->processTileMeshRefreshQueue(TILE_MESH_REFRESH_BUDGET_MICROSECONDS);
 
     return mContinue;
 }
@@ -277,7 +283,9 @@ void ODFrameListener::printDebugInfo()
         infoSS << "\ntriangleCount: " << mWindow->getStatistics().triangleCount;
         infoSS << "\nBatches: " << mWindow->getStatistics().batchCount;
         infoSS << "\nTurn number:  " << mGameMap->getTurnNumber();
-        infoSS << "\nCursor:  " << mModeManager->getInputManager().mXPos << ", " << mModeManager->getInputManager().mYPos << std::endl;
+        infoSS << "\nCursor:  " << mModeManager->getInputManager().mXPos << ", " << mModeManager->getInputManager().mYPos;
+        infoSS << "\nTiles refreshed: " << mGameMap->getNbTileMeshRefreshedLastCall()
+            << " (queued: " << mGameMap->getNbTileMeshRefreshQueued() << ")" << std::endl;
         infoSS << printDebugInfoTail.str() << std::endl;
         if(ODClient::getSingleton().isConnected())
         {
@@ -45,6 +45,7 @@
 #include <OgreEntity.h>
 #include <OgreMaterialManager.h>
 #include <OgreMesh.h>
+#include <OgreMeshManager.h>
 #include <OgreMovableObject.h>
 #include <OgreParticleSystem.h>
 #include <OgrePrerequisites.h>
@@ -63,6 +64,7 @@
 #include <Overlay/OgreOverlaySystem.h>
 #include <RTShaderSystem/OgreShaderGenerator.h>
 
+#include <set>
 #include <sstream>
 
 template<> RenderManager* Ogre::Singleton<RenderManager>::msSingleton = nullptr;
@@ -79,6 +81,9 @@ const Ogre::Real KEEPER_HAND_CREATURE_PICKED_SCALE = 0.05f;
 
 const Ogre::ColourValue BASE_AMBIENT_VALUE = Ogre::ColourValue(0.3f, 0.3f, 0.3f);
 
+//! \brief Number of colourized variants for each colour (normal, marked for digging, no vision)
+const uint32_t NB_MATERIAL_VARIANTS_PER_COLOUR = 3;
+
 RenderManager::RenderManager(Ogre::OverlaySystem* overlaySystem) :
     mHandAnimationState(nullptr),
     mViewport(nullptr),
@@ -112,6 +117,11 @@ void RenderManager::initGameRenderer(GameMap* gameMap)
     OD_ASSERT_TRUE(mHandKeeperNode);
     mCreatureTextOverlayDisplayed = false;
 
+    // Seats are configured at this point. We create the tiles colourized materials now instead of
+    // while playing
+    mSeatColourIndexes.clear();
+    warmUpColourizedMaterials(*gameMap);
+
     // Create the light which follows the single tile selection mesh
     if(mHandLight == nullptr)
     {
@@ -183,6 +193,9 @@ void RenderManager::stopGameRenderer(GameMap*)
         mSceneManager->destroyLight(mHandLight);
         mHandLight = nullptr;
     }
+
+    // The seats will be deleted. Note that the colourized materials are kept for the next game
+    mSeatColourIndexes.clear();
 }
 
 void RenderManager::triggerCompositor(const std::string& compositorName)
@@ -1284,22 +1297,156 @@ void RenderManager::colourizeEntity(Ogre::Entity *ent, const Seat* seat, bool ma
     {
         Ogre::SubEntity *tempSubEntity = ent->getSubEntity(i);
 
-        std::string materialName = tempSubEntity->getMaterialName();
-        // If the material name have been modified, we restore the original name
-        std::size_t index = materialName.find("##");
-        if(index != std::string::npos)
-            materialName = materialName.substr(0, index);
+        const Ogre::MaterialPtr& material = getColourizedMaterial(tempSubEntity->getMaterial(),
+            seat, markedForDigging, playerHasVision);
+        if(material.get() != tempSubEntity->getMaterial().get())
+            tempSubEntity->setMaterial(material);
+    }
+}
+
+const Ogre::MaterialPtr& RenderManager::getColourizedMaterial(const Ogre::MaterialPtr& material, const Seat* seat,
+    bool markedForDigging, bool playerHasVision)
+{
+    uint32_t index;
+    auto itIndex = mMaterialVariantsIndexes.find(material.get());
+    if(itIndex != mMaterialVariantsIndexes.end())
+        index = itIndex->second;
+    else
+    {
+        // We do not know this material yet. If its name has been modified, we find the original one
+        Ogre::MaterialPtr baseMaterial = material;
+        const std::string& materialName = material->getName();
+        std::size_t pos = materialName.find("##");
+        if(pos != std::string::npos)
+        {
+            baseMaterial = Ogre::MaterialManager::getSingleton().getByName(materialName.substr(0, pos));
+            if(baseMaterial.get() == nullptr)
+            {
+                OD_LOG_ERR("Cannot find base material for material=" + materialName);
+                return material;
+            }
+        }
+
+        auto itBase = mMaterialVariantsIndexes.find(baseMaterial.get());
+        if(itBase != mMaterialVariantsIndexes.end())
+            index = itBase->second;
+        else
+        {
+            index = mMaterialVariants.size();
+            mMaterialVariants.push_back(MaterialVariants());
+            mMaterialVariants.back().mBaseMaterial = baseMaterial;
+            mMaterialVariantsIndexes[baseMaterial.get()] = index;
+        }
+        mMaterialVariantsIndexes[material.get()] = index;
+    }
+
+    uint32_t variantIndex = (seat == nullptr) ? 0 : (getSeatColourIndex(seat) + 1);
+    variantIndex *= NB_MATERIAL_VARIANTS_PER_COLOUR;
+    if (markedForDigging)
+        variantIndex += 1;
+    else if(!playerHasVision)
+        variantIndex += 2;
+
+    MaterialVariants& variants = mMaterialVariants[index];
+    if(variantIndex == 0)
+        return variants.mBaseMaterial;
+
+    if(variantIndex >= variants.mVariants.size())
+        variants.mVariants.resize(variantIndex + 1);
+
+    Ogre::MaterialPtr& variant = variants.mVariants[variantIndex];
+    if(variant.get() == nullptr)
+    {
+        variant = colourizeMaterial(variants.mBaseMaterial, seat, markedForDigging, playerHasVision);
+        mMaterialVariantsIndexes[variant.get()] = index;
+    }
+
+    return variant;
+}
+
+uint32_t RenderManager::getSeatColourIndex(const Seat* seat)
+{
+    auto itSeat = mSeatColourIndexes.find(seat);
+    if(itSeat != mSeatColourIndexes.end())
+        return itSeat->second;
+
+    uint32_t colourIndex;
+    auto itColour = mColourIndexes.find(seat->getColorId());
+    if(itColour != mColourIndexes.end())
+        colourIndex = itColour->second;
+    else
+    {
+        colourIndex = mColourIndexes.size();
+        mColourIndexes[seat->getColorId()] = colourIndex;
+    }
+
+    mSeatColourIndexes[seat] = colourIndex;
+    return colourIndex;
+}
 
-        materialName = colourizeMaterial(materialName, seat, markedForDigging, playerHasVision);
-        tempSubEntity->setMaterialName(materialName);
+void RenderManager::warmUpColourizedMaterials(const GameMap& gameMap)
+{
+    const TileSet* tileSet = gameMap.getTileSet();
+    if(tileSet == nullptr)
+        return;
+
+    // We get the materials used by the tileset meshes
+    std::vector<Ogre::MaterialPtr> materials;
+    std::set<const Ogre::Material*> materialsAdded;
+    for(uint32_t i = 0; i < static_cast<uint32_t>(TileVisual::countTileVisual); ++i)
+    {
+        for(const TileSetValue& tileSetValue : tileSet->getTileValues(static_cast<TileVisual>(i)))
+        {
+            std::vector<std::string> materialNames;
+            if(!tileSetValue.getMaterialName().empty())
+                materialNames.push_back(tileSetValue.getMaterialName());
+            else if(!tileSetValue.getMeshName().empty())
+            {
+                Ogre::MeshPtr mesh = Ogre::MeshManager::getSingleton().load(tileSetValue.getMeshName(),
+                    Ogre::ResourceGroupManager::AUTODETECT_RESOURCE_GROUP_NAME);
+                for(uint16_t j = 0; j < mesh->getNumSubMeshes(); ++j)
+                    materialNames.push_back(mesh->getSubMesh(j)->getMaterialName());
+            }
+
+            for(const std::string& materialName : materialNames)
+            {
+                Ogre::MaterialPtr material = Ogre::MaterialManager::getSingleton().getByName(materialName);
+                if(material.get() == nullptr)
+                    continue;
+
+                if(!materialsAdded.insert(material.get()).second)
+                    continue;
+
+                materials.push_back(material);
+            }
+        }
     }
+
+    std::vector<const Seat*> seats;
+    seats.push_back(nullptr);
+    for(const Seat* seat : gameMap.getSeats())
+        seats.push_back(seat);
+
+    for(const Ogre::MaterialPtr& material : materials)
+    {
+        for(const Seat* seat : seats)
+        {
+            getColourizedMaterial(material, seat, false, true);
+            getColourizedMaterial(material, seat, true, true);
+            getColourizedMaterial(material, seat, false, false);
+        }
+    }
+
+    OD_LOG_INF("Colourized materials ready for " + Helper::toString(materials.size()) + " tileset materials and "
+        + Helper::toString(gameMap.getSeats().size()) + " seats");
 }
 
-std::string RenderManager::colourizeMaterial(const std::string& materialName, const Seat* seat, bool markedForDigging, bool playerHasVision)
+Ogre::MaterialPtr RenderManager::colourizeMaterial(const Ogre::MaterialPtr& baseMaterial, const Seat* seat, bool markedForDigging, bool playerHasVision)
 {
     if (seat == nullptr && !markedForDigging && playerHasVision)
-        return materialName;
+        return baseMaterial;
 
+    const std::string& materialName = baseMaterial->getName();
     std::stringstream tempSS;
 
     tempSS.str("");
@@ -1319,27 +1466,17 @@ std::string RenderManager::colourizeMaterial(const std::string& materialName, co
 
     Ogre::MaterialPtr requestedMaterial = Ogre::MaterialManager::getSingleton().getByName(tempSS.str());
 
-    //cout << "\nCloning material:  " << tempSS.str();
-
     // If this texture has been copied and colourized, we can return
 #if defined(OGRE_VERSION) && OGRE_VERSION < 0x10A00
     if (!requestedMaterial.isNull())
 #else
     if (requestedMaterial)
 #endif
-        return tempSS.str();
+        return requestedMaterial;
 
     // If not yet, then do so
-
-    // Check to see if we find a seat with the requested color, if not then just use the original, uncolored material.
-    if (seat == nullptr && !markedForDigging && playerHasVision)
-        return materialName;
-
-    Ogre::MaterialPtr oldMaterial = Ogre::MaterialManager::getSingleton().getByName(materialName);
-
-    //std::cout << "\nMaterial does not exist, creating a new one.";
-    Ogre::MaterialPtr newMaterial = oldMaterial->clone(tempSS.str());
-    bool cloned = mShaderGenerator->cloneShaderBasedTechniques(oldMaterial->getName(), oldMaterial->getGroup(),
+    Ogre::MaterialPtr newMaterial = baseMaterial->clone(tempSS.str());
+    bool cloned = mShaderGenerator->cloneShaderBasedTechniques(baseMaterial->getName(), baseMaterial->getGroup(),
                                                  newMaterial->getName(), newMaterial->getGroup());
     if(!cloned)
     {
@@ -1389,7 +1526,7 @@ std::string RenderManager::colourizeMaterial(const std::string& materialName, co
         }
     }
 
-    return tempSS.str();
+    return newMaterial;
 }
 
 void RenderManager::rrCarryEntity(Creature* carrier, GameEntity* carried)
@@ -23,9 +23,13 @@
 #define RENDERMANAGER_H
 
 #include <string>
+#include <OgreMaterial.h>
 #include <OgreSingleton.h>
 #include <OgreMath.h>
 #include <cstdint>
+#include <map>
+#include <unordered_map>
+#include <vector>
 
 class GameMap;
 class Building;
@@ -185,8 +189,21 @@ private:
     //! \brief Colorize the material with the corresponding team id color.
     //! \note If the material (wall tiles only) is marked for digging, a yellow color is added
     //! to the given color.
-    //! \returns The new material name according to the current colorization.
-    std::string colourizeMaterial(const std::string& materialName, const Seat* seat, bool markedForDigging, bool playerHasVision);
+    //! \returns The new material according to the current colorization. It is created if it does not exist yet.
+    Ogre::MaterialPtr colourizeMaterial(const Ogre::MaterialPtr& baseMaterial, const Seat* seat, bool markedForDigging, bool playerHasVision);
+
+    //! \brief Returns the colourized variant of the given material (that can be a base material or an already
+    //! colourized one). The variants are kept in mMaterialVariants so that, once created, getting one does
+    //! not need any string building nor material lookup by name.
+    const Ogre::MaterialPtr& getColourizedMaterial(const Ogre::MaterialPtr& material, const Seat* seat,
+        bool markedForDigging, bool playerHasVision);
+
+    //! \brief Creates the colourized variants of the tileset materials for every seat of the given gamemap so
+    //! that they do not have to be cloned while playing
+    void warmUpColourizedMaterials(const GameMap& gameMap);
+
+    //! \brief Returns the index of the colour of the given seat in the mMaterialVariants variants
+    uint32_t getSeatColourIndex(const Seat* seat);
 
     //! \brief Colorize an entity with the team corresponding color.
     //! \Note: if the entity is marked for digging (wall tiles only), then a yellow color
@@ -233,6 +250,25 @@ private:
 
     //! Bit array to allow to display tile hand (= 0) or not (!= 0)
     uint32_t mHandKeeperHandVisibility;
+
+    //! \brief Colourized variants of a base material. mVariants is indexed by colour index
+    //! (0 for no seat, seat colour index + 1 otherwise) * 3 + (0, 1 if marked for digging, 2 if no vision).
+    //! Variants not created yet are null.
+    struct MaterialVariants
+    {
+        Ogre::MaterialPtr mBaseMaterial;
+        std::vector<Ogre::MaterialPtr> mVariants;
+    };
+    std::vector<MaterialVariants> mMaterialVariants;
+
+    //! \brief Index in mMaterialVariants of the known materials (base materials and their variants)
+    std::unordered_map<const Ogre::Material*, uint32_t> mMaterialVariantsIndexes;
+
+    //! \brief Colour index of each seat colour id. Kept from one game to another as the variants are
+    std::map<std::string, uint32_t> mColourIndexes;
+
+    //! \brief Colour index of the seats of the current game
+    std::unordered_map<const Seat*, uint32_t> mSeatColourIndexes;
 };
 
 #endif // RENDERMANAGER_H
@@ -42,7 +42,12 @@
 
 Room::Room(GameMap* gameMap):
     Building(gameMap),
-    mNumActiveSpots(0)
+    mNumActiveSpots(0),
+    mIsCountedInGameMap(false),
+    mFreeCapacityIndexed(0),
+    mSeatGoldCounted(nullptr),
+    mGoldCounted(0),
+    mGoldMaxCounted(0)
 {
 }
 
@@ -64,14 +69,19 @@ bool Room::compareTile(Tile* tile1, Tile* tile2)
 
 void Room::addToGameMap()
 {
+    mFreeCapacityIndexed = getFreeCapacity();
     getGameMap()->addRoom(this);
+    mIsCountedInGameMap = true;
     getGameMap()->addActiveObject(this);
+
+    updateSeatGoldCount();
 }
 
 void Room::removeFromGameMap()
 {
     fireEntityRemoveFromGameMap();
     getGameMap()->removeRoom(this);
+    mIsCountedInGameMap = false;
     setIsOnMap(false);
     for(Seat* seat : getGameMap()->getSeats())
     {
@@ -83,6 +93,8 @@ void Room::removeFromGameMap()
 
     removeAllBuildingObjects();
     getGameMap()->removeActiveObject(this);
+
+    updateSeatGoldCount();
 }
 
 void Room::absorbRoom(Room *r)
@@ -131,6 +143,11 @@ void Room::absorbRoom(Room *r)
     r->mCoveredTilesDestroyed.insert(r->mCoveredTilesDestroyed.end(), r->mCoveredTiles.begin(), r->mCoveredTiles.end());
     r->mCoveredTiles.clear();
 
+    updateSeatGoldCount();
+    r->updateSeatGoldCount();
+    updateFreeCapacity();
+    r->updateFreeCapacity();
+
     // We fire the dead event so that if there are creatures heading for this room or
     // whatever, we release them before the remove from gamemap event
     r->fireEntityDead();
@@ -159,6 +176,7 @@ bool Room::addCreatureUsingRoom(Creature* c)
         return false;
 
     mCreaturesUsingRoom.push_back(c);
+    updateFreeCapacity();
     return true;
 }
 
@@ -172,6 +190,7 @@ void Room::removeCreatureUsingRoom(Creature *c)
             break;
         }
     }
+    updateFreeCapacity();
 }
 
 Creature* Room::getCreatureUsingRoom(unsigned index)
@@ -447,6 +466,8 @@ void Room::updateActiveSpots()
     mNumActiveSpots = mCentralActiveSpotTiles.size()
                       + mLeftWallsActiveSpotTiles.size() + mRightWallsActiveSpotTiles.size()
                       + mTopWallsActiveSpotTiles.size() + mBottomWallsActiveSpotTiles.size();
+
+    updateFreeCapacity();
 }
 
 void Room::activeSpotCheckChange(ActiveSpotPlace place, const std::vector<Tile*>& originalSpotTiles,
@@ -674,9 +695,52 @@ void Room::repairRoom()
         tile->setCoveringBuilding(this);
     }
 
+    updateSeatGoldCount();
+    updateFreeCapacity();
     updateActiveSpots();
 }
 
+void Room::updateSeatGoldCount()
+{
+    if(!getIsOnServerMap())
+        return;
+
+    Seat* seat = nullptr;
+    int gold = 0;
+    int goldMax = 0;
+    if(mIsCountedInGameMap && (getSeat() != nullptr))
+    {
+        seat = getSeat();
+        gold = getTotalGoldStored();
+        goldMax = getTotalGoldStorage();
+    }
+
+    if((seat == mSeatGoldCounted) && (gold == mGoldCounted) && (goldMax == mGoldMaxCounted))
+        return;
+
+    if(mSeatGoldCounted != nullptr)
+        mSeatGoldCounted->notifyGoldStoredChanged(-mGoldCounted, -mGoldMaxCounted);
+
+    if(seat != nullptr)
+        seat->notifyGoldStoredChanged(gold, goldMax);
+
+    mSeatGoldCounted = seat;
+    mGoldCounted = gold;
+    mGoldMaxCounted = goldMax;
+}
+
+void Room::updateFreeCapacity()
+{
+    int32_t freeCapacity = getFreeCapacity();
+    if(freeCapacity == mFreeCapacityIndexed)
+        return;
+
+    if(mIsCountedInGameMap)
+        getGameMap()->notifyRoomFreeCapacityChanged(this, freeCapacity - mFreeCapacityIndexed);
+
+    mFreeCapacityIndexed = freeCapacity;
+}
+
 bool Room::sortForMapSave(Room* r1, Room* r2)
 {
     // We sort room by seat id then meshName
@@ -20,6 +20,7 @@
 
 #include "entities/Building.h"
 
+#include <cstdint>
 #include <string>
 #include <iosfwd>
 
@@ -126,6 +127,15 @@ public:
     virtual int withdrawGold(int gold)
     { return 0; }
 
+    //! \brief Returns how much the room can still accept (gold for a treasury, creatures
+    //! for a hatchery, free tiles for a dormitory, ...). Rooms that do not need it return 0
+    virtual int32_t getFreeCapacity() const
+    { return 0; }
+
+    //! \brief Returns the free capacity this room is counted for in the GameMap room index
+    inline int32_t getFreeCapacityIndexed() const
+    { return mFreeCapacityIndexed; }
+
     virtual void creatureDropped(Creature& creature) override;
 
     virtual bool isInContainment(Creature& creature)
@@ -168,10 +178,29 @@ protected:
 
     //! \brief This function will be called when reordering room is needed (for example if another room has been absorbed)
     static void reorderRoomTiles(std::vector<Tile*>& tiles);
+
+    //! \brief Updates the seat gold counters if the gold stored or the storage capacity of this
+    //! room changed. Should be called each time gold is deposited/withdrawn or covered tiles change
+    void updateSeatGoldCount();
+
+    //! \brief Notifies the GameMap room index if getFreeCapacity changed. Should be called by the
+    //! rooms overriding getFreeCapacity each time it may have changed
+    void updateFreeCapacity();
 private :
     void activeSpotCheckChange(ActiveSpotPlace place, const std::vector<Tile*>& originalSpotTiles,
         const std::vector<Tile*>& newSpotTiles);
 
+    //! \brief True between addToGameMap and removeFromGameMap
+    bool mIsCountedInGameMap;
+
+    //! \brief The free capacity of this room as counted in the GameMap room index
+    int32_t mFreeCapacityIndexed;
+
+    //! \brief The seat whose gold counters this room is counted in and the values counted. Used on server side only
+    Seat* mSeatGoldCounted;
+    int mGoldCounted;
+    int mGoldMaxCounted;
+
 };
 
 #endif // ROOM_H
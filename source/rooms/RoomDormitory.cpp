@@ -155,10 +155,11 @@ bool RoomDormitory::removeCoveredTile(Tile* t)
         releaseTileForSleeping(t, roomDormitoryTileData->mCreature);
     }
 
-    if(Room::removeCoveredTile(t))
-        return true;
+    if(!Room::removeCoveredTile(t))
+        return false;
 
-    return false;
+    updateFreeCapacity();
+    return true;
 }
 
 std::vector<Tile*> RoomDormitory::getOpenTiles()
@@ -179,6 +180,23 @@ std::vector<Tile*> RoomDormitory::getOpenTiles()
     return returnVector;
 }
 
+int32_t RoomDormitory::getFreeCapacity() const
+{
+    int32_t nbOpenTiles = 0;
+    for (const std::pair<Tile* const, TileData*>& p : mTileData)
+    {
+        const RoomDormitoryTileData* roomDormitoryTileData = static_cast<const RoomDormitoryTileData*>(p.second);
+        if (roomDormitoryTileData->mHP <=0)
+            continue;
+        if (roomDormitoryTileData->mCreature != nullptr)
+            continue;
+
+        ++nbOpenTiles;
+    }
+
+    return nbOpenTiles;
+}
+
 Tile* RoomDormitory::claimTileForSleeping(Tile* t, Creature* c)
 {
     if (t == nullptr || c == nullptr)
@@ -255,6 +273,7 @@ void RoomDormitory::createBed(Tile* sleepTile, int x, int y, int width, int heig
     ro->createMesh();
     // Save the info for later...
     mBedRoomObjectsInfo.push_back(bedInfo);
+    updateFreeCapacity();
 }
 
 bool RoomDormitory::releaseTileForSleeping(Tile* t, Creature* c)
@@ -293,6 +312,7 @@ bool RoomDormitory::releaseTileForSleeping(Tile* t, Creature* c)
             ++it;
     }
 
+    updateFreeCapacity();
     return true;
 }
 
@@ -150,6 +150,10 @@ public:
 
     // Functions specific to this class.
     std::vector<Tile*> getOpenTiles();
+
+    //! \brief Returns the number of covered tiles that are not destroyed and not claimed by a
+    //! creature for sleeping (the tiles getOpenTiles would return)
+    int32_t getFreeCapacity() const override;
     Tile* claimTileForSleeping(Tile *t, Creature *c);
     bool releaseTileForSleeping(Tile *t, Creature *c);
     Tile* getLocationForBed(Creature* creature);
@@ -180,6 +180,14 @@ bool RoomHatchery::hasOpenCreatureSpot(Creature* c)
     return mNumActiveSpots > mCreaturesUsingRoom.size();
 }
 
+int32_t RoomHatchery::getFreeCapacity() const
+{
+    if(mNumActiveSpots <= mCreaturesUsingRoom.size())
+        return 0;
+
+    return static_cast<int32_t>(mNumActiveSpots - mCreaturesUsingRoom.size());
+}
+
 bool RoomHatchery::useRoom(Creature& creature, bool forced)
 {
     // Check if the creature needs to eat
@@ -134,7 +134,7 @@ BuildingObject* RoomLibrary::notifyActiveSpotCreated(ActiveSpotPlace place, Tile
             Ogre::Real z = 0;
             y += OFFSET_SPOT;
             mUnusedSpots.push_back(tile);
-            if (Random::Int(0, 100) > 50)
+            if (Random::Int(Random::Stream::rooms, 0, 100) > 50)
                 return new BuildingObject(getGameMap(), *this, "Podium", tile, x, y, z, 45.0, false);
             else
                 return new BuildingObject(getGameMap(), *this, "Bookcase", tile, x, y, z, 45.0, false);
@@ -228,7 +228,7 @@ bool RoomLibrary::addCreatureUsingRoom(Creature* creature)
     if(!Room::addCreatureUsingRoom(creature))
         return false;
 
-    int index = Random::Int(0, mUnusedSpots.size() - 1);
+    int index = Random::Int(Random::Stream::rooms, 0, mUnusedSpots.size() - 1);
     Tile* tileSpot = mUnusedSpots[index];
     mUnusedSpots.erase(mUnusedSpots.begin() + index);
     mCreaturesSpots[creature] = tileSpot;
@@ -376,7 +376,7 @@ bool RoomLibrary::useRoom(Creature& creature, bool forced)
 
     int32_t pointsEarned = static_cast<int32_t>(creatureRoomAffinity.getEfficiency() * ConfigManager::getSingleton().getRoomConfigDouble("LibraryPointsPerWork"));
     creature.jobDone(ConfigManager::getSingleton().getRoomConfigDouble("LibraryWakefulnessPerWork"));
-    creature.setJobCooldown(Random::Uint(ConfigManager::getSingleton().getRoomConfigUInt32("LibraryCooldownWorkMin"),
+    creature.setJobCooldown(Random::Uint(Random::Stream::rooms, ConfigManager::getSingleton().getRoomConfigUInt32("LibraryCooldownWorkMin"),
         ConfigManager::getSingleton().getRoomConfigUInt32("LibraryCooldownWorkMax")));
 
     // We check if we have enough points to create a skill entity
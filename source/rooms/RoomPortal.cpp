@@ -147,7 +147,9 @@ void RoomPortal::claimForSeat(Seat* seat, Tile* tile, double danceRate)
     }
 
     mClaimedValue = static_cast<double>(numCoveredTiles());
+    Seat* oldSeat = getSeat();
     setSeat(seat);
+    getGameMap()->notifyRoomSeatChanged(this, oldSeat);
 
     for(Tile* tile : mCoveredTiles)
         tile->claimTile(seat);
@@ -216,7 +218,7 @@ void RoomPortal::doUpkeep()
         --mSpawnCreatureCountdown;
         return;
     }
-    mSpawnCreatureCountdown = Random::Uint(ConfigManager::getSingleton().getRoomConfigUInt32("PortalCooldownSpawnMin"),
+    mSpawnCreatureCountdown = Random::Uint(Random::Stream::rooms, ConfigManager::getSingleton().getRoomConfigUInt32("PortalCooldownSpawnMin"),
         ConfigManager::getSingleton().getRoomConfigUInt32("PortalCooldownSpawnMax"));
 
     if (mCoveredTiles.empty())
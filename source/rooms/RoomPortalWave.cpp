@@ -100,38 +100,6 @@ class RoomPortalWaveFactory : public RoomFactory
 static RoomRegister reg(new RoomPortalWaveFactory);
 }
 
-class TileSearch
-{
-public:
-    TileSearch() :
-        mTile(nullptr),
-        mRotationClockWise(false),
-        mRotationCounterClockWise(false)
-    {}
-
-    static std::pair<int,int> computeNextRotation(const std::pair<int,int>& currentRotation,
-        bool rotationClockWise)
-    {
-        if(rotationClockWise)
-        {
-            int newY = currentRotation.first;
-            int newX = currentRotation.second * -1;
-            return std::pair<int, int>(newX, newY);
-        }
-        else
-        {
-            int newY = currentRotation.first * -1;
-            int newX = currentRotation.second;
-            return std::pair<int, int>(newX, newY);
-        }
-    }
-
-    Tile* mTile;
-    bool mRotationClockWise;
-    bool mRotationCounterClockWise;
-    std::pair<int,int> mDirectionHit;
-};
-
 static const double CLAIMED_VALUE_PER_TILE = 1.0;
 
 RoomPortalWave::RoomPortalWave(GameMap* gameMap) :
@@ -143,6 +111,7 @@ RoomPortalWave::RoomPortalWave(GameMap* gameMap) :
         mClaimedValue(0),
         mTargetDungeon(nullptr),
         mIsFirstUpkeep(true),
+        mIsDigPathBudgetLogged(false),
         mStrategy(RoomPortalWaveStrategy::closestDungeon),
         mRangeTilesAttack(-1)
 {
@@ -274,7 +243,7 @@ void RoomPortalWave::doUpkeep()
         --mSearchFoeCountdown;
     else
     {
-        mSearchFoeCountdown = Random::Uint(10, 20);
+        mSearchFoeCountdown = Random::Uint(Random::Stream::rooms, 10, 20);
 
         handleAttack();
     }
@@ -304,7 +273,7 @@ void RoomPortalWave::handleChooseTarget()
         {
             case RoomPortalWaveStrategy::randomPlayer:
             {
-                uint32_t kk = Random::Uint(0, mAttackableSeats.size() - 1);
+                uint32_t kk = Random::Uint(Random::Stream::rooms, 0, mAttackableSeats.size() - 1);
                 mTargetSeats.clear();
                 Seat* attackedSeat = mAttackableSeats[kk];
                 OD_LOG_INF("PortalWave=" + getName() + ", attacking seatId=" + Helper::toString(attackedSeat->getId()));
@@ -477,7 +446,7 @@ void RoomPortalWave::handleSpawnWave()
         return;
 
     // Randomly choose a wave to spawn
-    uint32_t index = Random::Uint(0, mRoomPortalWaveDataSpawnable.size() - 1);
+    uint32_t index = Random::Uint(Random::Stream::rooms, 0, mRoomPortalWaveDataSpawnable.size() - 1);
     spawnWave(mRoomPortalWaveDataSpawnable[index], maxCreatures - numCreatures);
 }
 
@@ -715,15 +684,15 @@ bool RoomPortalWave::handleSearchFoe()
         return false;
     }
 
-    std::vector<Creature*> creatures = getGameMap()->getCreaturesBySeat(getSeat());
+    TurnSpan<Creature*> creatures = getGameMap()->getCreaturesBySeat(getSeat());
     if(creatures.empty())
         return false;
 
     // We randomly pick a creature to test for path
-    uint32_t index = Random::Uint(0, creatures.size() - 1);
+    uint32_t index = Random::Uint(Random::Stream::rooms, 0, creatures.size() - 1);
     Creature* creature = creatures[index];
 
-    std::vector<Room*> dungeonTemples = getGameMap()->getRoomsByType(RoomType::dungeonTemple);
+    RoomsView dungeonTemples = getGameMap()->getRoomsByType(RoomType::dungeonTemple);
 
     // First, we check if a dungeon temple is reachable by ground. If yes, we cast a call to war
     // if not, we search the closest and try to go there
@@ -850,7 +819,7 @@ bool RoomPortalWave::handleDigging()
 
     // We sort the dungeon temples by distance. We will try to reach the closest accessible one
     std::vector<std::pair<Room*,Ogre::Real>> tileDungeons;
-    std::vector<Room*> dungeonTemples = getGameMap()->getRoomsByType(RoomType::dungeonTemple);
+    RoomsView dungeonTemples = getGameMap()->getRoomsByType(RoomType::dungeonTemple);
     for(Room* room : dungeonTemples)
     {
         // We check if the strategy allows us to attack the dungeon
@@ -888,11 +857,8 @@ bool RoomPortalWave::handleDigging()
         if(tileDungeon == nullptr)
             continue;
 
-        if(!findBestDiggablePath(tileStart, tileDungeon, creature, mMarkedTilesToEnemy) &&
-           mMarkedTilesToEnemy.empty())
-        {
+        if(!findBestDiggablePath(tileStart, tileDungeon, creature, mMarkedTilesToEnemy))
             continue;
-        }
 
         if(mTargetDungeon != nullptr)
             mTargetDungeon->removeGameEntityListener(this);
@@ -917,176 +883,35 @@ bool RoomPortalWave::handleDigging()
 
 bool RoomPortalWave::findBestDiggablePath(Tile* tileStart, Tile* tileDest, Creature* creature, std::vector<Tile*>& tiles)
 {
-    if(!creature->canGoThroughTile(tileStart) &&
-       !tileStart->isDiggable(creature->getSeat()))
+    Seat* seat = creature->getSeat();
+    bool nodeBudgetReached = false;
+    std::list<Tile*> pathToDig = getGameMap()->path(tileStart, tileDest, creature, seat, true, &nodeBudgetReached);
+    if(nodeBudgetReached && !mIsDigPathBudgetLogged)
     {
-        return false;
+        // The search is retried regularly. We only log the first time to avoid flooding the log
+        mIsDigPathBudgetLogged = true;
+        OD_LOG_INF("PortalWave=" + getName() + " reached the dig path node budget while searching path from "
+            + Tile::displayAsString(tileStart) + " to " + Tile::displayAsString(tileDest));
     }
+    if(pathToDig.empty())
+        return false;
 
-    std::vector<std::pair<int, int>> rotations;
-    std::vector<TileSearch> blockingTiles;
-    Tile* tile = tileStart;
-    Tile* lastTileBlocked = nullptr;
-    bool currentRotationClockWise = false;
-    while(true)
+    // We keep the tiles that need to be dug and are not already marked
+    for(Tile* tile : pathToDig)
     {
-        if(tile == tileDest)
-            return true;
-
-        if(tile == nullptr)
-        {
-            // We reach the end of the map.
-            // We try the last blocking tile we found in the other direction (if any)
-            lastTileBlocked = nullptr;
-            for(auto it = blockingTiles.rbegin(); it != blockingTiles.rend(); ++it)
-            {
-                TileSearch& tileSearch = *it;
-                if(tileSearch.mRotationClockWise &&
-                   tileSearch.mRotationCounterClockWise)
-                {
-                    continue;
-                }
-
-                lastTileBlocked = tileSearch.mTile;
-                if(tileSearch.mRotationClockWise)
-                {
-                    tileSearch.mRotationCounterClockWise = true;
-                    currentRotationClockWise = false;
-                }
-                else
-                {
-                    tileSearch.mRotationClockWise = true;
-                    currentRotationClockWise = true;
-                }
-
-                rotations.clear();
-                rotations.push_back(tileSearch.mDirectionHit);
-                rotations.push_back(TileSearch::computeNextRotation(rotations.back(), currentRotationClockWise));
-                break;
-            }
-
-            if(lastTileBlocked == nullptr)
-                return false;
-
-            tile = getGameMap()->getTile(lastTileBlocked->getX() + rotations.back().first, lastTileBlocked->getY() + rotations.back().second);
-        }
-
-        // A nullptr tile is possible if we are searching near the map border after applying the rotation
-        if(tile == nullptr)
-            continue;
-
-        bool isTilePassable = false;
-        // If the tile is walkable, no need to dig it
         if(creature->canGoThroughTile(tile))
-        {
-            isTilePassable = true;
-        }
-        else if(tile->getMarkedForDigging(creature->getSeat()->getPlayer()))
-        {
-            isTilePassable = true;
-        }
-        else if(tile->isDiggable(creature->getSeat()))
-        {
-            tiles.push_back(tile);
-            isTilePassable = true;
-        }
-
-        if(isTilePassable)
-        {
-            // The tile is passable. If we were rotating, we try the next rotation
-            // If not, we continue our way
-            if(!rotations.empty())
-                rotations.pop_back();
-
-            if(rotations.empty())
-            {
-                int diffX = tileDest->getX() - tile->getX();
-                int diffY = tileDest->getY() - tile->getY();
-                if(std::abs(diffX) > std::abs(diffY))
-                {
-                    if(diffX < 0)
-                        rotations.push_back(std::pair<int, int>(-1, 0));
-                    else
-                        rotations.push_back(std::pair<int, int>(1, 0));
-                }
-                else
-                {
-                    if(diffY < 0)
-                        rotations.push_back(std::pair<int, int>(0, -1));
-                    else
-                        rotations.push_back(std::pair<int, int>(0, 1));
-                }
-
-                // We are not blocked
-                lastTileBlocked = nullptr;
-            }
-            tile = getGameMap()->getTile(tile->getX() + rotations.back().first, tile->getY() + rotations.back().second);
-        }
-        else
-        {
-            // We start from the previous tile (that was good to go)
-            tile = getGameMap()->getTile(tile->getX() - rotations.back().first, tile->getY() - rotations.back().second);
-            if(tile == nullptr)
-            {
-                OD_LOG_ERR("room=" + getName());
-                return false;
-            }
-
-            // Tile is not passable. We try to go around. If we are not already following a wall, we start to
-            if(lastTileBlocked == nullptr)
-            {
-                // We check if we already hit this tile
-                bool isFound = false;
-                for(TileSearch& tileSearch : blockingTiles)
-                {
-                    if(tileSearch.mTile != tile)
-                        continue;
-
-                    // We already hit this tile. We stop searching this way
-                    isFound = true;
-                }
-
-                if(isFound)
-                {
-                    tile = nullptr;
-                    continue;
-                }
+            continue;
 
-                // We have never been blocked here
-                lastTileBlocked = tile;
+        if(tile->getMarkedForDigging(seat->getPlayer()))
+            continue;
 
-                int diffX = tileDest->getX() - tile->getX();
-                int diffY = tileDest->getY() - tile->getY();
-                if(rotations.back().first == 0)
-                {
-                    if(diffX < 0)
-                        currentRotationClockWise = (rotations.back().second > 0);
-                    else
-                        currentRotationClockWise = (rotations.back().second < 0);
-                }
-                else // rotations.back().second should be 0
-                {
-                    if(diffY < 0)
-                        currentRotationClockWise = (rotations.back().first < 0);
-                    else
-                        currentRotationClockWise = (rotations.back().first > 0);
-                }
-                TileSearch tileSearch;
-                tileSearch.mTile = tile;
-                tileSearch.mDirectionHit = rotations.back();
-                if(currentRotationClockWise)
-                    tileSearch.mRotationClockWise = true;
-                else
-                    tileSearch.mRotationCounterClockWise = true;
-
-                blockingTiles.push_back(tileSearch);
-            }
+        if(!tile->isDiggable(seat))
+            continue;
 
-            // We set next direction
-            rotations.push_back(TileSearch::computeNextRotation(rotations.back(), currentRotationClockWise));
-            tile = getGameMap()->getTile(tile->getX() + rotations.back().first, tile->getY() + rotations.back().second);
-        }
+        tiles.push_back(tile);
     }
+
+    return true;
 }
 
 void RoomPortalWave::handleFirstUpkeep()
@@ -1102,7 +927,7 @@ void RoomPortalWave::handleFirstUpkeep()
     if(mRangeTilesAttack <= 0)
     {
         // We take all dungeons
-        std::vector<Room*> dungeonTemples = getGameMap()->getRoomsByType(RoomType::dungeonTemple);
+        RoomsView dungeonTemples = getGameMap()->getRoomsByType(RoomType::dungeonTemple);
         for(Room* room : dungeonTemples)
         {
             Seat* roomSeat = room->getSeat();
@@ -1124,7 +949,7 @@ void RoomPortalWave::handleFirstUpkeep()
     }
 
     double squaredRange = static_cast<double>(mRangeTilesAttack) * static_cast<double>(mRangeTilesAttack);
-    std::vector<Room*> dungeonTemples = getGameMap()->getRoomsByType(RoomType::dungeonTemple);
+    RoomsView dungeonTemples = getGameMap()->getRoomsByType(RoomType::dungeonTemple);
     for(Room* room : dungeonTemples)
     {
         Seat* roomSeat = room->getSeat();
@@ -143,6 +143,8 @@ private:
     Room* mTargetDungeon;
 
     bool mIsFirstUpkeep;
+    //! \brief True once we have logged that the dig path search reached DigPathNodeBudget
+    bool mIsDigPathBudgetLogged;
     RoomPortalWaveStrategy mStrategy;
     //! \brief Range to attack. If a player starts claiming tiles within range, the portal will try to dig to the corresponding
     //! dungeon temple. If -1, there is no limit
@@ -157,9 +159,8 @@ private:
     //! \brief Updates the portal mesh position.
     void updatePortalPosition();
 
-    //! \brief Finds the best diggable path between tileStart and tileDest.
-    //! Note that a path is returned even if tileDest is not reachable. It should go around
-    //! the undiggable tiles
+    //! \brief Finds the best diggable path between tileStart and tileDest using the dig-through path search
+    //! (see GameMap::path) and fills tiles with the tiles to dig that are not already marked.
     //! Returns true if a path was found to the dungeon and false otherwise
     bool findBestDiggablePath(Tile* tileStart, Tile* tileDest, Creature* creature, std::vector<Tile*>& tiles);
 
@@ -328,7 +328,7 @@ bool RoomTorture::useRoom(Creature& creature, bool forced)
         p.second.mIsReady = true;
 
         if((getSeat() != creature.getSeat()) &&
-           (Random::Double(0.0, 1.0) <= config.getRoomConfigDouble("TortureRallyPercent")))
+           (Random::Double(Random::Stream::rooms, 0.0, 1.0) <= config.getRoomConfigDouble("TortureRallyPercent")))
         {
             // The creature changes side
             creature.changeSeat(getSeat());
@@ -349,7 +349,7 @@ bool RoomTorture::useRoom(Creature& creature, bool forced)
         }
 
         // We start the fire effect and we set job cooldown
-        uint32_t nbTurns = Random::Uint(config.getRoomConfigUInt32("TortureSessionLengthMin"),
+        uint32_t nbTurns = Random::Uint(Random::Stream::rooms, config.getRoomConfigUInt32("TortureSessionLengthMin"),
             config.getRoomConfigUInt32("TortureSessionLengthMax"));
         creature.setJobCooldown(nbTurns);
 
@@ -144,7 +144,7 @@ BuildingObject* RoomTrainingHall::notifyActiveSpotCreated(ActiveSpotPlace place,
         {
             y += OFFSET_DUMMY;
             mUnusedDummies.push_back(tile);
-            switch(Random::Int(1, 4))
+            switch(Random::Int(Random::Stream::rooms, 1, 4))
             {
                 case 1:
                     return new BuildingObject(getGameMap(), *this, "TrainingDummy1", tile, x, y, z, 0.0, false);
@@ -161,25 +161,25 @@ BuildingObject* RoomTrainingHall::notifyActiveSpotCreated(ActiveSpotPlace place,
         case ActiveSpotPlace::activeSpotLeft:
         {
             x -= OFFSET_DUMMY;
-            std::string meshName = Random::Int(1, 2) > 1 ? "WeaponShield2" : "WeaponShield1";
+            std::string meshName = Random::Int(Random::Stream::rooms, 1, 2) > 1 ? "WeaponShield2" : "WeaponShield1";
             return new BuildingObject(getGameMap(), *this, meshName, tile, x, y, z, 90.0, false);
         }
         case ActiveSpotPlace::activeSpotRight:
         {
             x += OFFSET_DUMMY;
-            std::string meshName = Random::Int(1, 2) > 1 ? "WeaponShield2" : "WeaponShield1";
+            std::string meshName = Random::Int(Random::Stream::rooms, 1, 2) > 1 ? "WeaponShield2" : "WeaponShield1";
             return new BuildingObject(getGameMap(), *this, meshName, tile, x, y, z, 270.0, false);
         }
         case ActiveSpotPlace::activeSpotTop:
         {
             y += OFFSET_DUMMY;
-            std::string meshName = Random::Int(1, 2) > 1 ? "WeaponShield2" : "WeaponShield1";
+            std::string meshName = Random::Int(Random::Stream::rooms, 1, 2) > 1 ? "WeaponShield2" : "WeaponShield1";
             return new BuildingObject(getGameMap(), *this, meshName, tile, x, y, z, 0.0, false);
         }
         case ActiveSpotPlace::activeSpotBottom:
         {
             y -= OFFSET_DUMMY;
-            std::string meshName = Random::Int(1, 2) > 1 ? "WeaponShield2" : "WeaponShield1";
+            std::string meshName = Random::Int(Random::Stream::rooms, 1, 2) > 1 ? "WeaponShield2" : "WeaponShield1";
             return new BuildingObject(getGameMap(), *this, meshName, tile, x, y, z, 180.0, false);
         }
         default:
@@ -233,7 +233,7 @@ void RoomTrainingHall::refreshCreaturesDummies()
 
     for(Creature* creature : mCreaturesUsingRoom)
     {
-        int index = Random::Int(0, mUnusedDummies.size() - 1);
+        int index = Random::Int(Random::Stream::rooms, 0, mUnusedDummies.size() - 1);
         Tile* tileDummy = mUnusedDummies[index];
         mUnusedDummies.erase(mUnusedDummies.begin() + index);
         mCreaturesDummies[creature] = tileDummy;
@@ -278,7 +278,7 @@ bool RoomTrainingHall::addCreatureUsingRoom(Creature* creature)
     if(!Room::addCreatureUsingRoom(creature))
         return false;
 
-    int index = Random::Int(0, mUnusedDummies.size() - 1);
+    int index = Random::Int(Random::Stream::rooms, 0, mUnusedDummies.size() - 1);
     Tile* tileDummy = mUnusedDummies[index];
     mUnusedDummies.erase(mUnusedDummies.begin() + index);
     mCreaturesDummies[creature] = tileDummy;
@@ -336,7 +336,7 @@ void RoomTrainingHall::doUpkeep()
         return;
 
     // We add a probability to change dummies so that creatures do not use the same during too much time
-    if(mCreaturesDummies.size() > 0 && Random::Int(50,150) < ++nbTurnsNoChangeDummies)
+    if(mCreaturesDummies.size() > 0 && Random::Int(Random::Stream::rooms, 50,150) < ++nbTurnsNoChangeDummies)
         refreshCreaturesDummies();
 }
 
@@ -395,7 +395,7 @@ bool RoomTrainingHall::useRoom(Creature& creature, bool forced)
 
     creature.receiveExp(expReceived);
     creature.jobDone(ConfigManager::getSingleton().getRoomConfigDouble("TrainHallWakefulnessPerAttack"));
-    creature.setJobCooldown(Random::Uint(ConfigManager::getSingleton().getRoomConfigUInt32("TrainHallCooldownHitMin"),
+    creature.setJobCooldown(Random::Uint(Random::Stream::rooms, ConfigManager::getSingleton().getRoomConfigUInt32("TrainHallCooldownHitMin"),
         ConfigManager::getSingleton().getRoomConfigUInt32("TrainHallCooldownHitMax")));
 
     return false;
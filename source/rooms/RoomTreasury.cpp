@@ -221,8 +221,7 @@ class RoomTreasuryFactory : public RoomFactory
         int32_t pricePerTarget = RoomManager::costPerTile(RoomTreasury::mRoomType);
         int32_t price = static_cast<int32_t>(tiles.size()) * pricePerTarget;
         // First treasury tile is free
-        std::vector<Room*> treasuriesOwned = gameMap->getRoomsByTypeAndSeat(RoomTreasury::mRoomType, player->getSeat());
-        if(treasuriesOwned.empty())
+        if(gameMap->getRoomsByTypeAndSeat(RoomTreasury::mRoomType, player->getSeat()).empty())
             price -= pricePerTarget;
 
         return price;
@@ -287,7 +286,12 @@ bool RoomTreasury::removeCoveredTile(Tile* t)
 
     roomTreasuryTileData->mMeshOfTile.clear();
     roomTreasuryTileData->mGoldInTile = 0;
-    return Room::removeCoveredTile(t);
+    if(!Room::removeCoveredTile(t))
+        return false;
+
+    updateSeatGoldCount();
+    updateFreeCapacity();
+    return true;
 }
 
 int RoomTreasury::getTotalGoldStorage() const
@@ -308,6 +312,11 @@ int RoomTreasury::getTotalGoldStored() const
     return totalGold;
 }
 
+int32_t RoomTreasury::getFreeCapacity() const
+{
+    return getTotalGoldStorage() - getTotalGoldStored();
+}
+
 int RoomTreasury::depositGold(int gold, Tile *tile)
 {
     int goldDeposited, goldToDeposit = gold, emptySpace;
@@ -344,6 +353,8 @@ int RoomTreasury::depositGold(int gold, Tile *tile)
         return wasDeposited;
 
     mGoldChanged = true;
+    updateSeatGoldCount();
+    updateFreeCapacity();
 
     // Tells the client to play a deposit gold sound. For now, we only send it to the players
     // with vision on tile
@@ -377,6 +388,8 @@ int RoomTreasury::withdrawGold(int gold)
         }
     }
 
+    updateSeatGoldCount();
+    updateFreeCapacity();
     return withdrawlAmount;
 }
 
@@ -412,9 +425,9 @@ void RoomTreasury::updateMeshesForTile(Tile* tile, RoomTreasuryTileData* roomTre
         double posX = static_cast<double>(tile->getX());
         double posY = static_cast<double>(tile->getY());
         double posZ = 0;
-        posX += Random::Double(-offset, offset);
-        posY += Random::Double(-offset, offset);
-        double angle = Random::Double(0.0, 360);
+        posX += Random::Double(Random::Stream::rooms, -offset, offset);
+        posY += Random::Double(Random::Stream::rooms, -offset, offset);
+        double angle = Random::Double(Random::Stream::rooms, 0.0, 360);
         BuildingObject* ro = new BuildingObject(getGameMap(), *this, newMeshName, tile, posX, posY, posZ, angle, false);
         addBuildingObject(tile, ro);
     }
@@ -66,6 +66,7 @@ public:
 
     virtual int getTotalGoldStorage() const override;
     virtual int getTotalGoldStored() const override;
+    int32_t getFreeCapacity() const override;
     virtual int depositGold(int gold, Tile *tile) override;
     virtual int withdrawGold(int gold) override;
 
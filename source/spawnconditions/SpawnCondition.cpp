@@ -28,12 +28,11 @@
 #include "utils/ConfigManager.h"
 #include "utils/Helper.h"
 #include "utils/LogManager.h"
-
-#include <istream>
+#include "utils/TextTokenizer.h"
 
 const std::vector<const SpawnCondition*> SpawnCondition::EMPTY_SPAWNCONDITIONS;
 
-SpawnCondition* SpawnCondition::load(std::istream& defFile)
+SpawnCondition* SpawnCondition::load(TextTokenizer& defFile)
 {
     std::string nextParam;
     SpawnCondition* condition = nullptr;
@@ -24,6 +24,7 @@
 
 class GameMap;
 class Seat;
+class TextTokenizer;
 
 class SpawnCondition
 {
@@ -35,7 +36,7 @@ public:
     virtual ~SpawnCondition()
     {}
 
-    static SpawnCondition* load(std::istream& defFile);
+    static SpawnCondition* load(TextTokenizer& defFile);
 
     //! \brief Checks if this spawning condition is met for the given gameMap/Seat. Returns true if the conditions are met and
     //! false otherwise. If true, computedPoints will be set to the additional points (can be < 0).
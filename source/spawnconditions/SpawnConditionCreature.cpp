@@ -24,7 +24,7 @@
 bool SpawnConditionCreature::computePointsForSeat(const GameMap& gameMap, const Seat& seat, int32_t& computedPoints) const
 {
     int32_t nbCreatures = 0;
-    std::vector<Creature*> creatures = gameMap.getCreaturesBySeat(&seat);
+    TurnSpan<Creature*> creatures = gameMap.getCreaturesBySeat(&seat);
     for(Creature* creature : creatures)
     {
         if(creature->getDefinition() == mCreatureDefinition)
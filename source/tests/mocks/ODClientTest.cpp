@@ -36,6 +36,8 @@ static const std::string OD_VERSION_STR = "undefined";
 ODClientTest::ODClientTest(const std::vector<PlayerInfo>& players, uint32_t indexLocalPlayer) :
     mTurnNum(0),
     mContinueLoop(true),
+    mExpectedMapSizeX(10),
+    mExpectedMapSizeY(20),
     mIsActivated(false),
     mIsGameModeStarted(false),
     mPlayers(players),
@@ -100,8 +102,8 @@ bool ODClientTest::processMessage(ServerNotificationType cmd, ODPacket& packetRe
             BOOST_CHECK(packetReceived >> mapSizeX);
             BOOST_CHECK(packetReceived >> mapSizeY);
             OD_LOG_INF("map x=" + Helper::toString(mapSizeX) + ", y=" + Helper::toString(mapSizeX));
-            BOOST_CHECK(mapSizeX == 10);
-            BOOST_CHECK(mapSizeY == 20);
+            BOOST_CHECK(mapSizeX == mExpectedMapSizeX);
+            BOOST_CHECK(mapSizeY == mExpectedMapSizeY);
 
             // Map infos
             std::string str;
@@ -66,6 +66,14 @@ public:
 
     SeatData* getLocalSeat() const;
 
+    //! \brief Sets the map size the level sent by the server should have. By default, the one of the test
+    //! maps (10x20)
+    void setExpectedMapSize(int32_t mapSizeX, int32_t mapSizeY)
+    {
+        mExpectedMapSizeX = mapSizeX;
+        mExpectedMapSizeY = mapSizeY;
+    }
+
     // Allows to check that the server correctly launched and sent new turns
     int64_t mTurnNum;
 
@@ -84,6 +92,9 @@ protected:
     //! before the end of the timeout
     bool mContinueLoop;
 
+    int32_t mExpectedMapSizeX;
+    int32_t mExpectedMapSizeY;
+
 private:
     bool mIsActivated;
     bool mIsGameModeStarted;
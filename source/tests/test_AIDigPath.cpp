@@ -0,0 +1,140 @@
+/*
+ *  Copyright (C) 2011-2016  OpenDungeons Team
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#define BOOST_TEST_MODULE AIDigPath
+#include "BoostTestTargetConfig.h"
+
+#include "ai/AIDigPath.h"
+#include "ai/AITileSnapshot.h"
+
+#include <algorithm>
+#include <utility>
+#include <vector>
+
+// Same values as in config/global.cfg
+static const double costFullTile = 4.0;
+static const double penaltyGold = 2.0;
+static const double penaltyClaimedWall = 8.0;
+
+static const uint16_t walkable = AITileSnapshot::WALKABLE;
+static const uint16_t dirtWall = AITileSnapshot::FULL | AITileSnapshot::DIRT | AITileSnapshot::DIGGABLE;
+static const uint16_t goldWall = AITileSnapshot::FULL | AITileSnapshot::GOLD | AITileSnapshot::DIGGABLE;
+static const uint16_t claimedWall = AITileSnapshot::FULL | AITileSnapshot::CLAIMED | AITileSnapshot::DIGGABLE;
+
+//! \brief Builds a 7x3 map where the worker can reach the column x=0. The target is a dirt wall at (6, 1).
+//! The straight way to it is made of 5 walls of the given kind and the rows y=0 and y=2 are dirt walls
+static void buildMap(AITileSnapshot& snapshot, std::vector<uint8_t>& reachable, uint16_t straightWall)
+{
+    snapshot.reset(7, 3);
+    reachable.assign(7 * 3, 0);
+    for(int32_t xx = 0; xx < 7; ++xx)
+    {
+        for(int32_t yy = 0; yy < 3; ++yy)
+        {
+            if(xx == 0)
+            {
+                snapshot.setFlags(xx, yy, walkable);
+                reachable[snapshot.getIndex(xx, yy)] = 1;
+            }
+            else if((yy == 1) && (xx < 6))
+                snapshot.setFlags(xx, yy, straightWall);
+            else
+                snapshot.setFlags(xx, yy, dirtWall);
+        }
+    }
+}
+
+static bool isDug(const std::vector<std::pair<int32_t, int32_t>>& tilesToDig, int32_t x, int32_t y)
+{
+    return std::find(tilesToDig.begin(), tilesToDig.end(), std::make_pair(x, y)) != tilesToDig.end();
+}
+
+BOOST_AUTO_TEST_CASE(test_AIDigPathStraight)
+{
+    // With dirt everywhere, the straight way is the cheapest
+    AITileSnapshot snapshot;
+    std::vector<uint8_t> reachable;
+    buildMap(snapshot, reachable, dirtWall);
+
+    AIDigPath digPath;
+    digPath.setCosts(costFullTile, penaltyGold, penaltyClaimedWall, 0);
+    std::vector<std::pair<int32_t, int32_t>> tilesToDig;
+    BOOST_CHECK(digPath.search(snapshot, reachable, 6, 1, tilesToDig));
+    BOOST_CHECK(tilesToDig.size() == 6);
+    for(int32_t xx = 1; xx <= 6; ++xx)
+        BOOST_CHECK(isDug(tilesToDig, xx, 1));
+}
+
+BOOST_AUTO_TEST_CASE(test_AIDigPathAvoidsGold)
+{
+    // Digging the 5 gold tiles costs more than digging 6 dirt tiles around them
+    AITileSnapshot snapshot;
+    std::vector<uint8_t> reachable;
+    buildMap(snapshot, reachable, goldWall);
+
+    AIDigPath digPath;
+    digPath.setCosts(costFullTile, penaltyGold, penaltyClaimedWall, 0);
+    std::vector<std::pair<int32_t, int32_t>> tilesToDig;
+    BOOST_CHECK(digPath.search(snapshot, reachable, 6, 1, tilesToDig));
+    BOOST_CHECK(tilesToDig.size() == 7);
+    BOOST_CHECK(isDug(tilesToDig, 6, 1));
+    for(int32_t xx = 1; xx < 6; ++xx)
+        BOOST_CHECK(!isDug(tilesToDig, xx, 1));
+
+    // Without the penalty, the fewer tiles are dug
+    digPath.setCosts(costFullTile, 0.0, penaltyClaimedWall, 0);
+    tilesToDig.clear();
+    BOOST_CHECK(digPath.search(snapshot, reachable, 6, 1, tilesToDig));
+    BOOST_CHECK(tilesToDig.size() == 6);
+    BOOST_CHECK(isDug(tilesToDig, 1, 1));
+}
+
+BOOST_AUTO_TEST_CASE(test_AIDigPathAvoidsClaimedWalls)
+{
+    AITileSnapshot snapshot;
+    std::vector<uint8_t> reachable;
+    buildMap(snapshot, reachable, claimedWall);
+
+    AIDigPath digPath;
+    digPath.setCosts(costFullTile, penaltyGold, penaltyClaimedWall, 0);
+    std::vector<std::pair<int32_t, int32_t>> tilesToDig;
+    BOOST_CHECK(digPath.search(snapshot, reachable, 6, 1, tilesToDig));
+    BOOST_CHECK(tilesToDig.size() == 7);
+    for(int32_t xx = 1; xx < 6; ++xx)
+        BOOST_CHECK(!isDug(tilesToDig, xx, 1));
+}
+
+BOOST_AUTO_TEST_CASE(test_AIDigPathNodeBudget)
+{
+    AITileSnapshot snapshot;
+    std::vector<uint8_t> reachable;
+    buildMap(snapshot, reachable, dirtWall);
+
+    AIDigPath digPath;
+    digPath.setCosts(costFullTile, penaltyGold, penaltyClaimedWall, 3);
+    std::vector<std::pair<int32_t, int32_t>> tilesToDig;
+    BOOST_CHECK(!digPath.search(snapshot, reachable, 6, 1, tilesToDig));
+    BOOST_CHECK(digPath.isNodeBudgetReached());
+    BOOST_CHECK(tilesToDig.empty());
+
+    // The search state is reset so the next search is not affected
+    digPath.setCosts(costFullTile, penaltyGold, penaltyClaimedWall, 0);
+    BOOST_CHECK(digPath.search(snapshot, reachable, 6, 1, tilesToDig));
+    BOOST_CHECK(!digPath.isNodeBudgetReached());
+    BOOST_CHECK(tilesToDig.size() == 6);
+}
@@ -0,0 +1,119 @@
+/*
+ *  Copyright (C) 2011-2016  OpenDungeons Team
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "utils/ChunkedGrid.h"
+
+#define BOOST_TEST_MODULE ChunkedGrid
+#include "BoostTestTargetConfig.h"
+
+#include <chrono>
+#include <cstdint>
+
+//! \brief Same layout as the per seat tile state
+struct GridTestState
+{
+    int32_t mVisual;
+    int32_t mOwner;
+    bool mMarked;
+    bool mVisionLast;
+    bool mVisionCurrent;
+    void* mBuilding;
+};
+
+BOOST_AUTO_TEST_CASE(test_ChunkedGridAccess)
+{
+    ChunkedGrid<int> grid;
+    // Size not multiple of the chunk size to check the last chunks
+    grid.reset(40, 20);
+    BOOST_CHECK_EQUAL(grid.getNbChunks(), 3 * 2);
+    BOOST_CHECK(grid.find(5, 5) == nullptr);
+    BOOST_CHECK(grid.find(-1, 5) == nullptr);
+    BOOST_CHECK(grid.get(40, 0, [](int, int, int&) {}) == nullptr);
+
+    auto init = [](int x, int y, int& cell) { cell = x * 100 + y; };
+    int* cell = grid.get(35, 18, init);
+    BOOST_REQUIRE(cell != nullptr);
+    BOOST_CHECK_EQUAL(*cell, 3518);
+    BOOST_CHECK_EQUAL(grid.getNbChunksAllocated(), 1);
+
+    // The other cells of the chunk are initialized too
+    BOOST_REQUIRE(grid.find(32, 16) != nullptr);
+    BOOST_CHECK_EQUAL(*grid.find(32, 16), 3216);
+    BOOST_CHECK(grid.find(31, 16) == nullptr);
+
+    // Only cells inside the grid are given
+    uint32_t nbCells = 0;
+    grid.forEach([&nbCells](int x, int y, int& value)
+    {
+        BOOST_CHECK(x >= 32 && x < 40);
+        BOOST_CHECK(y >= 16 && y < 20);
+        BOOST_CHECK_EQUAL(value, x * 100 + y);
+        ++nbCells;
+    });
+    BOOST_CHECK_EQUAL(nbCells, 8u * 4u);
+
+    grid.reset(40, 20);
+    BOOST_CHECK_EQUAL(grid.getNbChunksAllocated(), 0);
+    BOOST_CHECK(grid.find(35, 18) == nullptr);
+}
+
+BOOST_AUTO_TEST_CASE(test_ChunkedGridBigMap)
+{
+    // Synthetic 1024x1024 map where a seat has explored a 128x128 region around its dungeon
+    const int mapSize = 1024;
+    const int exploredSize = 128;
+    ChunkedGrid<GridTestState> grid;
+    grid.reset(mapSize, mapSize);
+
+    auto init = [](int, int, GridTestState& state)
+    {
+        state.mVisual = 1;
+        state.mOwner = -1;
+        state.mMarked = false;
+        state.mVisionLast = false;
+        state.mVisionCurrent = false;
+        state.mBuilding = nullptr;
+    };
+    for(int x = 0; x < exploredSize; ++x)
+    {
+        for(int y = 0; y < exploredSize; ++y)
+            grid.get(x + 400, y + 400, init)->mVisionCurrent = true;
+    }
+
+    std::size_t denseMemory = static_cast<std::size_t>(mapSize) * mapSize * sizeof(GridTestState);
+    std::size_t sparseMemory = grid.getMemoryUsed();
+    BOOST_TEST_MESSAGE("1024x1024 tile states: dense=" << denseMemory << " bytes, chunked=" << sparseMemory
+        << " bytes, chunks=" << grid.getNbChunksAllocated() << "/" << grid.getNbChunks());
+    BOOST_CHECK(sparseMemory * 32 < denseMemory);
+
+    // A full pass only visits the allocated chunks
+    auto start = std::chrono::steady_clock::now();
+    uint32_t nbVisible = 0;
+    for(int turn = 0; turn < 100; ++turn)
+    {
+        nbVisible = 0;
+        grid.forEach([&nbVisible](int, int, GridTestState& state)
+        {
+            state.mVisionLast = state.mVisionCurrent;
+            if(state.mVisionCurrent)
+                ++nbVisible;
+        });
+    }
+    auto duration = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start);
+    BOOST_TEST_MESSAGE("100 vision passes: " << duration.count() << " us");
+    BOOST_CHECK_EQUAL(nbVisible, static_cast<uint32_t>(exploredSize * exploredSize));
+}
@@ -0,0 +1,146 @@
+/*
+ *  Copyright (C) 2011-2016  OpenDungeons Team
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "mocks/ODClientTest.h"
+
+#include "utils/LogManager.h"
+#include "utils/LogSinkConsole.h"
+
+#define BOOST_TEST_MODULE TestLargeLevel
+#include <BoostTestTargetConfig.h>
+
+#include <SFML/System.hpp>
+
+#include <algorithm>
+
+//! \brief Size of the generated test map ac.level
+static const int32_t LARGE_LEVEL_SIZE = 1024;
+
+class ODClientTestLargeLevel : public ODClientTest
+{
+public:
+    ODClientTestLargeLevel(const std::vector<PlayerInfo>& players, uint32_t indexLocalPlayer) :
+        ODClientTest(players, indexLocalPlayer),
+        mLastTurnTime(-1),
+        mNbTurnsTimed(0),
+        mTotalTurnsTime(0),
+        mMaxTurnTime(0)
+    {}
+
+    void resetTurnTimes()
+    {
+        mLastTurnTime = -1;
+        mNbTurnsTimed = 0;
+        mTotalTurnsTime = 0;
+        mMaxTurnTime = 0;
+    }
+
+    int32_t mLastTurnTime;
+    int32_t mNbTurnsTimed;
+    int32_t mTotalTurnsTime;
+    int32_t mMaxTurnTime;
+
+protected:
+    virtual void handleTurnStarted(int64_t turnNum) override
+    {
+        int32_t now = mClock.getElapsedTime().asMilliseconds();
+        if(mLastTurnTime >= 0)
+        {
+            int32_t turnTime = now - mLastTurnTime;
+            ++mNbTurnsTimed;
+            mTotalTurnsTime += turnTime;
+            mMaxTurnTime = std::max(mMaxTurnTime, turnTime);
+        }
+        mLastTurnTime = now;
+    }
+
+private:
+    sf::Clock mClock;
+};
+
+BOOST_AUTO_TEST_CASE(test_LargeLevel)
+{
+    LogManager logMgr;
+    logMgr.addSink(std::unique_ptr<LogSink>(new LogSinkConsole()));
+    std::vector<PlayerInfo> players;
+
+    // We know we have seat id = 1 (human) and 2
+    PlayerInfo player;
+    player.mNick = "PlayerStub1";
+    player.mWantedSeatId = 1;
+    player.mWantedTeamId = 1;
+    player.mIsHuman = true;
+    // The player id will be set by the server
+    player.mPlayerId = -1;
+    // We take faction index 0 for every player (keeper faction)
+    player.mWantedFactionIndex = 0;
+    players.push_back(player);
+
+    PlayerInfo playerAi;
+    playerAi.mPlayerId = 0;
+    playerAi.mWantedSeatId = 2;
+    playerAi.mWantedTeamId = 2;
+    playerAi.mWantedFactionIndex = 0;
+    playerAi.mIsHuman = false;
+    players.push_back(playerAi);
+
+    ODClientTestLargeLevel client(players, 0);
+    client.setExpectedMapSize(LARGE_LEVEL_SIZE, LARGE_LEVEL_SIZE);
+    BOOST_CHECK(client.connect("localhost", 32222, 10, "test_LargeLevelReplay"));
+
+    BOOST_CHECK(client.isConnected());
+
+    // We let the server send the level and start the game
+    client.runFor(10000);
+
+    // We add some creatures in each dungeon (opposite corners of the map) to have them wander and dig
+    std::string cmd;
+    for(int32_t i = 0; i < 20; ++i)
+    {
+        int32_t posX = 10 + (i % 5) * 3;
+        int32_t posY = 10 + (i / 5) * 3;
+        cmd = "addcreature 1 LargeWyvern1_" + Helper::toString(i) + " Wyvern " + Helper::toString(posX) + " "
+            + Helper::toString(posY) + " 0 Wyvern 1 0 max 100 0 0 none none 4 none 0";
+        client.sendConsoleCmd(cmd);
+
+        posX += LARGE_LEVEL_SIZE - 36;
+        posY += LARGE_LEVEL_SIZE - 36;
+        cmd = "addcreature 2 LargeWyvern2_" + Helper::toString(i) + " Wyvern " + Helper::toString(posX) + " "
+            + Helper::toString(posY) + " 0 Wyvern 1 0 max 100 0 0 none none 4 none 0";
+        client.sendConsoleCmd(cmd);
+    }
+
+    // The memory reports are written in the server log
+    client.sendConsoleCmd("memoryreport");
+    client.resetTurnTimes();
+    client.runFor(30000);
+    client.sendConsoleCmd("memoryreport");
+    client.runFor(1000);
+
+    OD_LOG_INF("turnNum=" + Helper::toString(client.mTurnNum) + ", turns timed=" + Helper::toString(client.mNbTurnsTimed)
+        + ", max turn time=" + Helper::toString(client.mMaxTurnTime) + " ms");
+    // The turn times depend on the machine running the test. They are only logged (the server
+    // starts a turn each 714 ms). We only check that the game is running
+    BOOST_CHECK(client.mNbTurnsTimed > 0);
+    if(client.mNbTurnsTimed > 0)
+    {
+        int32_t averageTurnTime = client.mTotalTurnsTime / client.mNbTurnsTimed;
+        OD_LOG_INF("average turn time=" + Helper::toString(averageTurnTime) + " ms");
+    }
+
+    client.disconnect(false);
+}
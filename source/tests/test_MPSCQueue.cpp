@@ -0,0 +1,102 @@
+/*
+ *  Copyright (C) 2011-2016  OpenDungeons Team
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "utils/MPSCQueue.h"
+
+#define BOOST_TEST_MODULE MPSCQueue
+#include "BoostTestTargetConfig.h"
+
+#include <cstdint>
+#include <thread>
+#include <vector>
+
+//! \brief Element pushed by the producers. Each producer stands for a player and numbers its elements
+struct QueueElement
+{
+    uint32_t mPlayerId;
+    uint32_t mSequence;
+};
+
+BOOST_AUTO_TEST_CASE(test_MPSCQueueSingleThread)
+{
+    MPSCQueue<uint32_t> queue;
+    uint32_t value = 0;
+    BOOST_CHECK(!queue.pop(value));
+
+    for(uint32_t i = 0; i < 10; ++i)
+        queue.push(i);
+
+    for(uint32_t i = 0; i < 10; ++i)
+    {
+        BOOST_REQUIRE(queue.pop(value));
+        BOOST_CHECK_EQUAL(value, i);
+    }
+    BOOST_CHECK(!queue.pop(value));
+
+    // The queue should still work after being emptied
+    queue.push(42);
+    BOOST_REQUIRE(queue.pop(value));
+    BOOST_CHECK_EQUAL(value, 42u);
+}
+
+BOOST_AUTO_TEST_CASE(test_MPSCQueueStress)
+{
+    const uint32_t nbProducers = 8;
+    const uint32_t nbElementsPerProducer = 100000;
+    MPSCQueue<QueueElement> queue;
+
+    std::vector<std::thread> producers;
+    for(uint32_t playerId = 0; playerId < nbProducers; ++playerId)
+    {
+        producers.push_back(std::thread([&queue, playerId, nbElementsPerProducer]()
+        {
+            for(uint32_t i = 0; i < nbElementsPerProducer; ++i)
+                queue.push(QueueElement{playerId, i});
+        }));
+    }
+
+    // The elements of a player should be received in the order they were pushed
+    std::vector<uint32_t> nextSequence(nbProducers, 0);
+    uint32_t nbReceived = 0;
+    uint32_t nbOrderErrors = 0;
+    while(nbReceived < nbProducers * nbElementsPerProducer)
+    {
+        QueueElement element;
+        if(!queue.pop(element))
+        {
+            std::this_thread::yield();
+            continue;
+        }
+
+        BOOST_REQUIRE(element.mPlayerId < nbProducers);
+        if(element.mSequence != nextSequence[element.mPlayerId])
+            ++nbOrderErrors;
+
+        nextSequence[element.mPlayerId] = element.mSequence + 1;
+        ++nbReceived;
+    }
+
+    for(std::thread& producer : producers)
+        producer.join();
+
+    BOOST_CHECK_EQUAL(nbOrderErrors, 0u);
+    for(uint32_t sequence : nextSequence)
+        BOOST_CHECK_EQUAL(sequence, nbElementsPerProducer);
+
+    QueueElement element;
+    BOOST_CHECK(!queue.pop(element));
+}
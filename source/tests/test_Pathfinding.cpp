@@ -20,6 +20,10 @@
 
 #include "gamemap/Pathfinding.h"
 
+#include <chrono>
+#include <cstdlib>
+#include <vector>
+
 struct Point
 {
     int x;
@@ -39,3 +43,121 @@ BOOST_AUTO_TEST_CASE(test_Pathfinding)
     BOOST_CHECK((Pathfinding::distanceTile(a, b) - std::sqrt(128.0f)) < 0.0001f);
     BOOST_CHECK(Pathfinding::squaredDistance(9,1,1,9) == 128);
 }
+
+BOOST_AUTO_TEST_CASE(test_GridTraversal)
+{
+    // Horizontal segment from the middle of cell (0, 0)
+    Pathfinding::GridTraversal horizontal(0.0, 0.0, 1.0, 0.0, 2.2);
+    BOOST_CHECK(horizontal.getX() == 0 && horizontal.getY() == 0);
+    BOOST_CHECK(horizontal.next());
+    BOOST_CHECK(horizontal.getX() == 1 && horizontal.getY() == 0);
+    BOOST_CHECK(std::fabs(horizontal.getDistance() - 0.5) < 0.0001);
+    BOOST_CHECK(horizontal.next());
+    BOOST_CHECK(horizontal.getX() == 2 && horizontal.getY() == 0);
+    BOOST_CHECK(!horizontal.next());
+
+    // A diagonal going through cell corners visits the cell adjacent along X before the diagonal one
+    Pathfinding::GridTraversal diagonal(0.0, 0.0, -std::sqrt(0.5), std::sqrt(0.5), 1.5);
+    int nbCells = 1;
+    int lastX = diagonal.getX();
+    int lastY = diagonal.getY();
+    while(diagonal.next())
+    {
+        BOOST_CHECK(std::abs(diagonal.getX() - lastX) + std::abs(diagonal.getY() - lastY) == 1);
+        lastX = diagonal.getX();
+        lastY = diagonal.getY();
+        ++nbCells;
+    }
+    BOOST_CHECK(nbCells == 3);
+    BOOST_CHECK(lastX == -1 && lastY == 1);
+
+    // Same along the other diagonal: (0, 0), (1, 0) then (1, -1)
+    Pathfinding::GridTraversal otherDiagonal(0.0, 0.0, std::sqrt(0.5), -std::sqrt(0.5), 1.5);
+    BOOST_CHECK(otherDiagonal.next());
+    BOOST_CHECK(otherDiagonal.getX() == 1 && otherDiagonal.getY() == 0);
+    BOOST_CHECK(otherDiagonal.next());
+    BOOST_CHECK(otherDiagonal.getX() == 1 && otherDiagonal.getY() == -1);
+    BOOST_CHECK(!otherDiagonal.next());
+}
+
+BOOST_AUTO_TEST_CASE(test_GridTraversalBouncingSegments)
+{
+    // We walk 1000 bouncing segments with GridTraversal on a grid with walls on its border and some
+    // pillars. Each segment bounces back when hitting a wall and none should ever end in a wall.
+    // This only times the traversal itself, not MissileObject::doUpkeep which needs a full GameMap
+    const int mapSize = 128;
+    std::vector<bool> walls(mapSize * mapSize, false);
+    for(int y = 0; y < mapSize; ++y)
+    {
+        for(int x = 0; x < mapSize; ++x)
+        {
+            bool isBorder = (x == 0) || (y == 0) || (x == mapSize - 1) || (y == mapSize - 1);
+            bool isPillar = (x % 8 == 4) && (y % 8 == 4);
+            walls[x + y * mapSize] = isBorder || isPillar;
+        }
+    }
+
+    const uint32_t nbSegments = 1000;
+    const uint32_t nbTurns = 200;
+    const double speed = 1.7;
+    std::vector<double> posX(nbSegments);
+    std::vector<double> posY(nbSegments);
+    std::vector<double> dirX(nbSegments);
+    std::vector<double> dirY(nbSegments);
+    for(uint32_t i = 0; i < nbSegments; ++i)
+    {
+        posX[i] = 2.0 + (i % 8) * 0.1;
+        posY[i] = 2.0 + (i % 5) * 0.1;
+        double angle = i * 0.0123;
+        dirX[i] = std::cos(angle);
+        dirY[i] = std::sin(angle);
+    }
+
+    uint32_t nbWallsEntered = 0;
+    uint64_t nbCellsVisited = 0;
+    auto begin = std::chrono::steady_clock::now();
+    for(uint32_t turn = 0; turn < nbTurns; ++turn)
+    {
+        for(uint32_t i = 0; i < nbSegments; ++i)
+        {
+            Pathfinding::GridTraversal traversal(posX[i], posY[i], dirX[i], dirY[i], speed);
+            int lastX = traversal.getX();
+            int lastY = traversal.getY();
+            bool isWallHit = false;
+            while(traversal.next())
+            {
+                ++nbCellsVisited;
+                if(walls[traversal.getX() + traversal.getY() * mapSize])
+                {
+                    isWallHit = true;
+                    break;
+                }
+                lastX = traversal.getX();
+                lastY = traversal.getY();
+            }
+
+            if(walls[lastX + lastY * mapSize])
+                ++nbWallsEntered;
+
+            if(isWallHit)
+            {
+                // The segment bounces from the last free cell
+                posX[i] = lastX;
+                posY[i] = lastY;
+                dirX[i] = -dirX[i];
+                dirY[i] = -dirY[i];
+                continue;
+            }
+
+            posX[i] += speed * dirX[i];
+            posY[i] += speed * dirY[i];
+        }
+    }
+    auto end = std::chrono::steady_clock::now();
+
+    BOOST_CHECK(nbWallsEntered == 0);
+    BOOST_CHECK(nbCellsVisited > 0);
+    BOOST_TEST_MESSAGE("Walked " << nbSegments << " synthetic segments during " << nbTurns << " turns in "
+        << std::chrono::duration_cast<std::chrono::microseconds>(end - begin).count()
+        << " us (GridTraversal only, MissileObject::doUpkeep is not timed)");
+}
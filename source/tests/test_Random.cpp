@@ -20,8 +20,78 @@
 #define BOOST_TEST_MODULE Random
 #include "BoostTestTargetConfig.h"
 
+#include <cmath>
+#include <vector>
+
 BOOST_AUTO_TEST_CASE(test_Random)
 {
     Random::initialize();
     BOOST_CHECK (Random::Int(1, 2 ) <= 2);
 }
+
+BOOST_AUTO_TEST_CASE(test_RandomDistribution)
+{
+    RandomGenerator generator(42);
+    const uint32_t nbDraws = 100000;
+    const int nbValues = 10;
+    std::vector<uint32_t> counts(nbValues, 0);
+    double sum = 0.0;
+    for(uint32_t i = 0; i < nbDraws; ++i)
+    {
+        int value = generator.Int(-5, 4);
+        BOOST_REQUIRE(value >= -5 && value <= 4);
+        ++counts[value + 5];
+
+        double d = generator.Double(0.0, 1.0);
+        BOOST_REQUIRE(d >= 0.0 && d < 1.0);
+        sum += d;
+    }
+
+    // Every value should get about 10% of the draws
+    for(uint32_t count : counts)
+        BOOST_CHECK(std::abs(static_cast<double>(count) - nbDraws / nbValues) < 0.05 * nbDraws / nbValues);
+
+    BOOST_CHECK(std::abs(sum / nbDraws - 0.5) < 0.01);
+
+    // The bulk version gives the same values as the single calls
+    RandomGenerator single(7);
+    RandomGenerator bulk(7);
+    std::vector<unsigned int> values(100);
+    bulk.fillUint(values.data(), values.size(), 3, 12);
+    for(unsigned int value : values)
+        BOOST_CHECK_EQUAL(value, single.Uint(3, 12));
+}
+
+BOOST_AUTO_TEST_CASE(test_RandomStreams)
+{
+    // Same seed and stream give the same sequence
+    RandomGenerator generator1(1234, 1);
+    RandomGenerator generator2(1234, 1);
+    for(uint32_t i = 0; i < 100; ++i)
+        BOOST_CHECK_EQUAL(generator1.next(), generator2.next());
+
+    // Different streams are not correlated: about half the bits should differ
+    RandomGenerator stream1(1234, 1);
+    RandomGenerator stream2(1234, 2);
+    const uint32_t nbDraws = 10000;
+    uint64_t nbDifferentBits = 0;
+    for(uint32_t i = 0; i < nbDraws; ++i)
+    {
+        uint64_t diff = stream1.next() ^ stream2.next();
+        while(diff != 0)
+        {
+            diff &= diff - 1;
+            ++nbDifferentBits;
+        }
+    }
+    BOOST_CHECK(std::abs(static_cast<double>(nbDifferentBits) / nbDraws - 32.0) < 0.5);
+
+    // Drawing from a stream does not change the other ones
+    Random::setGameSeed(99);
+    int expected = Random::Int(Random::Stream::rooms, 0, 1000000);
+    Random::setGameSeed(99);
+    for(uint32_t i = 0; i < 100; ++i)
+        Random::Int(Random::Stream::creatures, 0, 1000000);
+    BOOST_CHECK_EQUAL(Random::Int(Random::Stream::rooms, 0, 1000000), expected);
+    BOOST_CHECK_EQUAL(Random::getGameSeed(), 99u);
+}
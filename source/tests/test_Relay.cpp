@@ -0,0 +1,164 @@
+/*
+ *  Copyright (C) 2011-2016  OpenDungeons Team
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "network/ODRelay.h"
+#include "network/ServerNotification.h"
+#include "utils/LogManager.h"
+#include "utils/LogSinkConsole.h"
+
+#define BOOST_TEST_MODULE TestRelay
+#include <BoostTestTargetConfig.h>
+
+#include <SFML/System.hpp>
+
+#include <cstdio>
+
+static const int32_t SERVER_PORT = 32300;
+static const int32_t RELAY_PORT = 32301;
+
+//! \brief Spectator connecting to the relay. It keeps the chat messages received
+class SpectatorTest : public ODSocketClient
+{
+public:
+    bool connectToRelay(int32_t port = RELAY_PORT)
+    { return connect("localhost", port, 5000, ""); }
+
+    //! \brief Processes the received packets until nbMessages are received or the timeout is over
+    bool waitMessages(uint32_t nbMessages, int32_t timeoutMs)
+    {
+        sf::Clock clock;
+        while(clock.getElapsedTime().asMilliseconds() < timeoutMs)
+        {
+            processClientSocketMessages();
+            if(mMessages.size() >= nbMessages)
+                return true;
+
+            sf::sleep(sf::milliseconds(10));
+        }
+        return false;
+    }
+
+    std::vector<std::string> mMessages;
+
+protected:
+    bool processMessage(ServerNotificationType cmd, ODPacket& packetReceived) override
+    {
+        BOOST_CHECK(cmd == ServerNotificationType::chatServer);
+        std::string msg;
+        BOOST_CHECK(packetReceived >> msg);
+        mMessages.push_back(msg);
+        return true;
+    }
+};
+
+static void sendChat(ODSocketClient& server, const std::string& msg)
+{
+    ODPacket packet;
+    packet << ServerNotificationType::chatServer << msg;
+    BOOST_CHECK(server.send(packet) == ODSocketClient::ODComStatus::OK);
+}
+
+BOOST_AUTO_TEST_CASE(test_Relay)
+{
+    LogManager logMgr;
+    logMgr.addSink(std::unique_ptr<LogSink>(new LogSinkConsole()));
+
+    // We play the server ourselves to control what the relay receives
+    sf::TcpListener listener;
+    BOOST_REQUIRE(listener.listen(SERVER_PORT) == sf::Socket::Done);
+
+    ODRelay relay("RelayTest", "OpenDungeons V test", 500);
+    BOOST_REQUIRE(relay.startRelay("localhost", SERVER_PORT, RELAY_PORT, ""));
+
+    ODSocketClient server;
+    BOOST_REQUIRE(listener.accept(server.getSockClient()) == sf::Socket::Done);
+    server.setSource(ODSocketClient::ODSource::network);
+
+    SpectatorTest spectator1;
+    BOOST_REQUIRE(spectator1.connectToRelay());
+
+    sendChat(server, "msg1");
+    sendChat(server, "msg2");
+
+    // Because of the delay, nothing should be received right away
+    BOOST_CHECK(!spectator1.waitMessages(1, 200));
+    BOOST_CHECK(spectator1.waitMessages(2, 2000));
+
+    // A late spectator should receive the stream from the beginning
+    SpectatorTest spectator2;
+    BOOST_REQUIRE(spectator2.connectToRelay());
+    sendChat(server, "msg3");
+    BOOST_CHECK(spectator2.waitMessages(3, 2000));
+    BOOST_CHECK(spectator1.waitMessages(3, 2000));
+    BOOST_CHECK(relay.getNbSpectators() == 2);
+
+    BOOST_REQUIRE(spectator2.mMessages.size() == 3);
+    BOOST_CHECK(spectator2.mMessages[0] == "msg1");
+    BOOST_CHECK(spectator2.mMessages[2] == "msg3");
+    BOOST_CHECK(spectator1.mMessages == spectator2.mMessages);
+
+    // Once the server is gone, the relay stops when every packet is sent
+    server.disconnect();
+    sf::Clock clock;
+    while(relay.isRelaying() && (clock.getElapsedTime().asMilliseconds() < 2000))
+        sf::sleep(sf::milliseconds(10));
+    BOOST_CHECK(!relay.isRelaying());
+
+    spectator1.disconnect();
+    spectator2.disconnect();
+    relay.stopRelay();
+}
+
+BOOST_AUTO_TEST_CASE(test_RelaySpool)
+{
+    LogManager logMgr;
+    logMgr.addSink(std::unique_ptr<LogSink>(new LogSinkConsole()));
+
+    sf::TcpListener listener;
+    BOOST_REQUIRE(listener.listen(SERVER_PORT + 2) == sf::Socket::Done);
+
+    // No memory allowed: the packets are removed from memory as soon as they are released
+    const std::string replayFilename = "TestRelaySpool.replay";
+    ODRelay relay("RelayTest", "OpenDungeons V test", 0, 0);
+    BOOST_REQUIRE(relay.startRelay("localhost", SERVER_PORT + 2, RELAY_PORT + 2, replayFilename));
+
+    ODSocketClient server;
+    BOOST_REQUIRE(listener.accept(server.getSockClient()) == sf::Socket::Done);
+    server.setSource(ODSocketClient::ODSource::network);
+
+    sendChat(server, "msg1");
+    sendChat(server, "msg2");
+    sf::Clock clock;
+    while((relay.getNbPacketsInMemory() != 0) && (clock.getElapsedTime().asMilliseconds() < 2000))
+        sf::sleep(sf::milliseconds(10));
+    BOOST_CHECK(relay.getNbPacketsInMemory() == 0);
+
+    // The late spectator should get the packets from the spool file
+    SpectatorTest spectator;
+    BOOST_REQUIRE(spectator.connectToRelay(RELAY_PORT + 2));
+    sendChat(server, "msg3");
+    BOOST_CHECK(spectator.waitMessages(3, 2000));
+    BOOST_REQUIRE(spectator.mMessages.size() == 3);
+    BOOST_CHECK(spectator.mMessages[0] == "msg1");
+    BOOST_CHECK(spectator.mMessages[1] == "msg2");
+    BOOST_CHECK(spectator.mMessages[2] == "msg3");
+
+    server.disconnect();
+    spectator.disconnect();
+    relay.stopRelay();
+    std::remove(replayFilename.c_str());
+}
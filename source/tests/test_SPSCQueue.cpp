@@ -0,0 +1,110 @@
+/*
+ *  Copyright (C) 2011-2016  OpenDungeons Team
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "utils/SPSCQueue.h"
+
+#define BOOST_TEST_MODULE SPSCQueue
+#include "BoostTestTargetConfig.h"
+
+#include <cstdint>
+#include <thread>
+
+BOOST_AUTO_TEST_CASE(test_SPSCQueueFullAndEmpty)
+{
+    // A queue of capacity 4 holds 3 elements. We fill and empty it more times than its capacity
+    // so that the head and tail indexes wrap around in every possible position
+    SPSCQueue<uint32_t> queue(4);
+    uint32_t value = 0;
+    uint32_t nextPushed = 0;
+    uint32_t nextPopped = 0;
+    for(uint32_t round = 0; round < 10; ++round)
+    {
+        BOOST_CHECK(queue.empty());
+        BOOST_CHECK(!queue.pop(value));
+
+        for(uint32_t i = 0; i < 3; ++i)
+            BOOST_REQUIRE(queue.push(nextPushed++));
+
+        // Full
+        BOOST_CHECK(!queue.push(nextPushed));
+        BOOST_CHECK(!queue.empty());
+
+        // We shift the indexes by one more slot each round
+        for(uint32_t i = 0; i < 3; ++i)
+        {
+            BOOST_REQUIRE(queue.pop(value));
+            BOOST_CHECK_EQUAL(value, nextPopped++);
+        }
+        BOOST_CHECK(!queue.pop(value));
+
+        BOOST_REQUIRE(queue.push(nextPushed++));
+        BOOST_REQUIRE(queue.pop(value));
+        BOOST_CHECK_EQUAL(value, nextPopped++);
+    }
+
+    BOOST_REQUIRE(queue.push(42));
+    queue.clear();
+    BOOST_CHECK(queue.empty());
+}
+
+BOOST_AUTO_TEST_CASE(test_SPSCQueueStress)
+{
+    // A small capacity makes both threads hit the full and empty cases often
+    const uint32_t nbElements = 1000000;
+    SPSCQueue<uint32_t> queue(8);
+
+    uint32_t nbFull = 0;
+    std::thread producer([&queue, &nbFull, nbElements]()
+    {
+        for(uint32_t i = 0; i < nbElements; ++i)
+        {
+            while(!queue.push(i))
+            {
+                ++nbFull;
+                std::this_thread::yield();
+            }
+        }
+    });
+
+    // The elements should be received in the order they were pushed
+    uint32_t nbReceived = 0;
+    uint32_t nbOrderErrors = 0;
+    uint32_t nbEmpty = 0;
+    while(nbReceived < nbElements)
+    {
+        uint32_t value;
+        if(!queue.pop(value))
+        {
+            ++nbEmpty;
+            std::this_thread::yield();
+            continue;
+        }
+
+        if(value != nbReceived)
+            ++nbOrderErrors;
+
+        ++nbReceived;
+    }
+
+    producer.join();
+
+    BOOST_CHECK_EQUAL(nbOrderErrors, 0u);
+    BOOST_TEST_MESSAGE("Queue found full " << nbFull << " times and empty " << nbEmpty << " times");
+
+    uint32_t value;
+    BOOST_CHECK(!queue.pop(value));
+    BOOST_CHECK(queue.empty());
+}
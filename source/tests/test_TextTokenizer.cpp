@@ -0,0 +1,200 @@
+/*
+ *  Copyright (C) 2011-2016  OpenDungeons Team
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "utils/TextTokenizer.h"
+
+#define BOOST_TEST_MODULE TextTokenizer
+#include "BoostTestTargetConfig.h"
+
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <locale>
+#include <sstream>
+#include <string>
+
+BOOST_AUTO_TEST_CASE(test_TextTokenizerTokensAndLines)
+{
+    std::string text = "[Info]  # comment\r\n"
+        "Name\tMy level # with comment\n"
+        "\n"
+        "   # only a comment\n"
+        "12\t-3\t0.5\tabc#def\n"
+        "4294967295 99999999999\n";
+    TextTokenizer tokenizer((TextView(text.data(), text.size())));
+
+    TextView token;
+    BOOST_REQUIRE(tokenizer.nextToken(token));
+    BOOST_CHECK(token == "[Info]");
+    TextView line;
+    BOOST_REQUIRE(tokenizer.restOfLine(line));
+    BOOST_CHECK(line.empty());
+    BOOST_REQUIRE(tokenizer.nextLine(line));
+    BOOST_CHECK(line == "Name\tMy level");
+
+    int32_t i1 = 0;
+    int32_t i2 = 0;
+    double d = 0.0;
+    std::string str;
+    BOOST_REQUIRE(tokenizer >> i1 >> i2 >> d >> str);
+    BOOST_CHECK_EQUAL(i1, 12);
+    BOOST_CHECK_EQUAL(i2, -3);
+    BOOST_CHECK_EQUAL(d, 0.5);
+    // Everything after # is a comment, even inside a token
+    BOOST_CHECK_EQUAL(str, "abc");
+
+    uint32_t u = 0;
+    BOOST_REQUIRE(tokenizer >> u);
+    BOOST_CHECK_EQUAL(u, 4294967295u);
+    // Out of range
+    BOOST_CHECK(!(tokenizer >> u));
+    BOOST_CHECK_EQUAL(u, 4294967295u);
+    BOOST_CHECK(!tokenizer.good());
+    BOOST_CHECK(!(tokenizer >> str));
+}
+
+BOOST_AUTO_TEST_CASE(test_TextTokenizerParseDouble)
+{
+    // The values should be the same as the ones read by a stream with the classic locale
+    const char* numbers[] = { "0.5", "-1.25", "+3", "0.2", "1e3", "2.5E-2", ".5", "5.", "-0.0", "0.1",
+        "3.14159265358979", "123456789.123456789", "1e-30", "6.02e23", "0.30000000000000004" };
+    for(const char* number : numbers)
+    {
+        std::istringstream stream(number);
+        stream.imbue(std::locale::classic());
+        double expected = 0.0;
+        BOOST_REQUIRE(stream >> expected);
+
+        double value = 0.0;
+        BOOST_CHECK(TextTokenizer::parseDouble(TextView(number, std::strlen(number)), value));
+        BOOST_CHECK_MESSAGE(value == expected, number);
+    }
+
+    const char* invalids[] = { "", "-", ".", "1,5", "1e", "1e+", "abc", "1.5x", "--1" };
+    for(const char* invalid : invalids)
+    {
+        double value = 7.0;
+        BOOST_CHECK_MESSAGE(!TextTokenizer::parseDouble(TextView(invalid, std::strlen(invalid)), value), invalid);
+        BOOST_CHECK_EQUAL(value, 7.0);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(test_TextTokenizerBlock)
+{
+    std::string text = "[Seat] seatId 1 # comment\n"
+        "teamId\t2\n"
+        "[/Seat] [Seat]\n";
+    TextTokenizer tokenizer((TextView(text.data(), text.size())));
+    TextView token;
+    BOOST_REQUIRE(tokenizer.nextToken(token));
+    std::string block;
+    BOOST_REQUIRE(tokenizer.nextBlock("[/Seat]", block));
+    BOOST_CHECK_EQUAL(block, " seatId 1 \nteamId\t2\n[/Seat]\n");
+    BOOST_REQUIRE(tokenizer.nextToken(token));
+    BOOST_CHECK(token == "[Seat]");
+    BOOST_CHECK(!tokenizer.nextBlock("[/Seat]", block));
+}
+
+BOOST_AUTO_TEST_CASE(test_TextTokenizerBlockView)
+{
+    std::string text = "[Creature] Name Imp # [/Creature]\n"
+        "HpPerLevel 1.5\n"
+        "[/Creature]\n[Creature]\n";
+    TextTokenizer tokenizer((TextView(text.data(), text.size())));
+    TextView token;
+    BOOST_REQUIRE(tokenizer.nextToken(token));
+    TextView block;
+    BOOST_REQUIRE(tokenizer.nextBlock("[/Creature]", block));
+
+    // The block keeps its comments but its own tokenizer skips them and cannot read further
+    TextTokenizer blockTokenizer(block);
+    std::string name;
+    double hpPerLevel = 0.0;
+    BOOST_REQUIRE(blockTokenizer.nextToken(token));
+    BOOST_CHECK(token == "Name");
+    blockTokenizer >> name >> token >> hpPerLevel;
+    BOOST_CHECK_EQUAL(name, "Imp");
+    BOOST_CHECK(token == "HpPerLevel");
+    BOOST_CHECK_EQUAL(hpPerLevel, 1.5);
+    BOOST_REQUIRE(blockTokenizer.nextToken(token));
+    BOOST_CHECK(token == "[/Creature]");
+    BOOST_CHECK(!blockTokenizer.nextToken(token));
+
+    BOOST_REQUIRE(tokenizer.nextToken(token));
+    BOOST_CHECK(token == "[Creature]");
+}
+
+BOOST_AUTO_TEST_CASE(test_TextTokenizerLargeLevel)
+{
+    // Tiles section of a 1024x1024 level where every tile is written
+    const int mapSize = 1024;
+    std::ostringstream ss;
+    for(int x = 0; x < mapSize; ++x)
+    {
+        for(int y = 0; y < mapSize; ++y)
+            ss << x << "\t" << y << "\t" << ((x + y) % 5) << "\t" << ((x * y) % 2 == 0 ? 100 : 0) << "\t" << (y % 3) << "\n";
+    }
+    ss << "[/Tiles]\n";
+    const std::string text = ss.str();
+
+    auto start = std::chrono::steady_clock::now();
+    int64_t sumTokenizer = 0;
+    uint32_t nbErrors = 0;
+    TextTokenizer tokenizer((TextView(text.data(), text.size())));
+    TextView line;
+    while(tokenizer.nextLine(line))
+    {
+        if(line == "[/Tiles]")
+            break;
+
+        TextTokenizer lineTokenizer(line);
+        int32_t values[5];
+        double fullness;
+        if(!(lineTokenizer >> values[0] >> values[1] >> values[2] >> fullness >> values[4]))
+        {
+            ++nbErrors;
+            continue;
+        }
+        sumTokenizer += values[0] + values[1] + values[2] + static_cast<int64_t>(fullness) + values[4];
+    }
+    auto durationTokenizer = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start);
+
+    // What the loaders did before: a stream on the whole text and one per line
+    start = std::chrono::steady_clock::now();
+    int64_t sumStream = 0;
+    std::stringstream levelFile(text);
+    std::string nextParam;
+    while(levelFile >> nextParam)
+    {
+        if(nextParam == "[/Tiles]")
+            break;
+
+        std::string entireLine = nextParam;
+        std::getline(levelFile, nextParam);
+        entireLine += nextParam;
+        std::stringstream lineStream(entireLine);
+        int32_t values[5];
+        double fullness;
+        lineStream >> values[0] >> values[1] >> values[2] >> fullness >> values[4];
+        sumStream += values[0] + values[1] + values[2] + static_cast<int64_t>(fullness) + values[4];
+    }
+    auto durationStream = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start);
+
+    BOOST_CHECK_EQUAL(nbErrors, 0u);
+    BOOST_CHECK_EQUAL(sumTokenizer, sumStream);
+    BOOST_TEST_MESSAGE("1024x1024 tiles: tokenizer=" << durationTokenizer.count() << " ms, streams="
+        << durationStream.count() << " ms");
+}
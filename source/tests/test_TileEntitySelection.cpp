@@ -0,0 +1,232 @@
+/*
+ *  Copyright (C) 2011-2016  OpenDungeons Team
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#define BOOST_TEST_MODULE TileEntitySelection
+#include "BoostTestTargetConfig.h"
+
+#include "entities/TileEntitySelection.h"
+
+#include <algorithm>
+#include <chrono>
+#include <vector>
+
+// Minimal stubs providing what the selection filters use from the game classes
+struct StubSeat
+{
+    int mTeamId;
+    bool isAlliedSeat(const StubSeat* seat) const
+    { return mTeamId == seat->mTeamId; }
+};
+
+struct StubPlayer
+{
+    StubSeat* mSeat;
+    StubSeat* getSeat() const
+    { return mSeat; }
+};
+
+struct StubTile
+{
+};
+
+struct StubEntity
+{
+    GameEntityType mType;
+    StubSeat* mSeat;
+    GameEntityType getObjectType() const
+    { return mType; }
+    StubSeat* getSeat() const
+    { return mSeat; }
+};
+
+struct StubCreature : public StubEntity
+{
+    bool mIsAlive;
+    bool isAlive() const
+    { return mIsAlive; }
+};
+
+enum class StubSelection
+{
+    creatureAliveAllied,
+    creatureAliveEnemy,
+    creatureAliveOrDead
+};
+
+//! \brief Reference implementation: the selection is checked for each entity and every entity already
+//! in the vector is searched for duplicates (as Tile::fillWithEntities used to do)
+static void fillWithEntitiesSwitch(const std::vector<StubEntity*>& entitiesInTile, StubSelection selection,
+    StubPlayer* player, std::vector<StubEntity*>& entities)
+{
+    for(StubEntity* entity : entitiesInTile)
+    {
+        switch(selection)
+        {
+            case StubSelection::creatureAliveAllied:
+            {
+                if(entity->getObjectType() != GameEntityType::creature)
+                    continue;
+                if(entity->getSeat() == nullptr)
+                    continue;
+                if(!player->getSeat()->isAlliedSeat(entity->getSeat()))
+                    continue;
+                if(!static_cast<StubCreature*>(entity)->isAlive())
+                    continue;
+                break;
+            }
+            case StubSelection::creatureAliveEnemy:
+            {
+                if(entity->getObjectType() != GameEntityType::creature)
+                    continue;
+                if(entity->getSeat() == nullptr)
+                    continue;
+                if(player->getSeat()->isAlliedSeat(entity->getSeat()))
+                    continue;
+                if(!static_cast<StubCreature*>(entity)->isAlive())
+                    continue;
+                break;
+            }
+            case StubSelection::creatureAliveOrDead:
+            {
+                if(entity->getObjectType() != GameEntityType::creature)
+                    continue;
+                break;
+            }
+            default:
+                continue;
+        }
+
+        if(std::find(entities.begin(), entities.end(), entity) != entities.end())
+            continue;
+
+        entities.push_back(entity);
+    }
+}
+
+//! \brief Crowded tiles: each tile has creatures of 2 teams (some dead) and some other entities
+struct CrowdedTiles
+{
+    CrowdedTiles(uint32_t nbTiles, uint32_t nbEntitiesPerTile) :
+        mCreatures(nbTiles * nbEntitiesPerTile),
+        mTiles(nbTiles)
+    {
+        mSeats[0].mTeamId = 1;
+        mSeats[1].mTeamId = 2;
+        mPlayer.mSeat = &mSeats[0];
+        uint32_t index = 0;
+        for(std::vector<StubEntity*>& tile : mTiles)
+        {
+            for(uint32_t i = 0; i < nbEntitiesPerTile; ++i)
+            {
+                StubCreature& entity = mCreatures[index];
+                entity.mType = (index % 5 == 4) ? GameEntityType::treasuryObject : GameEntityType::creature;
+                entity.mSeat = &mSeats[(index / 3) % 2];
+                entity.mIsAlive = (index % 7 != 0);
+                tile.push_back(&entity);
+                ++index;
+            }
+        }
+    }
+
+    StubSeat mSeats[2];
+    StubPlayer mPlayer;
+    StubTile mTile;
+    std::vector<StubCreature> mCreatures;
+    std::vector<std::vector<StubEntity*>> mTiles;
+};
+
+BOOST_AUTO_TEST_CASE(test_TileEntitySelectionFilters)
+{
+    using namespace TileEntitySelection;
+    CrowdedTiles tiles(10, 40);
+
+    // The filters should select the same entities as the reference implementation
+    std::vector<StubEntity*> expected;
+    std::vector<StubEntity*> result;
+    for(const std::vector<StubEntity*>& tile : tiles.mTiles)
+    {
+        fillWithEntitiesSwitch(tile, StubSelection::creatureAliveEnemy, &tiles.mPlayer, expected);
+        fillWithFilteredEntities<SelectCreatureAlive<StubCreature, CreatureEnemy>>(tile, &tiles.mTile,
+            &tiles.mPlayer, result, false);
+    }
+    BOOST_CHECK(!result.empty());
+    BOOST_CHECK(result == expected);
+
+    expected.clear();
+    result.clear();
+    for(const std::vector<StubEntity*>& tile : tiles.mTiles)
+    {
+        fillWithEntitiesSwitch(tile, StubSelection::creatureAliveOrDead, &tiles.mPlayer, expected);
+        fillWithFilteredEntities<SelectType<GameEntityType::creature>>(tile, &tiles.mTile,
+            &tiles.mPlayer, result, false);
+    }
+    BOOST_CHECK(result == expected);
+
+    // Entities already in the vector are not added twice when checking duplicates
+    uint32_t nbNull = fillWithFilteredEntities<SelectType<GameEntityType::creature>>(tiles.mTiles[0], &tiles.mTile,
+        &tiles.mPlayer, result, true);
+    BOOST_CHECK(nbNull == 0);
+    BOOST_CHECK(result == expected);
+
+    // Null entities are skipped and counted
+    std::vector<StubEntity*> tileWithNull = { nullptr, tiles.mTiles[0][0] };
+    result.clear();
+    nbNull = fillWithFilteredEntities<SelectAny>(tileWithNull, &tiles.mTile, &tiles.mPlayer, result, true);
+    BOOST_CHECK(nbNull == 1);
+    BOOST_CHECK(result.size() == 1);
+}
+
+BOOST_AUTO_TEST_CASE(test_TileEntitySelectionCrowdedTiles)
+{
+    // Selects the allied and enemy creatures on 300 tiles with 40 entities each, as getVisibleForce does
+    // for a creature looking at a crowded battle, with the reference implementation and the filters
+    using namespace TileEntitySelection;
+    CrowdedTiles tiles(300, 40);
+    const uint32_t nbRuns = 20;
+
+    std::vector<StubEntity*> entities;
+    std::size_t nbSwitch = 0;
+    auto begin = std::chrono::steady_clock::now();
+    for(uint32_t run = 0; run < nbRuns; ++run)
+    {
+        entities.clear();
+        for(const std::vector<StubEntity*>& tile : tiles.mTiles)
+            fillWithEntitiesSwitch(tile, StubSelection::creatureAliveEnemy, &tiles.mPlayer, entities);
+        for(const std::vector<StubEntity*>& tile : tiles.mTiles)
+            fillWithEntitiesSwitch(tile, StubSelection::creatureAliveAllied, &tiles.mPlayer, entities);
+        nbSwitch += entities.size();
+    }
+    auto middle = std::chrono::steady_clock::now();
+    std::size_t nbFilters = 0;
+    for(uint32_t run = 0; run < nbRuns; ++run)
+    {
+        entities.clear();
+        for(const std::vector<StubEntity*>& tile : tiles.mTiles)
+            fillWithFilteredEntities<SelectCreatureAlive<StubCreature, CreatureEnemy>>(tile, &tiles.mTile,
+                &tiles.mPlayer, entities, false);
+        for(const std::vector<StubEntity*>& tile : tiles.mTiles)
+            fillWithFilteredEntities<SelectCreatureAlive<StubCreature, CreatureAllied>>(tile, &tiles.mTile,
+                &tiles.mPlayer, entities, false);
+        nbFilters += entities.size();
+    }
+    auto end = std::chrono::steady_clock::now();
+
+    BOOST_CHECK(nbSwitch == nbFilters);
+    BOOST_TEST_MESSAGE("Selected " << nbFilters << " entities on crowded tiles: "
+        << std::chrono::duration_cast<std::chrono::microseconds>(middle - begin).count() << " us with a switch per entity, "
+        << std::chrono::duration_cast<std::chrono::microseconds>(end - middle).count() << " us with the filters");
+}
@@ -0,0 +1,74 @@
+/*
+ *  Copyright (C) 2011-2016  OpenDungeons Team
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "utils/TurnArena.h"
+
+#define BOOST_TEST_MODULE TurnArena
+#include "BoostTestTargetConfig.h"
+
+#include <cstdint>
+
+BOOST_AUTO_TEST_CASE(test_TurnVectorGrowth)
+{
+    TurnArena arena(1024);
+    TurnVector<uint32_t> values(arena, 4);
+    for(uint32_t i = 0; i < 1000; ++i)
+        values.push_back(i);
+
+    BOOST_REQUIRE_EQUAL(values.size(), 1000u);
+    for(uint32_t i = 0; i < 1000; ++i)
+        BOOST_CHECK_EQUAL(values[i], i);
+
+    // Another allocation between two push_back forces a copy
+    TurnVector<uint64_t> other(arena, 2);
+    other.push_back(1);
+    TurnVector<uint64_t> between(arena, 1);
+    between.push_back(2);
+    for(uint64_t i = 0; i < 100; ++i)
+        other.push_back(i + 2);
+    TurnSpan<uint64_t> span = other.span();
+    BOOST_REQUIRE_EQUAL(span.size(), 101u);
+    BOOST_CHECK_EQUAL(span.front(), 1u);
+    BOOST_CHECK_EQUAL(span.back(), 101u);
+    BOOST_CHECK_EQUAL(between[0], 2u);
+}
+
+BOOST_AUTO_TEST_CASE(test_TurnArenaReuse)
+{
+    TurnArena arena(1024);
+    for(uint32_t turn = 0; turn < 10; ++turn)
+    {
+        for(uint32_t k = 0; k < 20; ++k)
+        {
+            uint64_t* values = arena.allocateArray<uint64_t>(16);
+            BOOST_REQUIRE((reinterpret_cast<uintptr_t>(values) % alignof(uint64_t)) == 0);
+            values[15] = k;
+        }
+        // Bigger than a block
+        arena.allocate(4096, 8);
+        arena.reset();
+        BOOST_CHECK_EQUAL(arena.getBytesUsed(), 0u);
+    }
+
+    // Once the first turn allocated the blocks, the next ones reuse them
+    std::size_t capacity = arena.getCapacity();
+    uint64_t nbBlocks = arena.getNbBlocksAllocated();
+    for(uint32_t k = 0; k < 20; ++k)
+        arena.allocateArray<uint64_t>(16);
+    arena.allocate(4096, 8);
+    BOOST_CHECK_EQUAL(arena.getCapacity(), capacity);
+    BOOST_CHECK_EQUAL(arena.getNbBlocksAllocated(), nbBlocks);
+}
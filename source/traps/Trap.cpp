@@ -38,9 +38,99 @@
 #include "utils/LogManager.h"
 #include "utils/Random.h"
 
+#include <algorithm>
 #include <istream>
 #include <ostream>
 
+//! \brief Listens to the tiles around a trap tile. It allows the trap to look for targets only when
+//! something changed in its range and caches the tiles visible from the trap tile
+class TrapTileWatcher : public TileStateListener
+{
+public:
+    TrapTileWatcher(GameMap& gameMap, Tile& trapTile, int32_t range) :
+        mGameMap(gameMap),
+        mTrapTile(trapTile),
+        mRange(range),
+        mWidth(2 * range + 1),
+        mIsAwake(true),
+        mIsVisibleTilesDirty(true)
+    {
+        // Out of map tiles are kept as nullptr so that the index of a tile can be computed from its coordinates
+        for(int32_t y = trapTile.getY() - range; y <= trapTile.getY() + range; ++y)
+        {
+            for(int32_t x = trapTile.getX() - range; x <= trapTile.getX() + range; ++x)
+            {
+                Tile* tile = gameMap.getTile(x, y);
+                mWatchedTiles.push_back(tile);
+                mPermitsVision.push_back((tile != nullptr) && tile->permitsVision());
+                if(tile != nullptr)
+                    tile->addTileStateListener(*this);
+            }
+        }
+    }
+
+    virtual ~TrapTileWatcher()
+    {
+        for(Tile* tile : mWatchedTiles)
+        {
+            if(tile != nullptr)
+                tile->removeTileStateListener(*this);
+        }
+    }
+
+    void tileStateChanged(Tile& tile) override
+    {
+        // Something happened in range (creature moving, tile dug, ...). The trap should look for a target
+        mIsAwake = true;
+
+        int32_t index = (tile.getX() - mTrapTile.getX() + mRange) + (tile.getY() - mTrapTile.getY() + mRange) * mWidth;
+        if((index < 0) || (index >= static_cast<int32_t>(mPermitsVision.size())))
+        {
+            OD_LOG_ERR("trapTile=" + Tile::displayAsString(&mTrapTile) + ", tile=" + Tile::displayAsString(&tile));
+            return;
+        }
+
+        bool permitsVision = tile.permitsVision();
+        if(mPermitsVision[index] == permitsVision)
+            return;
+
+        mPermitsVision[index] = permitsVision;
+        mIsVisibleTilesDirty = true;
+    }
+
+    inline bool isAwake() const
+    { return mIsAwake; }
+
+    inline void setAwake(bool awake)
+    { mIsAwake = awake; }
+
+    const std::vector<Tile*>& getVisibleTiles()
+    {
+        if(mIsVisibleTilesDirty)
+        {
+            mGameMap.visibleTiles(mTrapTile.getX(), mTrapTile.getY(), mRange, mVisibleTiles);
+            mIsVisibleTilesDirty = false;
+        }
+        return mVisibleTiles;
+    }
+
+private:
+    GameMap& mGameMap;
+    Tile& mTrapTile;
+    int32_t mRange;
+    int32_t mWidth;
+    bool mIsAwake;
+    bool mIsVisibleTilesDirty;
+
+    //! \brief Tiles in the square around the trap tile, row by row
+    std::vector<Tile*> mWatchedTiles;
+
+    //! \brief Vision state of mWatchedTiles when last notified. Used to know if mVisibleTiles is still valid
+    std::vector<bool> mPermitsVision;
+
+    std::vector<Tile*> mVisibleTiles;
+};
+
 void TrapTileData::fireSeatsSawTriggering()
 {
     if(mTrapEntity == nullptr)
@@ -77,6 +167,11 @@ Trap::Trap(GameMap* gameMap) :
 {
 }
 
+Trap::~Trap()
+{
+    clearTileWatchers();
+}
+
 GameEntityType Trap::getObjectType() const
 {
     return GameEntityType::trap;
@@ -103,6 +198,7 @@ void Trap::removeFromGameMap()
 
     removeAllBuildingObjects();
     getGameMap()->removeActiveObject(this);
+    clearTileWatchers();
 }
 
 void Trap::doUpkeep()
@@ -136,18 +232,28 @@ void Trap::doUpkeep()
         if(trapTileData->decreaseReloadTime())
             continue;
 
-        if(shoot(tile))
-        {
-            trapTileData->setReloadTime(mReloadTime);
-            if(!trapTileData->decreaseShoot())
-                deactivate(tile);
+        // If nothing changed in range since the last time the trap could not shoot, there is no need to check again
+        TrapTileWatcher* watcher = getTileWatcher(tile);
+        if((watcher != nullptr) && !watcher->isAwake())
+            continue;
 
-            const std::vector<Seat*>& seats = tile->getSeatsWithVision();
-            trapTileData->seatsSawTriggering(seats);
+        if(!shoot(tile))
+        {
+            if(watcher != nullptr)
+                watcher->setAwake(false);
 
-            for(Seat* seat : trapTileData->mSeatsVision)
-                seat->setVisibleBuildingOnTile(this, tile);
+            continue;
         }
+
+        trapTileData->setReloadTime(mReloadTime);
+        if(!trapTileData->decreaseShoot())
+            deactivate(tile);
+
+        const std::vector<Seat*>& seats = tile->getSeatsWithVision();
+        trapTileData->seatsSawTriggering(seats);
+
+        for(Seat* seat : trapTileData->mSeatsVision)
+            seat->setVisibleBuildingOnTile(this, tile);
     }
 }
 
@@ -180,6 +286,7 @@ bool Trap::removeCoveredTile(Tile* t)
 
     TrapTileData* trapTileData = static_cast<TrapTileData*>(mTileData.at(t));
     trapTileData->setRemoveTrap(true);
+    removeTileWatcher(t);
 
     return true;
 }
@@ -249,6 +356,10 @@ void Trap::activate(Tile* tile)
     trapTileData->setNbShootsBeforeDeactivation(mNbShootsBeforeDeactivation);
     trapTileData->setReloadTime(0);
 
+    auto it = mTileWatchers.find(tile);
+    if(it != mTileWatchers.end())
+        it->second->setAwake(true);
+
     BuildingObject* entity = getBuildingObjectFromTile(tile);
     if (entity == nullptr)
         return;
@@ -256,6 +367,49 @@ void Trap::activate(Tile* tile)
     entity->setMeshOpacity(1.0f);
 }
 
+const std::vector<Tile*>& Trap::getVisibleTilesInRange(Tile* tile)
+{
+    TrapTileWatcher* watcher = getTileWatcher(tile);
+    if(watcher != nullptr)
+        return watcher->getVisibleTiles();
+
+    getGameMap()->visibleTiles(tile->getX(), tile->getY(), std::max(getTriggerRange(), 0), mVisibleTilesWork);
+    return mVisibleTilesWork;
+}
+
+TrapTileWatcher* Trap::getTileWatcher(Tile* tile)
+{
+    auto it = mTileWatchers.find(tile);
+    if(it != mTileWatchers.end())
+        return it->second;
+
+    int32_t range = getTriggerRange();
+    if((range < 0) || !getIsOnServerMap())
+        return nullptr;
+
+    TrapTileWatcher* watcher = new TrapTileWatcher(*getGameMap(), *tile, range);
+    mTileWatchers[tile] = watcher;
+    return watcher;
+}
+
+void Trap::removeTileWatcher(Tile* tile)
+{
+    auto it = mTileWatchers.find(tile);
+    if(it == mTileWatchers.end())
+        return;
+
+    delete it->second;
+    mTileWatchers.erase(it);
+}
+
+void Trap::clearTileWatchers()
+{
+    for(std::pair<Tile* const, TrapTileWatcher*>& p : mTileWatchers)
+        delete p.second;
+
+    mTileWatchers.clear();
+}
+
 void Trap::deactivate(Tile* tile)
 {
     if (tile == nullptr)
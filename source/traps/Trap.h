@@ -35,6 +35,7 @@ class Player;
 class Seat;
 class Tile;
 class TrapEntity;
+class TrapTileWatcher;
 
 enum class TrapType;
 
@@ -163,8 +164,7 @@ class Trap : public Building
 {
 public:
     Trap(GameMap* gameMap);
-    virtual ~Trap()
-    {}
+    virtual ~Trap();
 
     virtual GameEntityType getObjectType() const override;
 
@@ -230,6 +230,16 @@ protected:
     //! \brief Triggered when the trap is activated
     void activate(Tile* tile);
 
+    //! \brief Range (in tiles) around a trap tile in which something can trigger it. If positive or null,
+    //! shoot will only be called when something changed in this range since the last time the trap tile
+    //! could not shoot. If negative, shoot is called every turn
+    virtual int32_t getTriggerRange() const
+    { return -1; }
+
+    //! \brief Returns the tiles visible from the given trap tile within getTriggerRange. The result is
+    //! cached and only computed again when a tile in range blocks or unblocks vision
+    const std::vector<Tile*>& getVisibleTilesInRange(Tile* tile);
+
     //! \brief Triggered when deactivated.
     virtual void deactivate(Tile* tile);
 
@@ -241,6 +251,20 @@ protected:
     //! List of traps destroyed but with at least 1 player having vision. They will
     //! get removed when vision is gained by every player having seen it before destruction
     std::vector<BuildingObject*> mTrapEntitiesWaitingRemove;
+
+private:
+    //! \brief Watchers listening to the tiles in range of the covered tiles. They are created (server side)
+    //! the first time a covered tile is checked
+    std::map<Tile*, TrapTileWatcher*> mTileWatchers;
+
+    //! \brief Used by getVisibleTilesInRange when no watcher can be used
+    std::vector<Tile*> mVisibleTilesWork;
+
+    //! \brief Returns the watcher for the given covered tile (and creates it if needed). Returns nullptr
+    //! if the trap is not triggered by what happens in its range
+    TrapTileWatcher* getTileWatcher(Tile* tile);
+    void removeTileWatcher(Tile* tile);
+    void clearTileWatchers();
 };
 
 #endif // TRAP_H
@@ -139,7 +139,7 @@ bool TrapBoulder::shoot(Tile* tile)
         return false;
 
     // We take a random tile and launch boulder it
-    Tile* tileChosen = tiles[Random::Uint(0, tiles.size() - 1)];
+    Tile* tileChosen = tiles[Random::Uint(Random::Stream::traps, 0, tiles.size() - 1)];
     // We launch the boulder
     Ogre::Vector3 direction(static_cast<Ogre::Real>(tileChosen->getX() - tile->getX()),
                             static_cast<Ogre::Real>(tileChosen->getY() - tile->getY()),
@@ -151,7 +151,7 @@ bool TrapBoulder::shoot(Tile* tile)
     direction.normalise();
     MissileBoulder* missile = new MissileBoulder(getGameMap(), getSeat(), getName(), "Boulder",
         direction, ConfigManager::getSingleton().getTrapConfigDouble("BoulderSpeed"),
-        Random::Double(mMinDamage, mMaxDamage), nullptr, true);
+        Random::Double(Random::Stream::traps, mMinDamage, mMaxDamage), nullptr, true);
     missile->addToGameMap();
     missile->createMesh();
     missile->setPosition(position);
@@ -45,6 +45,11 @@ public:
     virtual TrapEntity* getTrapEntity(Tile* tile) override;
 
     static const TrapType mTrapType;
+
+protected:
+    //! \brief The boulder is triggered by creatures on the neighbor tiles
+    virtual int32_t getTriggerRange() const override
+    { return 1; }
 };
 
 #endif // TRAPBOULDER_H
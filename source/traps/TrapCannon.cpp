@@ -128,14 +128,14 @@ TrapCannon::TrapCannon(GameMap* gameMap) :
 
 bool TrapCannon::shoot(Tile* tile)
 {
-    std::vector<Tile*> visibleTiles = getGameMap()->visibleTiles(tile->getX(), tile->getY(), mRange);
+    const std::vector<Tile*>& visibleTiles = getVisibleTilesInRange(tile);
     std::vector<GameEntity*> enemyObjects = getGameMap()->getVisibleCreatures(visibleTiles, getSeat(), true);
 
     if(enemyObjects.empty())
         return false;
 
     // Select an enemy to shoot at.
-    GameEntity* targetEnemy = enemyObjects[Random::Uint(0, enemyObjects.size()-1)];
+    GameEntity* targetEnemy = enemyObjects[Random::Uint(Random::Stream::traps, 0, enemyObjects.size()-1)];
 
     // Create the cannonball to move toward the enemy creature.
     Ogre::Vector3 direction(static_cast<Ogre::Real>(targetEnemy->getCoveredTile(0)->getX()),
@@ -150,7 +150,7 @@ bool TrapCannon::shoot(Tile* tile)
     direction.normalise();
     MissileOneHit* missile = new MissileOneHit(getGameMap(), getSeat(), getName(), "Cannonball",
         "", direction, ConfigManager::getSingleton().getTrapConfigDouble("CannonSpeed"),
-        Random::Double(mMinDamage, mMaxDamage), 0.0, 0.0, nullptr, false, false, true);
+        Random::Double(Random::Stream::traps, mMinDamage, mMaxDamage), 0.0, 0.0, nullptr, false, false, true);
     missile->addToGameMap();
     missile->createMesh();
     missile->setPosition(position);
@@ -48,6 +48,10 @@ public:
 
     static const TrapType mTrapType;
 
+protected:
+    virtual int32_t getTriggerRange() const override
+    { return static_cast<int32_t>(mRange); }
+
 private:
     uint32_t mRange;
 };
@@ -356,7 +356,14 @@ void TrapDoor::doUpkeep()
             changeDoorState(doorEntity, tile, mIsLocked);
         }
     }
+    bool isLockedStateChanged = (mIsLockedState != mIsLocked);
     mIsLockedState = mIsLocked;
+    // Locking or unlocking the door changes the vision through it
+    if(isLockedStateChanged)
+    {
+        for(Tile* tile : mCoveredTiles)
+            tile->fireTileStateChanged();
+    }
 
     Trap::doUpkeep();
 }
@@ -367,6 +374,7 @@ void TrapDoor::notifyDoorSlapped(DoorEntity* doorEntity, Tile* tile)
     changeDoorState(doorEntity, tile, mIsLocked);
 
     mIsLockedState = mIsLocked;
+    tile->fireTileStateChanged();
 }
 
 void TrapDoor::changeDoorState(DoorEntity* doorEntity, Tile* tile, bool locked)
@@ -46,6 +46,11 @@ public:
     virtual TrapEntity* getTrapEntity(Tile* tile) override;
 
     static const TrapType mTrapType;
+
+protected:
+    //! \brief The spikes are triggered by creatures on the trap tile
+    virtual int32_t getTriggerRange() const override
+    { return 0; }
 };
 
 #endif // TRAPSPIKE_H
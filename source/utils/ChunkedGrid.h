@@ -0,0 +1,187 @@
+/*
+ *  Copyright (C) 2011-2016  OpenDungeons Team
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef CHUNKEDGRID_H
+#define CHUNKEDGRID_H
+
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+//! \brief Sparse 2D grid split in square chunks of CHUNK_SIZE x CHUNK_SIZE cells. A chunk is only
+//! allocated when one of its cells is first accessed through get. That allows to store per tile data
+//! on very big maps while only paying memory for the regions really used.
+//! Note that the cells of the last chunks can be outside the grid. They are never given to the callers.
+template<typename T, int ChunkShift = 4>
+class ChunkedGrid
+{
+public:
+    static const int CHUNK_SIZE = 1 << ChunkShift;
+
+    ChunkedGrid() :
+        mSizeX(0),
+        mSizeY(0),
+        mNbChunksX(0),
+        mNbChunksY(0),
+        mNbChunksAllocated(0)
+    {}
+
+    //! \brief Releases all the chunks and sets the new grid size
+    void reset(int sizeX, int sizeY)
+    {
+        mSizeX = sizeX;
+        mSizeY = sizeY;
+        mNbChunksX = (sizeX + CHUNK_SIZE - 1) >> ChunkShift;
+        mNbChunksY = (sizeY + CHUNK_SIZE - 1) >> ChunkShift;
+        mChunks.clear();
+        mChunks.resize(static_cast<std::size_t>(mNbChunksX * mNbChunksY));
+        mNbChunksAllocated = 0;
+    }
+
+    inline int getSizeX() const
+    { return mSizeX; }
+
+    inline int getSizeY() const
+    { return mSizeY; }
+
+    inline int getNbChunks() const
+    { return mNbChunksX * mNbChunksY; }
+
+    inline bool isInside(int x, int y) const
+    { return (x >= 0) && (y >= 0) && (x < mSizeX) && (y < mSizeY); }
+
+    //! \brief Returns the index of the chunk containing the given cell. The cell must be inside the grid
+    inline int getChunkIndex(int x, int y) const
+    { return (x >> ChunkShift) * mNbChunksY + (y >> ChunkShift); }
+
+    inline bool isChunkAllocated(int chunkIndex) const
+    { return mChunks[chunkIndex] != nullptr; }
+
+    //! \brief Returns the cell at the given position or nullptr if it is outside the grid or if
+    //! its chunk is not allocated
+    const T* find(int x, int y) const
+    {
+        if(!isInside(x, y))
+            return nullptr;
+
+        const Chunk* chunk = mChunks[getChunkIndex(x, y)].get();
+        if(chunk == nullptr)
+            return nullptr;
+
+        return &chunk->mCells[getCellIndex(x, y)];
+    }
+
+    T* find(int x, int y)
+    {
+        return const_cast<T*>(static_cast<const ChunkedGrid*>(this)->find(x, y));
+    }
+
+    //! \brief Returns the cell at the given position (or nullptr if it is outside the grid). If its chunk
+    //! is not allocated, it is allocated and init(x, y, cell) is called for each of its cells inside the grid
+    template<typename Init>
+    T* get(int x, int y, Init init)
+    {
+        if(!isInside(x, y))
+            return nullptr;
+
+        std::unique_ptr<Chunk>& chunk = mChunks[getChunkIndex(x, y)];
+        if(chunk == nullptr)
+        {
+            chunk.reset(new Chunk);
+            ++mNbChunksAllocated;
+            int startX = (x >> ChunkShift) << ChunkShift;
+            int startY = (y >> ChunkShift) << ChunkShift;
+            for(int xx = startX; (xx < startX + CHUNK_SIZE) && (xx < mSizeX); ++xx)
+            {
+                for(int yy = startY; (yy < startY + CHUNK_SIZE) && (yy < mSizeY); ++yy)
+                    init(xx, yy, chunk->mCells[getCellIndex(xx, yy)]);
+            }
+        }
+
+        return &chunk->mCells[getCellIndex(x, y)];
+    }
+
+    //! \brief Calls f(x, y, cell) for each cell inside the grid of the given chunk if it is allocated
+    template<typename F>
+    void forEachInChunk(int chunkIndex, F f)
+    {
+        Chunk* chunk = mChunks[chunkIndex].get();
+        if(chunk == nullptr)
+            return;
+
+        int startX = (chunkIndex / mNbChunksY) << ChunkShift;
+        int startY = (chunkIndex % mNbChunksY) << ChunkShift;
+        for(int xx = startX; (xx < startX + CHUNK_SIZE) && (xx < mSizeX); ++xx)
+        {
+            for(int yy = startY; (yy < startY + CHUNK_SIZE) && (yy < mSizeY); ++yy)
+                f(xx, yy, chunk->mCells[getCellIndex(xx, yy)]);
+        }
+    }
+
+    template<typename F>
+    void forEachInChunk(int chunkIndex, F f) const
+    {
+        const_cast<ChunkedGrid*>(this)->forEachInChunk(chunkIndex,
+            [&f](int x, int y, T& cell) { f(x, y, static_cast<const T&>(cell)); });
+    }
+
+    //! \brief Calls f(x, y, cell) for each cell inside the grid of the allocated chunks. Cells are
+    //! processed chunk by chunk
+    template<typename F>
+    void forEach(F f)
+    {
+        int nbChunks = getNbChunks();
+        for(int chunkIndex = 0; chunkIndex < nbChunks; ++chunkIndex)
+            forEachInChunk(chunkIndex, f);
+    }
+
+    template<typename F>
+    void forEach(F f) const
+    {
+        int nbChunks = getNbChunks();
+        for(int chunkIndex = 0; chunkIndex < nbChunks; ++chunkIndex)
+            forEachInChunk(chunkIndex, f);
+    }
+
+    inline int getNbChunksAllocated() const
+    { return mNbChunksAllocated; }
+
+    //! \brief Returns the memory used by the grid in bytes (allocated chunks and chunk index)
+    std::size_t getMemoryUsed() const
+    {
+        return static_cast<std::size_t>(mNbChunksAllocated) * sizeof(Chunk)
+            + mChunks.capacity() * sizeof(std::unique_ptr<Chunk>);
+    }
+
+private:
+    struct Chunk
+    {
+        T mCells[CHUNK_SIZE * CHUNK_SIZE];
+    };
+
+    static inline int getCellIndex(int x, int y)
+    { return ((x & (CHUNK_SIZE - 1)) << ChunkShift) | (y & (CHUNK_SIZE - 1)); }
+
+    int mSizeX;
+    int mSizeY;
+    int mNbChunksX;
+    int mNbChunksY;
+    int mNbChunksAllocated;
+    std::vector<std::unique_ptr<Chunk>> mChunks;
+};
+
+#endif // CHUNKEDGRID_H
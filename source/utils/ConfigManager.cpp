@@ -25,10 +25,13 @@
 #include "spawnconditions/SpawnCondition.h"
 #include "utils/Helper.h"
 #include "utils/LogManager.h"
+#include "utils/TextTokenizer.h"
 
 #include <boost/dynamic_bitset.hpp>
 #include <OgreRoot.h>
 
+#include <chrono>
+
 const std::vector<std::string> EMPTY_SPAWNPOOL;
 const std::string EMPTY_STRING;
 const Ogre::ColourValue DEFAULT_SEAT_COLOURVALUE;
@@ -56,12 +59,19 @@ ConfigManager::ConfigManager(const std::string& configPath, const std::string& u
     mSlapDamagePercent(15),
     mSlapEffectDuration(15),
     mTimePayDay(300),
+    mAutosavePeriodTurns(0),
     mNbTurnsFuriousMax(120),
     mMaxManaPerSeat(250000.0),
     mClaimingWallPenalty(0.8),
     mDigCoefGold(5.0),
     mDigCoefGem(1.0),
     mDigCoefClaimedWall(0.5),
+    mDigPathCostFullTile(4.0),
+    mDigPathPenaltyGold(2.0),
+    mDigPathPenaltyClaimedWall(8.0),
+    mDigPathNodeBudget(20000),
+    mMemoryReportPeriod(600),
+    mAITurnBudgetMicroseconds(10000),
     mNbTurnsKoCreatureAttacked(10),
     mCreatureDefinitionDefaultWorker(nullptr),
     mNbWorkersDigSameFaceTile(2),
@@ -70,6 +80,7 @@ ConfigManager::ConfigManager(const std::string& configPath, const std::string& u
     // TODO: it might be better to go through the creature definitions and try to pickup the first worker we can find
     mCreatureDefinitionDefaultWorker = new CreatureDefinition(DefaultWorkerCreatureDefinition,
         CreatureDefinition::CreatureJob::Worker, "Kobold.mesh");
+    std::chrono::steady_clock::time_point startTime = std::chrono::steady_clock::now();
     if(!loadGlobalConfig(configPath))
     {
         OD_LOG_ERR("Couldn't read loadCreatureDefinitions");
@@ -129,6 +140,9 @@ ConfigManager::ConfigManager(const std::string& configPath, const std::string& u
         OD_LOG_ERR("Couldn't read loadTilesets");
         exit(1);
     }
+    std::chrono::milliseconds duration = std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::steady_clock::now() - startTime);
+    OD_LOG_INF("Config files read in " + Helper::toString(static_cast<uint64_t>(duration.count())) + " ms");
 
     // Reserve space in any case.
     mUserConfig.resize(Config::Ctg::TOTAL);
@@ -173,9 +187,9 @@ ConfigManager::~ConfigManager()
 
 bool ConfigManager::loadGlobalConfig(const std::string& configPath)
 {
-    std::stringstream configFile;
+    TextTokenizer configFile;
     std::string fileName = configPath + "global.cfg";
-    if(!Helper::readFileWithoutComments(fileName, configFile))
+    if(!configFile.loadFile(fileName))
     {
         OD_LOG_ERR("Couldn't read " + fileName);
         return false;
@@ -225,7 +239,7 @@ bool ConfigManager::loadGlobalConfig(const std::string& configPath)
     return true;
 }
 
-bool ConfigManager::loadGlobalConfigDefinitionFiles(std::stringstream& configFile)
+bool ConfigManager::loadGlobalConfigDefinitionFiles(TextTokenizer& configFile)
 {
     std::string nextParam;
     uint32_t filesOk = 0;
@@ -333,7 +347,7 @@ bool ConfigManager::loadGlobalConfigDefinitionFiles(std::stringstream& configFil
     return true;
 }
 
-bool ConfigManager::loadGlobalConfigSeatColors(std::stringstream& configFile)
+bool ConfigManager::loadGlobalConfigSeatColors(TextTokenizer& configFile)
 {
     std::string nextParam;
     while(configFile.good())
@@ -425,7 +439,7 @@ bool ConfigManager::loadGlobalConfigSeatColors(std::stringstream& configFile)
     return true;
 }
 
-bool ConfigManager::loadGlobalGameConfig(std::stringstream& configFile)
+bool ConfigManager::loadGlobalGameConfig(TextTokenizer& configFile)
 {
     std::string nextParam;
     uint32_t paramsOk = 0;
@@ -493,6 +507,13 @@ bool ConfigManager::loadGlobalGameConfig(std::stringstream& configFile)
             // Not mandatory
         }
 
+        if(nextParam == "AutosavePeriodTurns")
+        {
+            configFile >> nextParam;
+            mAutosavePeriodTurns = Helper::toUInt32(nextParam);
+            // Not mandatory
+        }
+
         if(nextParam == "NbTurnsFuriousMax")
         {
             configFile >> nextParam;
@@ -535,6 +556,48 @@ bool ConfigManager::loadGlobalGameConfig(std::stringstream& configFile)
             // Not mandatory
         }
 
+        if(nextParam == "DigPathCostFullTile")
+        {
+            configFile >> nextParam;
+            mDigPathCostFullTile = Helper::toDouble(nextParam);
+            // Not mandatory
+        }
+
+        if(nextParam == "DigPathPenaltyGold")
+        {
+            configFile >> nextParam;
+            mDigPathPenaltyGold = Helper::toDouble(nextParam);
+            // Not mandatory
+        }
+
+        if(nextParam == "DigPathPenaltyClaimedWall")
+        {
+            configFile >> nextParam;
+            mDigPathPenaltyClaimedWall = Helper::toDouble(nextParam);
+            // Not mandatory
+        }
+
+        if(nextParam == "DigPathNodeBudget")
+        {
+            configFile >> nextParam;
+            mDigPathNodeBudget = Helper::toUInt32(nextParam);
+            // Not mandatory
+        }
+
+        if(nextParam == "MemoryReportPeriod")
+        {
+            configFile >> nextParam;
+            mMemoryReportPeriod = Helper::toUInt32(nextParam);
+            // Not mandatory
+        }
+
+        if(nextParam == "AITurnBudgetMicroseconds")
+        {
+            configFile >> nextParam;
+            mAITurnBudgetMicroseconds = Helper::toUInt32(nextParam);
+            // Not mandatory
+        }
+
         if(nextParam == "CreatureBaseMood")
         {
             configFile >> nextParam;
@@ -593,12 +656,12 @@ bool ConfigManager::loadGlobalGameConfig(std::stringstream& configFile)
 
         if(nextParam == "MainMenuMusic")
         {
-            std::string line;
-            std::getline(configFile, line);
-            std::vector<std::string> elements = Helper::split(line, '\t', true);
+            TextView line;
+            configFile.restOfLine(line);
+            std::vector<std::string> elements = Helper::split(line.toString(), '\t', true);
             if (elements.empty())
             {
-                OD_LOG_WRN("Invalid MainMenuMusic : " + line);
+                OD_LOG_WRN("Invalid MainMenuMusic : " + line.toString());
                 continue;
             }
             mMainMenuMusic = elements[0];
@@ -624,8 +687,8 @@ bool ConfigManager::loadGlobalGameConfig(std::stringstream& configFile)
 bool ConfigManager::loadCreatureDefinitions(const std::string& fileName)
 {
     OD_LOG_INF("Load creature definition file: " + fileName);
-    std::stringstream defFile;
-    if(!Helper::readFileWithoutComments(fileName, defFile))
+    TextTokenizer defFile;
+    if(!defFile.loadFile(fileName))
     {
         OD_LOG_ERR("Couldn't read " + fileName);
         return false;
@@ -640,6 +703,7 @@ bool ConfigManager::loadCreatureDefinitions(const std::string& fileName)
         return false;
     }
 
+    TextView defBlock;
     while(defFile.good())
     {
         if(!(defFile >> nextParam))
@@ -659,7 +723,13 @@ bool ConfigManager::loadCreatureDefinitions(const std::string& fileName)
         }
 
         // Load the creature definition until a [/Creature] tag is found
-        CreatureDefinition* creatureDef = CreatureDefinition::load(defFile, mCreatureDefs);
+        if(!defFile.nextBlock("[/Creature]", defBlock))
+        {
+            OD_LOG_ERR("Missing [/Creature] tag");
+            return false;
+        }
+        TextTokenizer defStream(defBlock);
+        CreatureDefinition* creatureDef = CreatureDefinition::load(defStream, mCreatureDefs);
         if (creatureDef == nullptr)
         {
             OD_LOG_ERR("Invalid Creature classes start format");
@@ -674,8 +744,8 @@ bool ConfigManager::loadCreatureDefinitions(const std::string& fileName)
 bool ConfigManager::loadEquipements(const std::string& fileName)
 {
     OD_LOG_INF("Load weapon definition file: " + fileName);
-    std::stringstream defFile;
-    if(!Helper::readFileWithoutComments(fileName, defFile))
+    TextTokenizer defFile;
+    if(!defFile.loadFile(fileName))
     {
         OD_LOG_ERR("Couldn't read " + fileName);
         return false;
@@ -690,6 +760,7 @@ bool ConfigManager::loadEquipements(const std::string& fileName)
         return false;
     }
 
+    TextView defBlock;
     while(defFile.good())
     {
         if(!(defFile >> nextParam))
@@ -708,7 +779,13 @@ bool ConfigManager::loadEquipements(const std::string& fileName)
         }
 
         // Load the definition
-        Weapon* weapon = Weapon::load(defFile);
+        if(!defFile.nextBlock("[/Equipment]", defBlock))
+        {
+            OD_LOG_ERR("Missing [/Equipment] tag");
+            return false;
+        }
+        TextTokenizer defStream(defBlock);
+        Weapon* weapon = Weapon::load(defStream);
         if (weapon == nullptr)
         {
             OD_LOG_ERR("Invalid Weapon definition format");
@@ -723,8 +800,8 @@ bool ConfigManager::loadEquipements(const std::string& fileName)
 bool ConfigManager::loadSpawnConditions(const std::string& fileName)
 {
     OD_LOG_INF("Load creature spawn conditions file: " + fileName);
-    std::stringstream defFile;
-    if(!Helper::readFileWithoutComments(fileName, defFile))
+    TextTokenizer defFile;
+    if(!defFile.loadFile(fileName))
     {
         OD_LOG_ERR("Couldn't read " + fileName);
         return false;
@@ -739,6 +816,7 @@ bool ConfigManager::loadSpawnConditions(const std::string& fileName)
         return false;
     }
 
+    TextView defBlock;
     while(defFile.good())
     {
         if(!(defFile >> nextParam))
@@ -793,7 +871,13 @@ bool ConfigManager::loadSpawnConditions(const std::string& fileName)
             }
 
             // Load the definition
-            SpawnCondition* def = SpawnCondition::load(defFile);
+            if(!defFile.nextBlock("[/Condition]", defBlock))
+            {
+                OD_LOG_ERR("Missing [/Condition] tag");
+                return false;
+            }
+            TextTokenizer defStream(defBlock);
+            SpawnCondition* def = SpawnCondition::load(defStream);
             if (def == nullptr)
             {
                 OD_LOG_ERR("Invalid creature spawn condition format");
@@ -809,8 +893,8 @@ bool ConfigManager::loadSpawnConditions(const std::string& fileName)
 bool ConfigManager::loadFactions(const std::string& fileName)
 {
     OD_LOG_INF("Load factions file: " + fileName);
-    std::stringstream defFile;
-    if(!Helper::readFileWithoutComments(fileName, defFile))
+    TextTokenizer defFile;
+    if(!defFile.loadFile(fileName))
     {
         OD_LOG_ERR("Couldn't read " + fileName);
         return false;
@@ -920,8 +1004,8 @@ bool ConfigManager::loadFactions(const std::string& fileName)
 bool ConfigManager::loadRooms(const std::string& fileName)
 {
     OD_LOG_INF("Load Rooms file: " + fileName);
-    std::stringstream defFile;
-    if(!Helper::readFileWithoutComments(fileName, defFile))
+    TextTokenizer defFile;
+    if(!defFile.loadFile(fileName))
     {
         OD_LOG_ERR("Couldn't read " + fileName);
         return false;
@@ -953,8 +1037,8 @@ bool ConfigManager::loadRooms(const std::string& fileName)
 bool ConfigManager::loadTraps(const std::string& fileName)
 {
     OD_LOG_INF("Load traps file: " + fileName);
-    std::stringstream defFile;
-    if(!Helper::readFileWithoutComments(fileName, defFile))
+    TextTokenizer defFile;
+    if(!defFile.loadFile(fileName))
     {
         OD_LOG_ERR("Couldn't read " + fileName);
         return false;
@@ -986,8 +1070,8 @@ bool ConfigManager::loadTraps(const std::string& fileName)
 bool ConfigManager::loadSpellConfig(const std::string& fileName)
 {
     OD_LOG_INF("Load Spell config file: " + fileName);
-    std::stringstream defFile;
-    if(!Helper::readFileWithoutComments(fileName, defFile))
+    TextTokenizer defFile;
+    if(!defFile.loadFile(fileName))
     {
         OD_LOG_ERR("Couldn't read " + fileName);
         return false;
@@ -1019,8 +1103,8 @@ bool ConfigManager::loadSpellConfig(const std::string& fileName)
 bool ConfigManager::loadSkills(const std::string& fileName)
 {
     OD_LOG_INF("Load Skills file: " + fileName);
-    std::stringstream defFile;
-    if(!Helper::readFileWithoutComments(fileName, defFile))
+    TextTokenizer defFile;
+    if(!defFile.loadFile(fileName))
     {
         OD_LOG_ERR("Couldn't read " + fileName);
         return false;
@@ -1051,8 +1135,8 @@ bool ConfigManager::loadSkills(const std::string& fileName)
 bool ConfigManager::loadTilesets(const std::string& fileName)
 {
     OD_LOG_INF("Load Tilesets file: " + fileName);
-    std::stringstream defFile;
-    if(!Helper::readFileWithoutComments(fileName, defFile))
+    TextTokenizer defFile;
+    if(!defFile.loadFile(fileName))
     {
         OD_LOG_ERR("Couldn't read " + fileName);
         return false;
@@ -1160,7 +1244,7 @@ bool ConfigManager::loadTilesets(const std::string& fileName)
     return true;
 }
 
-bool ConfigManager::loadTilesetValues(std::istream& defFile, TileVisual tileVisual, std::vector<TileSetValue>& tileValues)
+bool ConfigManager::loadTilesetValues(TextTokenizer& defFile, TileVisual tileVisual, std::vector<TileSetValue>& tileValues)
 {
     std::string nextParam;
     std::string beginTag = "[" + Tile::tileVisualToString(tileVisual) + "]";
@@ -1216,8 +1300,8 @@ void ConfigManager::loadUserConfig(const std::string& fileName)
     mFilenameUserCfg = fileName;
 
     OD_LOG_INF("Load user config file: " + fileName);
-    std::stringstream defFile;
-    if(!Helper::readFileWithoutComments(fileName, defFile))
+    TextTokenizer defFile;
+    if(!defFile.loadFile(fileName))
     {
         OD_LOG_INF("Couldn't read " + fileName);
         return;
@@ -1234,70 +1318,58 @@ void ConfigManager::loadUserConfig(const std::string& fileName)
         return;
     }
 
-    std::string value;
+    // The parameter names can contain spaces so the file is read line by line
+    TextView line;
     Config::Ctg category = Config::Ctg::NONE;
-    while(defFile.good())
+    while(defFile.nextLine(line))
     {
-        if (!(defFile >> nextParam))
+        if (line == "[/Configuration]")
         {
             break;
         }
-        else if (nextParam == "[/Configuration]")
-        {
-            break;
-        }
-        else if (nextParam == "[Audio]")
+        else if (line == "[Audio]")
         {
             category = Config::Ctg::AUDIO;
             continue;
         }
-        else if (nextParam == "[Video]")
+        else if (line == "[Video]")
         {
             category = Config::Ctg::VIDEO;
             continue;
         }
-        else if (nextParam == "[Input]")
+        else if (line == "[Input]")
         {
             category = Config::Ctg::INPUT;
             continue;
         }
-        else if (nextParam == "[Game]")
+        else if (line == "[Game]")
         {
             category = Config::Ctg::GAME;
             continue;
         }
-        else if (nextParam == "[/Audio]" || nextParam == "[/Video]" || nextParam == "[/Input]"
-                 || nextParam == "[/Game]")
+        else if (line == "[/Audio]" || line == "[/Video]" || line == "[/Input]"
+                 || line == "[/Game]")
         {
             category = Config::Ctg::NONE;
             continue;
         }
-        else if (!nextParam.empty())
-        {
-            std::string line;
-            std::getline(defFile, line);
-            // Make sure to cut the line only when encountering a tab.
-            line = nextParam + line;
-            std::vector<std::string> elements = Helper::split(line, '\t');
-            if (elements.size() != 2)
-            {
-                OD_LOG_WRN("Invalid parameter line: " + line);
-                continue;
-            }
 
-            if (category == Config::Ctg::NONE)
-            {
-                OD_LOG_WRN("Parameter set in unknown category. Will be ignored: "
-                            + elements[0] + ": " + elements[1]);
-                continue;
-            }
-
-            mUserConfig[ category ][ elements[0] ] = elements[1];
+        // Make sure to cut the line only when encountering a tab.
+        std::vector<std::string> elements = Helper::split(line.toString(), '\t');
+        if (elements.size() != 2)
+        {
+            OD_LOG_WRN("Invalid parameter line: " + line.toString());
+            continue;
         }
-        else
+
+        if (category == Config::Ctg::NONE)
         {
+            OD_LOG_WRN("Parameter set in unknown category. Will be ignored: "
+                        + elements[0] + ": " + elements[1]);
             continue;
         }
+
+        mUserConfig[ category ][ elements[0] ] = elements[1];
     }
 }
 
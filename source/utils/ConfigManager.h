@@ -27,6 +27,7 @@ class CreatureDefinition;
 class Weapon;
 class SpawnCondition;
 class Skill;
+class TextTokenizer;
 class TileSet;
 class TileSetValue;
 
@@ -124,6 +125,10 @@ public:
     inline int64_t getTimePayDay() const
     { return mTimePayDay; }
 
+    //! \brief Number of turns between 2 autosaves. 0 if autosave is disabled
+    inline uint32_t getAutosavePeriodTurns() const
+    { return mAutosavePeriodTurns; }
+
     inline uint32_t getNetworkPort() const
     { return mNetworkPort; }
 
@@ -151,6 +156,25 @@ public:
     inline double getDigCoefClaimedWall() const
     { return mDigCoefClaimedWall; }
 
+    //! \brief Costs used when searching a path through diggable tiles (see GameMap::path and AIDigPath)
+    inline double getDigPathCostFullTile() const
+    { return mDigPathCostFullTile; }
+
+    inline double getDigPathPenaltyGold() const
+    { return mDigPathPenaltyGold; }
+
+    inline double getDigPathPenaltyClaimedWall() const
+    { return mDigPathPenaltyClaimedWall; }
+
+    inline uint32_t getDigPathNodeBudget() const
+    { return mDigPathNodeBudget; }
+
+    inline uint32_t getMemoryReportPeriod() const
+    { return mMemoryReportPeriod; }
+
+    inline uint32_t getAITurnBudgetMicroseconds() const
+    { return mAITurnBudgetMicroseconds; }
+
     inline int32_t getNbTurnsKoCreatureAttacked() const
     { return mNbTurnsKoCreatureAttacked; }
 
@@ -248,9 +272,9 @@ private:
     //! \brief Function used to load the global configuration. They should return true if the configuration
     //! is ok and false if a mandatory parameter is missing
     bool loadGlobalConfig(const std::string& configPath);
-    bool loadGlobalConfigSeatColors(std::stringstream& configFile);
-    bool loadGlobalConfigDefinitionFiles(std::stringstream& configFile);
-    bool loadGlobalGameConfig(std::stringstream& configFile);
+    bool loadGlobalConfigSeatColors(TextTokenizer& configFile);
+    bool loadGlobalConfigDefinitionFiles(TextTokenizer& configFile);
+    bool loadGlobalGameConfig(TextTokenizer& configFile);
     bool loadCreatureDefinitions(const std::string& fileName);
     bool loadEquipements(const std::string& fileName);
     bool loadSpawnConditions(const std::string& fileName);
@@ -260,7 +284,7 @@ private:
     bool loadSpellConfig(const std::string& fileName);
     bool loadSkills(const std::string& fileName);
     bool loadTilesets(const std::string& fileName);
-    bool loadTilesetValues(std::istream& defFile, TileVisual tileVisual, std::vector<TileSetValue>& tileValues);
+    bool loadTilesetValues(TextTokenizer& defFile, TileVisual tileVisual, std::vector<TileSetValue>& tileValues);
 
     //! \brief Loads the user configuration values, and use default ones if it cannot do it.
     void loadUserConfig(const std::string& fileName);
@@ -300,12 +324,19 @@ private:
     double mSlapDamagePercent;
     uint32_t mSlapEffectDuration;
     int64_t mTimePayDay;
+    uint32_t mAutosavePeriodTurns;
     int32_t mNbTurnsFuriousMax;
     double mMaxManaPerSeat;
     double mClaimingWallPenalty;
     double mDigCoefGold;
     double mDigCoefGem;
     double mDigCoefClaimedWall;
+    double mDigPathCostFullTile;
+    double mDigPathPenaltyGold;
+    double mDigPathPenaltyClaimedWall;
+    uint32_t mDigPathNodeBudget;
+    uint32_t mMemoryReportPeriod;
+    uint32_t mAITurnBudgetMicroseconds;
     int32_t mNbTurnsKoCreatureAttacked;
     std::string mDefaultWorkerRogue;
     std::string mMainMenuMusic;
@@ -30,6 +30,7 @@
 #include <boost/algorithm/string/trim.hpp>
 #include <boost/filesystem.hpp>
 
+#include <cstdlib>
 #include <iomanip>
 #include <fstream>
 
@@ -54,18 +55,13 @@ namespace Helper
 
     int toInt(const std::string& text)
     {
-        std::stringstream ss(text);
-        int number = 0;
-        ss >> number;
-        return number;
+        // strtol does not need to build a stream like operator>> (these are called a lot when loading configs)
+        return static_cast<int>(std::strtol(text.c_str(), nullptr, 10));
     }
 
     uint32_t toUInt32(const std::string& text)
     {
-        std::stringstream ss(text);
-        uint32_t number = 0;
-        ss >> number;
-        return number;
+        return static_cast<uint32_t>(std::strtoul(text.c_str(), nullptr, 10));
     }
 
     float toFloat(const std::string& text)
@@ -164,27 +160,52 @@ namespace Helper
     bool readFileWithoutComments(const std::string& fileName, std::stringstream& stream)
     {
         // Try to open the input file for reading and throw an error if we can't.
-        std::ifstream baseLevelFile(fileName.c_str(), std::ifstream::in);
+        std::ifstream baseLevelFile(fileName.c_str(), std::ifstream::in | std::ifstream::binary);
         if (!baseLevelFile.good())
         {
             OD_LOG_WRN("File not found=" + fileName);
             return false;
         }
 
-        // Read in the whole baseLevelFile, strip it of comments and feed it into
-        // the stream.
-        std::string nextParam;
-        while (baseLevelFile.good())
+        // Read in the whole baseLevelFile with one read
+        baseLevelFile.seekg(0, std::ios::end);
+        std::streamoff fileSize = baseLevelFile.tellg();
+        baseLevelFile.seekg(0, std::ios::beg);
+        std::string content;
+        if(fileSize > 0)
         {
-            std::getline(baseLevelFile, nextParam);
-            /* Find the first occurrence of the comment symbol on the
-             * line and return everything before that character.
-             */
-            stream << nextParam.substr(0, nextParam.find('#')) << "\n";
+            content.resize(static_cast<size_t>(fileSize));
+            baseLevelFile.read(&content[0], fileSize);
+            content.resize(static_cast<size_t>(baseLevelFile.gcount()));
         }
-
         baseLevelFile.close();
 
+        // Strip it of comments in place: everything from the comment symbol to the end
+        // of the line is skipped. Then, the stream takes the content in one go
+        bool isComment = false;
+        size_t dest = 0;
+        for(size_t src = 0; src < content.size(); ++src)
+        {
+            char c = content[src];
+            // The file is read in binary mode so we drop the carriage returns ourselves
+            if(c == '\r')
+                continue;
+
+            if(c == '\n')
+                isComment = false;
+            else if(c == '#')
+                isComment = true;
+
+            if(isComment)
+                continue;
+
+            content[dest] = c;
+            ++dest;
+        }
+        content.resize(dest);
+        content += '\n';
+
+        stream.str(content);
         return true;
     }
 
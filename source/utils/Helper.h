@@ -118,7 +118,7 @@ namespace Helper
                            std::vector<std::string>& listFiles,
                            const std::string& fileExtension);
 
-    //! \brief opens the file fileName and adds the uncommented lines to the stream.
+    //! \brief opens the file fileName and sets the stream content to its uncommented lines.
     //! Returns true is the file could be open and false if an error occurs
     bool readFileWithoutComments(const std::string& fileName, std::stringstream& stream);
 
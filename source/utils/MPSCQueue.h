@@ -0,0 +1,136 @@
+/*
+ *  Copyright (C) 2011-2016  OpenDungeons Team
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef MPSCQUEUE_H
+#define MPSCQUEUE_H
+
+#include <atomic>
+
+//! \brief Unbounded lock-free queue to pass data from any number of threads (the producers) to one
+//! thread (the consumer). push can be called from any thread and pop must only be called from the
+//! consumer thread. The elements pushed by a given thread are popped in the order they were pushed.
+//! Elements pushed by different threads are popped in the order the pushes were linearized.
+//! Note that pop can return false while a producer is in the middle of a push. In this case, the
+//! element will be available on a later call.
+template<typename T>
+class MPSCQueue
+{
+public:
+    MPSCQueue() :
+        mHead(&mStub),
+        mTail(&mStub)
+    {}
+
+    ~MPSCQueue()
+    {
+        clear();
+    }
+
+    //! \brief Producer side. Copies the given element at the end of the queue
+    void push(const T& element)
+    {
+        Node* node = new Node(element);
+        pushNode(node);
+    }
+
+    //! \brief Consumer side. Copies the first element of the queue in the given element and removes it.
+    //! Returns false if the queue is empty (or if the first element is being pushed)
+    bool pop(T& element)
+    {
+        Node* tail = mTail;
+        Node* next = tail->mNext.load(std::memory_order_acquire);
+        if(tail == &mStub)
+        {
+            // The stub is only there to never have an empty list. We skip it
+            if(next == nullptr)
+                return false;
+
+            mTail = next;
+            tail = next;
+            next = next->mNext.load(std::memory_order_acquire);
+        }
+
+        if(next != nullptr)
+        {
+            mTail = next;
+            element = tail->mElement;
+            delete tail;
+            return true;
+        }
+
+        // tail is the last node. If a producer is pushing, we wait for the next call
+        if(tail != mHead.load(std::memory_order_acquire))
+            return false;
+
+        // We push the stub back so that we can remove the last node
+        pushNode(&mStub);
+        next = tail->mNext.load(std::memory_order_acquire);
+        if(next == nullptr)
+            return false;
+
+        mTail = next;
+        element = tail->mElement;
+        delete tail;
+        return true;
+    }
+
+    //! \brief Removes every element. Should only be called from the consumer thread while no producer is pushing
+    void clear()
+    {
+        T element;
+        while(pop(element))
+        {}
+    }
+
+private:
+    struct Node
+    {
+        Node() :
+            mNext(nullptr),
+            mElement()
+        {}
+
+        explicit Node(const T& element) :
+            mNext(nullptr),
+            mElement(element)
+        {}
+
+        std::atomic<Node*> mNext;
+        T mElement;
+    };
+
+    void pushNode(Node* node)
+    {
+        node->mNext.store(nullptr, std::memory_order_relaxed);
+        Node* prev = mHead.exchange(node, std::memory_order_acq_rel);
+        prev->mNext.store(node, std::memory_order_release);
+    }
+
+    MPSCQueue(const MPSCQueue&) = delete;
+    MPSCQueue& operator=(const MPSCQueue&) = delete;
+
+    //! \brief Node never holding an element. It allows the list to never be empty
+    Node mStub;
+
+    //! \brief Last pushed node. Written by the producers
+    std::atomic<Node*> mHead;
+
+    //! \brief First node. Only accessed by the consumer
+    Node* mTail;
+};
+
+#endif // MPSCQUEUE_H
@@ -0,0 +1,114 @@
+/*
+ *  Copyright (C) 2011-2016  OpenDungeons Team
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "utils/MemoryReport.h"
+
+#include <iomanip>
+#include <sstream>
+
+void MemoryReport::add(const std::string& subsystem, std::size_t bytes)
+{
+    for(std::pair<std::string, std::size_t>& entry : mEntries)
+    {
+        if(entry.first != subsystem)
+            continue;
+
+        entry.second += bytes;
+        return;
+    }
+
+    mEntries.push_back(std::make_pair(subsystem, bytes));
+}
+
+std::size_t MemoryReport::getBytes(const std::string& subsystem) const
+{
+    for(const std::pair<std::string, std::size_t>& entry : mEntries)
+    {
+        if(entry.first == subsystem)
+            return entry.second;
+    }
+
+    return 0;
+}
+
+std::size_t MemoryReport::getTotalBytes() const
+{
+    std::size_t total = 0;
+    for(const std::pair<std::string, std::size_t>& entry : mEntries)
+        total += entry.second;
+
+    return total;
+}
+
+std::vector<std::string> MemoryReport::toLines(const MemoryReport* previous, double elapsedSeconds) const
+{
+    std::vector<std::string> lines;
+    for(const std::pair<std::string, std::size_t>& entry : mEntries)
+    {
+        std::string line = entry.first + "=" + formatBytes(entry.second);
+        if(previous != nullptr)
+            line += " (" + formatRate(entry.second, previous->getBytes(entry.first), elapsedSeconds) + ")";
+
+        lines.push_back(line);
+    }
+
+    std::string line = "total=" + formatBytes(getTotalBytes());
+    if(previous != nullptr)
+        line += " (" + formatRate(getTotalBytes(), previous->getTotalBytes(), elapsedSeconds) + ")";
+
+    lines.push_back(line);
+    return lines;
+}
+
+std::string MemoryReport::toString(const MemoryReport* previous, double elapsedSeconds) const
+{
+    std::string str;
+    for(const std::string& line : toLines(previous, elapsedSeconds))
+    {
+        if(!str.empty())
+            str += ", ";
+
+        str += line;
+    }
+
+    return str;
+}
+
+std::string MemoryReport::formatBytes(std::size_t bytes)
+{
+    std::ostringstream ss;
+    ss << std::fixed << std::setprecision(2);
+    if(bytes >= 1024 * 1024)
+        ss << static_cast<double>(bytes) / (1024.0 * 1024.0) << "MB";
+    else if(bytes >= 1024)
+        ss << static_cast<double>(bytes) / 1024.0 << "KB";
+    else
+        ss << bytes << "B";
+
+    return ss.str();
+}
+
+std::string MemoryReport::formatRate(std::size_t bytes, std::size_t previousBytes, double elapsedSeconds)
+{
+    if(elapsedSeconds <= 0.0)
+        return "n/a";
+
+    double diff = static_cast<double>(bytes) - static_cast<double>(previousBytes);
+    std::ostringstream ss;
+    ss << std::fixed << std::setprecision(2) << std::showpos << diff / 1024.0 / elapsedSeconds << "KB/s";
+    return ss.str();
+}
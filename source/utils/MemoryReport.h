@@ -0,0 +1,62 @@
+/*
+ *  Copyright (C) 2011-2016  OpenDungeons Team
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef MEMORYREPORT_H
+#define MEMORYREPORT_H
+
+#include <cstddef>
+#include <string>
+#include <utility>
+#include <vector>
+
+//! \brief Memory used by the main containers, tagged by subsystem. The values are estimated from the
+//! containers sizes and capacities when the report is filled. Nothing is counted when memory is allocated
+//! so that it costs nothing between two reports.
+class MemoryReport
+{
+public:
+    //! \brief Adds the given bytes to the given subsystem. Subsystems are reported in the order they are first added
+    void add(const std::string& subsystem, std::size_t bytes);
+
+    //! \brief Returns the bytes counted for the given subsystem (0 if unknown)
+    std::size_t getBytes(const std::string& subsystem) const;
+
+    std::size_t getTotalBytes() const;
+
+    inline const std::vector<std::pair<std::string, std::size_t>>& getEntries() const
+    { return mEntries; }
+
+    //! \brief Returns one line per subsystem (and one for the total) with the used memory. If previous is given,
+    //! the growth rate since previous is added (elapsedSeconds being the time between the 2 reports)
+    std::vector<std::string> toLines(const MemoryReport* previous, double elapsedSeconds) const;
+
+    //! \brief Same as toLines but on a single line. Used for periodic logging
+    std::string toString(const MemoryReport* previous, double elapsedSeconds) const;
+
+    //! \brief Helper returning the memory allocated by a vector (its elements are not followed)
+    template<typename T>
+    static std::size_t vectorBytes(const std::vector<T>& vec)
+    { return vec.capacity() * sizeof(T); }
+
+private:
+    std::vector<std::pair<std::string, std::size_t>> mEntries;
+
+    static std::string formatBytes(std::size_t bytes);
+    static std::string formatRate(std::size_t bytes, std::size_t previousBytes, double elapsedSeconds);
+};
+
+#endif // MEMORYREPORT_H
@@ -24,87 +24,230 @@
 #include "utils/Helper.h"
 
 #include <algorithm>
+#include <chrono>
 #include <cmath>
-#include <ctime>
 
-unsigned long myRandomSeed;
-const unsigned long MAX = 32768;
+namespace
+{
+//! \brief splitmix64. Used to expand a seed in the generator state (as recommended for xoshiro)
+uint64_t splitMix64(uint64_t& x)
+{
+    x += 0x9E3779B97F4A7C15ULL;
+    uint64_t z = x;
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+    return z ^ (z >> 31);
+}
 
-static unsigned long randgen()
+inline uint64_t rotl(uint64_t x, int k)
 {
-    myRandomSeed = myRandomSeed * 1103515245 + 12345;
-    //TODO: What is the purpose of the cast?
-    unsigned long returnVal = static_cast<unsigned int>(myRandomSeed / 65536) % MAX;
+    return (x << k) | (x >> (64 - k));
+}
+
+const uint32_t NB_STREAMS = static_cast<uint32_t>(Random::Stream::nbStreams);
 
-    return returnVal;
+uint64_t gameSeed = 0;
+RandomGenerator streams[NB_STREAMS];
 }
 
-//! \brief uniformly distributed number [0;1)
-static double uniform()
+RandomGenerator::RandomGenerator(uint64_t seed, uint64_t streamId)
 {
-    return randgen() * 1.0 / static_cast<double>(MAX);
+    this->seed(seed, streamId);
 }
 
-//! \brief uniformly distributed number [lo;hi)
-static double uniform(double lo, double hi)
+void RandomGenerator::seed(uint64_t seed, uint64_t streamId)
 {
-    return uniform() * (hi - lo) + lo;
+    // We mix the stream id before expanding so that close ids give unrelated states
+    uint64_t x = streamId;
+    uint64_t mixedSeed = seed ^ splitMix64(x);
+    for(uint64_t& state : mState)
+        state = splitMix64(mixedSeed);
 }
 
-//! \brief random integer [lo;hi]
-static int randint(int lo, int hi)
+uint64_t RandomGenerator::next()
 {
-    return static_cast<int>(uniform() * (hi - lo + 1) + lo);
+    const uint64_t result = rotl(mState[1] * 5, 7) * 9;
+    const uint64_t t = mState[1] << 17;
+
+    mState[2] ^= mState[0];
+    mState[3] ^= mState[1];
+    mState[1] ^= mState[2];
+    mState[0] ^= mState[3];
+    mState[2] ^= t;
+    mState[3] = rotl(mState[3], 45);
+
+    return result;
 }
 
-//! \brief random unsigned integer [lo;hi]
-static unsigned int randuint(unsigned int lo, unsigned int hi)
+double RandomGenerator::uniform()
 {
-    return static_cast<unsigned int>(uniform() * (hi - lo + 1) + lo);
+    // The 53 upper bits fill the mantissa of the double
+    return static_cast<double>(next() >> 11) * (1.0 / 9007199254740992.0);
 }
 
+double RandomGenerator::Double(double min, double max)
+{
+    if (min > max)
+        std::swap(min, max);
 
-namespace Random
+    return uniform() * (max - min) + min;
+}
+
+int RandomGenerator::Int(int min, int max)
 {
+    if (min > max)
+        std::swap(min, max);
 
-void initialize()
+    int64_t range = static_cast<int64_t>(max) - static_cast<int64_t>(min) + 1;
+    return static_cast<int>(min + static_cast<int64_t>(uniform() * range));
+}
+
+unsigned int RandomGenerator::Uint(unsigned int min, unsigned int max)
 {
-    myRandomSeed = static_cast<unsigned long>(std::time(0));
+    if (min > max)
+        std::swap(min, max);
+
+    uint64_t range = static_cast<uint64_t>(max) - static_cast<uint64_t>(min) + 1;
+    return static_cast<unsigned int>(min + static_cast<uint64_t>(uniform() * range));
 }
 
-double Double(double min, double max)
+double RandomGenerator::gaussianRandomDouble()
+{
+    // We use 1 - uniform to be in (0;1] and avoid log(0)
+    double u1 = 1.0 - uniform();
+    double u2 = uniform();
+    return std::sqrt(-2.0 * std::log(u1)) * std::cos(2.0 * PI * u2);
+}
+
+void RandomGenerator::fillDouble(double* values, uint32_t nbValues, double min, double max)
 {
     if (min > max)
-    {
         std::swap(min, max);
-    }
 
-    return uniform(min, max);
+    double range = max - min;
+    for(uint32_t i = 0; i < nbValues; ++i)
+        values[i] = uniform() * range + min;
 }
 
-int Int(int min, int max)
+void RandomGenerator::fillUint(unsigned int* values, uint32_t nbValues, unsigned int min, unsigned int max)
 {
     if (min > max)
-    {
         std::swap(min, max);
+
+    uint64_t range = static_cast<uint64_t>(max) - static_cast<uint64_t>(min) + 1;
+    for(uint32_t i = 0; i < nbValues; ++i)
+        values[i] = static_cast<unsigned int>(min + static_cast<uint64_t>(uniform() * range));
+}
+
+uint64_t RandomGenerator::getStateHash() const
+{
+    uint64_t hash = 0;
+    for(uint64_t state : mState)
+    {
+        uint64_t x = hash ^ state;
+        hash = splitMix64(x);
     }
+    return hash;
+}
+
+namespace Random
+{
 
-    return randint(min, max);
+void initialize()
+{
+    uint64_t seed = generateGameSeed();
+    for(uint32_t i = 0; i < NB_STREAMS; ++i)
+        streams[i].seed(seed, i);
+
+    gameSeed = seed;
 }
 
-unsigned int Uint(unsigned int min, unsigned int max)
+void setGameSeed(uint64_t seed)
 {
-    if (min > max)
+    gameSeed = seed;
+    for(uint32_t i = 0; i < NB_STREAMS; ++i)
     {
-        std::swap(min, max);
+        if(i == static_cast<uint32_t>(Stream::client))
+            continue;
+
+        streams[i].seed(seed, i);
+    }
+}
+
+uint64_t getGameSeed()
+{
+    return gameSeed;
+}
+
+uint64_t generateGameSeed()
+{
+    uint64_t x = static_cast<uint64_t>(std::chrono::high_resolution_clock::now().time_since_epoch().count());
+    return splitMix64(x);
+}
+
+uint64_t getResumeSeed()
+{
+    uint64_t seed = 0;
+    for(uint32_t i = 0; i < NB_STREAMS; ++i)
+    {
+        if(i == static_cast<uint32_t>(Stream::client))
+            continue;
+
+        uint64_t x = seed ^ streams[i].getStateHash();
+        seed = splitMix64(x);
     }
+    return seed;
+}
 
-    return randuint(min, max);
+RandomGenerator createGenerator(uint64_t id)
+{
+    // The ids are shifted after the streams so that they do not give the same sequences
+    return RandomGenerator(gameSeed, NB_STREAMS + id);
+}
+
+RandomGenerator& getStream(Stream stream)
+{
+    return streams[static_cast<uint32_t>(stream)];
+}
+
+double Double(double min, double max)
+{
+    return getStream(Stream::game).Double(min, max);
+}
+
+double Double(Stream stream, double min, double max)
+{
+    return getStream(stream).Double(min, max);
+}
+
+int Int(int min, int max)
+{
+    return getStream(Stream::game).Int(min, max);
+}
+
+int Int(Stream stream, int min, int max)
+{
+    return getStream(stream).Int(min, max);
+}
+
+unsigned int Uint(unsigned int min, unsigned int max)
+{
+    return getStream(Stream::game).Uint(min, max);
+}
+
+unsigned int Uint(Stream stream, unsigned int min, unsigned int max)
+{
+    return getStream(stream).Uint(min, max);
 }
 
 double gaussianRandomDouble()
 {
-    return std::sqrt(-2.0 * log(Double(0.0, 1.0))) * cos(2.0 * PI * Double(0.0, 1.0));
+    return getStream(Stream::game).gaussianRandomDouble();
+}
+
+double gaussianRandomDouble(Stream stream)
+{
+    return getStream(stream).gaussianRandomDouble();
 }
 
 } // namespace Random
@@ -23,11 +23,86 @@
 #ifndef RANDOM_H_
 #define RANDOM_H_
 
+#include <cstdint>
+
+//! \brief xoshiro256** generator. It is fast, has a small state and gives 64 bits per call. Every
+//! generator has its own state so that different subsystems (or entities) can draw numbers without
+//! depending on each other. Note that a generator is not thread safe: each thread should use its own.
+class RandomGenerator
+{
+public:
+    //! \brief Seeds the generator with the given seed. Generators built with the same seed and
+    //! different streamId give independent sequences
+    explicit RandomGenerator(uint64_t seed = 0, uint64_t streamId = 0);
+
+    void seed(uint64_t seed, uint64_t streamId = 0);
+
+    //! \brief Returns the next 64 random bits
+    uint64_t next();
+
+    //! \brief Uniformly distributed double in [0;1)
+    double uniform();
+
+    //! \brief Same as Random::Double/Int/Uint but drawn from this generator
+    double Double(double min, double max);
+    int Int(int min, int max);
+    unsigned int Uint(unsigned int min, unsigned int max);
+
+    //! \brief Gaussian distributed double (Box-Muller)
+    double gaussianRandomDouble();
+
+    //! \brief Bulk versions for the consumers needing many values at once. They give
+    //! the same values as calling Double/Uint nbValues times
+    void fillDouble(double* values, uint32_t nbValues, double min, double max);
+    void fillUint(unsigned int* values, uint32_t nbValues, unsigned int min, unsigned int max);
+
+    //! \brief Returns a value depending on the whole state of the generator without changing it
+    uint64_t getStateHash() const;
+
+private:
+    uint64_t mState[4];
+};
+
 namespace Random
 {
-    //! \brief initializes the semaphore and seeds the generator
+    //! \brief Independent streams of random numbers. The simulation streams (every stream except
+    //! client) are seeded from the game seed so that a game can be reproduced. The client stream is
+    //! used by the client thread (rendering, sounds) so that it does not interfere with the server.
+    enum class Stream
+    {
+        game,
+        creatures,
+        rooms,
+        traps,
+        ai,
+        client,
+        nbStreams
+    };
+
+    //! \brief Seeds every stream from the current time
     void initialize();
 
+    //! \brief Reseeds the simulation streams from the given game seed. Should be called before the
+    //! server starts processing turns
+    void setGameSeed(uint64_t gameSeed);
+
+    //! \brief Returns the last game seed set
+    uint64_t getGameSeed();
+
+    //! \brief Returns a new seed that can be used for a game (based on the current time)
+    uint64_t generateGameSeed();
+
+    //! \brief Returns a seed depending on the current state of the simulation streams. Saved in
+    //! savegames so that a loaded game keeps being reproducible. The streams are not modified
+    uint64_t getResumeSeed();
+
+    //! \brief Returns a generator for the given entity/task. Its sequence only depends on the game
+    //! seed and the given id. Useful for work that may be done on other threads
+    RandomGenerator createGenerator(uint64_t id);
+
+    //! \brief Returns the generator used for the given stream
+    RandomGenerator& getStream(Stream stream);
+
     /*! \brief generate a random double
      *
      *  \param min, max One or both can be negative
@@ -36,6 +111,7 @@ namespace Random
      *          number entered
      */
     double Double(double min, double max);
+    double Double(Stream stream, double min, double max);
 
     /*! \brief generate a random int
      *
@@ -45,6 +121,7 @@ namespace Random
      *          number entered
      */
     int Int(int min, int max);
+    int Int(Stream stream, int min, int max);
 
     /*! \brief generate a random unsigned int
      *
@@ -54,12 +131,14 @@ namespace Random
      *          number entered
      */
     unsigned int Uint(unsigned int min, unsigned int max);
+    unsigned int Uint(Stream stream, unsigned int min, unsigned int max);
 
     /*! \brief generates a gaussian distributed random double
      *
-     *  \return a gaussian distributed random double value in [-1,1]
+     *  \return a gaussian distributed random double value
      */
     double gaussianRandomDouble();
+    double gaussianRandomDouble(Stream stream);
 }
 
 #endif // RANDOM_H_
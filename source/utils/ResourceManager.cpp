@@ -87,6 +87,7 @@ const std::string ResourceManager::RESOURCEGROUPSOUND = "Sound";
 ResourceManager::ResourceManager(boost::program_options::variables_map& options) :
         mServerMode(false),
         mForcedNetworkPort(-1),
+        mRelayDelaySeconds(0),
         mLogLevel(LogMessageLevel::NORMAL),
         mGameDataPath("./"),
         mUserDataPath("./"),
@@ -438,6 +439,20 @@ void ResourceManager::setupUserDataFolders(boost::program_options::variables_map
     if(itOption != options.end())
         mForcedNetworkPort = itOption->second.as<int32_t>();
 
+    // Relay mode is only used if we are not a server
+    if(!mServerMode)
+    {
+        itOption = options.find("relay");
+        if(itOption != options.end())
+        {
+            mRelayServer = itOption->second.as<std::string>();
+
+            auto it2 = options.find("relaydelay");
+            if((it2 != options.end()) && (it2->second.as<int32_t>() > 0))
+                mRelayDelaySeconds = static_cast<uint32_t>(it2->second.as<int32_t>());
+        }
+    }
+
     itOption = options.find("loglevel");
     if(itOption != options.end())
         mLogLevel = static_cast<LogMessageLevel>(itOption->second.as<int32_t>());
@@ -601,6 +616,10 @@ void ResourceManager::buildCommandOptions(boost::program_options::options_descri
         ("appData", boost::program_options::value<std::string>(), "Sets appData to the given path (where logs, replays, ... are saved)")
         ("mscreator", boost::program_options::value<std::string>(), "Sets the creator for this map to connect to the master server. server/servercustom/serversave option needs to be on")
         ("port", boost::program_options::value<int32_t>(), "Sets the port used. Note that the port is used for both single and multi player")
+        ("relay", boost::program_options::value<std::string>(), "Launches the game on relay mode: connects to the given server (host[:port]) and relays the game to the spectators connecting on the port used. "
+            "The relay takes a player seat on the server: the host has to give it one and the spectators only see what this seat sees. "
+            "Spectators joining late replay the whole game from its start before reaching the current turn")
+        ("relaydelay", boost::program_options::value<int32_t>(), "Sets the delay (in seconds) before the relay sends the game to the spectators. relay option needs to be on")
         ("loglevel", boost::program_options::value<int32_t>(), "Sets the log level (between 0=Trivial and 3=Critical)")
     ;
 }
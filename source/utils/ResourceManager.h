@@ -148,6 +148,16 @@ public:
     inline int32_t getForcedNetworkPort() const
     { return mForcedNetworkPort; }
 
+    inline bool isRelayMode() const
+    { return !mRelayServer.empty(); }
+
+    //! \brief Server the relay connects to (host or host:port)
+    inline const std::string& getRelayServer() const
+    { return mRelayServer; }
+
+    inline uint32_t getRelayDelaySeconds() const
+    { return mRelayDelaySeconds; }
+
     inline LogMessageLevel getLogLevel() const
     { return mLogLevel; }
 
@@ -160,6 +170,10 @@ private:
     //! \brief used when the network port is forced
     int32_t mForcedNetworkPort;
 
+    //! \brief used when the executable is launched in relay mode
+    std::string mRelayServer;
+    uint32_t mRelayDelaySeconds;
+
     //! \brief The log level
     LogMessageLevel mLogLevel;
 
@@ -0,0 +1,94 @@
+/*
+ *  Copyright (C) 2011-2016  OpenDungeons Team
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef SPSCQUEUE_H
+#define SPSCQUEUE_H
+
+#include <atomic>
+#include <cstdint>
+#include <vector>
+
+//! \brief Bounded lock-free queue to pass data from one thread (the producer) to one other thread
+//! (the consumer). push must only be called from the producer thread and pop from the consumer thread.
+//! Neither of them blocks: push returns false if the queue is full and pop returns false if it is empty.
+template<typename T>
+class SPSCQueue
+{
+public:
+    //! \brief The queue will be able to hold capacity - 1 elements
+    explicit SPSCQueue(uint32_t capacity) :
+        mElements(capacity),
+        mHead(0),
+        mTail(0)
+    {}
+
+    //! \brief Producer side. Copies the given element at the end of the queue. Returns false
+    //! if the queue is full
+    bool push(const T& element)
+    {
+        uint32_t tail = mTail.load(std::memory_order_relaxed);
+        uint32_t nextTail = next(tail);
+        if(nextTail == mHead.load(std::memory_order_acquire))
+            return false;
+
+        mElements[tail] = element;
+        mTail.store(nextTail, std::memory_order_release);
+        return true;
+    }
+
+    //! \brief Consumer side. Copies the first element of the queue in the given element and removes it.
+    //! Returns false if the queue is empty
+    bool pop(T& element)
+    {
+        uint32_t head = mHead.load(std::memory_order_relaxed);
+        if(head == mTail.load(std::memory_order_acquire))
+            return false;
+
+        element = mElements[head];
+        // We release the slot content so that it does not keep memory until it gets overwritten
+        mElements[head] = T();
+        mHead.store(next(head), std::memory_order_release);
+        return true;
+    }
+
+    //! \brief Can be called from the consumer thread. Note that if the producer is pushing, the queue
+    //! may not be empty anymore when the function returns
+    bool empty() const
+    { return mHead.load(std::memory_order_acquire) == mTail.load(std::memory_order_acquire); }
+
+    //! \brief Removes every element. Should only be called while the producer is not running
+    void clear()
+    {
+        T element;
+        while(pop(element))
+        {}
+    }
+
+private:
+    inline uint32_t next(uint32_t index) const
+    { return (index + 1) % static_cast<uint32_t>(mElements.size()); }
+
+    std::vector<T> mElements;
+
+    //! \brief Index of the first element. Only written by the consumer
+    std::atomic<uint32_t> mHead;
+
+    //! \brief Index where the next element will be pushed. Only written by the producer
+    std::atomic<uint32_t> mTail;
+};
+
+#endif // SPSCQUEUE_H
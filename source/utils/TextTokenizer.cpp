@@ -0,0 +1,509 @@
+/*
+ *  Copyright (C) 2011-2016  OpenDungeons Team
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "utils/TextTokenizer.h"
+
+#include <cstdlib>
+#include <fstream>
+#include <limits>
+#include <locale>
+#include <sstream>
+
+namespace
+{
+const char COMMENT_SYMBOL = '#';
+
+inline bool isSeparator(char c)
+{
+    return (c == ' ') || (c == '\t') || (c == '\n') || (c == '\r');
+}
+
+inline bool isBlank(char c)
+{
+    return (c == ' ') || (c == '\t') || (c == '\r');
+}
+
+//! \brief Numbers longer than that are not valid in our files
+const std::size_t MAX_NUMBER_LENGTH = 63;
+
+inline bool isDigit(char c)
+{
+    return (c >= '0') && (c <= '9');
+}
+
+//! \brief Adds the digit to mantissa. Returns false if the mantissa would not fit exactly in a double
+inline bool addDigit(uint64_t& mantissa, char c)
+{
+    const uint64_t maxExactMantissa = (static_cast<uint64_t>(1) << 53) - 1;
+    uint64_t digit = static_cast<uint64_t>(c - '0');
+    if(mantissa > (maxExactMantissa - digit) / 10)
+        return false;
+
+    mantissa = mantissa * 10 + digit;
+    return true;
+}
+
+//! \brief Parses [sign] digits [. digits] [(e|E) [sign] digits] with '.' as decimal separator. Only handles
+//! the numbers whose significant digits fit exactly in a double and whose power of 10 is exact too. Then,
+//! a single multiplication or division gives the correctly rounded value. Returns false for the other ones
+bool parseSimpleDouble(const TextView& text, double& value)
+{
+    static const double powersOf10[] = { 1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+        1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22 };
+    const int32_t maxExactPower = 22;
+
+    std::size_t pos = 0;
+    bool isNegative = false;
+    if((pos < text.size()) && ((text[pos] == '-') || (text[pos] == '+')))
+    {
+        isNegative = (text[pos] == '-');
+        ++pos;
+    }
+
+    uint64_t mantissa = 0;
+    int32_t exponent = 0;
+    bool hasDigit = false;
+    for(; (pos < text.size()) && isDigit(text[pos]); ++pos)
+    {
+        hasDigit = true;
+        if(!addDigit(mantissa, text[pos]))
+            return false;
+    }
+    if((pos < text.size()) && (text[pos] == '.'))
+    {
+        for(++pos; (pos < text.size()) && isDigit(text[pos]); ++pos)
+        {
+            hasDigit = true;
+            if(!addDigit(mantissa, text[pos]))
+                return false;
+            --exponent;
+        }
+    }
+    if(!hasDigit)
+        return false;
+
+    if((pos < text.size()) && ((text[pos] == 'e') || (text[pos] == 'E')))
+    {
+        ++pos;
+        bool isExponentNegative = false;
+        if((pos < text.size()) && ((text[pos] == '-') || (text[pos] == '+')))
+        {
+            isExponentNegative = (text[pos] == '-');
+            ++pos;
+        }
+        if((pos >= text.size()) || !isDigit(text[pos]))
+            return false;
+
+        int32_t exponentValue = 0;
+        for(; (pos < text.size()) && isDigit(text[pos]); ++pos)
+        {
+            exponentValue = exponentValue * 10 + (text[pos] - '0');
+            // Too big for the exact powers anyway
+            if(exponentValue > 1000)
+                return false;
+        }
+        exponent += isExponentNegative ? -exponentValue : exponentValue;
+    }
+    if(pos != text.size())
+        return false;
+
+    double result = static_cast<double>(mantissa);
+    if(exponent < 0)
+    {
+        if(-exponent > maxExactPower)
+            return false;
+        result /= powersOf10[-exponent];
+    }
+    else
+    {
+        if(exponent > maxExactPower)
+            return false;
+        result *= powersOf10[exponent];
+    }
+
+    value = isNegative ? -result : result;
+    return true;
+}
+}
+
+bool TextView::startsWith(const char* prefix) const
+{
+    std::size_t len = std::strlen(prefix);
+    return (len <= mSize) && (std::memcmp(mData, prefix, len) == 0);
+}
+
+TextView TextView::substr(std::size_t pos) const
+{
+    if(pos >= mSize)
+        return TextView(mData + mSize, 0);
+
+    return TextView(mData + pos, mSize - pos);
+}
+
+TextView TextView::trimmed() const
+{
+    const char* begin = mData;
+    const char* end = mData + mSize;
+    while((begin < end) && isBlank(*begin))
+        ++begin;
+    while((end > begin) && isBlank(*(end - 1)))
+        --end;
+
+    return TextView(begin, static_cast<std::size_t>(end - begin));
+}
+
+TextTokenizer::TextTokenizer() :
+    mPos(nullptr),
+    mEnd(nullptr),
+    mFail(false)
+{
+}
+
+TextTokenizer::TextTokenizer(const TextView& text) :
+    mPos(text.data()),
+    mEnd(text.data() + text.size()),
+    mFail(false)
+{
+}
+
+bool TextTokenizer::loadFile(const std::string& fileName)
+{
+    std::ifstream file(fileName.c_str(), std::ifstream::in | std::ifstream::binary);
+    if (!file.good())
+        return false;
+
+    // Read in the whole file with one read
+    file.seekg(0, std::ios::end);
+    std::streamoff fileSize = file.tellg();
+    file.seekg(0, std::ios::beg);
+    mBuffer.clear();
+    if(fileSize > 0)
+    {
+        mBuffer.resize(static_cast<std::size_t>(fileSize));
+        file.read(&mBuffer[0], fileSize);
+        mBuffer.resize(static_cast<std::size_t>(file.gcount()));
+    }
+
+    mPos = mBuffer.data();
+    mEnd = mBuffer.data() + mBuffer.size();
+    mFail = false;
+    return true;
+}
+
+void TextTokenizer::skipSeparators()
+{
+    while(mPos < mEnd)
+    {
+        if(*mPos == COMMENT_SYMBOL)
+        {
+            skipLine();
+            continue;
+        }
+
+        if(!isSeparator(*mPos))
+            return;
+
+        ++mPos;
+    }
+}
+
+void TextTokenizer::skipLine()
+{
+    const char* newLine = static_cast<const char*>(std::memchr(mPos, '\n', static_cast<std::size_t>(mEnd - mPos)));
+    mPos = (newLine == nullptr) ? mEnd : newLine + 1;
+}
+
+bool TextTokenizer::nextToken(TextView& token)
+{
+    skipSeparators();
+    if(mPos >= mEnd)
+        return false;
+
+    const char* begin = mPos;
+    while((mPos < mEnd) && !isSeparator(*mPos) && (*mPos != COMMENT_SYMBOL))
+        ++mPos;
+
+    token = TextView(begin, static_cast<std::size_t>(mPos - begin));
+    return true;
+}
+
+bool TextTokenizer::restOfLine(TextView& line)
+{
+    if(mPos >= mEnd)
+        return false;
+
+    const char* begin = mPos;
+    while((mPos < mEnd) && (*mPos != '\n') && (*mPos != COMMENT_SYMBOL))
+        ++mPos;
+
+    line = TextView(begin, static_cast<std::size_t>(mPos - begin)).trimmed();
+    skipLine();
+    return true;
+}
+
+bool TextTokenizer::nextLine(TextView& line)
+{
+    while(restOfLine(line))
+    {
+        if(!line.empty())
+            return true;
+    }
+    return false;
+}
+
+bool TextTokenizer::nextBlock(const char* endTag, TextView& block)
+{
+    const char* blockBegin = mPos;
+    while(mPos < mEnd)
+    {
+        const char* lineEnd = mPos;
+        while((lineEnd < mEnd) && (*lineEnd != '\n') && (*lineEnd != COMMENT_SYMBOL))
+            ++lineEnd;
+
+        // We look for the end tag in the tokens of the line
+        const char* pos = mPos;
+        while(pos < lineEnd)
+        {
+            if(isSeparator(*pos))
+            {
+                ++pos;
+                continue;
+            }
+
+            const char* tokenBegin = pos;
+            while((pos < lineEnd) && !isSeparator(*pos))
+                ++pos;
+
+            if(TextView(tokenBegin, static_cast<std::size_t>(pos - tokenBegin)) == endTag)
+            {
+                block = TextView(blockBegin, static_cast<std::size_t>(pos - blockBegin));
+                mPos = pos;
+                return true;
+            }
+        }
+
+        mPos = lineEnd;
+        skipLine();
+    }
+    return false;
+}
+
+bool TextTokenizer::nextBlock(const char* endTag, std::string& block)
+{
+    block.clear();
+    TextView view;
+    if(!nextBlock(endTag, view))
+        return false;
+
+    // We copy the lines of the block without their comment
+    const char* pos = view.data();
+    const char* end = view.data() + view.size();
+    while(pos < end)
+    {
+        const char* lineEnd = pos;
+        while((lineEnd < end) && (*lineEnd != '\n') && (*lineEnd != COMMENT_SYMBOL))
+            ++lineEnd;
+
+        block.append(pos, lineEnd);
+        block += '\n';
+        while((lineEnd < end) && (*lineEnd != '\n'))
+            ++lineEnd;
+
+        pos = lineEnd + 1;
+    }
+    return true;
+}
+
+TextTokenizer& TextTokenizer::operator>>(TextView& token)
+{
+    if(mFail || !nextToken(token))
+        mFail = true;
+
+    return *this;
+}
+
+TextTokenizer& TextTokenizer::operator>>(std::string& token)
+{
+    TextView view;
+    if(mFail || !nextToken(view))
+    {
+        mFail = true;
+        return *this;
+    }
+
+    token.assign(view.data(), view.size());
+    return *this;
+}
+
+TextTokenizer& TextTokenizer::operator>>(int32_t& value)
+{
+    TextView view;
+    if(mFail || !nextToken(view) || !parseInt32(view, value))
+        mFail = true;
+
+    return *this;
+}
+
+TextTokenizer& TextTokenizer::operator>>(uint32_t& value)
+{
+    TextView view;
+    if(mFail || !nextToken(view) || !parseUInt32(view, value))
+        mFail = true;
+
+    return *this;
+}
+
+TextTokenizer& TextTokenizer::operator>>(uint64_t& value)
+{
+    TextView view;
+    if(mFail || !nextToken(view) || !parseUInt64(view, value))
+        mFail = true;
+
+    return *this;
+}
+
+TextTokenizer& TextTokenizer::operator>>(double& value)
+{
+    TextView view;
+    if(mFail || !nextToken(view) || !parseDouble(view, value))
+        mFail = true;
+
+    return *this;
+}
+
+TextTokenizer& TextTokenizer::operator>>(float& value)
+{
+    double number;
+    *this >> number;
+    if(!mFail)
+        value = static_cast<float>(number);
+
+    return *this;
+}
+
+bool TextTokenizer::parseInt32(const TextView& text, int32_t& value)
+{
+    bool isNegative;
+    uint64_t number;
+    if(!parseDecimal(text, isNegative, number))
+        return false;
+
+    if(isNegative)
+    {
+        if(number > static_cast<uint64_t>(std::numeric_limits<int32_t>::max()) + 1)
+            return false;
+
+        value = static_cast<int32_t>(-static_cast<int64_t>(number));
+        return true;
+    }
+
+    if(number > static_cast<uint64_t>(std::numeric_limits<int32_t>::max()))
+        return false;
+
+    value = static_cast<int32_t>(number);
+    return true;
+}
+
+bool TextTokenizer::parseUInt32(const TextView& text, uint32_t& value)
+{
+    bool isNegative;
+    uint64_t number;
+    if(!parseDecimal(text, isNegative, number) || isNegative ||
+       (number > std::numeric_limits<uint32_t>::max()))
+    {
+        return false;
+    }
+
+    value = static_cast<uint32_t>(number);
+    return true;
+}
+
+bool TextTokenizer::parseUInt64(const TextView& text, uint64_t& value)
+{
+    bool isNegative;
+    uint64_t number;
+    if(!parseDecimal(text, isNegative, number) || isNegative)
+        return false;
+
+    value = number;
+    return true;
+}
+
+bool TextTokenizer::parseDouble(const TextView& text, double& value)
+{
+    // Most of the values in the level files are integers (like tile fullness)
+    bool isNegative;
+    uint64_t number;
+    if(parseDecimal(text, isNegative, number))
+    {
+        value = isNegative ? -static_cast<double>(number) : static_cast<double>(number);
+        return true;
+    }
+
+    // strtod would depend on the C locale. Most numbers can be parsed by hand. The other ones (too many
+    // digits or big exponents) use a stream with the classic locale so that the separator is always '.'
+    if(parseSimpleDouble(text, value))
+        return true;
+
+    if(text.empty() || (text.size() > MAX_NUMBER_LENGTH))
+        return false;
+
+    std::istringstream stream(text.toString());
+    stream.imbue(std::locale::classic());
+    double result;
+    if(!(stream >> result))
+        return false;
+
+    // The whole view should be the number
+    if(stream.peek() != std::char_traits<char>::eof())
+        return false;
+
+    value = result;
+    return true;
+}
+
+bool TextTokenizer::parseDecimal(const TextView& text, bool& isNegative, uint64_t& value)
+{
+    // Like strtoull in base 10 but without a copy to get a null terminated string. The whole view should be used
+    std::size_t pos = 0;
+    isNegative = false;
+    if((pos < text.size()) && ((text[pos] == '-') || (text[pos] == '+')))
+    {
+        isNegative = (text[pos] == '-');
+        ++pos;
+    }
+
+    if(pos >= text.size())
+        return false;
+
+    uint64_t number = 0;
+    for(; pos < text.size(); ++pos)
+    {
+        char c = text[pos];
+        if((c < '0') || (c > '9'))
+            return false;
+
+        uint64_t digit = static_cast<uint64_t>(c - '0');
+        if(number > (std::numeric_limits<uint64_t>::max() - digit) / 10)
+            return false;
+
+        number = number * 10 + digit;
+    }
+
+    value = number;
+    return true;
+}
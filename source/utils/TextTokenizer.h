@@ -0,0 +1,165 @@
+/*
+ *  Copyright (C) 2011-2016  OpenDungeons Team
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef TEXTTOKENIZER_H
+#define TEXTTOKENIZER_H
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string>
+
+//! \brief Non owning view on a part of a text (pointer + length). It is only valid as long as
+//! the text it points to is.
+class TextView
+{
+public:
+    TextView() :
+        mData(nullptr),
+        mSize(0)
+    {}
+
+    TextView(const char* data, std::size_t size) :
+        mData(data),
+        mSize(size)
+    {}
+
+    inline const char* data() const
+    { return mData; }
+
+    inline std::size_t size() const
+    { return mSize; }
+
+    inline bool empty() const
+    { return mSize == 0; }
+
+    inline char operator[](std::size_t index) const
+    { return mData[index]; }
+
+    inline std::string toString() const
+    { return std::string(mData, mSize); }
+
+    inline bool operator==(const char* str) const
+    { return (std::strlen(str) == mSize) && (std::memcmp(mData, str, mSize) == 0); }
+
+    inline bool operator!=(const char* str) const
+    { return !(*this == str); }
+
+    inline bool operator==(const std::string& str) const
+    { return (str.size() == mSize) && (std::memcmp(mData, str.data(), mSize) == 0); }
+
+    inline bool operator!=(const std::string& str) const
+    { return !(*this == str); }
+
+    //! \brief Returns true if the view starts with the given prefix
+    bool startsWith(const char* prefix) const;
+
+    //! \brief Returns the view without its first pos characters
+    TextView substr(std::size_t pos) const;
+
+    //! \brief Returns the view without the leading and trailing spaces and tabs
+    TextView trimmed() const;
+
+private:
+    const char* mData;
+    std::size_t mSize;
+};
+
+//! \brief Reads the level and config files. The file is read in memory with one read. Then, the tokens
+//! and lines are returned as views on this buffer while it is scanned once. Everything after a '#' until
+//! the end of the line is a comment and skipped while scanning.
+//! The extraction operators mimic the std::istream ones (so the loaders keep their shape): a failed
+//! extraction (end of text or invalid number) sets the fail state and every following one fails too.
+//! Integers are parsed like strtol does but directly on the views. Other numbers are parsed by hand too (or
+//! with a classic locale stream for the rare ones needing more precision) so that the decimal separator is
+//! always '.', whatever the C locale.
+class TextTokenizer
+{
+public:
+    TextTokenizer();
+
+    //! \brief Tokenizes the given text. It is not copied so it should outlive the tokenizer
+    explicit TextTokenizer(const TextView& text);
+
+    TextTokenizer(const TextTokenizer&) = delete;
+    TextTokenizer& operator=(const TextTokenizer&) = delete;
+
+    //! \brief Reads the whole file in memory and tokenizes it. Returns false if it cannot be read
+    bool loadFile(const std::string& fileName);
+
+    //! \brief Sets token to the next token (characters not separated by spaces, tabs or new lines).
+    //! Returns false if there is no more token
+    bool nextToken(TextView& token);
+
+    //! \brief Sets line to the rest of the current line (like std::getline after an extraction) without
+    //! the comment and goes to the next line. line can be empty. Returns false at the end of the text
+    bool restOfLine(TextView& line);
+
+    //! \brief Sets line to the next line that is not empty once trimmed and stripped of its comment.
+    //! Returns false if there is no more line
+    bool nextLine(TextView& line);
+
+    //! \brief Sets block to the text from the current position until the end of the next token equal to
+    //! endTag (included) and goes after it. The block can be read with its own TextTokenizer (comments
+    //! included) so that a loader cannot read further than its block. Returns false if endTag is not found
+    bool nextBlock(const char* endTag, TextView& block);
+
+    //! \brief Same as the other nextBlock but copies the block without its comments. This allows to read
+    //! it with a parser needing a std::istream
+    bool nextBlock(const char* endTag, std::string& block);
+
+    TextTokenizer& operator>>(TextView& token);
+    TextTokenizer& operator>>(std::string& token);
+    TextTokenizer& operator>>(int32_t& value);
+    TextTokenizer& operator>>(uint32_t& value);
+    TextTokenizer& operator>>(uint64_t& value);
+    TextTokenizer& operator>>(double& value);
+    TextTokenizer& operator>>(float& value);
+
+    //! \brief Returns false once an extraction failed
+    inline bool good() const
+    { return !mFail; }
+
+    inline explicit operator bool() const
+    { return !mFail; }
+
+    //! \brief Parse the whole view as a number. Return false (and do not change value) if it is not one
+    static bool parseInt32(const TextView& text, int32_t& value);
+    static bool parseUInt32(const TextView& text, uint32_t& value);
+    static bool parseUInt64(const TextView& text, uint64_t& value);
+    static bool parseDouble(const TextView& text, double& value);
+
+private:
+    //! \brief Parses a base 10 integer with an optional sign. Returns false if the whole view is not one
+    //! or if it does not fit in 64 bits
+    static bool parseDecimal(const TextView& text, bool& isNegative, uint64_t& value);
+
+    //! \brief Skips spaces, tabs, new lines and comments
+    void skipSeparators();
+
+    //! \brief Skips the rest of the current line (if any) including the new line character
+    void skipLine();
+
+    //! \brief Buffer owned when a file is loaded
+    std::string mBuffer;
+
+    const char* mPos;
+    const char* mEnd;
+    bool mFail;
+};
+
+#endif // TEXTTOKENIZER_H
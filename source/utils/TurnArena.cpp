@@ -0,0 +1,114 @@
+/*
+ *  Copyright (C) 2011-2016  OpenDungeons Team
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "utils/TurnArena.h"
+
+#include <algorithm>
+#include <cassert>
+
+TurnArena::TurnArena(std::size_t blockSize) :
+    mBlockSize(blockSize),
+    mCurrentBlock(0),
+    mCurrentOffset(0),
+    mBytesUsedInPreviousBlocks(0),
+    mLastAllocation(nullptr),
+    mNbAllocations(0),
+    mNbBlocksAllocated(0)
+{
+}
+
+TurnArena::~TurnArena()
+{
+    for(Block& block : mBlocks)
+        delete[] block.mData;
+}
+
+void* TurnArena::allocate(std::size_t size, std::size_t alignment)
+{
+#ifndef NDEBUG
+    // Only one thread can use the arena during a turn. The worker threads helping the server thread
+    // must not call the queries returning a TurnSpan
+    if(mOwnerThread == std::thread::id())
+        mOwnerThread = std::this_thread::get_id();
+    assert(mOwnerThread == std::this_thread::get_id());
+#endif
+    ++mNbAllocations;
+    while(mCurrentBlock < mBlocks.size())
+    {
+        Block& block = mBlocks[mCurrentBlock];
+        std::size_t offset = (mCurrentOffset + alignment - 1) & ~(alignment - 1);
+        if(offset + size <= block.mSize)
+        {
+            mCurrentOffset = offset + size;
+            mLastAllocation = block.mData + offset;
+            return mLastAllocation;
+        }
+
+        // The end of this block is lost until the next reset
+        mBytesUsedInPreviousBlocks += mCurrentOffset;
+        ++mCurrentBlock;
+        mCurrentOffset = 0;
+    }
+
+    // No block has enough space left. We add a new one (bigger if needed). Blocks are allocated
+    // with new[] so they are aligned for any fundamental type
+    Block block;
+    block.mSize = std::max(mBlockSize, size);
+    block.mData = new char[block.mSize];
+    mBlocks.push_back(block);
+    ++mNbBlocksAllocated;
+    mCurrentBlock = static_cast<uint32_t>(mBlocks.size() - 1);
+    mCurrentOffset = size;
+    mLastAllocation = block.mData;
+    return mLastAllocation;
+}
+
+bool TurnArena::extend(void* ptr, std::size_t oldSize, std::size_t newSize)
+{
+    if((ptr == nullptr) || (ptr != mLastAllocation))
+        return false;
+
+    Block& block = mBlocks[mCurrentBlock];
+    std::size_t offset = static_cast<char*>(ptr) - block.mData;
+    if((offset + oldSize != mCurrentOffset) || (offset + newSize > block.mSize))
+        return false;
+
+    mCurrentOffset = offset + newSize;
+    return true;
+}
+
+void TurnArena::reset()
+{
+    mCurrentBlock = 0;
+    mCurrentOffset = 0;
+    mBytesUsedInPreviousBlocks = 0;
+    mLastAllocation = nullptr;
+    mOwnerThread = std::thread::id();
+}
+
+std::size_t TurnArena::getBytesUsed() const
+{
+    return mBytesUsedInPreviousBlocks + mCurrentOffset;
+}
+
+std::size_t TurnArena::getCapacity() const
+{
+    std::size_t capacity = 0;
+    for(const Block& block : mBlocks)
+        capacity += block.mSize;
+    return capacity;
+}
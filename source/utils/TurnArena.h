@@ -0,0 +1,203 @@
+/*
+ *  Copyright (C) 2011-2016  OpenDungeons Team
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef TURNARENA_H
+#define TURNARENA_H
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+//! \brief Bump allocator for the temporary results computed during a server turn (lists of creatures, entities or
+//! tiles returned by the gamemap queries). Allocating only moves an offset and everything is released at once by
+//! reset() at the end of the turn (see ODServer::startNewTurn). The blocks are kept from one turn to another so that,
+//! once the arena is big enough, the turns do not use the heap for these results.
+//! Only the server thread should use it and nothing allocated from it should be kept after the turn.
+class TurnArena
+{
+public:
+    explicit TurnArena(std::size_t blockSize = DEFAULT_BLOCK_SIZE);
+    ~TurnArena();
+
+    TurnArena(const TurnArena&) = delete;
+    TurnArena& operator=(const TurnArena&) = delete;
+
+    //! \brief Returns size bytes aligned on alignment (that should be a power of 2)
+    void* allocate(std::size_t size, std::size_t alignment);
+
+    //! \brief Grows the given allocation from oldSize to newSize bytes if it is the last one done and there is
+    //! enough space after it. Returns true on success (ptr is still valid) and false otherwise
+    bool extend(void* ptr, std::size_t oldSize, std::size_t newSize);
+
+    template<typename T>
+    inline T* allocateArray(uint32_t nbElements)
+    { return static_cast<T*>(allocate(nbElements * sizeof(T), alignof(T))); }
+
+    //! \brief Releases everything allocated since the last reset. The memory is kept for the next turn
+    void reset();
+
+    //! \brief Number of allocations since the arena was created. Can be used to check the per turn allocations
+    inline uint64_t getNbAllocations() const
+    { return mNbAllocations; }
+
+    //! \brief Number of blocks taken from the heap since the arena was created. Once the arena is warm, it
+    //! should not change from one turn to another
+    inline uint64_t getNbBlocksAllocated() const
+    { return mNbBlocksAllocated; }
+
+    //! \brief Bytes used since the last reset
+    std::size_t getBytesUsed() const;
+
+    //! \brief Memory kept by the arena
+    std::size_t getCapacity() const;
+
+    static const std::size_t DEFAULT_BLOCK_SIZE = 256 * 1024;
+
+private:
+    struct Block
+    {
+        char* mData;
+        std::size_t mSize;
+    };
+
+    std::size_t mBlockSize;
+    std::vector<Block> mBlocks;
+    //! \brief Block currently used and offset of the free space in it
+    uint32_t mCurrentBlock;
+    std::size_t mCurrentOffset;
+    //! \brief Bytes used in the blocks before mCurrentBlock
+    std::size_t mBytesUsedInPreviousBlocks;
+    //! \brief Last allocation done (for extend)
+    void* mLastAllocation;
+    //! \brief Thread that used the arena since the last reset. Only checked in debug builds
+    std::thread::id mOwnerThread;
+
+    uint64_t mNbAllocations;
+    uint64_t mNbBlocksAllocated;
+};
+
+//! \brief Non owning view over elements allocated in a TurnArena. It is only valid during the turn
+template<typename T>
+class TurnSpan
+{
+public:
+    TurnSpan() :
+        mData(nullptr),
+        mSize(0)
+    {}
+
+    TurnSpan(T* data, uint32_t size) :
+        mData(data),
+        mSize(size)
+    {}
+
+    inline T* begin() const
+    { return mData; }
+
+    inline T* end() const
+    { return mData + mSize; }
+
+    inline uint32_t size() const
+    { return mSize; }
+
+    inline bool empty() const
+    { return mSize == 0; }
+
+    inline T& operator[](uint32_t index) const
+    { return mData[index]; }
+
+    inline T& front() const
+    { return mData[0]; }
+
+    inline T& back() const
+    { return mData[mSize - 1]; }
+
+private:
+    T* mData;
+    uint32_t mSize;
+};
+
+//! \brief Growable array allocated in a TurnArena. Used to build a result which size is not known in advance.
+//! When it grows, it is extended in place if it is the last allocation of the arena. Otherwise, the elements are
+//! copied in a bigger array (the old one is released with the others at the end of the turn). Only trivial
+//! types (like pointers) are allowed because no destructor is ever called.
+template<typename T>
+class TurnVector
+{
+    static_assert(std::is_trivially_destructible<T>::value, "TurnVector only supports trivial types");
+
+public:
+    explicit TurnVector(TurnArena& arena, uint32_t capacity = 16) :
+        mArena(arena),
+        mData(arena.allocateArray<T>(capacity)),
+        mSize(0),
+        mCapacity(capacity)
+    {}
+
+    inline void push_back(const T& value)
+    {
+        if(mSize == mCapacity)
+            grow();
+
+        mData[mSize++] = value;
+    }
+
+    inline T* begin() const
+    { return mData; }
+
+    inline T* end() const
+    { return mData + mSize; }
+
+    inline uint32_t size() const
+    { return mSize; }
+
+    inline bool empty() const
+    { return mSize == 0; }
+
+    inline T& operator[](uint32_t index) const
+    { return mData[index]; }
+
+    inline void clear()
+    { mSize = 0; }
+
+    inline TurnSpan<T> span() const
+    { return TurnSpan<T>(mData, mSize); }
+
+private:
+    void grow()
+    {
+        uint32_t newCapacity = (mCapacity > 0) ? mCapacity * 2 : 16;
+        if(!mArena.extend(mData, mCapacity * sizeof(T), newCapacity * sizeof(T)))
+        {
+            T* newData = mArena.allocateArray<T>(newCapacity);
+            if(mSize > 0)
+                std::memcpy(newData, mData, mSize * sizeof(T));
+            mData = newData;
+        }
+        mCapacity = newCapacity;
+    }
+
+    TurnArena& mArena;
+    T* mData;
+    uint32_t mSize;
+    uint32_t mCapacity;
+};
+
+#endif // TURNARENA_H
@@ -0,0 +1,150 @@
+/*
+ *  Copyright (C) 2011-2016  OpenDungeons Team
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "utils/WorkerPool.h"
+
+#include <SFML/System.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <memory>
+
+namespace
+{
+//! \brief State shared by the threads taking part to a parallelFor. It is kept alive by the jobs
+//! queued to the workers because they may start after the calling thread has returned
+struct ParallelForState
+{
+    ParallelForState(uint32_t nbTasks, const std::function<void(uint32_t)>& task) :
+        mNbTasks(nbTasks),
+        mTask(task),
+        mNextIndex(0),
+        mNbTasksDone(0)
+    {}
+
+    //! \brief Runs tasks until there is no more index to process
+    void runTasks()
+    {
+        uint32_t nbDone = 0;
+        for(uint32_t index = mNextIndex++; index < mNbTasks; index = mNextIndex++)
+        {
+            mTask(index);
+            ++nbDone;
+        }
+
+        if(nbDone == 0)
+            return;
+
+        std::lock_guard<std::mutex> lock(mMutex);
+        mNbTasksDone += nbDone;
+        if(mNbTasksDone >= mNbTasks)
+            mAllDone.notify_all();
+    }
+
+    const uint32_t mNbTasks;
+    const std::function<void(uint32_t)> mTask;
+    std::atomic<uint32_t> mNextIndex;
+
+    std::mutex mMutex;
+    std::condition_variable mAllDone;
+    uint32_t mNbTasksDone;
+};
+}
+
+WorkerPool::WorkerPool(uint32_t nbWorkers) :
+    mStopRequested(false)
+{
+    for(uint32_t i = 0; i < nbWorkers; ++i)
+    {
+        sf::Thread* thread = new sf::Thread(&WorkerPool::workerThread, this);
+        mThreads.push_back(thread);
+        thread->launch();
+    }
+}
+
+WorkerPool::~WorkerPool()
+{
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        mStopRequested = true;
+    }
+    mJobAvailable.notify_all();
+
+    // Deleting a sf::Thread waits for it to finish
+    for(sf::Thread* thread : mThreads)
+        delete thread;
+
+    mThreads.clear();
+}
+
+void WorkerPool::post(const std::function<void()>& job)
+{
+    if(mThreads.empty())
+    {
+        job();
+        return;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        mJobs.push_back(job);
+    }
+    mJobAvailable.notify_one();
+}
+
+void WorkerPool::parallelFor(uint32_t nbTasks, const std::function<void(uint32_t)>& task)
+{
+    if(nbTasks == 0)
+        return;
+
+    std::shared_ptr<ParallelForState> state = std::make_shared<ParallelForState>(nbTasks, task);
+    uint32_t nbHelpers = std::min(getNbWorkers(), nbTasks - 1);
+    if(nbHelpers > 0)
+    {
+        {
+            std::lock_guard<std::mutex> lock(mMutex);
+            for(uint32_t i = 0; i < nbHelpers; ++i)
+                mJobs.push_back([state]() { state->runTasks(); });
+        }
+        mJobAvailable.notify_all();
+    }
+
+    state->runTasks();
+
+    std::unique_lock<std::mutex> lock(state->mMutex);
+    state->mAllDone.wait(lock, [&state]() { return state->mNbTasksDone >= state->mNbTasks; });
+}
+
+void WorkerPool::workerThread()
+{
+    while(true)
+    {
+        std::function<void()> job;
+        {
+            std::unique_lock<std::mutex> lock(mMutex);
+            mJobAvailable.wait(lock, [this]() { return mStopRequested || !mJobs.empty(); });
+            // We finish the queued jobs before stopping
+            if(mJobs.empty())
+                return;
+
+            job.swap(mJobs.front());
+            mJobs.pop_front();
+        }
+
+        job();
+    }
+}
@@ -0,0 +1,70 @@
+/*
+ *  Copyright (C) 2011-2016  OpenDungeons Team
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef WORKERPOOL_H
+#define WORKERPOOL_H
+
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <vector>
+
+namespace sf
+{
+class Thread;
+}
+
+//! \brief Threads created once and kept waiting for jobs. Avoids paying the thread creation each time some
+//! work is split between threads. Jobs can be queued to run asynchronously (post) or an index range can be
+//! processed by the workers and the calling thread together (parallelFor).
+class WorkerPool
+{
+public:
+    //! \brief Creates the given number of worker threads. If 0, jobs are run by the calling thread
+    explicit WorkerPool(uint32_t nbWorkers);
+
+    //! \brief Waits for the queued jobs to be done and stops the workers
+    ~WorkerPool();
+
+    WorkerPool(const WorkerPool&) = delete;
+    WorkerPool& operator=(const WorkerPool&) = delete;
+
+    inline uint32_t getNbWorkers() const
+    { return static_cast<uint32_t>(mThreads.size()); }
+
+    //! \brief Queues the given job. It will be run by the first available worker. If there is no worker,
+    //! it is run right away by the calling thread
+    void post(const std::function<void()>& job);
+
+    //! \brief Calls task(index) for each index in [0, nbTasks). The indexes are shared between the workers
+    //! and the calling thread. Returns once every task is done
+    void parallelFor(uint32_t nbTasks, const std::function<void(uint32_t)>& task);
+
+private:
+    void workerThread();
+
+    std::vector<sf::Thread*> mThreads;
+
+    std::mutex mMutex;
+    std::condition_variable mJobAvailable;
+    std::deque<std::function<void()>> mJobs;
+    bool mStopRequested;
+};
+
+#endif // WORKERPOOL_H